@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""Replays editing sessions against `voltc --lsp-replay` and prints its latencies.
+
+    python3 bench/lsp/replay.py build/volt                # generated 100k-line workspace
+    python3 bench/lsp/replay.py build/volt bench/lsp/sessions/test_volt.jsonl test/test.volt
+
+A session holds the client's side of a conversation, one JSON-RPC message per line; `{root}`
+in it stands for the repository root as a file URI. Without one, a workspace of 50 files of
+2000 lines each is generated under bench/lsp/workspace, with a session that types into a
+function body (going through unparsable states on the way), drops and restores a semicolon,
+and changes the signature of a function the next file calls.
+"""
+import json
+import pathlib
+import subprocess
+import sys
+
+HERE = pathlib.Path(__file__).resolve().parent
+ROOT = HERE.parent.parent
+WORKSPACE = HERE / "workspace"
+FILES = 50
+FUNCTIONS = 180  # Per file, 11 lines each
+
+
+class Session:
+    def __init__(self):
+        self.messages = [
+            {"jsonrpc": "2.0", "id": 1, "method": "initialize", "params": {"capabilities": {}}},
+            {"jsonrpc": "2.0", "method": "initialized", "params": {}},
+        ]
+        self.versions = {}
+
+    def notify(self, method: str, params: dict):
+        self.messages.append({"jsonrpc": "2.0", "method": method, "params": params})
+
+    def open(self, path: pathlib.Path):
+        uri = path.as_uri()
+        self.versions[uri] = 1
+        self.notify("textDocument/didOpen", {
+            "textDocument": {"uri": uri, "languageId": "volt", "version": 1,
+                             "text": path.read_text()},
+        })
+
+    # Replaces [start, end) of `line`, or up to `end` of `end_line`
+    def change(self, path: pathlib.Path, line: int, start: int, end: int, text: str,
+               end_line: int = None):
+        uri = path.as_uri()
+        self.versions[uri] += 1
+        self.notify("textDocument/didChange", {
+            "textDocument": {"uri": uri, "version": self.versions[uri]},
+            "contentChanges": [{
+                "range": {"start": {"line": line, "character": start},
+                          "end": {"line": line if end_line is None else end_line,
+                                  "character": end}},
+                "text": text,
+            }],
+        })
+
+    # One change per character, like an editor sends while typing
+    def type(self, path: pathlib.Path, line: int, column: int, text: str):
+        for i, c in enumerate(text):
+            self.change(path, line, column + i, column + i, c)
+
+    def erase(self, path: pathlib.Path, line: int, column: int, count: int):
+        for i in reversed(range(count)):
+            self.change(path, line, column + i, column + i + 1, "")
+
+    def close(self, path: pathlib.Path):
+        self.notify("textDocument/didClose", {"textDocument": {"uri": path.as_uri()}})
+
+    def write(self, path: pathlib.Path):
+        messages = self.messages + [
+            {"jsonrpc": "2.0", "id": 2, "method": "shutdown"},
+            {"jsonrpc": "2.0", "method": "exit"},
+        ]
+        lines = (json.dumps(message).replace(ROOT.as_uri(), "{root}") for message in messages)
+        path.write_text("".join(line + "\n" for line in lines))
+
+
+def function(file: int, index: int) -> str:
+    call = ""
+    if index > 0:
+        call = f"    acc = acc + f{file}_{index - 1}(acc, 2);\n"
+    elif file > 0:
+        call = f"    acc = acc + f{file - 1}_{FUNCTIONS - 1}(acc, 2);\n"
+    return (
+        f"fn f{file}_{index}(p: i32, q: i32) -> i32 {{\n"
+        f"    var acc: i32 = p;\n"
+        f"    for (i) in 0..q {{\n"
+        f"        acc = acc + i * 2;\n"
+        f"    }}\n"
+        f"    if (acc > 10) {{ acc = acc - 1; }}\n"
+        f"{call}"
+        f"    val v: s{file} = {{ a: acc, b: 2, c: true }};\n"
+        f"    return acc + v.a;\n"
+        f"}}\n\n"
+    )
+
+
+def generate_workspace() -> list:
+    WORKSPACE.mkdir(exist_ok=True)
+    paths = []
+    for file in range(FILES):
+        text = f"struct s{file} {{ a: i32; b: i64; c: bool; }}\nenum e{file} {{ x, y, z }}\n"
+        text += "".join(function(file, index) for index in range(FUNCTIONS))
+        path = WORKSPACE / f"w{file:02}.volt"
+        path.write_text(text)
+        paths.append(path)
+    return paths
+
+
+def generate_session(paths: list) -> pathlib.Path:
+    session = Session()
+    middle = paths[FILES // 2]
+    session.open(middle)
+
+    # `    var acc: i32 = p;` in the 90th function, before the semicolon
+    body = 2 + 90 * 11 + 1
+    session.type(middle, body, 20, " + q * 3")
+    session.erase(middle, body, 20, 8)
+
+    session.change(middle, body, 20, 21, "")
+    session.change(middle, body, 20, 20, ";")
+
+    # Another parameter type for the last function, and back
+    signature = 2 + (FUNCTIONS - 1) * 11
+    column = len(f"fn f{FILES // 2}_{FUNCTIONS - 1}(p: ")
+    session.change(middle, signature, column, column + 3, "i64")
+    session.change(middle, signature, column, column + 3, "i32")
+
+    path = HERE / "workspace.jsonl"
+    session.write(path)
+    return path
+
+
+# Frames each message with its Content-Length, as on the wire
+def frame(session: pathlib.Path) -> bytes:
+    framed = []
+    for line in session.read_text().splitlines():
+        if not line.strip():
+            continue
+        body = line.replace("{root}", ROOT.as_uri()).encode()
+        framed.append(b"Content-Length: %d\r\n\r\n" % len(body) + body)
+    return b"".join(framed)
+
+
+def main() -> None:
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+
+    voltc = sys.argv[1]
+    if len(sys.argv) > 2:
+        session = pathlib.Path(sys.argv[2])
+        files = [pathlib.Path(path).resolve() for path in sys.argv[3:]]
+    else:
+        files = generate_workspace()
+        session = generate_session(files)
+
+    result = subprocess.run([voltc, "--lsp-replay", *map(str, files)], input=frame(session))
+    sys.exit(result.returncode)
+
+
+if __name__ == "__main__":
+    main()
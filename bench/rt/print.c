@@ -0,0 +1,133 @@
+// The runtime's per-thread writers against C stdio, writing to stdout.
+//
+//     volt_bench_print [lines] [threads] > /dev/null
+//
+// Each case writes the same bytes both ways, first from one thread and then split across
+// `threads` threads. stdio goes through printf, which locks stdout on every call; the runtime
+// goes through volt_rt_stdout, which every thread has to itself. Times go to stderr. Build with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+
+#include <pthread.h>
+#include <rt/io.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_LINES   4000000u
+#define BENCH_DEFAULT_THREADS 4u
+
+typedef enum {
+    BENCH_INTEGERS,  // "<i>\n"
+    BENCH_RECORDS,   // "item <i>: <i * 7>, ok=<bool>\n"
+} bench_case_t;
+
+typedef struct bench_job_t bench_job_t;
+struct bench_job_t {
+    bench_case_t kind;
+    bool         runtime;
+    size_t       first;
+    size_t       count;
+};
+
+static double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+}
+
+static void bench_stdio(const bench_job_t* job) {
+    for (size_t i = job->first; i < job->first + job->count; i++) {
+        if (job->kind == BENCH_INTEGERS)
+            printf("%zu\n", i);
+        else
+            printf("item %zu: %zu, ok=%s\n", i, i * 7, i % 3 == 0 ? "true" : "false");
+    }
+    fflush(stdout);
+}
+
+static void bench_runtime(const bench_job_t* job) {
+    volt_rt_writer_t* out = volt_rt_stdout();
+    for (size_t i = job->first; i < job->first + job->count; i++) {
+        if (job->kind == BENCH_INTEGERS) {
+            volt_rt_write_uint(out, i);
+            volt_rt_write_bytes(out, "\n", 1);
+        } else {
+            volt_rt_write_bytes(out, "item ", 5);
+            volt_rt_write_uint(out, i);
+            volt_rt_write_bytes(out, ": ", 2);
+            volt_rt_write_uint(out, i * 7);
+            volt_rt_write_bytes(out, ", ok=", 5);
+            volt_rt_write_bool(out, i % 3 == 0);
+            volt_rt_write_bytes(out, "\n", 1);
+        }
+    }
+    volt_rt_flush(out);
+}
+
+static void* bench_thread(void* argument) {
+    bench_job_t* job = (bench_job_t*) argument;
+    if (job->runtime)
+        bench_runtime(job);
+    else
+        bench_stdio(job);
+    return NULL;
+}
+
+// Splits the lines evenly across `threads` threads; a single share runs on the calling thread
+static double bench_run(bench_case_t kind, bool runtime, size_t lines, size_t threads) {
+    bench_job_t* jobs    = calloc(threads, sizeof(bench_job_t));
+    pthread_t*   handles = calloc(threads, sizeof(pthread_t));
+    if (!jobs || !handles) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    for (size_t i = 0; i < threads; i++) {
+        jobs[i].kind    = kind;
+        jobs[i].runtime = runtime;
+        jobs[i].first   = lines / threads * i;
+        jobs[i].count   = i + 1 == threads ? lines - jobs[i].first : lines / threads;
+    }
+
+    double start = bench_now();
+    if (threads == 1) {
+        bench_thread(&jobs[0]);
+    } else {
+        for (size_t i = 0; i < threads; i++) {
+            if (pthread_create(&handles[i], NULL, bench_thread, &jobs[i]) != 0) {
+                fprintf(stderr, "cannot start a thread\n");
+                exit(1);
+            }
+        }
+        for (size_t i = 0; i < threads; i++)
+            pthread_join(handles[i], NULL);
+    }
+    double seconds = bench_now() - start;
+
+    free(handles);
+    free(jobs);
+    return seconds;
+}
+
+static void bench_compare(const char* name, bench_case_t kind, size_t lines, size_t threads) {
+    double stdio   = bench_run(kind, false, lines, threads);
+    double runtime = bench_run(kind, true, lines, threads);
+    fprintf(stderr, "%-8s %2zu thread(s)  stdio %8.3f s  runtime %8.3f s  %6.2fx\n", name,
+            threads, stdio, runtime, stdio / runtime);
+}
+
+int main(int argc, char** argv) {
+    size_t lines   = argc > 1 ? (size_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_LINES;
+    size_t threads = argc > 2 ? (size_t) strtoul(argv[2], NULL, 10) : BENCH_DEFAULT_THREADS;
+    if (threads == 0)
+        threads = 1;
+
+    fprintf(stderr, "%zu line(s) per case\n", lines);
+    bench_compare("integers", BENCH_INTEGERS, lines, 1);
+    bench_compare("records", BENCH_RECORDS, lines, 1);
+    if (threads > 1) {
+        bench_compare("integers", BENCH_INTEGERS, lines, threads);
+        bench_compare("records", BENCH_RECORDS, lines, threads);
+    }
+    return 0;
+}
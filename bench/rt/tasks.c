@@ -0,0 +1,141 @@
+// Scheduler throughput on millions of tiny tasks.
+//
+//     volt_bench_tasks [depth] [workers]
+//
+// tree:  one task fans out into a binary tree of `depth` levels. Every inner task spawns its two
+//        children on its own worker, joins them one after the other and frees them, so the run is
+//        dominated by deque pushes, takes, steals and joins.
+// flat:  a thread outside the pool spawns as many leaf tasks in batches through the injection
+//        queue, then waits for and frees each one, as a program's main thread would.
+//
+// Prints the task count, the time and the tasks per second of each run. Build with
+// -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+
+#include <rt/scheduler.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_DEPTH 21u  // 4M tasks
+#define BENCH_BATCH         256u
+
+typedef struct bench_task_t bench_task_t;
+struct bench_task_t {
+    volt_rt_task_t task;
+    unsigned       state;
+    unsigned       depth;
+    bench_task_t*  left;
+    bench_task_t*  right;
+};
+
+static volt_rt_scheduler_t bench_scheduler;
+
+static double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+}
+
+static volt_rt_task_status_t bench_resume(volt_rt_task_t* task);
+
+static bench_task_t* bench_create(unsigned depth) {
+    bench_task_t* frame = malloc(sizeof(bench_task_t));
+    if (!frame) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    frame->state = 0;
+    frame->depth = depth;
+    frame->left  = NULL;
+    frame->right = NULL;
+    volt_rt_task_init(&frame->task, bench_resume, frame);
+    return frame;
+}
+
+static void bench_spawn(bench_task_t* frame) {
+    if (!volt_rt_spawn(&bench_scheduler, &frame->task)) {
+        fprintf(stderr, "spawn failed\n");
+        exit(1);
+    }
+}
+
+static volt_rt_task_status_t bench_resume(volt_rt_task_t* task) {
+    bench_task_t* frame = (bench_task_t*) task->frame;
+    switch (frame->state) {
+        case 0:
+            if (frame->depth == 0)
+                return VOLT_RT_TASK_DONE;
+            frame->left  = bench_create(frame->depth - 1);
+            frame->right = bench_create(frame->depth - 1);
+            bench_spawn(frame->left);
+            bench_spawn(frame->right);
+            frame->state = 1;
+            return volt_rt_join(task, &frame->left->task);
+        case 1:
+            frame->state = 2;
+            return volt_rt_join(task, &frame->right->task);
+        default:
+            // Both children are done, and a done task is no longer touched by the scheduler
+            free(frame->left);
+            free(frame->right);
+            return VOLT_RT_TASK_DONE;
+    }
+}
+
+static void bench_report(const char* name, size_t tasks, double seconds) {
+    printf("%-5s %10zu tasks  %8.3f s  %8.2f M tasks/s\n", name, tasks, seconds,
+           (double) tasks / seconds * 1e-6);
+}
+
+static void bench_tree(unsigned depth) {
+    double        start = bench_now();
+    bench_task_t* root  = bench_create(depth);
+    bench_spawn(root);
+    volt_rt_wait(&bench_scheduler, &root->task);
+    free(root);
+    bench_report("tree", ((size_t) 2 << depth) - 1, bench_now() - start);
+}
+
+static void bench_flat(size_t count) {
+    bench_task_t** batch = malloc(BENCH_BATCH * sizeof(bench_task_t*));
+    if (!batch) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    double start = bench_now();
+    for (size_t done = 0; done < count; done += BENCH_BATCH) {
+        size_t size = count - done < BENCH_BATCH ? count - done : BENCH_BATCH;
+        for (size_t i = 0; i < size; i++) {
+            batch[i] = bench_create(0);
+            bench_spawn(batch[i]);
+        }
+        for (size_t i = 0; i < size; i++) {
+            volt_rt_wait(&bench_scheduler, &batch[i]->task);
+            free(batch[i]);
+        }
+    }
+    bench_report("flat", count, bench_now() - start);
+    free(batch);
+}
+
+int main(int argc, char** argv) {
+    unsigned depth   = argc > 1 ? (unsigned) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_DEPTH;
+    size_t   workers = argc > 2 ? (size_t) strtoul(argv[2], NULL, 10) : 0;
+    if (depth > 30) {
+        fprintf(stderr, "depth must be at most 30\n");
+        return 1;
+    }
+
+    if (!volt_rt_scheduler_init(&bench_scheduler, workers)) {
+        fprintf(stderr, "cannot start the scheduler\n");
+        return 1;
+    }
+    printf("%zu worker(s)\n", bench_scheduler.worker_count);
+
+    bench_tree(depth);
+    bench_flat(((size_t) 2 << depth) - 1);
+
+    volt_rt_scheduler_deinit(&bench_scheduler);
+    return 0;
+}
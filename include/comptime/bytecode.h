@@ -0,0 +1,165 @@
+#ifndef __VOLT_BYTECODE_H__
+#define __VOLT_BYTECODE_H__
+
+#include <util/memory/allocator.h>
+#include <util/types/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct volt_type_info_t;
+struct volt_symbol_t;
+
+typedef enum volt_comptime_value_kind_t volt_comptime_value_kind_t;
+enum volt_comptime_value_kind_t {
+    VOLT_COMPTIME_VALUE_VOID,
+    VOLT_COMPTIME_VALUE_NULL,
+    VOLT_COMPTIME_VALUE_BOOL,
+    VOLT_COMPTIME_VALUE_INT,
+    VOLT_COMPTIME_VALUE_FLOAT,
+    VOLT_COMPTIME_VALUE_TYPE,
+};
+
+typedef struct volt_comptime_value_t volt_comptime_value_t;
+struct volt_comptime_value_t {
+    volt_comptime_value_kind_t kind;
+    union {
+        bool                     b;
+        int64_t                  i;
+        float64_t                f;
+        struct volt_type_info_t* type;
+    };
+};
+
+// Instructions are 32 bits wide, register based:
+//   | op:8 | a:8 | b:8 | c:8 |   or   | op:8 | a:8 | bx:16 |
+// `sbx` is bx biased by VOLT_BYTECODE_SBX_BIAS so jumps can go backwards.
+typedef uint32_t volt_instruction_t;
+
+#define VOLT_BYTECODE_MAX_REGISTERS 255
+#define VOLT_BYTECODE_SBX_BIAS      0x7FFF
+#define VOLT_BYTECODE_SBX_MAX       0x8000
+#define VOLT_BYTECODE_SBX_MIN       (-0x7FFF)
+
+#define VOLT_INSTR_OP(i)  ((volt_opcode_t) ((i) & 0xFFu))
+#define VOLT_INSTR_A(i)   ((uint8_t) (((i) >> 8) & 0xFFu))
+#define VOLT_INSTR_B(i)   ((uint8_t) (((i) >> 16) & 0xFFu))
+#define VOLT_INSTR_C(i)   ((uint8_t) (((i) >> 24) & 0xFFu))
+#define VOLT_INSTR_BX(i)  ((uint16_t) ((i) >> 16))
+#define VOLT_INSTR_SBX(i) ((int32_t) VOLT_INSTR_BX(i) - VOLT_BYTECODE_SBX_BIAS)
+
+#define VOLT_INSTR_ABC(op, a, b, c)                                 \
+    ((volt_instruction_t) (op) | ((volt_instruction_t) (a) << 8) | \
+     ((volt_instruction_t) (b) << 16) | ((volt_instruction_t) (c) << 24))
+#define VOLT_INSTR_ABX(op, a, bx)                                  \
+    ((volt_instruction_t) (op) | ((volt_instruction_t) (a) << 8) | \
+     ((volt_instruction_t) (bx) << 16))
+
+// X-macro so the opcode enum, the disassembler names and the VM dispatch table stay in sync.
+//   MOVE      R[a] = R[b]
+//   LOADK     R[a] = K[bx]
+//   LOADI     R[a] = sbx
+//   LOADBOOL  R[a] = (bool) b
+//   LOADNULL  R[a] = null
+//   ADD..SHR  R[a] = R[b] op R[c]
+//   ADDI      R[a] = R[b] + (int8_t) c
+//   EQ..GE    R[a] = R[b] cmp R[c]
+//   NEG..BNOT R[a] = op R[b]
+//   JMP       ip += sbx
+//   JMPF/JMPT if (!R[a] / R[a]) ip += sbx
+//   FORPREP   if (!(R[a] < R[a + 1])) ip += sbx
+//   FORLOOP   R[a] += 1; if (R[a] < R[a + 1]) ip += sbx
+//   CALL      R[a] = callees[b](R[a] .. R[a + c - 1])
+//   RET       return R[a]
+//   RETNONE   return void
+#define VOLT_OPCODE_LIST(X) \
+    X(MOVE)                 \
+    X(LOADK)                \
+    X(LOADI)                \
+    X(LOADBOOL)             \
+    X(LOADNULL)             \
+    X(ADD)                  \
+    X(SUB)                  \
+    X(MUL)                  \
+    X(DIV)                  \
+    X(MOD)                  \
+    X(BAND)                 \
+    X(BOR)                  \
+    X(BXOR)                 \
+    X(SHL)                  \
+    X(SHR)                  \
+    X(ADDI)                 \
+    X(EQ)                   \
+    X(NE)                   \
+    X(LT)                   \
+    X(LE)                   \
+    X(GT)                   \
+    X(GE)                   \
+    X(NEG)                  \
+    X(NOT)                  \
+    X(BNOT)                 \
+    X(JMP)                  \
+    X(JMPF)                 \
+    X(JMPT)                 \
+    X(FORPREP)              \
+    X(FORLOOP)              \
+    X(CALL)                 \
+    X(RET)                  \
+    X(RETNONE)
+
+typedef enum volt_opcode_t volt_opcode_t;
+enum volt_opcode_t {
+#define VOLT_OPCODE_ENUM(name) VOLT_OP_##name,
+    VOLT_OPCODE_LIST(VOLT_OPCODE_ENUM)
+#undef VOLT_OPCODE_ENUM
+    VOLT_OP_COUNT
+};
+
+// A compiled function (or a standalone comptime expression)
+typedef struct volt_bytecode_chunk_t volt_bytecode_chunk_t;
+struct volt_bytecode_chunk_t {
+    const char*           name;
+    struct volt_symbol_t* symbol;  // NULL for standalone expressions
+
+    volt_instruction_t* code;
+    size_t*             lines;  // Source line per instruction (for diagnostics)
+    size_t              code_size;
+    size_t              code_capacity;
+
+    volt_comptime_value_t* constants;
+    size_t                 constant_count;
+    size_t                 constant_capacity;
+
+    struct volt_symbol_t** callees;  // Resolved lazily by the VM on first call
+    size_t                 callee_count;
+    size_t                 callee_capacity;
+
+    uint8_t param_count;
+    uint8_t register_count;
+
+    volt_allocator_t* allocator;
+};
+
+volt_bytecode_chunk_t* volt_bytecode_chunk_create(volt_allocator_t*, const char*);
+void                   volt_bytecode_chunk_free(volt_bytecode_chunk_t*);
+void                   volt_bytecode_chunk_vfree(void*);
+size_t                 volt_bytecode_emit(volt_bytecode_chunk_t*, volt_instruction_t, size_t);
+void                   volt_bytecode_patch_jump(volt_bytecode_chunk_t*, size_t, size_t);
+int32_t                volt_bytecode_add_constant(volt_bytecode_chunk_t*, volt_comptime_value_t);
+int32_t                volt_bytecode_add_callee(volt_bytecode_chunk_t*, struct volt_symbol_t*);
+const char*            volt_opcode_to_string(volt_opcode_t);
+void                   volt_bytecode_disassemble(volt_bytecode_chunk_t*);
+
+bool        volt_comptime_value_equals(const volt_comptime_value_t*, const volt_comptime_value_t*);
+bool        volt_comptime_value_truthy(const volt_comptime_value_t*);
+uint64_t    volt_comptime_value_hash(const volt_comptime_value_t*);
+const char* volt_comptime_value_kind_to_string(volt_comptime_value_kind_t);
+
+extern volt_allocator_t volt_bytecode_chunk_allocator;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_BYTECODE_H__
@@ -0,0 +1,24 @@
+#ifndef __VOLT_COMPTIME_COMPILER_H__
+#define __VOLT_COMPTIME_COMPILER_H__
+
+#include <comptime/bytecode.h>
+#include <comptime/vm.h>
+#include <parser/parser.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Lowers a function body (func_def / export_decl) to register bytecode. The chunk is cached on
+// the symbol, so each function is compiled at most once per build.
+volt_bytecode_chunk_t* volt_comptime_compile_function(volt_comptime_t*, struct volt_symbol_t*);
+
+// Lowers a single expression into a zero-parameter chunk
+volt_bytecode_chunk_t* volt_comptime_compile_expression(volt_comptime_t*, volt_ast_node_t*,
+                                                        const volt_comptime_binding_t*, size_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_COMPTIME_COMPILER_H__
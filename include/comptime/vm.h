@@ -0,0 +1,118 @@
+#ifndef __VOLT_VM_H__
+#define __VOLT_VM_H__
+
+#include <comptime/bytecode.h>
+#include <parser/parser.h>
+#include <util/memory/allocator.h>
+#include <util/types/types.h>
+#include <util/types/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct volt_semantic_analyzer_t;
+
+// Backward branches and calls a single evaluation may take before it is assumed to diverge
+#define VOLT_COMPTIME_DEFAULT_MAX_STEPS 50000000u
+#define VOLT_COMPTIME_MAX_CALL_DEPTH    1024u
+
+// Name -> value pairs visible to a standalone expression (e.g. generic const params)
+typedef struct volt_comptime_binding_t volt_comptime_binding_t;
+struct volt_comptime_binding_t {
+    const char*           name;
+    volt_comptime_value_t value;
+};
+
+typedef struct volt_comptime_frame_t volt_comptime_frame_t;
+struct volt_comptime_frame_t {
+    volt_bytecode_chunk_t*    chunk;
+    const volt_instruction_t* ip;
+    size_t                    base;       // First register of this frame in the register stack
+    size_t                    memo_args;  // Offset of the argument snapshot in memo_stack
+    uint8_t                   argc;
+};
+
+// Memoized results keyed by (chunk, argument values)
+typedef struct volt_comptime_memo_entry_t volt_comptime_memo_entry_t;
+struct volt_comptime_memo_entry_t {
+    volt_bytecode_chunk_t* chunk;  // NULL marks an empty slot
+    uint64_t               hash;
+    volt_comptime_value_t* args;
+    uint8_t                argc;
+    volt_comptime_value_t  result;
+};
+
+typedef struct volt_comptime_memo_t volt_comptime_memo_t;
+struct volt_comptime_memo_t {
+    volt_comptime_memo_entry_t* entries;
+    size_t                      count;
+    size_t                      capacity;
+    size_t                      hits;
+    size_t                      misses;
+    volt_allocator_t*           allocator;
+};
+
+typedef struct volt_comptime_vm_t volt_comptime_vm_t;
+struct volt_comptime_vm_t {
+    volt_comptime_value_t* registers;
+    size_t                 register_capacity;
+
+    volt_comptime_frame_t* frames;
+    size_t                 frame_count;
+    size_t                 frame_capacity;
+
+    volt_comptime_value_t* memo_stack;  // Argument snapshots of the active frames
+    size_t                 memo_stack_size;
+    size_t                 memo_stack_capacity;
+
+    uint64_t steps;
+    uint64_t max_steps;
+};
+
+// Comptime evaluation context, owned by the semantic analyzer
+typedef struct volt_comptime_t volt_comptime_t;
+struct volt_comptime_t {
+    volt_allocator_t*                allocator;
+    struct volt_semantic_analyzer_t* analyzer;
+
+    volt_comptime_vm_t   vm;
+    volt_comptime_memo_t memo;
+    volt_vector_t        chunks;  // Every chunk compiled so far (owned)
+    volt_vector_t        folded;  // volt_comptime_value_t* attached to AST nodes (owned)
+
+    // Last failure
+    char             error_message[256];
+    volt_ast_node_t* error_node;
+    size_t           error_line;
+};
+
+volt_status_code_t volt_comptime_init(volt_comptime_t*, struct volt_semantic_analyzer_t*,
+                                      volt_allocator_t*);
+volt_status_code_t volt_comptime_deinit(volt_comptime_t*);
+
+// Runs a function symbol with the given arguments; results are memoized by argument values
+volt_status_code_t volt_comptime_call(volt_comptime_t*, struct volt_symbol_t*,
+                                      const volt_comptime_value_t*, size_t,
+                                      volt_comptime_value_t*);
+
+// Evaluates a standalone expression; free identifiers are looked up in the bindings first
+volt_status_code_t volt_comptime_eval(volt_comptime_t*, volt_ast_node_t*,
+                                      const volt_comptime_binding_t*, size_t,
+                                      volt_comptime_value_t*);
+
+// Records a folded value on an AST node (node->data) and returns it
+volt_comptime_value_t* volt_comptime_fold(volt_comptime_t*, volt_ast_node_t*,
+                                          volt_comptime_value_t);
+
+void volt_comptime_set_error(volt_comptime_t*, volt_ast_node_t*, const char*, ...);
+
+volt_status_code_t volt_comptime_vm_execute(volt_comptime_t*, volt_bytecode_chunk_t*,
+                                            const volt_comptime_value_t*, size_t,
+                                            volt_comptime_value_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_VM_H__
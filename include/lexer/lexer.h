@@ -1,8 +1,8 @@
 #ifndef __VOLT_LEXER_H__
 #define __VOLT_LEXER_H__
 
+#include <lexer/token.h>
 #include <util/types/types.h>
-#include <util/types/vector.h>
 #include <volt/error.h>
 
 #ifdef __cplusplus
@@ -17,7 +17,7 @@ struct volt_lexer_t {
     size_t                current_line;
     size_t                current_column;
     size_t                input_stream_length;
-    volt_vector_t         tokens;
+    volt_token_vector_t   tokens;
     volt_error_handler_t* error_handler;
     volt_allocator_t*     allocator;
 };
@@ -26,6 +26,12 @@ volt_status_code_t volt_lexer_init(volt_lexer_t*, volt_allocator_t*);
 volt_status_code_t volt_lexer_deinit(volt_lexer_t*);
 volt_status_code_t volt_lexer_lex(volt_lexer_t*);
 
+// Replaces `removed` bytes at `offset` with `text` and relexes only the damaged range: from the
+// last token the edit cannot reach to the first old token the new stream lines up with again.
+// Tokens after that are kept and moved. `edit` (optional) gets the token range that changed,
+// for volt_parser_reparse. Lexical errors are only reported for the relexed range.
+volt_status_code_t volt_lexer_relex(volt_lexer_t*, size_t, size_t, const char*, volt_token_edit_t*);
+
 #ifdef __cplusplus
 }
 #endif
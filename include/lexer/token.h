@@ -4,6 +4,7 @@
 #include <lexer/token_type.h>
 #include <util/memory/allocator.h>
 #include <util/types/types.h>
+#include <util/types/value_vector.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,16 +16,28 @@ struct volt_token_t {
     const char*       lexeme;
     size_t            line;
     size_t            column;
+    size_t            offset;  // Byte offset of the first character in the source
+    size_t            length;  // Bytes of source it spans, quotes included
     volt_allocator_t* allocator;
 };
 
-void               volt_vtoken_deinit(void*);
+// Tokens live by value in one array per file; AST nodes point into it once lexing is done
+VOLT_VECTOR_DEFINE(token, volt_token_t)
+
+// Which tokens an edit replaced: [first, first + removed) of the old stream became
+// [first, first + inserted) of the new one, and every later token moved by the difference
+typedef struct volt_token_edit_t volt_token_edit_t;
+struct volt_token_edit_t {
+    size_t first;
+    size_t removed;
+    size_t inserted;
+};
+
+// Frees the lexeme; the token itself belongs to its vector
 volt_status_code_t volt_token_deinit(volt_token_t*);
 void               volt_token_print(volt_token_t*);
 const char*        volt_token_type_to_string(volt_token_type_t);
 
-extern volt_allocator_t volt_token_allocator;
-
 #ifdef __cplusplus
 }
 #endif
@@ -135,7 +135,9 @@ enum volt_token_type_t {
     VOLT_TOKEN_TYPE_SUSPEND_KW,
     VOLT_TOKEN_TYPE_RESUME_KW,
     VOLT_TOKEN_TYPE_AS_KW,
-    VOLT_TOKEN_TYPE_DEFER_KW
+    VOLT_TOKEN_TYPE_DEFER_KW,
+
+    VOLT_TOKEN_TYPE_COUNT  // Number of token types, not a token
 };
 
 #ifdef __cplusplus
@@ -15,29 +15,37 @@ struct volt_subexpression_t {
         volt_token_type_t token_type;
         const char*       subexpression;
     };
-    bool is_subexpression;
-    bool is_optional;  // marks this element as optional
+    bool   is_subexpression;
+    bool   is_optional;  // marks this element as optional
+    bool   is_body;      // A function body, skipped by brace matching when parsing lazily
+    size_t rule;         // Registry index of `subexpression`, count when it names no rule
 };
 
 typedef struct volt_expression_t volt_expression_t;
 struct volt_expression_t {
-    const char*            expression_name;
-    size_t                 num_alternatives;
-    size_t                 capacity;
-    volt_subexpression_t** alternatives;
-    size_t*                alternative_lengths;
+    const char*                        expression_name;
+    size_t                             num_alternatives;
+    size_t                             capacity;
+    const volt_subexpression_t* const* alternatives;
+    const size_t*                      alternative_lengths;
+    // `x_rest ::= sep? item x_rest | ... | ε`, parsed as a loop
+    bool                               is_list;
 };
 
+// Either built at runtime by volt_define_expressions, or the read-only tables volt_pgen emits
+// from it (see src/parser/parser.c), which need no init, resolve or deinit
 typedef struct volt_expression_registry_t volt_expression_registry_t;
 struct volt_expression_registry_t {
-    volt_expression_t** expressions;
-    size_t              count;
-    size_t              capacity;
-    volt_allocator_t*   allocator;
+    const volt_expression_t* const* expressions;
+    size_t                          count;
+    size_t                          capacity;
+    volt_allocator_t*               allocator;
 };
 
 // Expression management
 volt_expression_t* volt_expression_create(const char*);
+// Items of a list rule become siblings under one node instead of one nested node per item
+volt_expression_t* volt_expression_create_list(const char*);
 void               volt_expression_add_alt(volt_expression_t* expr, volt_subexpression_t*, size_t);
 void               volt_expression_free(volt_expression_t*);
 
@@ -49,11 +57,15 @@ volt_subexpression_t volt_sub_expr(const char*);
 volt_subexpression_t volt_sub_opt_token(volt_token_type_t);
 volt_subexpression_t volt_sub_opt_expr(const char*);
 
+// Helper functions - function bodies, a `{ ... }` rule that lazy parsing may skip
+volt_subexpression_t volt_sub_body(const char*);
+
 // Convenient macros
 #define volt_token(type)     volt_sub_token(type)
 #define volt_expr(name)      volt_sub_expr(name)
 #define volt_opt_token(type) volt_sub_opt_token(type)
 #define volt_opt_expr(name)  volt_sub_opt_expr(name)
+#define volt_body(name)      volt_sub_body(name)
 
 // Magic macro that automatically counts arguments
 #define VOLT_ALT(expr_ptr, ...)                           \
@@ -62,11 +74,18 @@ volt_subexpression_t volt_sub_opt_expr(const char*);
         sizeof((volt_subexpression_t[]) {__VA_ARGS__}) / sizeof(volt_subexpression_t))
 
 // Registry for storing and looking up expressions
-volt_status_code_t volt_expression_registry_init(volt_expression_registry_t*, volt_allocator_t*);
-volt_status_code_t volt_expression_registry_deinit(volt_expression_registry_t*);
-void               volt_expression_registry_add(volt_expression_registry_t*, volt_expression_t*);
-volt_expression_t* volt_expression_registry_get(volt_expression_registry_t*, const char*);
-void               volt_define_expressions(volt_expression_registry_t*);
+volt_status_code_t       volt_expression_registry_init(volt_expression_registry_t*,
+                                                       volt_allocator_t*);
+volt_status_code_t       volt_expression_registry_deinit(volt_expression_registry_t*);
+void                     volt_expression_registry_add(volt_expression_registry_t*,
+                                                      volt_expression_t*);
+// Fills in `rule` for every subexpression, once all rules are added
+void                     volt_expression_registry_resolve(volt_expression_registry_t*);
+size_t                   volt_expression_registry_index(const volt_expression_registry_t*,
+                                                        const char*);
+const volt_expression_t* volt_expression_registry_get(const volt_expression_registry_t*,
+                                                      const char*);
+void                     volt_define_expressions(volt_expression_registry_t*);
 
 #ifdef __cplusplus
 }
@@ -6,6 +6,9 @@
 #include <parser/expression.h>
 #include <pch.h>
 #include <util/memory/allocator.h>
+#include <util/memory/arena.h>
+#include <util/types/small_vector.h>
+#include <util/types/value_vector.h>
 #include <util/types/vector.h>
 #include <volt/error.h>
 
@@ -28,38 +31,94 @@ enum volt_ast_node_type_t {
 // AST Node structure
 struct volt_ast_node_t {
     volt_ast_node_type_t type;
+    bool                 skipped;          // Body not parsed yet, see volt_ast_parse_body
     const char*          expression_name;  // Which grammar rule created this
     volt_token_t*        token;            // If this is a token node
-    volt_vector_t        children;         // Child nodes (volt_ast_node_t*)
+    volt_small_vector_t  children;         // Child nodes (volt_ast_node_t*)
     void*                data;             // Extra data specific to node type
 };
 
+// Children matched so far by the alternatives being tried, innermost last
+VOLT_VECTOR_DEFINE(ast_node, volt_ast_node_t*)
+
+// A top-level item and its tokens. `examined` is one past the furthest token its parse looked
+// at, which is past `end` when an alternative failed further in.
+typedef struct volt_parser_item_t volt_parser_item_t;
+struct volt_parser_item_t {
+    volt_ast_node_t* node;
+    size_t           start;
+    size_t           end;
+    size_t           examined;
+};
+
+VOLT_VECTOR_DEFINE(parser_item, volt_parser_item_t)
+
 // Parser state
 struct volt_parser_t {
-    volt_allocator_t*           allocator;
-    volt_vector_t*              tokens;         // Input tokens
-    size_t                      current;        // Current token index
-    volt_expression_registry_t* registry;       // Grammar rules
-    volt_ast_node_t*            root;           // Root AST node
-    volt_error_handler_t*       error_handler;  // Parse errors
-    const char*                 input_stream_name;
-    size_t                      furthest_error_pos;
-    char                        furthest_error_msg[256];
-    bool                        error_reported;
+    volt_allocator_t*                 allocator;
+    volt_token_vector_t*              tokens;         // Input tokens
+    size_t                            current;        // Current token index
+    const volt_expression_registry_t* registry;       // Grammar rules, shared and read-only
+    volt_ast_node_t*                  root;           // Root AST node
+    volt_arena_t                      nodes;          // Every node and children array
+    volt_ast_node_vector_t            pending;        // Children of alternatives being matched
+    volt_error_handler_t*             error_handler;  // Parse errors
+    const char*                       input_stream_name;
+    bool                              interpreted;  // Walk the grammar, not the generated parser
+    bool                              lazy_bodies;  // Skip function bodies until they are needed
+
+    // Kept for volt_parser_reparse
+    volt_parser_item_vector_t items;       // Top-level items of the current tree
+    volt_small_vector_t       top_level;   // Children of the top-level list node
+    volt_token_t*             token_data;  // Where the tokens were when the tree last saw them
+    size_t                    examined;    // One past the furthest token looked at
+    size_t                    stale;       // About how many nodes reparsing has left behind
+    size_t                    generation;  // Bumped by every full parse, which replaces all nodes
+
+    // Furthest failure, turned into a message only when it is reported
+    size_t                   furthest_error_pos;
+    const volt_expression_t* furthest_error_rule;  // Innermost rule that failed there
+    const char*              furthest_error_msg;   // Static message, when not a rule failure
+    uint64_t                 furthest_expected[(VOLT_TOKEN_TYPE_COUNT + 63) / 64];
+    bool                     error_reported;
 };
 
 // Parser functions
-volt_status_code_t volt_parser_init(volt_parser_t*, volt_allocator_t*, volt_vector_t*,
+volt_status_code_t volt_parser_init(volt_parser_t*, volt_allocator_t*, volt_token_vector_t*,
                                     volt_error_handler_t*, const char*);
 volt_status_code_t volt_parser_parse(volt_parser_t*);
 volt_status_code_t volt_parser_deinit(volt_parser_t*);
 
+// Brings the tree up to date with an edit from volt_lexer_relex, for the same token vector.
+// Top-level items that never looked at the replaced tokens are kept, and only the ones between
+// them are parsed again. Nodes of replaced items stay in the arena until the next full parse,
+// which this does instead once a file's worth of tokens has been reparsed. Only nodes of kept
+// items outlive the call, and not when it falls back to a full parse.
+volt_status_code_t volt_parser_reparse(volt_parser_t*, const volt_token_edit_t*);
+
 void volt_ast_print_tree(volt_ast_node_t*, int32_t);
 
 // AST functions
-volt_ast_node_t* volt_ast_node_create(volt_parser_t*, volt_ast_node_type_t, const char*);
-void             volt_ast_node_add_child(volt_ast_node_t*, volt_ast_node_t*);
-void             volt_ast_node_free(volt_parser_t*, volt_ast_node_t*);
+// Nodes live in the parser's arena and are released with it; children are fixed at creation
+volt_ast_node_t* volt_ast_node_create(volt_parser_t*, volt_ast_node_type_t, const char*,
+                                      volt_ast_node_t**, size_t);
+
+// Function bodies skipped by lazy parsing are placeholder `block` nodes without children until
+// volt_ast_parse_body parses them in place, through the parser that skipped them (which must
+// still be alive). Anything that reads a function body goes through volt_ast_body.
+// Both return NULL when the body fails to parse; the syntax error is reported then.
+volt_ast_node_t* volt_ast_parse_body(volt_ast_node_t*);
+volt_ast_node_t* volt_ast_body(volt_ast_node_t*);
+
+// AST queries (shared by the semantic passes)
+bool             volt_ast_is(volt_ast_node_t*, const char*);
+volt_ast_node_t* volt_ast_get_child(volt_ast_node_t*, size_t);
+volt_ast_node_t* volt_ast_find_child(volt_ast_node_t*, const char*);
+volt_token_t*    volt_ast_find_token(volt_ast_node_t*, volt_token_type_t);
+volt_token_t*    volt_ast_first_token(volt_ast_node_t*);
+const char*      volt_ast_get_identifier(volt_ast_node_t*);
+volt_ast_node_t* volt_ast_unwrap(volt_ast_node_t*);
+size_t           volt_ast_collect_list(volt_ast_node_t*, const char*, volt_vector_t*);
 
 #ifdef __cplusplus
 }
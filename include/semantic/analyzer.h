@@ -1,8 +1,11 @@
 #ifndef VOLT_SEMANTIC_ANALYZER_H
 #define VOLT_SEMANTIC_ANALYZER_H
 
+#include <comptime/vm.h>
 #include <parser/parser.h>
+#include <semantic/generics.h>
 #include <util/memory/allocator.h>
+#include <util/types/small_vector.h>
 #include <util/types/vector.h>
 #include <volt/error.h>
 
@@ -49,6 +52,7 @@ typedef enum {
     VOLT_TYPE_REFERENCE,
     VOLT_TYPE_ARRAY,
     VOLT_TYPE_SLICE,
+    VOLT_TYPE_OPTIONAL,
     VOLT_TYPE_TUPLE,
     VOLT_TYPE_STRUCT,
     VOLT_TYPE_ENUM,
@@ -64,18 +68,33 @@ struct volt_type_info_t {
     const char*      name;
 
     // For composite types (filled progressively)
-    volt_type_info_t* base_type;      // For pointers, arrays, etc.
-    volt_vector_t     element_types;  // For tuples, function params (vector of volt_type_info_t*)
-    volt_type_info_t* return_type;    // For functions
+    volt_type_info_t*   base_type;      // For pointers, arrays, etc.
+    volt_small_vector_t element_types;  // Tuples, function params (vector of volt_type_info_t*)
+    volt_type_info_t*   return_type;    // For functions
+    size_t              array_length;   // For sized arrays (0 when unsized)
 
     // For structs/enums (filled when we analyze their declaration)
-    volt_vector_t fields;    // vector of volt_symbol_t* (struct fields)
-    volt_vector_t variants;  // vector of volt_symbol_t* (enum variants)
+    volt_ast_node_t*    declaration;  // struct_decl / enum_decl / error_decl
+    volt_small_vector_t fields;       // vector of volt_symbol_t* (struct and tuple fields)
+    volt_small_vector_t variants;     // vector of volt_symbol_t* (enum variants)
 
     // Size and alignment (computed after type is complete)
-    size_t size;
-    size_t alignment;
-    bool   size_computed;
+    size_t         size;
+    size_t         alignment;
+    volt_symbol_t* layout_member;       // Member being laid out, to name the cycle if there is one
+    bool           size_computed;
+    bool           layout_in_progress;  // Guards against types that contain themselves by value
+    bool           is_repr_c;           // `@repr("C")`: keep fields in declaration order
+
+    // Niche: bit patterns the type never uses, so an enclosing optional can encode `none` in
+    // them instead of adding a flag
+    size_t   niche_offset;  // Byte offset of the field that has them
+    size_t   niche_width;   // Width of that field in bytes (0 when there is no niche)
+    uint64_t niche_start;   // First unused value
+    uint64_t niche_count;   // Number of consecutive unused values
+
+    // Set on concrete types produced by generic instantiation
+    volt_instance_t* instance;
 
     // Flags
     bool is_const;
@@ -90,30 +109,56 @@ struct volt_symbol_t {
     volt_type_info_t*  type;         // Can be NULL initially, filled later
     volt_ast_node_t*   declaration;  // AST node where this was declared
     volt_scope_t*      scope;        // Scope where this symbol lives
+    volt_symbol_t*     overload;     // Next symbol of the same name in that scope
 
     // For functions
-    volt_vector_t parameters;  // vector of volt_symbol_t*
-    bool          is_comptime;
-    bool          is_async;
-    bool          is_extern;
+    volt_vector_t          parameters;  // vector of volt_symbol_t*
+    bool                   is_comptime;
+    bool                   is_async;
+    bool                   is_extern;
+    bool                   is_generic;
+    volt_bytecode_chunk_t* comptime_chunk;  // Compiled on first comptime call
 
     // For variables
     bool is_mutable;  // true for 'var', false for 'val'
     bool is_static;
 
+    // For struct fields and enum variants (byte offset of the field or payload)
+    size_t offset;
+
+    volt_ast_node_t* attributes;  // `@name(...)` preceding the declaration, if any
+
     // Source location
     size_t line;
     size_t column;
+    size_t file_index;  // Input file the declaration lives in
 
     // Resolution state
     bool is_resolved;  // true when type is fully resolved
+
+    // Reachability
+    volt_vector_t instances;     // Generic instances the declaration references
+    bool          is_reachable;  // Set by dead code elimination
+};
+
+// Index entry of a scope; the name's hash is kept so probes rarely need to read names
+typedef struct volt_scope_slot_t volt_scope_slot_t;
+struct volt_scope_slot_t {
+    uint64_t       hash;
+    volt_symbol_t* symbol;
 };
 
 // Scope (symbol table)
 struct volt_scope_t {
-    volt_scope_t* parent;    // Parent scope (NULL for global)
-    volt_vector_t symbols;   // vector of volt_symbol_t*
-    volt_vector_t children;  // vector of volt_scope_t* (child scopes)
+    volt_scope_t*       parent;    // Parent scope (NULL for global)
+    volt_small_vector_t symbols;   // vector of volt_symbol_t*
+    volt_small_vector_t children;  // vector of volt_scope_t* (child scopes)
+
+    // Open-addressed by name, holding the first symbol of each name (the rest follow through
+    // `overload`); capacity is a power of two
+    volt_scope_slot_t* index;
+    size_t             index_capacity;
+    size_t             index_count;
 
     // Scope type (for break/continue validation)
     enum {
@@ -165,9 +210,56 @@ struct volt_semantic_analyzer_t {
     volt_type_info_t* type_type;
     volt_type_info_t* type_unknown;
 
+    // Interned derived types (pointers, arrays, optionals, tuples, error unions)
+    volt_vector_t derived_types;  // vector of volt_type_info_t*
+    volt_vector_t type_names;     // Owned names of derived and instantiated types
+
+    // Generic instantiation
+    volt_instance_cache_t          instances;
+    volt_instance_t*               current_instance;  // Instance whose body is being analyzed
+    volt_symbol_t*                 current_owner;     // Non-generic declaration being walked
+    const volt_comptime_binding_t* generic_bindings;  // Its parameter bindings
+    size_t                         generic_binding_count;
+
+    // Print calls expanded from their literal format strings (vector of volt_format_t*)
+    volt_vector_t formats;
+
+    // Async functions lowered to state machines (vector of volt_coroutine_t*)
+    volt_vector_t coroutines;
+
+    // Lowering plans for `for` loops (vector of volt_loop_t*)
+    volt_vector_t loops;
+
+    // Lowering plans for `match` statements (vector of volt_match_t*)
+    volt_vector_t matches;
+
+    // Closures and whether their environment escapes (vector of volt_closure_t*)
+    volt_vector_t closures;
+
+    // Error union return conventions and cold error paths (vector of volt_fallible_t*)
+    volt_vector_t fallibles;
+
+    // Traits with their implementations and vtables (vector of volt_trait_t*)
+    volt_vector_t traits;
+
+    // Trait method calls, direct or through a vtable (vector of volt_dispatch_t*)
+    volt_vector_t dispatches;
+
     // Unresolved symbols (for forward references)
     volt_vector_t unresolved_symbols;  // vector of volt_symbol_t*
 
+    // Compile-time evaluation
+    volt_comptime_t comptime;
+
+    // Every symbol and type created, freed with the analyzer
+    volt_vector_t owned_symbols;  // vector of volt_symbol_t*
+    volt_vector_t owned_types;    // vector of volt_type_info_t*
+
+    // When set, only declarations it accepts have their function bodies analyzed; the others
+    // are declared but get no body results. The language server rechecks edits this way.
+    bool (*checks)(void* context, volt_ast_node_t* declaration);
+    void* checks_context;
+
     // Analysis state
     bool   had_error;
     size_t error_count;
@@ -184,19 +276,36 @@ volt_status_code_t volt_semantic_analyzer_init(volt_semantic_analyzer_t* analyze
 // Run semantic analysis on the AST (multi-pass)
 volt_status_code_t volt_semantic_analyzer_analyze(volt_semantic_analyzer_t* analyzer);
 
-// Cleanup
+// Cleanup; does nothing for an analyzer that was never initialized
 volt_status_code_t volt_semantic_analyzer_deinit(volt_semantic_analyzer_t* analyzer);
 
+// Report an error located at the first token of `node`
+void volt_semantic_error(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* node,
+                         const char* message);
+
+// Whether the body of the top-level `declaration` is analyzed in this run
+bool volt_semantic_checks(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* declaration);
+
 // Symbol table operations
 volt_scope_t*  volt_scope_create(volt_semantic_analyzer_t* analyzer, volt_scope_t* parent);
 volt_symbol_t* volt_scope_lookup(volt_scope_t* scope, const char* name, bool recursive);
+// Resolves an overloaded function by name and arity, preferring definitions with a body
+volt_symbol_t* volt_scope_lookup_function(volt_scope_t* scope, const char* name, size_t argc);
 volt_symbol_t* volt_scope_insert(volt_semantic_analyzer_t* analyzer, volt_scope_t* scope,
                                  volt_symbol_t* symbol);
+volt_symbol_t* volt_symbol_create(volt_semantic_analyzer_t* analyzer, volt_symbol_kind_t kind);
 
 // Type operations
 volt_type_info_t* volt_type_create(volt_semantic_analyzer_t* analyzer, volt_type_kind_t kind);
 volt_type_info_t* volt_type_from_ast(volt_semantic_analyzer_t* analyzer,
                                      volt_ast_node_t*          type_node);
+// Interns `base` wrapped in a pointer, reference, optional, array, slice or error union
+volt_type_info_t* volt_type_derive(volt_semantic_analyzer_t* analyzer, volt_type_kind_t kind,
+                                   volt_type_info_t* base, size_t array_length);
+volt_type_info_t* volt_type_tuple(volt_semantic_analyzer_t* analyzer, volt_type_info_t** elements,
+                                  size_t count);
+// Copies `name` into storage owned by the analyzer
+const char*       volt_type_own_name(volt_semantic_analyzer_t* analyzer, const char* name);
 bool              volt_type_equals(volt_type_info_t* a, volt_type_info_t* b);
 bool              volt_type_is_numeric(volt_type_info_t* type);
 bool              volt_type_is_integer(volt_type_info_t* type);
@@ -0,0 +1,57 @@
+#ifndef __VOLT_COROUTINE_H__
+#define __VOLT_COROUTINE_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A parameter or local of an async function. Positions count identifiers and suspension points
+// in program order; a use inside a loop the local was declared outside of lasts until the end of
+// that loop, since the next iteration reads it again.
+typedef struct volt_coroutine_local_t volt_coroutine_local_t;
+struct volt_coroutine_local_t {
+    const char*       name;
+    volt_type_info_t* type;
+    volt_ast_node_t*  declaration;  // param, var_decl, val_decl or for_binding
+    size_t            declared;
+    size_t            last_use;
+    size_t            loop;      // Depth of the loop its live range extends to the end of, or 0
+    bool              in_scope;  // While walking the body
+    volt_symbol_t*    slot;      // Frame field holding it, NULL when it never crosses a suspend
+};
+
+typedef struct volt_coroutine_suspend_t volt_coroutine_suspend_t;
+struct volt_coroutine_suspend_t {
+    volt_ast_node_t* node;      // suspend_stmt
+    size_t           position;  // Resuming after the i-th suspend enters state i + 1
+};
+
+// Stackless lowering of one async function: the body becomes a state machine switching on
+// `.state` (0 is the entry, each suspend adds one), and only locals live across a suspend are
+// kept in the frame. Locals whose live ranges never cross the same suspend share a slot.
+typedef struct volt_coroutine_t volt_coroutine_t;
+struct volt_coroutine_t {
+    volt_symbol_t*    function;
+    volt_type_info_t* frame;          // `.state`, `.result` and the shared slots, laid out
+    volt_vector_t     suspends;       // vector of volt_coroutine_suspend_t*
+    volt_vector_t     locals;         // vector of volt_coroutine_local_t*, parameters first
+    size_t            spilled;        // Locals that need a slot
+    size_t            unshared_size;  // Frame size with one slot per local, for comparison
+};
+
+// Lowers every non-generic async function into `analyzer->coroutines`. Frames have a fixed
+// size and alignment, so callers allocate them through any `t_allocator` (`malloc<frame>`).
+volt_status_code_t volt_coroutine_lower_all(volt_semantic_analyzer_t*);
+
+void volt_coroutine_destroy(volt_semantic_analyzer_t*, volt_coroutine_t*);
+
+// Frame layout and per-state live locals (`--print-coroutines`)
+void volt_coroutine_print(volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_COROUTINE_H__
@@ -0,0 +1,30 @@
+#ifndef __VOLT_DCE_H__
+#define __VOLT_DCE_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct volt_dce_stats_t volt_dce_stats_t;
+struct volt_dce_stats_t {
+    size_t functions;  // Non-generic functions, attached ones and trait methods included
+    size_t functions_dropped;
+    size_t instances;  // Generic instances of functions and types
+    size_t instances_dropped;
+};
+
+// Marks every symbol, attach-block method and instance reachable from `main`, export declarations
+// and extern declarations (`is_reachable`). Whatever is left unmarked must not be handed to
+// codegen. Runs after devirtualization, whose bindings it follows.
+volt_status_code_t volt_dce_run(volt_semantic_analyzer_t*, volt_dce_stats_t*);
+
+// Lists what was dropped (`--print-dce`)
+void volt_dce_print(volt_semantic_analyzer_t*, const volt_dce_stats_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_DCE_H__
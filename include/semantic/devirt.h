@@ -0,0 +1,68 @@
+#ifndef __VOLT_DEVIRT_H__
+#define __VOLT_DEVIRT_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A trait, the types attached to it and the vtable its trait objects use. Only methods that are
+// actually called through a trait object get a slot: the vtable is just those function pointers,
+// with no size, alignment or type header, and a trait object is the (data, vtable) pair.
+typedef struct volt_trait_t volt_trait_t;
+struct volt_trait_t {
+    const char*      name;
+    volt_ast_node_t* declaration;  // trait_decl
+    size_t           file_index;
+    volt_vector_t    methods;  // Method names in declaration order (const char*)
+    volt_vector_t    impls;    // vector of volt_trait_impl_t*
+    volt_vector_t    slots;    // Owned "method<args>" per method called dynamically
+};
+
+// `attach trait -> type { ... }`
+typedef struct volt_trait_impl_t volt_trait_impl_t;
+struct volt_trait_impl_t {
+    volt_trait_t*    trait;
+    const char*      type;         // Name of the implementing type
+    volt_ast_node_t* declaration;  // attach_decl
+    size_t           file_index;
+    volt_vector_t    methods;  // One function symbol per method, declared by its func_def
+};
+
+typedef enum {
+    VOLT_DISPATCH_DIRECT,      // Receiver type known after monomorphization: direct call
+    VOLT_DISPATCH_VIRTUAL,     // Receiver is a trait object: indirect call through a vtable slot
+    VOLT_DISPATCH_UNRESOLVED,  // Receiver type not known to the analyzer (e.g. namespaced)
+} volt_dispatch_kind_t;
+
+// One `receiver.method(...)` call of a trait method, per function or instance it appears in
+typedef struct volt_dispatch_t volt_dispatch_t;
+struct volt_dispatch_t {
+    volt_dispatch_kind_t kind;
+    volt_ast_node_t*     node;    // postfix_expr
+    const char*          caller;  // Function or instance name
+    const char*          owner;   // Implementing type when the caller is an attached method
+    size_t               file_index;
+    const char*          method;
+    volt_trait_t*        trait;
+    volt_trait_impl_t*   impl;    // VOLT_DISPATCH_DIRECT: implementation called
+    volt_symbol_t*       target;  // VOLT_DISPATCH_DIRECT: its method
+    size_t               slot;    // VOLT_DISPATCH_VIRTUAL: index into trait->slots
+};
+
+// Collects traits and their implementations into `analyzer->traits`, then binds every trait
+// method call in functions, attached methods and function instances into `analyzer->dispatches`
+volt_status_code_t volt_devirt_resolve_all(volt_semantic_analyzer_t*);
+
+void volt_devirt_destroy_trait(volt_semantic_analyzer_t*, volt_trait_t*);
+void volt_devirt_destroy_dispatch(volt_semantic_analyzer_t*, volt_dispatch_t*);
+
+// One line per call, then the vtables and the devirtualized / dynamic counts (`--print-devirt`)
+void volt_devirt_print(volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_DEVIRT_H__
@@ -0,0 +1,48 @@
+#ifndef __VOLT_ESCAPE_H__
+#define __VOLT_ESCAPE_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    VOLT_ESCAPE_NONE,      // Only called or discarded: the environment lives in the defining frame
+    VOLT_ESCAPE_RETURNED,  // Returned from the defining function
+    VOLT_ESCAPE_PASSED,    // Passed as an argument; the callee may keep it
+    VOLT_ESCAPE_STORED,    // Assigned, aliased, put in an aggregate or used as a value otherwise
+    VOLT_ESCAPE_CAPTURED,  // Captured by another closure that escapes
+} volt_escape_reason_t;
+
+// `|a, b*| (params) { ... }`
+typedef struct volt_closure_t volt_closure_t;
+struct volt_closure_t {
+    volt_ast_node_t*     node;  // closure
+    volt_symbol_t*       function;
+    const char*          binding;  // `val name = |...|`, NULL when not bound to a local
+    volt_escape_reason_t reason;
+    volt_ast_node_t*     escape;  // Where it escapes, when it does
+
+    // While the environment is on the stack the callee is known at every call, so these are
+    // direct calls codegen can inline
+    size_t direct_calls;
+
+    size_t captures;
+    size_t by_reference;  // `name*`: dangling once an escaping closure outlives the frame
+};
+
+// Finds every closure in every function into `analyzer->closures`. Escaping closures get their
+// environment from the allocator; the rest keep it on the stack.
+volt_status_code_t volt_escape_analyze_all(volt_semantic_analyzer_t*);
+
+void volt_escape_destroy(volt_semantic_analyzer_t*, volt_closure_t*);
+
+// One line per closure (`--print-escapes`)
+void volt_escape_print(volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_ESCAPE_H__
@@ -0,0 +1,58 @@
+#ifndef __VOLT_FALLIBLE_H__
+#define __VOLT_FALLIBLE_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Branch weights for the error test after a fallible call: errors are assumed rare, so the
+// success path falls through and the error path is laid out after the function body
+#define VOLT_FALLIBLE_HOT_WEIGHT  2000u
+#define VOLT_FALLIBLE_COLD_WEIGHT 1u
+
+// How a function returning `error!T` hands back its result. The error union is never
+// materialized in memory: the 16-bit error code comes back in its own register (0 = success).
+typedef enum {
+    VOLT_FALLIBLE_CODE_ONLY,    // `error!void`: the code is the whole result
+    VOLT_FALLIBLE_REGISTERS,    // Payload in the first return register, code in the second
+    VOLT_FALLIBLE_OUT_PAYLOAD,  // Payload written through a hidden pointer, code returned
+} volt_fallible_convention_t;
+
+typedef enum {
+    VOLT_FALLIBLE_TRY,    // `try f()`: branches to the function's shared cold exit on error
+    VOLT_FALLIBLE_CATCH,  // `f() catch |e| { ... }`: the handler block is cold
+} volt_fallible_site_kind_t;
+
+typedef struct volt_fallible_site_t volt_fallible_site_t;
+struct volt_fallible_site_t {
+    volt_fallible_site_kind_t kind;
+    volt_ast_node_t*          node;
+    volt_ast_node_t*          handler;  // VOLT_FALLIBLE_CATCH: the block
+    const char*               binding;  // VOLT_FALLIBLE_CATCH: `|e|`, NULL when absent
+};
+
+// A function that returns an error union, handles errors, or both
+typedef struct volt_fallible_t volt_fallible_t;
+struct volt_fallible_t {
+    volt_symbol_t*             function;
+    volt_type_info_t*          result;  // The error union returned, NULL when none
+    volt_fallible_convention_t convention;
+    volt_vector_t              sites;  // vector of volt_fallible_site_t*, in source order
+    size_t                     propagations;  // `try` sites sharing the single cold exit
+};
+
+// Plans the return convention and cold paths of every function into `analyzer->fallibles`
+volt_status_code_t volt_fallible_lower_all(volt_semantic_analyzer_t*);
+
+void volt_fallible_destroy(volt_semantic_analyzer_t*, volt_fallible_t*);
+
+// One line per function, then one per site (`--print-fallible`)
+void volt_fallible_print(volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_FALLIBLE_H__
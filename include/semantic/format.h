@@ -0,0 +1,53 @@
+#ifndef __VOLT_FORMAT_H__
+#define __VOLT_FORMAT_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The typed writer call a piece of output becomes
+typedef enum {
+    VOLT_FORMAT_WRITE_TEXT,     // Literal bytes known at compile time
+    VOLT_FORMAT_WRITE_INT,      // Signed integer, digits generated inline
+    VOLT_FORMAT_WRITE_UINT,     // Unsigned integer, digits generated inline
+    VOLT_FORMAT_WRITE_FLOAT,
+    VOLT_FORMAT_WRITE_BOOL,
+    VOLT_FORMAT_WRITE_STR,
+    VOLT_FORMAT_WRITE_VALUE,    // Writer chosen from the argument's type once it is inferred
+} volt_format_write_t;
+
+typedef struct volt_format_piece_t volt_format_piece_t;
+struct volt_format_piece_t {
+    volt_format_write_t write;
+    char*               text;  // VOLT_FORMAT_WRITE_TEXT: owned, `{{` and `}}` unescaped
+    size_t              length;
+    volt_ast_node_t*    argument;  // Other writes: the argument printed
+};
+
+// `std::io::print(ln)("literal {} ...", args...)` expanded into one writer call per piece: no
+// format string is parsed and no varargs are passed at runtime. Arguments known at compile time
+// are rendered into the surrounding text.
+typedef struct volt_format_t volt_format_t;
+struct volt_format_t {
+    volt_ast_node_t* node;  // The call's postfix_expr
+    volt_symbol_t*   function;
+    bool             newline;  // `println`
+    volt_vector_t    pieces;   // vector of volt_format_piece_t*, adjacent text merged
+};
+
+// Expands every print call with a literal format into `analyzer->formats`. Placeholder and
+// argument counts that disagree, and malformed placeholders, are reported as semantic errors.
+volt_status_code_t volt_format_expand_all(volt_semantic_analyzer_t*);
+
+void volt_format_destroy(volt_semantic_analyzer_t*, volt_format_t*);
+
+// One line per print call (`--print-formats`)
+void volt_format_print(volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_FORMAT_H__
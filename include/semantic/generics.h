@@ -0,0 +1,80 @@
+#ifndef __VOLT_GENERICS_H__
+#define __VOLT_GENERICS_H__
+
+#include <comptime/vm.h>
+#include <parser/parser.h>
+#include <util/memory/allocator.h>
+#include <util/types/vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct volt_semantic_analyzer_t;
+struct volt_symbol_t;
+struct volt_type_info_t;
+
+// Instantiations nested deeper than this are assumed to recurse without bound
+#define VOLT_GENERIC_MAX_DEPTH 64u
+
+// One monomorphized copy of a generic declaration. Arguments are canonical: type arguments are
+// interned type pointers and defaulted parameters are filled in, so every `box<i32>` shares an
+// instance whose name spells the defaults out.
+typedef struct volt_instance_t volt_instance_t;
+struct volt_instance_t {
+    struct volt_symbol_t*    generic;   // Generic declaration being instantiated
+    volt_comptime_binding_t* bindings;  // Generic parameter name -> canonical argument
+    size_t                   arg_count;
+    uint64_t                 hash;
+    const char*              name;  // Canonical name, e.g. "box<i32, 0>"
+    struct volt_type_info_t* type;  // Concrete type for struct/enum/error instances
+
+    volt_ast_node_t* first_use;     // For diagnostics
+    size_t           file_index;    // File of the first use
+    size_t           depth;         // Length of the instantiation chain that produced it
+    size_t           uses;
+    volt_vector_t    instances;     // Instances its body references (vector of volt_instance_t*)
+    bool             analyzed;
+    bool             is_reachable;  // Set by dead code elimination
+};
+
+// Instances keyed by (declaration, canonical arguments), shared by every input file
+typedef struct volt_instance_cache_t volt_instance_cache_t;
+struct volt_instance_cache_t {
+    volt_instance_t** slots;  // Open addressing, NULL marks an empty slot
+    size_t            capacity;
+    volt_vector_t     instances;  // Creation order; doubles as the analysis worklist
+
+    // Statistics
+    size_t requests;
+    size_t hits;
+    size_t bytes;  // Memory held by instances
+
+    volt_allocator_t* allocator;
+};
+
+volt_status_code_t volt_instance_cache_init(volt_instance_cache_t*, volt_allocator_t*);
+volt_status_code_t volt_instance_cache_deinit(volt_instance_cache_t*);
+
+// Resolves the arguments at an instantiation site (`generic_args`, may be NULL when every
+// parameter has a default) and returns the shared instance, creating it on first use
+volt_instance_t* volt_generic_instantiate(struct volt_semantic_analyzer_t*, struct volt_symbol_t*,
+                                          volt_ast_node_t* generic_args, volt_ast_node_t* site);
+
+// Records the instantiation sites in one file's items that do not declare a symbol
+volt_status_code_t volt_generic_collect(struct volt_semantic_analyzer_t*, volt_ast_node_t* root);
+
+// Records the instantiation sites in a non-generic declaration, attributing them to `symbol`
+volt_status_code_t volt_generic_collect_symbol(struct volt_semantic_analyzer_t*,
+                                               struct volt_symbol_t*);
+
+// Analyzes queued instances until no new ones appear
+volt_status_code_t volt_generic_analyze_instances(struct volt_semantic_analyzer_t*);
+
+void volt_generic_log_stats(struct volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_GENERICS_H__
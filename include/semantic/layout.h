@@ -0,0 +1,45 @@
+#ifndef __VOLT_LAYOUT_H__
+#define __VOLT_LAYOUT_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Layouts target 64-bit platforms
+#define VOLT_LAYOUT_POINTER_SIZE 8u
+
+// Fills `size`, `alignment` and member offsets for `type` and every type it contains by value.
+// Struct and tuple members are ordered by decreasing alignment unless the type is
+// `@repr("C")`. Optionals of types with a niche (references, bools, enums with spare
+// discriminants, ...) take no space beyond their payload; `error!T` uses error code 0 for
+// success instead of a flag.
+volt_status_code_t volt_layout_compute(volt_semantic_analyzer_t*, volt_type_info_t*);
+
+// Lays out every named type, generic instance and derived type known to the analyzer
+volt_status_code_t volt_layout_compute_all(volt_semantic_analyzer_t*);
+
+// Padding bytes inside `type` that hold no data
+size_t volt_layout_wasted(volt_type_info_t*);
+
+// The single compare that decides an optional or error union: the `width`-byte integer at
+// `offset` equals `value` exactly when an optional is `none` or an error union holds a value
+typedef struct volt_layout_test_t volt_layout_test_t;
+struct volt_layout_test_t {
+    size_t   offset;
+    size_t   width;
+    uint64_t value;
+    bool     uses_niche;  // Encoded in the payload's unused values, no extra storage
+};
+
+bool volt_layout_test(volt_type_info_t*, volt_layout_test_t*);
+
+// Size, alignment and wasted bytes per type (`--print-layouts`)
+void volt_layout_print(volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_LAYOUT_H__
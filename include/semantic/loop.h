@@ -0,0 +1,63 @@
+#ifndef __VOLT_LOOP_H__
+#define __VOLT_LOOP_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    VOLT_LOOP_RANGE,    // Counted loop over `start..end`; the range is never materialized
+    VOLT_LOOP_INDEXED,  // Counted loop over an array or slice's length, one load per iteration
+} volt_loop_kind_t;
+
+// `[ var result: T ]`
+typedef struct volt_loop_capture_t volt_loop_capture_t;
+struct volt_loop_capture_t {
+    const char*      name;
+    volt_ast_node_t* node;
+    volt_ast_node_t* escape;       // `&name` or a closure capturing it by reference, if any
+    bool             in_register;  // Nothing takes its address, so it needs no stack slot
+};
+
+// How a `for` loop is lowered: always a plain counter from 0 to the trip count, with the
+// bindings computed from the counter and the `| expr |` transform substituted for the value
+// binding at the top of the body instead of being called per iteration.
+typedef struct volt_loop_t volt_loop_t;
+struct volt_loop_t {
+    volt_ast_node_t* node;  // for_stmt
+    volt_symbol_t*   function;
+    volt_loop_kind_t kind;
+
+    // VOLT_LOOP_RANGE
+    volt_ast_node_t* start;
+    volt_ast_node_t* end;
+    bool             inclusive;   // `..=`
+    volt_ast_node_t* source;      // `val name = a..b;` iterated through `name`, if any
+    bool             constant;    // Bounds known at compile time
+    uint64_t         trip_count;  // When constant
+
+    // VOLT_LOOP_INDEXED
+    volt_ast_node_t* iterable;
+
+    const char*      value;         // First binding: the element, or `start + counter`
+    const char*      index;         // Second binding: the counter, NULL when absent
+    volt_ast_node_t* transform;     // `| expr |`, NULL when absent
+    volt_vector_t    captures;      // vector of volt_loop_capture_t*
+    bool             vectorizable;  // No calls, exits or suspends in the transform and body
+};
+
+// Plans every `for` loop in every function into `analyzer->loops`
+volt_status_code_t volt_loop_lower_all(volt_semantic_analyzer_t*);
+
+void volt_loop_destroy(volt_semantic_analyzer_t*, volt_loop_t*);
+
+// One line per loop (`--print-loops`)
+void volt_loop_print(volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_LOOP_H__
@@ -0,0 +1,65 @@
+#ifndef __VOLT_MATCH_H__
+#define __VOLT_MATCH_H__
+
+#include <semantic/analyzer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Smallest run of cases worth a jump table, and the share of table slots that must be real cases
+#define VOLT_MATCH_MIN_TABLE_CASES 4u
+#define VOLT_MATCH_MIN_DENSITY     0.4
+
+typedef enum {
+    VOLT_MATCH_FOLDED,         // The scrutinee is known at compile time; only one arm remains
+    VOLT_MATCH_COMPARES,       // Few cases, or patterns only known at runtime: tested in order
+    VOLT_MATCH_JUMP_TABLE,     // One dense range of cases
+    VOLT_MATCH_DECISION_TREE,  // Binary search over clusters, dense clusters use a table
+} volt_match_strategy_t;
+
+typedef struct volt_match_case_t volt_match_case_t;
+struct volt_match_case_t {
+    int64_t          value;  // Integer pattern or enum discriminant
+    volt_ast_node_t* arm;
+};
+
+// Consecutive cases (in value order) handled together
+typedef struct volt_match_cluster_t volt_match_cluster_t;
+struct volt_match_cluster_t {
+    size_t first;  // Index into `cases`
+    size_t count;
+    bool   is_table;
+};
+
+typedef struct volt_match_t volt_match_t;
+struct volt_match_t {
+    volt_ast_node_t*      node;  // match_stmt
+    volt_symbol_t*        function;
+    volt_match_strategy_t strategy;
+
+    volt_match_case_t*    cases;  // Sorted by value, duplicates removed
+    size_t                case_count;
+    volt_match_cluster_t* clusters;
+    size_t                cluster_count;
+    size_t                tree_depth;  // VOLT_MATCH_DECISION_TREE
+
+    volt_ast_node_t* default_arm;
+    volt_ast_node_t* folded_arm;  // VOLT_MATCH_FOLDED, NULL when no arm matches
+    size_t           arm_count;
+    size_t           dropped;  // Arms that can never run: duplicates, after `default`, false guards
+};
+
+// Chooses a strategy for every `match` in every function into `analyzer->matches`
+volt_status_code_t volt_match_lower_all(volt_semantic_analyzer_t*);
+
+void volt_match_destroy(volt_semantic_analyzer_t*, volt_match_t*);
+
+// One line per match (`--print-matches`)
+void volt_match_print(volt_semantic_analyzer_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_MATCH_H__
@@ -0,0 +1,57 @@
+#ifndef __VOLT_JSON_H__
+#define __VOLT_JSON_H__
+
+#include <util/memory/arena.h>
+#include <util/types/types.h>
+#include <util/types/value_vector.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum volt_json_kind_t volt_json_kind_t;
+enum volt_json_kind_t {
+    VOLT_JSON_NULL,
+    VOLT_JSON_BOOL,
+    VOLT_JSON_NUMBER,
+    VOLT_JSON_STRING,
+    VOLT_JSON_ARRAY,
+    VOLT_JSON_OBJECT,
+};
+
+// A parsed value. Everything lives in the arena it was parsed into and goes with it; elements
+// and members are linked through `next` in document order.
+typedef struct volt_json_t volt_json_t;
+struct volt_json_t {
+    volt_json_kind_t kind;
+    const char*      key;     // Member name, inside an object
+    const char*      string;  // Unescaped, NUL-terminated
+    size_t           length;  // Bytes in `string`, which may itself hold NULs
+    double           number;
+    bool             boolean;
+    volt_json_t*     first;  // First element or member
+    volt_json_t*     next;
+};
+
+// NULL unless `text` is exactly one well-formed value, surrounded by whitespace at most.
+// `text[length]` must be a NUL, which bounds number parsing.
+volt_json_t* volt_json_parse(volt_arena_t*, const char* text, size_t length);
+
+// Lookups take NULL or a value of the wrong kind and give NULL or the fallback back
+volt_json_t* volt_json_get(volt_json_t*, const char* key);
+const char*  volt_json_string(volt_json_t*);
+int64_t      volt_json_int(volt_json_t*, int64_t fallback);
+
+// Output is appended to a char vector, without a terminating NUL
+VOLT_VECTOR_DEFINE(json_text, char)
+
+void volt_json_write_raw(volt_json_text_vector_t*, const char*);
+void volt_json_write_string(volt_json_text_vector_t*, const char*, size_t);
+void volt_json_write_int(volt_json_text_vector_t*, int64_t);
+void volt_json_write_value(volt_json_text_vector_t*, volt_json_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_JSON_H__
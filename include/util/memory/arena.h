@@ -0,0 +1,53 @@
+#ifndef __VOLT_ARENA_H__
+#define __VOLT_ARENA_H__
+
+#include <stddef.h>
+#include <util/types/types.h>
+
+#include "util/memory/allocator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bytes per chunk unless a single allocation needs more
+#define VOLT_ARENA_CHUNK_SIZE (64u * 1024u)
+
+// Every allocation is rounded up to this; enough for anything built from pointers and sizes
+#define VOLT_ARENA_ALIGN sizeof(void*)
+
+typedef struct volt_arena_chunk_t volt_arena_chunk_t;
+struct volt_arena_chunk_t {
+    volt_arena_chunk_t* next;
+    size_t              capacity;
+    size_t              used;
+    unsigned char       data[];
+};
+
+// Stack-like bump allocator. There is no per-allocation free: take a mark, allocate, and either
+// keep everything or release back to the mark, which is O(1) however much was allocated.
+// Chunks above the mark are kept and reused by the next allocations; deinit frees them all.
+typedef struct volt_arena_t volt_arena_t;
+struct volt_arena_t {
+    volt_arena_chunk_t* head;
+    volt_arena_chunk_t* current;  // NULL until the first allocation or after releasing to it
+    volt_allocator_t*   allocator;
+};
+
+typedef struct volt_arena_mark_t volt_arena_mark_t;
+struct volt_arena_mark_t {
+    volt_arena_chunk_t* chunk;
+    size_t              used;
+};
+
+volt_status_code_t volt_arena_init(volt_arena_t*, volt_allocator_t*);
+volt_status_code_t volt_arena_deinit(volt_arena_t*);
+void*              volt_arena_alloc(volt_arena_t*, size_t);
+volt_arena_mark_t  volt_arena_mark(volt_arena_t*);
+void               volt_arena_release(volt_arena_t*, volt_arena_mark_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_ARENA_H__
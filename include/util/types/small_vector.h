@@ -0,0 +1,51 @@
+#ifndef __VOLT_SMALL_VECTOR_H__
+#define __VOLT_SMALL_VECTOR_H__
+
+#include <util/types/types.h>
+
+#include "util/memory/allocator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Slots kept inside the vector itself. Most AST nodes have at most two children and most
+// scopes and type lists are short, so those never touch the allocator.
+#define VOLT_SMALL_VECTOR_INLINE 2u
+
+// volt_vector_t with inline storage: nothing is allocated until the inline slots overflow, so an
+// empty vector costs nothing to create or destroy. The inline slots share space with the heap
+// pointer and are found through `capacity`, never through a pointer into the vector, so it is
+// safe to copy by value like volt_vector_t.
+typedef struct volt_small_vector_t volt_small_vector_t;
+struct volt_small_vector_t {
+    union {
+        void** heap;                             // capacity > VOLT_SMALL_VECTOR_INLINE
+        void*  items[VOLT_SMALL_VECTOR_INLINE];  // Otherwise
+    };
+    size_t            size;
+    size_t            capacity;
+    volt_allocator_t* allocator;
+    volt_allocator_t* item_allocator;
+};
+
+volt_small_vector_t volt_small_vector_default(void);
+volt_status_code_t  volt_small_vector_init(volt_small_vector_t*);
+volt_status_code_t  volt_small_vector_deinit(volt_small_vector_t*);
+volt_status_code_t  volt_small_vector_push_back(volt_small_vector_t*, void*);
+volt_status_code_t  volt_small_vector_pop_back(volt_small_vector_t*);
+volt_status_code_t  volt_small_vector_insert(volt_small_vector_t*, size_t, void*);
+volt_status_code_t  volt_small_vector_remove(volt_small_vector_t*, size_t);
+volt_status_code_t  volt_small_vector_ensure(volt_small_vector_t*, size_t);
+void*               volt_small_vector_get(volt_small_vector_t*, size_t);
+void*               volt_small_vector_get_back(volt_small_vector_t*);
+
+static inline void** volt_small_vector_data(volt_small_vector_t* v) {
+    return v->capacity > VOLT_SMALL_VECTOR_INLINE ? v->heap : v->items;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_SMALL_VECTOR_H__
@@ -0,0 +1,122 @@
+#ifndef __VOLT_VALUE_VECTOR_H__
+#define __VOLT_VALUE_VECTOR_H__
+
+#include <string.h>
+#include <util/types/types.h>
+
+#include "util/memory/allocator.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// VOLT_VECTOR_DEFINE(name, T) generates `volt_<name>_vector_t`, a growable array that stores T
+// by value. Unlike volt_vector_t there is no separate allocation per element and no pointer hop
+// on access. Pointers into it (get/back) stay valid until the next call that grows it.
+//
+// An empty vector owns no memory: zero it, set `allocator` (NULL picks the default) and call
+// init, which never allocates. Elements are plain bytes to the vector; whatever they own is
+// released by the owner before deinit.
+//
+//   volt_<name>_vector_init(v)                      Empties without allocating
+//   volt_<name>_vector_deinit(v)                    Frees the buffer
+//   volt_<name>_vector_reserve(v, capacity)         Grows to hold at least `capacity` elements
+//   volt_<name>_vector_push_back(v, item)           Appends a copy of `item`
+//   volt_<name>_vector_append_range(v, items, n)    Appends `n` elements in one copy
+//   volt_<name>_vector_get(v, index)                Element pointer, NULL when out of range
+//   volt_<name>_vector_back(v)                      Last element, NULL when empty
+//   volt_<name>_vector_clear(v)                     Drops the elements, keeps the buffer
+//   volt_<name>_vector_steal(v, &size)              Hands the buffer to the caller, who frees it
+//                                                   with the vector's allocator; v ends empty
+#define VOLT_VECTOR_DEFINE(name, T)                                                               \
+    typedef struct volt_##name##_vector_t volt_##name##_vector_t;                                 \
+    struct volt_##name##_vector_t {                                                               \
+        T*                data;                                                                   \
+        size_t            size;                                                                   \
+        size_t            capacity;                                                               \
+        volt_allocator_t* allocator;                                                              \
+    };                                                                                            \
+                                                                                                  \
+    static inline volt_status_code_t volt_##name##_vector_init(volt_##name##_vector_t* v) {       \
+        if (!v)                                                                                   \
+            return VOLT_FAILURE;                                                                  \
+        v->data      = NULL;                                                                      \
+        v->size      = 0;                                                                         \
+        v->capacity  = 0;                                                                         \
+        v->allocator = v->allocator ? v->allocator : &volt_default_allocator;                     \
+        return VOLT_SUCCESS;                                                                      \
+    }                                                                                             \
+                                                                                                  \
+    static inline volt_status_code_t volt_##name##_vector_deinit(volt_##name##_vector_t* v) {     \
+        if (!v || !v->allocator)                                                                  \
+            return VOLT_FAILURE;                                                                  \
+        if (v->data)                                                                              \
+            v->allocator->free(v->data);                                                          \
+        v->data = NULL;                                                                           \
+        v->size = v->capacity = 0;                                                                \
+        return VOLT_SUCCESS;                                                                      \
+    }                                                                                             \
+                                                                                                  \
+    static inline volt_status_code_t volt_##name##_vector_reserve(volt_##name##_vector_t* v,      \
+                                                                  size_t capacity) {              \
+        if (!v || !v->allocator)                                                                  \
+            return VOLT_FAILURE;                                                                  \
+        if (capacity <= v->capacity)                                                              \
+            return VOLT_SUCCESS;                                                                  \
+                                                                                                  \
+        size_t new_cap = v->capacity ? v->capacity : 8;                                           \
+        while (new_cap < capacity)                                                                \
+            new_cap *= 2;                                                                         \
+                                                                                                  \
+        T* new_data = v->data ? v->allocator->realloc(v->data, new_cap * sizeof(T))               \
+                              : v->allocator->malloc(new_cap * sizeof(T));                        \
+        if (!new_data)                                                                            \
+            return VOLT_FAILURE;                                                                  \
+                                                                                                  \
+        v->data     = new_data;                                                                   \
+        v->capacity = new_cap;                                                                    \
+        return VOLT_SUCCESS;                                                                      \
+    }                                                                                             \
+                                                                                                  \
+    static inline volt_status_code_t volt_##name##_vector_append_range(                           \
+        volt_##name##_vector_t* v, T const* items, size_t count) {                                \
+        if (!v || volt_##name##_vector_reserve(v, v->size + count) != VOLT_SUCCESS)               \
+            return VOLT_FAILURE;                                                                  \
+        if (count > 0)                                                                            \
+            memcpy(v->data + v->size, items, count * sizeof(T));                                  \
+        v->size += count;                                                                         \
+        return VOLT_SUCCESS;                                                                      \
+    }                                                                                             \
+                                                                                                  \
+    static inline volt_status_code_t volt_##name##_vector_push_back(volt_##name##_vector_t* v,    \
+                                                                    T item) {                     \
+        return volt_##name##_vector_append_range(v, &item, 1);                                    \
+    }                                                                                             \
+                                                                                                  \
+    static inline T* volt_##name##_vector_get(volt_##name##_vector_t* v, size_t index) {          \
+        return v && index < v->size ? &v->data[index] : NULL;                                     \
+    }                                                                                             \
+                                                                                                  \
+    static inline T* volt_##name##_vector_back(volt_##name##_vector_t* v) {                       \
+        return v && v->size > 0 ? &v->data[v->size - 1] : NULL;                                   \
+    }                                                                                             \
+                                                                                                  \
+    static inline void volt_##name##_vector_clear(volt_##name##_vector_t* v) {                    \
+        if (v)                                                                                    \
+            v->size = 0;                                                                          \
+    }                                                                                             \
+                                                                                                  \
+    static inline T* volt_##name##_vector_steal(volt_##name##_vector_t* v, size_t* size) {        \
+        T* data = v->data;                                                                        \
+        if (size)                                                                                 \
+            *size = v->size;                                                                      \
+        v->data = NULL;                                                                           \
+        v->size = v->capacity = 0;                                                                \
+        return data;                                                                              \
+    }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_VALUE_VECTOR_H__
@@ -2,7 +2,7 @@
 #define __VOLT_ERROR_H__
 
 #include <util/types/types.h>
-#include <util/types/vector.h>
+#include <util/types/value_vector.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,10 +18,6 @@ enum volt_error_type_t {
 };
 
 typedef struct volt_error_handler_t volt_error_handler_t;
-struct volt_error_handler_t {
-    volt_vector_t     errors;
-    volt_allocator_t* allocator;
-};
 
 typedef struct volt_error_t volt_error_t;
 struct volt_error_t {
@@ -33,10 +29,16 @@ struct volt_error_t {
     size_t                column;
 };
 
+VOLT_VECTOR_DEFINE(error, volt_error_t)
+
+struct volt_error_handler_t {
+    volt_error_vector_t errors;  // Owns each error's message
+    volt_allocator_t*   allocator;
+};
+
 volt_status_code_t volt_error_init(volt_error_handler_t* handler, volt_error_t*,
                                    volt_error_message_t, volt_error_type_t, const char*, size_t,
                                    size_t);
-void               volt_verror_deinit(void* verror);
 volt_status_code_t volt_error_deinit(volt_error_t*);
 
 volt_status_code_t volt_error_handler_init(volt_error_handler_t*, volt_allocator_t*);
@@ -44,8 +46,6 @@ volt_status_code_t volt_error_handler_deinit(volt_error_handler_t*);
 volt_status_code_t volt_error_handler_push_error(volt_error_handler_t*, volt_error_t*);
 volt_status_code_t volt_error_handler_print(volt_error_handler_t*);
 
-extern volt_allocator_t volt_error_allocator;
-
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,23 @@
+#ifndef __VOLT_LSP_H__
+#define __VOLT_LSP_H__
+
+#include <volt/volt.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Language server (`voltc --lsp [workspace files...]`): JSON-RPC 2.0 with Content-Length framing
+// on stdin/stdout. Lexers, parsers and the per-item results of the last analysis stay resident
+// between edits. An edit is relexed and reparsed in place, and the next analysis only checks
+// the bodies of the items it replaced plus those that mention a name whose declaration changed.
+//
+// `--lsp-replay` reads a recorded session (the client's side of the conversation) from stdin,
+// discards the replies and prints per-method latencies instead.
+volt_status_code_t volt_lsp_run(volt_compiler_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_LSP_H__
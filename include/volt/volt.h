@@ -20,6 +20,23 @@ struct volt_cmd_args_t {
     size_t            input_count;
     size_t            output_count;
     volt_allocator_t* allocator;
+
+    // Options (`--name` anywhere on the command line)
+    bool print_dce;
+    bool print_layouts;
+    bool print_coroutines;
+    bool print_loops;
+    bool print_matches;
+    bool print_escapes;
+    bool print_fallible;
+    bool print_formats;
+    bool print_devirt;
+    bool interpreted_parser;  // Reference grammar interpreter instead of the generated parser
+    bool lazy_bodies;         // Parse function bodies only when a pass needs them
+    bool lsp;                 // Serve the language server protocol on stdio; no outputs
+    bool lsp_replay;          // Replay a recorded session from stdin and print latencies
+
+    const char* runtime_library;  // `--runtime=<path>`: runtime archive to link programs with
 };
 
 typedef struct volt_compiler_t volt_compiler_t;
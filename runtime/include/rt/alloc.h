@@ -0,0 +1,73 @@
+#ifndef __VOLT_RT_ALLOC_H__
+#define __VOLT_RT_ALLOC_H__
+
+#include <stdalign.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Allocators behind `std::mem`'s `t_allocator` implementations. All memory they hand out is
+// aligned to VOLT_RT_ALLOC_ALIGNMENT.
+
+#define VOLT_RT_ALLOC_ALIGNMENT 16u
+
+// ARENA
+// Bump allocation out of chunks; nothing is freed individually except the most recent
+// allocation, everything goes at once on reset or deinit.
+
+typedef struct volt_rt_arena_chunk_t volt_rt_arena_chunk_t;
+struct volt_rt_arena_chunk_t {
+    volt_rt_arena_chunk_t* previous;
+    size_t                 capacity;
+    size_t                 used;
+    alignas(VOLT_RT_ALLOC_ALIGNMENT) unsigned char data[];
+};
+
+typedef struct volt_rt_arena_t volt_rt_arena_t;
+struct volt_rt_arena_t {
+    volt_rt_arena_chunk_t* chunk;       // Current chunk, linked to the older ones
+    size_t                 chunk_size;  // Capacity of new chunks, unless an allocation needs more
+    void*                  last;        // Most recent allocation, which can grow or shrink in place
+};
+
+void  volt_rt_arena_init(volt_rt_arena_t*, size_t chunk_size);  // 0 picks a default
+void  volt_rt_arena_deinit(volt_rt_arena_t*);
+void  volt_rt_arena_reset(volt_rt_arena_t*);  // Keeps the current chunk for reuse
+void* volt_rt_arena_alloc(volt_rt_arena_t*, size_t size);
+void* volt_rt_arena_realloc(volt_rt_arena_t*, void* pointer, size_t size);
+void  volt_rt_arena_free(volt_rt_arena_t*, void* pointer);
+
+// POOL
+// Fixed-size blocks carved out of slabs, recycled through an intrusive free list.
+
+typedef struct volt_rt_pool_t volt_rt_pool_t;
+struct volt_rt_pool_t {
+    size_t block_size;  // Rounded up to VOLT_RT_ALLOC_ALIGNMENT
+    size_t blocks_per_slab;
+    void*  free_list;
+    void*  slabs;  // Each slab starts with the link to the next one
+};
+
+void  volt_rt_pool_init(volt_rt_pool_t*, size_t block_size, size_t blocks_per_slab);
+void  volt_rt_pool_deinit(volt_rt_pool_t*);
+void* volt_rt_pool_alloc(volt_rt_pool_t*, size_t size);  // NULL when `size` exceeds the block
+void  volt_rt_pool_free(volt_rt_pool_t*, void* pointer);
+
+// THREAD-CACHING ALLOCATOR
+// General-purpose: sizes up to VOLT_RT_CACHE_MAX_SMALL come from power-of-two size classes, each
+// thread keeping its own free lists and exchanging blocks with shared per-class lists in
+// batches, so most calls take no lock. Larger sizes go straight to malloc.
+
+#define VOLT_RT_CACHE_MAX_SMALL 32768u
+
+void* volt_rt_cache_alloc(size_t size);
+void* volt_rt_cache_realloc(void* pointer, size_t size);
+void  volt_rt_cache_free(void* pointer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_RT_ALLOC_H__
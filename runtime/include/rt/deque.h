@@ -0,0 +1,44 @@
+#ifndef __VOLT_RT_DEQUE_H__
+#define __VOLT_RT_DEQUE_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Chase-Lev work-stealing deque (Lê et al., "Correct and Efficient Work-Stealing for Weak Memory
+// Models"). The owning worker pushes and takes at the bottom; any thread may steal from the top.
+
+typedef struct volt_rt_deque_array_t volt_rt_deque_array_t;
+struct volt_rt_deque_array_t {
+    size_t                 capacity;  // Power of two
+    volt_rt_deque_array_t* previous;  // Outgrown arrays stay alive until the deque is destroyed
+    _Atomic(void*)         items[];
+};
+
+typedef struct volt_rt_deque_t volt_rt_deque_t;
+struct volt_rt_deque_t {
+    _Atomic int64_t                top;
+    _Atomic int64_t                bottom;
+    _Atomic(volt_rt_deque_array_t*) array;
+};
+
+bool volt_rt_deque_init(volt_rt_deque_t*, size_t capacity);
+void volt_rt_deque_deinit(volt_rt_deque_t*);
+
+// Owner only
+bool  volt_rt_deque_push(volt_rt_deque_t*, void* item);
+void* volt_rt_deque_take(volt_rt_deque_t*);
+
+// Any thread. Returns NULL when empty or when it lost a race with another thief or the owner.
+void* volt_rt_deque_steal(volt_rt_deque_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_RT_DEQUE_H__
@@ -0,0 +1,59 @@
+#ifndef __VOLT_RT_IO_H__
+#define __VOLT_RT_IO_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Buffered writers behind `std::io::print` / `println`. Every thread gets its own stdout and
+// stderr writer, so printing never takes a lock: a thread's output appears in order, and output
+// from different threads interleaves at flush boundaries. Writers attached to a terminal flush
+// at each newline; anything else flushes only when the buffer fills, on volt_rt_flush, at
+// thread exit and at process exit. Writes too large for the space left go out in one `writev`
+// together with what is buffered instead of being copied.
+
+#define VOLT_RT_IO_BUFFER_SIZE (64u * 1024u)
+
+typedef enum {
+    VOLT_RT_IO_FULL,  // Flush when the buffer is full
+    VOLT_RT_IO_LINE,  // Also flush after every write containing a newline (terminals)
+} volt_rt_io_mode_t;
+
+typedef struct volt_rt_writer_t volt_rt_writer_t;
+struct volt_rt_writer_t {
+    int               fd;
+    volt_rt_io_mode_t mode;
+    bool              failed;  // Sticky: once a write fails, later writes are dropped
+    size_t            length;  // Bytes buffered
+    char              buffer[VOLT_RT_IO_BUFFER_SIZE];
+};
+
+// The calling thread's writers, created on first use
+volt_rt_writer_t* volt_rt_stdout(void);
+volt_rt_writer_t* volt_rt_stderr(void);
+
+// Picks the mode from whether `fd` is a terminal
+void volt_rt_writer_init(volt_rt_writer_t*, int fd);
+
+// Each returns false once the writer has failed
+bool volt_rt_write_bytes(volt_rt_writer_t*, const char*, size_t);
+bool volt_rt_write_cstr(volt_rt_writer_t*, const char*);
+bool volt_rt_write_int(volt_rt_writer_t*, int64_t);
+bool volt_rt_write_uint(volt_rt_writer_t*, uint64_t);
+bool volt_rt_write_float(volt_rt_writer_t*, double);  // Shortest text that reads back exactly
+bool volt_rt_write_bool(volt_rt_writer_t*, bool);
+
+bool volt_rt_flush(volt_rt_writer_t*);
+
+// Flushes the calling thread's stdout and stderr
+void volt_rt_flush_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_RT_IO_H__
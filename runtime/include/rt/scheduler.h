@@ -0,0 +1,95 @@
+#ifndef __VOLT_RT_SCHEDULER_H__
+#define __VOLT_RT_SCHEDULER_H__
+
+#include <pthread.h>
+#include <rt/deque.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Multi-threaded executor for lowered async functions. Each worker owns a Chase-Lev deque: tasks
+// spawned on a worker go to its bottom and are taken LIFO, idle workers steal FIFO from a random
+// victim, and workers with nothing to steal park until new work arrives. Tasks spawned from
+// outside the pool and tasks that yield go through a shared FIFO injection queue.
+
+typedef enum {
+    VOLT_RT_TASK_DONE,     // Finished; joiners are woken
+    VOLT_RT_TASK_YIELD,    // Suspended, run again later
+    VOLT_RT_TASK_AWAIT,    // Suspended until `awaiting` is done
+} volt_rt_task_status_t;
+
+typedef struct volt_rt_task_t volt_rt_task_t;
+
+// Runs the coroutine from its current state to the next suspend or to the end
+typedef volt_rt_task_status_t (*volt_rt_resume_fn)(volt_rt_task_t*);
+
+// Embedded at the start of a coroutine frame or allocated next to it; owned by the caller
+struct volt_rt_task_t {
+    volt_rt_resume_fn resume;
+    void*             frame;
+    volt_rt_task_t*   awaiting;  // Set before returning VOLT_RT_TASK_AWAIT
+
+    // Internal
+    _Atomic(volt_rt_task_t*) waiter;  // Task joining this one, the watch or the done marker
+    volt_rt_task_t*          next;    // Injection queue link
+};
+
+typedef struct volt_rt_worker_t    volt_rt_worker_t;
+typedef struct volt_rt_scheduler_t volt_rt_scheduler_t;
+
+struct volt_rt_worker_t {
+    volt_rt_scheduler_t* scheduler;
+    volt_rt_deque_t      deque;
+    pthread_t            thread;
+    size_t               index;
+    uint64_t             seed;  // Victim selection
+};
+
+struct volt_rt_scheduler_t {
+    volt_rt_worker_t* workers;
+    size_t            worker_count;
+    size_t            running;  // Workers whose thread has been started
+
+    // Injection queue
+    pthread_mutex_t injector_lock;
+    volt_rt_task_t* injector_head;
+    volt_rt_task_t* injector_tail;
+
+    // Parking
+    pthread_mutex_t park_lock;
+    pthread_cond_t  park_cond;
+    pthread_cond_t  done_cond;
+    atomic_size_t   queued;    // Tasks sitting in any queue
+    atomic_size_t   sleepers;  // Parked workers
+    atomic_bool     stopping;
+};
+
+void volt_rt_task_init(volt_rt_task_t*, volt_rt_resume_fn resume, void* frame);
+
+// `worker_count` 0 uses one worker per online CPU
+bool volt_rt_scheduler_init(volt_rt_scheduler_t*, size_t worker_count);
+
+// Stops the workers once they finish the task at hand; queued tasks are dropped
+void volt_rt_scheduler_deinit(volt_rt_scheduler_t*);
+
+// Makes `task` runnable. From a worker it goes to that worker's deque.
+bool volt_rt_spawn(volt_rt_scheduler_t*, volt_rt_task_t*);
+
+bool volt_rt_is_done(volt_rt_task_t*);
+
+// Blocks a thread outside the pool until `task` is done, after which the task may be freed. The
+// waiting thread takes the place of the task's joiner.
+void volt_rt_wait(volt_rt_scheduler_t*, volt_rt_task_t*);
+
+// Inside a task: `return volt_rt_join(self, child);` suspends until `child` is done. A task
+// has at most one joiner.
+// Inside a task: `return volt_rt_yield();` lets other tasks run first.
+volt_rt_task_status_t volt_rt_join(volt_rt_task_t* self, volt_rt_task_t* child);
+volt_rt_task_status_t volt_rt_yield(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __VOLT_RT_SCHEDULER_H__
@@ -0,0 +1,410 @@
+#include <pthread.h>
+#include <rt/alloc.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define VOLT_RT_ARENA_DEFAULT_CHUNK (64u * 1024u)
+#define VOLT_RT_POOL_DEFAULT_BLOCKS 64u
+
+// Classes are 16, 32, ... VOLT_RT_CACHE_MAX_SMALL bytes
+#define VOLT_RT_CACHE_CLASSES 12u
+#define VOLT_RT_CACHE_LARGE   VOLT_RT_CACHE_CLASSES  // Class of blocks that went to malloc
+#define VOLT_RT_CACHE_HEADER  VOLT_RT_ALLOC_ALIGNMENT
+#define VOLT_RT_CACHE_BATCH   32u            // Blocks moved between a thread and the shared list
+#define VOLT_RT_CACHE_LIMIT   128u           // Blocks a thread keeps per class before returning some
+#define VOLT_RT_CACHE_SPAN    (64u * 1024u)  // Bytes carved from malloc when a class runs dry
+
+static size_t volt_rt_align_up(size_t value) {
+    return (value + VOLT_RT_ALLOC_ALIGNMENT - 1) & ~(size_t) (VOLT_RT_ALLOC_ALIGNMENT - 1);
+}
+
+// ARENA
+
+static volt_rt_arena_chunk_t* volt_rt_arena_grow(volt_rt_arena_t* arena, size_t size) {
+    size_t capacity = size > arena->chunk_size ? size : arena->chunk_size;
+    if (capacity > SIZE_MAX - sizeof(volt_rt_arena_chunk_t))
+        return NULL;
+
+    volt_rt_arena_chunk_t* chunk = malloc(sizeof(volt_rt_arena_chunk_t) + capacity);
+    if (!chunk)
+        return NULL;
+
+    chunk->previous = arena->chunk;
+    chunk->capacity = capacity;
+    chunk->used     = 0;
+    arena->chunk    = chunk;
+    return chunk;
+}
+
+void volt_rt_arena_init(volt_rt_arena_t* arena, size_t chunk_size) {
+    arena->chunk      = NULL;
+    arena->chunk_size = volt_rt_align_up(chunk_size ? chunk_size : VOLT_RT_ARENA_DEFAULT_CHUNK);
+    arena->last       = NULL;
+}
+
+void volt_rt_arena_deinit(volt_rt_arena_t* arena) {
+    volt_rt_arena_chunk_t* chunk = arena->chunk;
+    while (chunk) {
+        volt_rt_arena_chunk_t* previous = chunk->previous;
+        free(chunk);
+        chunk = previous;
+    }
+    arena->chunk = NULL;
+    arena->last  = NULL;
+}
+
+void volt_rt_arena_reset(volt_rt_arena_t* arena) {
+    volt_rt_arena_chunk_t* chunk = arena->chunk;
+    if (!chunk)
+        return;
+
+    volt_rt_arena_chunk_t* previous = chunk->previous;
+    while (previous) {
+        volt_rt_arena_chunk_t* older = previous->previous;
+        free(previous);
+        previous = older;
+    }
+    chunk->previous = NULL;
+    chunk->used     = 0;
+    arena->last     = NULL;
+}
+
+void* volt_rt_arena_alloc(volt_rt_arena_t* arena, size_t size) {
+    if (size > SIZE_MAX - VOLT_RT_ALLOC_ALIGNMENT)
+        return NULL;
+
+    size_t                 rounded = volt_rt_align_up(size ? size : 1);
+    volt_rt_arena_chunk_t* chunk   = arena->chunk;
+    if (!chunk || chunk->capacity - chunk->used < rounded) {
+        chunk = volt_rt_arena_grow(arena, rounded);
+        if (!chunk)
+            return NULL;
+    }
+
+    void* pointer = chunk->data + chunk->used;
+    chunk->used += rounded;
+    arena->last = pointer;
+    return pointer;
+}
+
+// The old size is not recorded: the most recent allocation is resized in place, anything else
+// is copied up to the end of its chunk's used space, which covers the whole old allocation
+void* volt_rt_arena_realloc(volt_rt_arena_t* arena, void* pointer, size_t size) {
+    if (!pointer)
+        return volt_rt_arena_alloc(arena, size);
+    if (size > SIZE_MAX - VOLT_RT_ALLOC_ALIGNMENT)
+        return NULL;
+
+    volt_rt_arena_chunk_t* chunk   = arena->chunk;
+    size_t                 rounded = volt_rt_align_up(size ? size : 1);
+    if (pointer == arena->last) {
+        size_t offset = (size_t) ((unsigned char*) pointer - chunk->data);
+        if (rounded <= chunk->capacity - offset) {
+            chunk->used = offset + rounded;
+            return pointer;
+        }
+    }
+
+    volt_rt_arena_chunk_t* owner = chunk;
+    while (owner && ((unsigned char*) pointer < owner->data ||
+                     (unsigned char*) pointer >= owner->data + owner->used))
+        owner = owner->previous;
+    if (!owner)
+        return NULL;
+
+    size_t available = (size_t) (owner->data + owner->used - (unsigned char*) pointer);
+    void*  moved     = volt_rt_arena_alloc(arena, size);
+    if (moved)
+        memcpy(moved, pointer, available < size ? available : size);
+    return moved;
+}
+
+void volt_rt_arena_free(volt_rt_arena_t* arena, void* pointer) {
+    if (!pointer || pointer != arena->last)
+        return;
+
+    arena->chunk->used = (size_t) ((unsigned char*) pointer - arena->chunk->data);
+    arena->last        = NULL;
+}
+
+// POOL
+
+static bool volt_rt_pool_grow(volt_rt_pool_t* pool) {
+    size_t blocks = pool->blocks_per_slab;
+    if (pool->block_size > (SIZE_MAX - VOLT_RT_ALLOC_ALIGNMENT) / blocks)
+        return false;
+
+    // The link to the next slab takes one alignment unit so the blocks stay aligned
+    unsigned char* slab = malloc(VOLT_RT_ALLOC_ALIGNMENT + pool->block_size * blocks);
+    if (!slab)
+        return false;
+
+    *(void**) slab = pool->slabs;
+    pool->slabs    = slab;
+
+    for (size_t i = blocks; i > 0; i--) {
+        void* block     = slab + VOLT_RT_ALLOC_ALIGNMENT + (i - 1) * pool->block_size;
+        *(void**) block = pool->free_list;
+        pool->free_list = block;
+    }
+    return true;
+}
+
+void volt_rt_pool_init(volt_rt_pool_t* pool, size_t block_size, size_t blocks_per_slab) {
+    pool->block_size = volt_rt_align_up(block_size > sizeof(void*) ? block_size : sizeof(void*));
+    pool->blocks_per_slab = blocks_per_slab ? blocks_per_slab : VOLT_RT_POOL_DEFAULT_BLOCKS;
+    pool->free_list       = NULL;
+    pool->slabs           = NULL;
+}
+
+void volt_rt_pool_deinit(volt_rt_pool_t* pool) {
+    void* slab = pool->slabs;
+    while (slab) {
+        void* next = *(void**) slab;
+        free(slab);
+        slab = next;
+    }
+    pool->slabs     = NULL;
+    pool->free_list = NULL;
+}
+
+void* volt_rt_pool_alloc(volt_rt_pool_t* pool, size_t size) {
+    if (size > pool->block_size)
+        return NULL;
+    if (!pool->free_list && !volt_rt_pool_grow(pool))
+        return NULL;
+
+    void* block     = pool->free_list;
+    pool->free_list = *(void**) block;
+    return block;
+}
+
+void volt_rt_pool_free(volt_rt_pool_t* pool, void* pointer) {
+    if (!pointer)
+        return;
+
+    *(void**) pointer = pool->free_list;
+    pool->free_list   = pointer;
+}
+
+// THREAD-CACHING ALLOCATOR
+
+// Precedes every block; while the block is free its first word links the free list instead
+typedef struct volt_rt_cache_header_t volt_rt_cache_header_t;
+struct volt_rt_cache_header_t {
+    size_t size_class;
+    size_t size;  // Requested size, used to resize large blocks
+};
+
+typedef struct volt_rt_cache_list_t volt_rt_cache_list_t;
+struct volt_rt_cache_list_t {
+    void*  head;
+    size_t count;
+};
+
+typedef struct volt_rt_cache_central_t volt_rt_cache_central_t;
+struct volt_rt_cache_central_t {
+    pthread_mutex_t      lock;
+    volt_rt_cache_list_t list;
+};
+
+typedef struct volt_rt_cache_thread_t volt_rt_cache_thread_t;
+struct volt_rt_cache_thread_t {
+    volt_rt_cache_list_t lists[VOLT_RT_CACHE_CLASSES];
+};
+
+static volt_rt_cache_central_t volt_rt_cache_central[VOLT_RT_CACHE_CLASSES];
+static pthread_once_t          volt_rt_cache_once = PTHREAD_ONCE_INIT;
+static pthread_key_t           volt_rt_cache_key;
+
+static _Thread_local volt_rt_cache_thread_t* volt_rt_cache_current;
+
+static size_t volt_rt_cache_class_size(size_t size_class) {
+    return (size_t) 16 << size_class;
+}
+
+static size_t volt_rt_cache_class_of(size_t size) {
+    size_t size_class = 0;
+    while (volt_rt_cache_class_size(size_class) < size)
+        size_class++;
+    return size_class;
+}
+
+static void volt_rt_cache_push(volt_rt_cache_list_t* list, void* block) {
+    *(void**) block = list->head;
+    list->head      = block;
+    list->count++;
+}
+
+static void* volt_rt_cache_pop(volt_rt_cache_list_t* list) {
+    void* block = list->head;
+    list->head  = *(void**) block;
+    list->count--;
+    return block;
+}
+
+// Moves up to `count` blocks between lists
+static void volt_rt_cache_move(volt_rt_cache_list_t* from, volt_rt_cache_list_t* to,
+                               size_t count) {
+    while (count-- > 0 && from->head)
+        volt_rt_cache_push(to, volt_rt_cache_pop(from));
+}
+
+// A dying thread hands its blocks to the shared lists
+static void volt_rt_cache_release(void* data) {
+    volt_rt_cache_thread_t* thread = (volt_rt_cache_thread_t*) data;
+    volt_rt_cache_current          = NULL;  // Later destructors that allocate start afresh
+    for (size_t i = 0; i < VOLT_RT_CACHE_CLASSES; i++) {
+        volt_rt_cache_central_t* central = &volt_rt_cache_central[i];
+        pthread_mutex_lock(&central->lock);
+        volt_rt_cache_move(&thread->lists[i], &central->list, SIZE_MAX);
+        pthread_mutex_unlock(&central->lock);
+    }
+    free(thread);
+}
+
+static void volt_rt_cache_setup(void) {
+    for (size_t i = 0; i < VOLT_RT_CACHE_CLASSES; i++)
+        pthread_mutex_init(&volt_rt_cache_central[i].lock, NULL);
+    pthread_key_create(&volt_rt_cache_key, volt_rt_cache_release);
+}
+
+static volt_rt_cache_thread_t* volt_rt_cache_thread(void) {
+    if (volt_rt_cache_current)
+        return volt_rt_cache_current;
+
+    pthread_once(&volt_rt_cache_once, volt_rt_cache_setup);
+    volt_rt_cache_thread_t* thread = calloc(1, sizeof(volt_rt_cache_thread_t));
+    if (!thread)
+        return NULL;
+
+    pthread_setspecific(volt_rt_cache_key, thread);
+    volt_rt_cache_current = thread;
+    return thread;
+}
+
+// Takes a batch from the shared list, or carves a new span when that is empty too. Spans are
+// never returned to the system.
+static bool volt_rt_cache_refill(volt_rt_cache_list_t* list, size_t size_class) {
+    volt_rt_cache_central_t* central = &volt_rt_cache_central[size_class];
+    pthread_mutex_lock(&central->lock);
+    volt_rt_cache_move(&central->list, list, VOLT_RT_CACHE_BATCH);
+    pthread_mutex_unlock(&central->lock);
+    if (list->head)
+        return true;
+
+    size_t         block = VOLT_RT_CACHE_HEADER + volt_rt_cache_class_size(size_class);
+    size_t         count = VOLT_RT_CACHE_SPAN / block ? VOLT_RT_CACHE_SPAN / block : 1;
+    unsigned char* span  = malloc(block * count);
+    if (!span)
+        return false;
+
+    volt_rt_cache_list_t carved = {0};
+    for (size_t i = count; i > 0; i--)
+        volt_rt_cache_push(&carved, span + (i - 1) * block);
+
+    volt_rt_cache_move(&carved, list, VOLT_RT_CACHE_BATCH);
+    if (carved.head) {
+        pthread_mutex_lock(&central->lock);
+        volt_rt_cache_move(&carved, &central->list, SIZE_MAX);
+        pthread_mutex_unlock(&central->lock);
+    }
+    return true;
+}
+
+static void* volt_rt_cache_alloc_large(size_t size) {
+    if (size > SIZE_MAX - VOLT_RT_CACHE_HEADER)
+        return NULL;
+
+    volt_rt_cache_header_t* header = malloc(VOLT_RT_CACHE_HEADER + size);
+    if (!header)
+        return NULL;
+
+    header->size_class = VOLT_RT_CACHE_LARGE;
+    header->size       = size;
+    return (unsigned char*) header + VOLT_RT_CACHE_HEADER;
+}
+
+void* volt_rt_cache_alloc(size_t size) {
+    volt_rt_cache_thread_t* thread =
+        size <= VOLT_RT_CACHE_MAX_SMALL ? volt_rt_cache_thread() : NULL;
+    if (!thread)
+        return volt_rt_cache_alloc_large(size);
+
+    size_t                size_class = volt_rt_cache_class_of(size);
+    volt_rt_cache_list_t* list       = &thread->lists[size_class];
+    if (!list->head && !volt_rt_cache_refill(list, size_class))
+        return NULL;
+
+    volt_rt_cache_header_t* header = volt_rt_cache_pop(list);
+    header->size_class             = size_class;
+    header->size                   = size;
+    return (unsigned char*) header + VOLT_RT_CACHE_HEADER;
+}
+
+void volt_rt_cache_free(void* pointer) {
+    if (!pointer)
+        return;
+
+    volt_rt_cache_header_t* header =
+        (volt_rt_cache_header_t*) ((unsigned char*) pointer - VOLT_RT_CACHE_HEADER);
+    size_t size_class = header->size_class;
+    if (size_class == VOLT_RT_CACHE_LARGE) {
+        free(header);
+        return;
+    }
+
+    volt_rt_cache_thread_t* thread = volt_rt_cache_thread();
+    if (!thread) {
+        volt_rt_cache_central_t* central = &volt_rt_cache_central[size_class];
+        pthread_mutex_lock(&central->lock);
+        volt_rt_cache_push(&central->list, header);
+        pthread_mutex_unlock(&central->lock);
+        return;
+    }
+
+    volt_rt_cache_list_t* list = &thread->lists[size_class];
+    volt_rt_cache_push(list, header);
+    if (list->count > VOLT_RT_CACHE_LIMIT) {
+        volt_rt_cache_central_t* central = &volt_rt_cache_central[size_class];
+        pthread_mutex_lock(&central->lock);
+        volt_rt_cache_move(list, &central->list, VOLT_RT_CACHE_BATCH);
+        pthread_mutex_unlock(&central->lock);
+    }
+}
+
+void* volt_rt_cache_realloc(void* pointer, size_t size) {
+    if (!pointer)
+        return volt_rt_cache_alloc(size);
+
+    volt_rt_cache_header_t* header =
+        (volt_rt_cache_header_t*) ((unsigned char*) pointer - VOLT_RT_CACHE_HEADER);
+    if (header->size_class == VOLT_RT_CACHE_LARGE && size > VOLT_RT_CACHE_MAX_SMALL) {
+        if (size > SIZE_MAX - VOLT_RT_CACHE_HEADER)
+            return NULL;
+        volt_rt_cache_header_t* grown = realloc(header, VOLT_RT_CACHE_HEADER + size);
+        if (!grown)
+            return NULL;
+        grown->size = size;
+        return (unsigned char*) grown + VOLT_RT_CACHE_HEADER;
+    }
+
+    // Same class: nothing to move
+    size_t capacity = header->size_class == VOLT_RT_CACHE_LARGE
+                          ? header->size
+                          : volt_rt_cache_class_size(header->size_class);
+    if (header->size_class != VOLT_RT_CACHE_LARGE &&
+        volt_rt_cache_class_of(size) == header->size_class) {
+        header->size = size;
+        return pointer;
+    }
+
+    void* moved = volt_rt_cache_alloc(size);
+    if (!moved)
+        return NULL;
+    memcpy(moved, pointer, capacity < size ? capacity : size);
+    volt_rt_cache_free(pointer);
+    return moved;
+}
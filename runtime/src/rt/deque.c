@@ -0,0 +1,126 @@
+#include <rt/deque.h>
+#include <stdlib.h>
+
+// HELPER FUNCTIONS
+
+static volt_rt_deque_array_t* volt_rt_deque_array_create(size_t capacity) {
+    volt_rt_deque_array_t* array =
+        malloc(sizeof(volt_rt_deque_array_t) + capacity * sizeof(_Atomic(void*)));
+    if (!array)
+        return NULL;
+
+    array->capacity = capacity;
+    array->previous = NULL;
+    for (size_t i = 0; i < capacity; i++)
+        atomic_init(&array->items[i], NULL);
+    return array;
+}
+
+static void* volt_rt_deque_array_get(volt_rt_deque_array_t* array, int64_t index) {
+    return atomic_load_explicit(&array->items[(size_t) index & (array->capacity - 1)],
+                                memory_order_relaxed);
+}
+
+static void volt_rt_deque_array_put(volt_rt_deque_array_t* array, int64_t index, void* item) {
+    atomic_store_explicit(&array->items[(size_t) index & (array->capacity - 1)], item,
+                          memory_order_relaxed);
+}
+
+// Doubles the array; thieves may still be reading the old one, so it is only unlinked
+static volt_rt_deque_array_t* volt_rt_deque_grow(volt_rt_deque_t* deque,
+                                                 volt_rt_deque_array_t* array, int64_t top,
+                                                 int64_t bottom) {
+    volt_rt_deque_array_t* grown = volt_rt_deque_array_create(array->capacity * 2);
+    if (!grown)
+        return NULL;
+
+    for (int64_t i = top; i < bottom; i++)
+        volt_rt_deque_array_put(grown, i, volt_rt_deque_array_get(array, i));
+    grown->previous = array;
+    atomic_store_explicit(&deque->array, grown, memory_order_release);
+    return grown;
+}
+
+// DEQUE
+
+bool volt_rt_deque_init(volt_rt_deque_t* deque, size_t capacity) {
+    size_t rounded = 16;
+    while (rounded < capacity)
+        rounded *= 2;
+
+    volt_rt_deque_array_t* array = volt_rt_deque_array_create(rounded);
+    if (!array)
+        return false;
+
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, array);
+    return true;
+}
+
+void volt_rt_deque_deinit(volt_rt_deque_t* deque) {
+    volt_rt_deque_array_t* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    while (array) {
+        volt_rt_deque_array_t* previous = array->previous;
+        free(array);
+        array = previous;
+    }
+    atomic_store_explicit(&deque->array, NULL, memory_order_relaxed);
+}
+
+bool volt_rt_deque_push(volt_rt_deque_t* deque, void* item) {
+    int64_t                bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    int64_t                top    = atomic_load_explicit(&deque->top, memory_order_acquire);
+    volt_rt_deque_array_t* array  = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    if (bottom - top > (int64_t) array->capacity - 1) {
+        array = volt_rt_deque_grow(deque, array, top, bottom);
+        if (!array)
+            return false;
+    }
+
+    // A release store rather than the paper's release fence: same ordering, and thread
+    // sanitizers understand it
+    volt_rt_deque_array_put(array, bottom, item);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_release);
+    return true;
+}
+
+void* volt_rt_deque_take(volt_rt_deque_t* deque) {
+    int64_t                bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    volt_rt_deque_array_t* array  = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        // Empty
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    void* item = volt_rt_deque_array_get(array, bottom);
+    if (top == bottom) {
+        // Last item: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed))
+            item = NULL;
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+void* volt_rt_deque_steal(volt_rt_deque_t* deque) {
+    int64_t top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom)
+        return NULL;
+
+    volt_rt_deque_array_t* array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    void*                  item  = volt_rt_deque_array_get(array, top);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1, memory_order_seq_cst,
+                                                 memory_order_relaxed))
+        return NULL;
+    return item;
+}
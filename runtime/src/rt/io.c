@@ -0,0 +1,221 @@
+#include <errno.h>
+#include <pthread.h>
+#include <rt/io.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+typedef struct volt_rt_io_thread_t volt_rt_io_thread_t;
+struct volt_rt_io_thread_t {
+    volt_rt_writer_t out;
+    volt_rt_writer_t err;
+};
+
+static pthread_key_t  volt_rt_io_key;
+static pthread_once_t volt_rt_io_once = PTHREAD_ONCE_INIT;
+
+static _Thread_local volt_rt_io_thread_t* volt_rt_io_current;
+
+// Handed out when a thread's writers cannot be allocated; every write to it is dropped
+static volt_rt_writer_t volt_rt_io_dead = {.fd = -1, .failed = true};
+
+static const char volt_rt_io_digit_pairs[] = "00010203040506070809"
+                                             "10111213141516171819"
+                                             "20212223242526272829"
+                                             "30313233343536373839"
+                                             "40414243444546474849"
+                                             "50515253545556575859"
+                                             "60616263646566676869"
+                                             "70717273747576777879"
+                                             "80818283848586878889"
+                                             "90919293949596979899";
+
+// HELPER FUNCTIONS
+
+// Runs on the exiting thread. A destructor that writes after this one gets fresh writers, which
+// pthread then releases on its next round of destructors.
+static void volt_rt_io_release(void* data) {
+    volt_rt_io_thread_t* thread = (volt_rt_io_thread_t*) data;
+    volt_rt_flush(&thread->out);
+    volt_rt_flush(&thread->err);
+    if (volt_rt_io_current == thread)
+        volt_rt_io_current = NULL;
+    free(thread);
+}
+
+// `exit` runs no thread-specific destructors, so the exiting thread flushes here. Threads still
+// running at that point keep whatever they have not flushed.
+static void volt_rt_io_at_exit(void) {
+    volt_rt_flush_all();
+}
+
+static void volt_rt_io_setup(void) {
+    pthread_key_create(&volt_rt_io_key, volt_rt_io_release);
+    atexit(volt_rt_io_at_exit);
+}
+
+static volt_rt_io_thread_t* volt_rt_io_thread(void) {
+    if (volt_rt_io_current)
+        return volt_rt_io_current;
+
+    pthread_once(&volt_rt_io_once, volt_rt_io_setup);
+    volt_rt_io_thread_t* thread = malloc(sizeof(volt_rt_io_thread_t));
+    if (!thread)
+        return NULL;
+
+    volt_rt_writer_init(&thread->out, STDOUT_FILENO);
+    volt_rt_writer_init(&thread->err, STDERR_FILENO);
+    pthread_setspecific(volt_rt_io_key, thread);
+    volt_rt_io_current = thread;
+    return thread;
+}
+
+// Retries short writes and interrupts; a failure marks the writer failed
+static bool volt_rt_io_write_all(volt_rt_writer_t* writer, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t written = writev(writer->fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            writer->failed = true;
+            return false;
+        }
+
+        size_t left = (size_t) written;
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*) iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+    return true;
+}
+
+// Writes `value` backwards ending at `end`, two digits at a time; returns the digit count
+static size_t volt_rt_io_format_uint(char* end, uint64_t value) {
+    char* cursor = end;
+    while (value >= 100) {
+        size_t pair = (size_t) (value % 100) * 2;
+        value /= 100;
+        *--cursor = volt_rt_io_digit_pairs[pair + 1];
+        *--cursor = volt_rt_io_digit_pairs[pair];
+    }
+    if (value >= 10) {
+        size_t pair = (size_t) value * 2;
+        *--cursor   = volt_rt_io_digit_pairs[pair + 1];
+        *--cursor   = volt_rt_io_digit_pairs[pair];
+    } else {
+        *--cursor = (char) ('0' + value);
+    }
+    return (size_t) (end - cursor);
+}
+
+// WRITERS
+
+volt_rt_writer_t* volt_rt_stdout(void) {
+    volt_rt_io_thread_t* thread = volt_rt_io_thread();
+    return thread ? &thread->out : &volt_rt_io_dead;
+}
+
+volt_rt_writer_t* volt_rt_stderr(void) {
+    volt_rt_io_thread_t* thread = volt_rt_io_thread();
+    return thread ? &thread->err : &volt_rt_io_dead;
+}
+
+void volt_rt_writer_init(volt_rt_writer_t* writer, int fd) {
+    writer->fd     = fd;
+    writer->mode   = isatty(fd) ? VOLT_RT_IO_LINE : VOLT_RT_IO_FULL;
+    writer->failed = false;
+    writer->length = 0;
+}
+
+bool volt_rt_write_bytes(volt_rt_writer_t* writer, const char* data, size_t size) {
+    if (writer->failed)
+        return false;
+
+    size_t space = VOLT_RT_IO_BUFFER_SIZE - writer->length;
+    if (size <= space) {
+        memcpy(writer->buffer + writer->length, data, size);
+        writer->length += size;
+    } else if (size < VOLT_RT_IO_BUFFER_SIZE) {
+        // Top the buffer up so every write the kernel sees is a full buffer
+        memcpy(writer->buffer + writer->length, data, space);
+        writer->length = VOLT_RT_IO_BUFFER_SIZE;
+        if (!volt_rt_flush(writer))
+            return false;
+        memcpy(writer->buffer, data + space, size - space);
+        writer->length = size - space;
+    } else {
+        // Too big to be worth copying: one writev for the buffered bytes and the data
+        struct iovec iov[2] = {
+            {.iov_base = writer->buffer, .iov_len = writer->length},
+            {.iov_base = (void*) data, .iov_len = size},
+        };
+        writer->length = 0;
+        return volt_rt_io_write_all(writer, iov, 2);
+    }
+
+    if (writer->mode == VOLT_RT_IO_LINE && memchr(data, '\n', size))
+        return volt_rt_flush(writer);
+    return true;
+}
+
+bool volt_rt_write_cstr(volt_rt_writer_t* writer, const char* text) {
+    return volt_rt_write_bytes(writer, text, strlen(text));
+}
+
+bool volt_rt_write_uint(volt_rt_writer_t* writer, uint64_t value) {
+    char   digits[20];
+    size_t length = volt_rt_io_format_uint(digits + sizeof(digits), value);
+    return volt_rt_write_bytes(writer, digits + sizeof(digits) - length, length);
+}
+
+bool volt_rt_write_int(volt_rt_writer_t* writer, int64_t value) {
+    char     digits[21];
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t) value : (uint64_t) value;
+    size_t   length    = volt_rt_io_format_uint(digits + sizeof(digits), magnitude);
+    if (value < 0)
+        digits[sizeof(digits) - ++length] = '-';
+    return volt_rt_write_bytes(writer, digits + sizeof(digits) - length, length);
+}
+
+bool volt_rt_write_float(volt_rt_writer_t* writer, double value) {
+    char text[32];
+    int  length = 0;
+    for (int precision = 1; precision <= 17; precision++) {
+        length = snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (strtod(text, NULL) == value)
+            break;
+    }
+    return volt_rt_write_bytes(writer, text, (size_t) length);
+}
+
+bool volt_rt_write_bool(volt_rt_writer_t* writer, bool value) {
+    return value ? volt_rt_write_bytes(writer, "true", 4) : volt_rt_write_bytes(writer, "false", 5);
+}
+
+bool volt_rt_flush(volt_rt_writer_t* writer) {
+    if (writer->failed)
+        return false;
+    if (writer->length == 0)
+        return true;
+
+    struct iovec iov = {.iov_base = writer->buffer, .iov_len = writer->length};
+    writer->length   = 0;
+    return volt_rt_io_write_all(writer, &iov, 1);
+}
+
+void volt_rt_flush_all(void) {
+    volt_rt_io_thread_t* thread = volt_rt_io_current;
+    if (!thread)
+        return;
+
+    volt_rt_flush(&thread->out);
+    volt_rt_flush(&thread->err);
+}
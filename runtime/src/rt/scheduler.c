@@ -0,0 +1,274 @@
+#include <rt/scheduler.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Rounds of stealing attempts before a worker parks
+#define VOLT_RT_STEAL_ROUNDS 64u
+
+// `waiter` once the task is done, so a late joiner sees it instead of registering
+static volt_rt_task_t volt_rt_done_marker;
+
+// `waiter` while a thread outside the pool blocks in volt_rt_wait
+static volt_rt_task_t volt_rt_watch_marker;
+
+static _Thread_local volt_rt_worker_t* volt_rt_current_worker;
+
+// HELPER FUNCTIONS
+
+static uint64_t volt_rt_next_random(uint64_t* seed) {
+    // xorshift64
+    uint64_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *seed = x;
+    return x;
+}
+
+static void volt_rt_inject(volt_rt_scheduler_t* scheduler, volt_rt_task_t* task) {
+    task->next = NULL;
+    pthread_mutex_lock(&scheduler->injector_lock);
+    if (scheduler->injector_tail)
+        scheduler->injector_tail->next = task;
+    else
+        scheduler->injector_head = task;
+    scheduler->injector_tail = task;
+    pthread_mutex_unlock(&scheduler->injector_lock);
+}
+
+static volt_rt_task_t* volt_rt_take_injected(volt_rt_scheduler_t* scheduler) {
+    pthread_mutex_lock(&scheduler->injector_lock);
+    volt_rt_task_t* task = scheduler->injector_head;
+    if (task) {
+        scheduler->injector_head = task->next;
+        if (!scheduler->injector_head)
+            scheduler->injector_tail = NULL;
+    }
+    pthread_mutex_unlock(&scheduler->injector_lock);
+    return task;
+}
+
+// Called after a task entered a queue. The queued count is raised before the sleepers are
+// read, and a parking worker registers as a sleeper before re-reading the count under the park
+// lock, so either the worker sees the task or we see the worker.
+static void volt_rt_notify(volt_rt_scheduler_t* scheduler) {
+    atomic_fetch_add(&scheduler->queued, 1);
+    if (atomic_load(&scheduler->sleepers) == 0)
+        return;
+
+    pthread_mutex_lock(&scheduler->park_lock);
+    pthread_cond_signal(&scheduler->park_cond);
+    pthread_mutex_unlock(&scheduler->park_lock);
+}
+
+static bool volt_rt_enqueue(volt_rt_scheduler_t* scheduler, volt_rt_task_t* task,
+                            bool local) {
+    volt_rt_worker_t* worker = volt_rt_current_worker;
+    if (local && worker && worker->scheduler == scheduler) {
+        if (!volt_rt_deque_push(&worker->deque, task))
+            return false;
+    } else {
+        volt_rt_inject(scheduler, task);
+    }
+    volt_rt_notify(scheduler);
+    return true;
+}
+
+// A woken task must not be lost: when the worker's deque cannot grow, it is injected instead
+static void volt_rt_reschedule(volt_rt_scheduler_t* scheduler, volt_rt_task_t* task) {
+    if (!volt_rt_enqueue(scheduler, task, true))
+        volt_rt_enqueue(scheduler, task, false);
+}
+
+static volt_rt_task_t* volt_rt_find_task(volt_rt_worker_t* worker) {
+    volt_rt_scheduler_t* scheduler = worker->scheduler;
+
+    volt_rt_task_t* task = volt_rt_deque_take(&worker->deque);
+    if (!task)
+        task = volt_rt_take_injected(scheduler);
+
+    for (size_t round = 0; !task && round < VOLT_RT_STEAL_ROUNDS; round++) {
+        if (atomic_load_explicit(&scheduler->queued, memory_order_relaxed) == 0)
+            break;
+        size_t victim = (size_t) (volt_rt_next_random(&worker->seed) % scheduler->worker_count);
+        if (victim != worker->index)
+            task = volt_rt_deque_steal(&scheduler->workers[victim].deque);
+    }
+
+    if (task)
+        atomic_fetch_sub(&scheduler->queued, 1);
+    return task;
+}
+
+static void volt_rt_park(volt_rt_scheduler_t* scheduler) {
+    pthread_mutex_lock(&scheduler->park_lock);
+    atomic_fetch_add(&scheduler->sleepers, 1);
+    while (atomic_load(&scheduler->queued) == 0 && !atomic_load(&scheduler->stopping))
+        pthread_cond_wait(&scheduler->park_cond, &scheduler->park_lock);
+    atomic_fetch_sub(&scheduler->sleepers, 1);
+    pthread_mutex_unlock(&scheduler->park_lock);
+}
+
+// Publishing the done marker lets the joiner or waiting thread free `task`, so that exchange
+// is the last access to it
+static void volt_rt_complete(volt_rt_scheduler_t* scheduler, volt_rt_task_t* task) {
+    volt_rt_task_t* waiter = atomic_exchange(&task->waiter, &volt_rt_done_marker);
+    if (waiter == &volt_rt_watch_marker) {
+        pthread_mutex_lock(&scheduler->park_lock);
+        pthread_cond_broadcast(&scheduler->done_cond);
+        pthread_mutex_unlock(&scheduler->park_lock);
+    } else if (waiter) {
+        volt_rt_reschedule(scheduler, waiter);
+    }
+}
+
+// Registration happens here rather than in volt_rt_join, after the joiner has returned, so the
+// child cannot reschedule a task that is still running
+static void volt_rt_await(volt_rt_scheduler_t* scheduler, volt_rt_task_t* task) {
+    volt_rt_task_t* child    = task->awaiting;
+    volt_rt_task_t* expected = NULL;
+    task->awaiting           = NULL;
+    if (!atomic_compare_exchange_strong(&child->waiter, &expected, task))
+        volt_rt_reschedule(scheduler, task);  // Finished in the meantime
+}
+
+static void volt_rt_run(volt_rt_scheduler_t* scheduler, volt_rt_task_t* task) {
+    switch (task->resume(task)) {
+        case VOLT_RT_TASK_DONE:
+            volt_rt_complete(scheduler, task);
+            break;
+        case VOLT_RT_TASK_YIELD:
+            // Behind everything already queued, so a yielding task cannot starve the others
+            volt_rt_enqueue(scheduler, task, false);
+            break;
+        case VOLT_RT_TASK_AWAIT:
+            volt_rt_await(scheduler, task);
+            break;
+    }
+}
+
+static void* volt_rt_worker_main(void* argument) {
+    volt_rt_worker_t*    worker    = (volt_rt_worker_t*) argument;
+    volt_rt_scheduler_t* scheduler = worker->scheduler;
+    volt_rt_current_worker         = worker;
+
+    while (!atomic_load_explicit(&scheduler->stopping, memory_order_relaxed)) {
+        volt_rt_task_t* task = volt_rt_find_task(worker);
+        if (task)
+            volt_rt_run(scheduler, task);
+        else
+            volt_rt_park(scheduler);
+    }
+
+    volt_rt_current_worker = NULL;
+    return NULL;
+}
+
+// TASKS
+
+void volt_rt_task_init(volt_rt_task_t* task, volt_rt_resume_fn resume, void* frame) {
+    task->resume   = resume;
+    task->frame    = frame;
+    task->awaiting = NULL;
+    task->next     = NULL;
+    atomic_init(&task->waiter, NULL);
+}
+
+bool volt_rt_spawn(volt_rt_scheduler_t* scheduler, volt_rt_task_t* task) {
+    return volt_rt_enqueue(scheduler, task, true);
+}
+
+bool volt_rt_is_done(volt_rt_task_t* task) {
+    return atomic_load(&task->waiter) == &volt_rt_done_marker;
+}
+
+// The marker is checked under the park lock, which the completing worker takes before it
+// broadcasts, so the wakeup cannot be missed. Fails to register only when already done.
+void volt_rt_wait(volt_rt_scheduler_t* scheduler, volt_rt_task_t* task) {
+    volt_rt_task_t* expected = NULL;
+    atomic_compare_exchange_strong(&task->waiter, &expected, &volt_rt_watch_marker);
+
+    pthread_mutex_lock(&scheduler->park_lock);
+    while (atomic_load(&task->waiter) != &volt_rt_done_marker)
+        pthread_cond_wait(&scheduler->done_cond, &scheduler->park_lock);
+    pthread_mutex_unlock(&scheduler->park_lock);
+}
+
+volt_rt_task_status_t volt_rt_join(volt_rt_task_t* self, volt_rt_task_t* child) {
+    self->awaiting = child;
+    return VOLT_RT_TASK_AWAIT;
+}
+
+volt_rt_task_status_t volt_rt_yield(void) {
+    return VOLT_RT_TASK_YIELD;
+}
+
+// SCHEDULER
+
+bool volt_rt_scheduler_init(volt_rt_scheduler_t* scheduler, size_t worker_count) {
+    if (worker_count == 0) {
+        long online  = sysconf(_SC_NPROCESSORS_ONLN);
+        worker_count = online > 0 ? (size_t) online : 1;
+    }
+
+    scheduler->workers = calloc(worker_count, sizeof(volt_rt_worker_t));
+    if (!scheduler->workers)
+        return false;
+
+    scheduler->worker_count  = worker_count;
+    scheduler->running       = 0;
+    scheduler->injector_head = NULL;
+    scheduler->injector_tail = NULL;
+    pthread_mutex_init(&scheduler->injector_lock, NULL);
+    pthread_mutex_init(&scheduler->park_lock, NULL);
+    pthread_cond_init(&scheduler->park_cond, NULL);
+    pthread_cond_init(&scheduler->done_cond, NULL);
+    atomic_init(&scheduler->queued, 0);
+    atomic_init(&scheduler->sleepers, 0);
+    atomic_init(&scheduler->stopping, false);
+
+    for (size_t i = 0; i < worker_count; i++) {
+        volt_rt_worker_t* worker = &scheduler->workers[i];
+        worker->scheduler        = scheduler;
+        worker->index            = i;
+        worker->seed             = 0x9E3779B97F4A7C15ull * (i + 1);
+        if (!volt_rt_deque_init(&worker->deque, 256)) {
+            scheduler->worker_count = i;
+            volt_rt_scheduler_deinit(scheduler);
+            return false;
+        }
+    }
+
+    // Every deque exists before any worker can try to steal from it
+    for (size_t i = 0; i < worker_count; i++) {
+        volt_rt_worker_t* worker = &scheduler->workers[i];
+        if (pthread_create(&worker->thread, NULL, volt_rt_worker_main, worker) != 0) {
+            volt_rt_scheduler_deinit(scheduler);
+            return false;
+        }
+        scheduler->running++;
+    }
+
+    return true;
+}
+
+void volt_rt_scheduler_deinit(volt_rt_scheduler_t* scheduler) {
+    pthread_mutex_lock(&scheduler->park_lock);
+    atomic_store(&scheduler->stopping, true);
+    pthread_cond_broadcast(&scheduler->park_cond);
+    pthread_mutex_unlock(&scheduler->park_lock);
+
+    for (size_t i = 0; i < scheduler->running; i++)
+        pthread_join(scheduler->workers[i].thread, NULL);
+    for (size_t i = 0; i < scheduler->worker_count; i++)
+        volt_rt_deque_deinit(&scheduler->workers[i].deque);
+
+    pthread_cond_destroy(&scheduler->done_cond);
+    pthread_cond_destroy(&scheduler->park_cond);
+    pthread_mutex_destroy(&scheduler->park_lock);
+    pthread_mutex_destroy(&scheduler->injector_lock);
+    free(scheduler->workers);
+    scheduler->workers      = NULL;
+    scheduler->worker_count = 0;
+    scheduler->running      = 0;
+}
@@ -0,0 +1,252 @@
+#include <comptime/bytecode.h>
+#include <pch.h>
+
+#define CHUNK_INITIAL_CAPACITY 32
+
+volt_allocator_t volt_bytecode_chunk_allocator = {NULL, NULL, .free = volt_bytecode_chunk_vfree,
+                                                  NULL};
+
+volt_bytecode_chunk_t* volt_bytecode_chunk_create(volt_allocator_t* allocator, const char* name) {
+    allocator = allocator ? allocator : &volt_default_allocator;
+
+    volt_bytecode_chunk_t* chunk = allocator->malloc(sizeof(volt_bytecode_chunk_t));
+    if (!chunk)
+        return NULL;
+
+    memset(chunk, 0, sizeof(volt_bytecode_chunk_t));
+    chunk->allocator     = allocator;
+    chunk->name          = name ? name : "<expression>";
+    chunk->code_capacity = CHUNK_INITIAL_CAPACITY;
+    chunk->code          = allocator->malloc(chunk->code_capacity * sizeof(volt_instruction_t));
+    chunk->lines         = allocator->malloc(chunk->code_capacity * sizeof(size_t));
+
+    if (!chunk->code || !chunk->lines) {
+        volt_bytecode_chunk_free(chunk);
+        return NULL;
+    }
+
+    return chunk;
+}
+
+void volt_bytecode_chunk_free(volt_bytecode_chunk_t* chunk) {
+    if (!chunk)
+        return;
+
+    volt_allocator_t* allocator = chunk->allocator;
+    allocator->free(chunk->code);
+    allocator->free(chunk->lines);
+    allocator->free(chunk->constants);
+    allocator->free(chunk->callees);
+    allocator->free(chunk);
+}
+
+void volt_bytecode_chunk_vfree(void* vchunk) {
+    volt_bytecode_chunk_free((volt_bytecode_chunk_t*) vchunk);
+}
+
+size_t volt_bytecode_emit(volt_bytecode_chunk_t* chunk, volt_instruction_t instruction,
+                          size_t line) {
+    if (chunk->code_size >= chunk->code_capacity) {
+        size_t              new_capacity = chunk->code_capacity * 2;
+        volt_instruction_t* new_code =
+            chunk->allocator->realloc(chunk->code, new_capacity * sizeof(volt_instruction_t));
+        if (!new_code)
+            return SIZE_MAX;
+        chunk->code = new_code;
+
+        size_t* new_lines = chunk->allocator->realloc(chunk->lines, new_capacity * sizeof(size_t));
+        if (!new_lines)
+            return SIZE_MAX;
+        chunk->lines         = new_lines;
+        chunk->code_capacity = new_capacity;
+    }
+
+    chunk->code[chunk->code_size]  = instruction;
+    chunk->lines[chunk->code_size] = line;
+    return chunk->code_size++;
+}
+
+// Rewrites the sbx operand of the jump at `at` so it lands on `target`
+void volt_bytecode_patch_jump(volt_bytecode_chunk_t* chunk, size_t at, size_t target) {
+    int64_t            offset = (int64_t) target - (int64_t) (at + 1);
+    volt_instruction_t instr  = chunk->code[at];
+    uint32_t           bx     = (uint32_t) (offset + VOLT_BYTECODE_SBX_BIAS);
+    chunk->code[at]           = (instr & 0xFFFFu) | (bx << 16);
+}
+
+int32_t volt_bytecode_add_constant(volt_bytecode_chunk_t* chunk, volt_comptime_value_t value) {
+    for (size_t i = 0; i < chunk->constant_count; i++) {
+        if (volt_comptime_value_equals(&chunk->constants[i], &value))
+            return (int32_t) i;
+    }
+
+    if (chunk->constant_count >= UINT16_MAX)
+        return -1;
+
+    if (chunk->constant_count >= chunk->constant_capacity) {
+        size_t new_capacity = chunk->constant_capacity ? chunk->constant_capacity * 2 : 8;
+        volt_comptime_value_t* new_constants = chunk->allocator->realloc(
+            chunk->constants, new_capacity * sizeof(volt_comptime_value_t));
+        if (!new_constants)
+            return -1;
+        chunk->constants         = new_constants;
+        chunk->constant_capacity = new_capacity;
+    }
+
+    chunk->constants[chunk->constant_count] = value;
+    return (int32_t) chunk->constant_count++;
+}
+
+int32_t volt_bytecode_add_callee(volt_bytecode_chunk_t* chunk, struct volt_symbol_t* symbol) {
+    for (size_t i = 0; i < chunk->callee_count; i++) {
+        if (chunk->callees[i] == symbol)
+            return (int32_t) i;
+    }
+
+    if (chunk->callee_count >= UINT8_MAX)
+        return -1;
+
+    if (chunk->callee_count >= chunk->callee_capacity) {
+        size_t                 new_capacity = chunk->callee_capacity ? chunk->callee_capacity * 2 : 4;
+        struct volt_symbol_t** new_callees  = chunk->allocator->realloc(
+            chunk->callees, new_capacity * sizeof(struct volt_symbol_t*));
+        if (!new_callees)
+            return -1;
+        chunk->callees         = new_callees;
+        chunk->callee_capacity = new_capacity;
+    }
+
+    chunk->callees[chunk->callee_count] = symbol;
+    return (int32_t) chunk->callee_count++;
+}
+
+const char* volt_opcode_to_string(volt_opcode_t op) {
+    switch (op) {
+#define VOLT_OPCODE_NAME(name) \
+    case VOLT_OP_##name:       \
+        return #name;
+        VOLT_OPCODE_LIST(VOLT_OPCODE_NAME)
+#undef VOLT_OPCODE_NAME
+        default:
+            return "UNKNOWN_OPCODE";
+    }
+}
+
+void volt_bytecode_disassemble(volt_bytecode_chunk_t* chunk) {
+    printf("== %s (params: %u, registers: %u) ==\n", chunk->name, chunk->param_count,
+           chunk->register_count);
+    for (size_t i = 0; i < chunk->code_size; i++) {
+        volt_instruction_t instr = chunk->code[i];
+        volt_opcode_t      op    = VOLT_INSTR_OP(instr);
+        printf("%04zu  [line %4zu]  %-9s", i, chunk->lines[i], volt_opcode_to_string(op));
+
+        switch (op) {
+            case VOLT_OP_LOADK:
+                printf(" r%u k%u\n", VOLT_INSTR_A(instr), VOLT_INSTR_BX(instr));
+                break;
+            case VOLT_OP_LOADI:
+                printf(" r%u %d\n", VOLT_INSTR_A(instr), VOLT_INSTR_SBX(instr));
+                break;
+            case VOLT_OP_JMP:
+            case VOLT_OP_JMPF:
+            case VOLT_OP_JMPT:
+            case VOLT_OP_FORPREP:
+            case VOLT_OP_FORLOOP:
+                printf(" r%u -> %04lld\n", VOLT_INSTR_A(instr),
+                       (long long) i + 1 + VOLT_INSTR_SBX(instr));
+                break;
+            default:
+                printf(" r%u r%u r%u\n", VOLT_INSTR_A(instr), VOLT_INSTR_B(instr),
+                       VOLT_INSTR_C(instr));
+                break;
+        }
+    }
+}
+
+// VALUES
+
+bool volt_comptime_value_equals(const volt_comptime_value_t* a, const volt_comptime_value_t* b) {
+    if (a->kind != b->kind)
+        return false;
+
+    switch (a->kind) {
+        case VOLT_COMPTIME_VALUE_VOID:
+        case VOLT_COMPTIME_VALUE_NULL:
+            return true;
+        case VOLT_COMPTIME_VALUE_BOOL:
+            return a->b == b->b;
+        case VOLT_COMPTIME_VALUE_INT:
+            return a->i == b->i;
+        case VOLT_COMPTIME_VALUE_FLOAT:
+            // Bitwise, so constants and memo keys treat -0.0 and NaN payloads as distinct
+            return memcmp(&a->f, &b->f, sizeof(float64_t)) == 0;
+        case VOLT_COMPTIME_VALUE_TYPE:
+            return a->type == b->type;
+    }
+
+    return false;
+}
+
+bool volt_comptime_value_truthy(const volt_comptime_value_t* value) {
+    switch (value->kind) {
+        case VOLT_COMPTIME_VALUE_BOOL:
+            return value->b;
+        case VOLT_COMPTIME_VALUE_INT:
+            return value->i != 0;
+        case VOLT_COMPTIME_VALUE_FLOAT:
+            return value->f != 0.0;
+        case VOLT_COMPTIME_VALUE_TYPE:
+            return value->type != NULL;
+        case VOLT_COMPTIME_VALUE_VOID:
+        case VOLT_COMPTIME_VALUE_NULL:
+            return false;
+    }
+
+    return false;
+}
+
+uint64_t volt_comptime_value_hash(const volt_comptime_value_t* value) {
+    uint64_t bits = 0;
+    switch (value->kind) {
+        case VOLT_COMPTIME_VALUE_BOOL:
+            bits = value->b ? 1u : 0u;
+            break;
+        case VOLT_COMPTIME_VALUE_INT:
+            bits = (uint64_t) value->i;
+            break;
+        case VOLT_COMPTIME_VALUE_FLOAT:
+            memcpy(&bits, &value->f, sizeof(bits));
+            break;
+        case VOLT_COMPTIME_VALUE_TYPE:
+            bits = (uint64_t) (uintptr_t) value->type;
+            break;
+        case VOLT_COMPTIME_VALUE_VOID:
+        case VOLT_COMPTIME_VALUE_NULL:
+            break;
+    }
+
+    // splitmix64 finalizer
+    bits ^= (uint64_t) value->kind * 0x9E3779B97F4A7C15ull;
+    bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ull;
+    bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBull;
+    return bits ^ (bits >> 31);
+}
+
+const char* volt_comptime_value_kind_to_string(volt_comptime_value_kind_t kind) {
+    switch (kind) {
+        case VOLT_COMPTIME_VALUE_VOID:
+            return "void";
+        case VOLT_COMPTIME_VALUE_NULL:
+            return "null";
+        case VOLT_COMPTIME_VALUE_BOOL:
+            return "bool";
+        case VOLT_COMPTIME_VALUE_INT:
+            return "integer";
+        case VOLT_COMPTIME_VALUE_FLOAT:
+            return "float";
+        case VOLT_COMPTIME_VALUE_TYPE:
+            return "type";
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,948 @@
+#include <comptime/compiler.h>
+#include <errno.h>
+#include <pch.h>
+#include <semantic/analyzer.h>
+
+// Jump lists: a pending break/continue stores (previous pending index + 1) in its bx operand
+// until the loop knows its targets, so nesting depth and jump count are unbounded.
+#define VOLT_JUMP_LIST_END SIZE_MAX
+
+typedef struct volt_comptime_local_t volt_comptime_local_t;
+struct volt_comptime_local_t {
+    const char* name;
+    uint8_t     reg;
+    bool        is_mutable;
+};
+
+typedef struct volt_comptime_loop_t volt_comptime_loop_t;
+struct volt_comptime_loop_t {
+    const char*           label;
+    size_t                breaks;     // Head of the pending break jump list
+    size_t                continues;  // Head of the pending continue jump list
+    volt_comptime_loop_t* enclosing;
+};
+
+typedef struct volt_comptime_compiler_t volt_comptime_compiler_t;
+struct volt_comptime_compiler_t {
+    volt_comptime_t*       ctx;
+    volt_bytecode_chunk_t* chunk;
+
+    const volt_comptime_binding_t* bindings;
+    size_t                         binding_count;
+
+    volt_comptime_local_t locals[VOLT_BYTECODE_MAX_REGISTERS];
+    size_t                local_count;
+    uint8_t               free_reg;  // Registers below this are live
+
+    volt_comptime_loop_t* loop;  // Innermost loop
+    size_t                line;
+    bool                  failed;
+};
+
+static bool volt_comptime_compile_expr(volt_comptime_compiler_t*, volt_ast_node_t*, uint8_t);
+static bool volt_comptime_compile_block(volt_comptime_compiler_t*, volt_ast_node_t*);
+
+// HELPERS
+
+static bool volt_comptime_fail(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                               const char* message, const char* detail) {
+    if (!c->failed) {
+        if (detail)
+            volt_comptime_set_error(c->ctx, node, message, detail);
+        else
+            volt_comptime_set_error(c->ctx, node, "%s", message);
+    }
+    c->failed = true;
+    return false;
+}
+
+static void volt_comptime_track_line(volt_comptime_compiler_t* c, volt_ast_node_t* node) {
+    volt_token_t* token = volt_ast_first_token(node);
+    if (token)
+        c->line = token->line;
+}
+
+static size_t volt_comptime_emit(volt_comptime_compiler_t* c, volt_instruction_t instr) {
+    size_t at = volt_bytecode_emit(c->chunk, instr, c->line);
+    if (at == SIZE_MAX)
+        volt_comptime_fail(c, NULL, "out of memory while compiling comptime code", NULL);
+    return at;
+}
+
+static bool volt_comptime_reserve(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                  uint8_t* out) {
+    if (c->free_reg >= VOLT_BYTECODE_MAX_REGISTERS - 1)
+        return volt_comptime_fail(c, node, "comptime function '%s' needs too many registers",
+                                  c->chunk->name);
+    *out = c->free_reg++;
+    if (c->free_reg > c->chunk->register_count)
+        c->chunk->register_count = c->free_reg;
+    return true;
+}
+
+static bool volt_comptime_patch(volt_comptime_compiler_t* c, size_t at, size_t target) {
+    int64_t offset = (int64_t) target - (int64_t) (at + 1);
+    if (offset < VOLT_BYTECODE_SBX_MIN || offset > VOLT_BYTECODE_SBX_MAX)
+        return volt_comptime_fail(c, NULL, "comptime function '%s' is too large", c->chunk->name);
+    volt_bytecode_patch_jump(c->chunk, at, target);
+    return true;
+}
+
+static size_t volt_comptime_emit_pending_jump(volt_comptime_compiler_t* c, volt_opcode_t op,
+                                              uint8_t reg, size_t* list) {
+    size_t link = *list == VOLT_JUMP_LIST_END ? 0 : *list + 1;
+    if (link > UINT16_MAX) {
+        volt_comptime_fail(c, NULL, "comptime function '%s' is too large", c->chunk->name);
+        return SIZE_MAX;
+    }
+    size_t at = volt_comptime_emit(c, VOLT_INSTR_ABX(op, reg, link));
+    if (at != SIZE_MAX)
+        *list = at;
+    return at;
+}
+
+static bool volt_comptime_patch_list(volt_comptime_compiler_t* c, size_t list, size_t target) {
+    while (list != VOLT_JUMP_LIST_END) {
+        uint16_t link = VOLT_INSTR_BX(c->chunk->code[list]);
+        if (!volt_comptime_patch(c, list, target))
+            return false;
+        list = link == 0 ? VOLT_JUMP_LIST_END : (size_t) link - 1;
+    }
+    return true;
+}
+
+static bool volt_comptime_load_constant(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                        uint8_t dst, volt_comptime_value_t value) {
+    if (value.kind == VOLT_COMPTIME_VALUE_INT && value.i >= VOLT_BYTECODE_SBX_MIN &&
+        value.i <= VOLT_BYTECODE_SBX_MAX) {
+        return volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_LOADI, dst,
+                                                    value.i + VOLT_BYTECODE_SBX_BIAS)) != SIZE_MAX;
+    }
+    if (value.kind == VOLT_COMPTIME_VALUE_BOOL)
+        return volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_LOADBOOL, dst, value.b, 0)) !=
+               SIZE_MAX;
+    if (value.kind == VOLT_COMPTIME_VALUE_NULL)
+        return volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_LOADNULL, dst, 0, 0)) != SIZE_MAX;
+
+    int32_t index = volt_bytecode_add_constant(c->chunk, value);
+    if (index < 0)
+        return volt_comptime_fail(c, node, "too many constants in comptime function '%s'",
+                                  c->chunk->name);
+    return volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_LOADK, dst, index)) != SIZE_MAX;
+}
+
+static volt_comptime_local_t* volt_comptime_find_local(volt_comptime_compiler_t* c,
+                                                       const char*               name) {
+    for (size_t i = c->local_count; i-- > 0;) {
+        if (strcmp(c->locals[i].name, name) == 0)
+            return &c->locals[i];
+    }
+    return NULL;
+}
+
+static bool volt_comptime_declare_local(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                        const char* name, uint8_t reg, bool is_mutable) {
+    if (c->local_count >= VOLT_BYTECODE_MAX_REGISTERS)
+        return volt_comptime_fail(c, node, "too many locals in comptime function '%s'",
+                                  c->chunk->name);
+    c->locals[c->local_count++] = (volt_comptime_local_t) {name, reg, is_mutable};
+    return true;
+}
+
+static volt_opcode_t volt_comptime_binary_opcode(volt_token_type_t type) {
+    switch (type) {
+        case VOLT_TOKEN_TYPE_PLUS:
+        case VOLT_TOKEN_TYPE_PLUS_EQUAL:
+            return VOLT_OP_ADD;
+        case VOLT_TOKEN_TYPE_TACK:
+        case VOLT_TOKEN_TYPE_TACK_EQUAL:
+            return VOLT_OP_SUB;
+        case VOLT_TOKEN_TYPE_STAR:
+        case VOLT_TOKEN_TYPE_STAR_EQUAL:
+            return VOLT_OP_MUL;
+        case VOLT_TOKEN_TYPE_SLASH:
+        case VOLT_TOKEN_TYPE_SLASH_EQUAL:
+            return VOLT_OP_DIV;
+        case VOLT_TOKEN_TYPE_PERCENT:
+        case VOLT_TOKEN_TYPE_PERCENT_EQUAL:
+            return VOLT_OP_MOD;
+        case VOLT_TOKEN_TYPE_AMPERSAND:
+        case VOLT_TOKEN_TYPE_AMPERSAND_EQUAL:
+            return VOLT_OP_BAND;
+        case VOLT_TOKEN_TYPE_BAR:
+        case VOLT_TOKEN_TYPE_BAR_EQUAL:
+            return VOLT_OP_BOR;
+        case VOLT_TOKEN_TYPE_CARET:
+        case VOLT_TOKEN_TYPE_CARET_EQUAL:
+            return VOLT_OP_BXOR;
+        case VOLT_TOKEN_TYPE_LANGLE_LANGLE:
+        case VOLT_TOKEN_TYPE_LANGLE_LANGLE_EQUAL:
+            return VOLT_OP_SHL;
+        case VOLT_TOKEN_TYPE_RANGLE_RANGLE:
+        case VOLT_TOKEN_TYPE_RANGLE_RANGLE_EQUAL:
+            return VOLT_OP_SHR;
+        case VOLT_TOKEN_TYPE_EQUAL_EQUAL:
+            return VOLT_OP_EQ;
+        case VOLT_TOKEN_TYPE_BANG_EQUAL:
+            return VOLT_OP_NE;
+        case VOLT_TOKEN_TYPE_LANGLE:
+            return VOLT_OP_LT;
+        case VOLT_TOKEN_TYPE_LANGLE_EQUAL:
+            return VOLT_OP_LE;
+        case VOLT_TOKEN_TYPE_RANGLE:
+            return VOLT_OP_GT;
+        case VOLT_TOKEN_TYPE_RANGLE_EQUAL:
+            return VOLT_OP_GE;
+        default:
+            return VOLT_OP_COUNT;
+    }
+}
+
+// Binary precedence levels all share the `x ::= operand x_rest` shape
+static bool volt_comptime_is_binary_level(volt_ast_node_t* node) {
+    static const char* levels[] = {
+        "logical_or_expr", "logical_and_expr", "bitwise_or_expr",     "bitwise_xor_expr",
+        "bitwise_and_expr", "equality_expr",   "relational_expr",     "shift_expr",
+        "additive_expr",    "multiplicative_expr",
+    };
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        if (volt_ast_is(node, levels[i]))
+            return true;
+    }
+    return false;
+}
+
+// EXPRESSIONS
+
+static bool volt_comptime_compile_literal(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                          uint8_t dst) {
+    volt_ast_node_t*      token_node = volt_ast_get_child(node, 0);
+    volt_token_t*         token      = token_node ? token_node->token : NULL;
+    volt_comptime_value_t value      = {.kind = VOLT_COMPTIME_VALUE_NULL};
+
+    if (!token)
+        return volt_comptime_fail(c, node, "malformed literal", NULL);
+
+    switch (token->type) {
+        case VOLT_TOKEN_TYPE_NUMBER_LITERAL:
+            errno = 0;
+            if (strchr(token->lexeme, '.')) {
+                value.kind = VOLT_COMPTIME_VALUE_FLOAT;
+                value.f    = strtod(token->lexeme, NULL);
+            } else {
+                value.kind = VOLT_COMPTIME_VALUE_INT;
+                value.i    = strtoll(token->lexeme, NULL, 10);
+            }
+            if (errno == ERANGE)
+                return volt_comptime_fail(c, node, "numeric literal '%s' is out of range",
+                                          token->lexeme);
+            break;
+        case VOLT_TOKEN_TYPE_TRUE_KW:
+        case VOLT_TOKEN_TYPE_FALSE_KW:
+            value.kind = VOLT_COMPTIME_VALUE_BOOL;
+            value.b    = token->type == VOLT_TOKEN_TYPE_TRUE_KW;
+            break;
+        case VOLT_TOKEN_TYPE_NULL_KW:
+            break;
+        default:
+            return volt_comptime_fail(c, node, "'%s' literals are not supported in comptime code",
+                                      volt_token_type_to_string(token->type));
+    }
+
+    return volt_comptime_load_constant(c, node, dst, value);
+}
+
+static bool volt_comptime_compile_identifier(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                             const char* name, uint8_t dst) {
+    volt_comptime_local_t* local = volt_comptime_find_local(c, name);
+    if (local) {
+        if (local->reg == dst)
+            return true;
+        return volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_MOVE, dst, local->reg, 0)) != SIZE_MAX;
+    }
+
+    for (size_t i = 0; i < c->binding_count; i++) {
+        if (strcmp(c->bindings[i].name, name) == 0)
+            return volt_comptime_load_constant(c, node, dst, c->bindings[i].value);
+    }
+
+    volt_semantic_analyzer_t* analyzer = c->ctx->analyzer;
+    volt_symbol_t*            symbol   = analyzer ? volt_scope_lookup(analyzer->global_scope, name,
+                                                                      false)
+                                                  : NULL;
+    if (symbol && symbol->kind == VOLT_SYMBOL_TYPE) {
+        volt_comptime_value_t value = {.kind = VOLT_COMPTIME_VALUE_TYPE};
+        value.type                  = symbol->type;
+        return volt_comptime_load_constant(c, node, dst, value);
+    }
+
+    return volt_comptime_fail(c, node, "'%s' is not known at compile time", name);
+}
+
+// Register window: callee parameters land in consecutive registers starting at `base`, which is
+// also where the result comes back.
+static bool volt_comptime_compile_call(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                       const char* name, volt_ast_node_t* args, uint8_t dst) {
+    volt_vector_t arg_nodes = volt_vector_default();
+    size_t        argc      = volt_ast_collect_list(args, "expression", &arg_nodes);
+    bool          ok        = false;
+
+    volt_semantic_analyzer_t* analyzer = c->ctx->analyzer;
+    volt_symbol_t*            callee   = analyzer ? volt_scope_lookup_function(
+                                                        analyzer->global_scope, name, argc)
+                                                  : NULL;
+    if (!callee) {
+        volt_comptime_fail(c, node, "no function '%s' with a matching signature is callable at "
+                                    "compile time",
+                           name);
+        goto done;
+    }
+    if (callee->is_extern) {
+        volt_comptime_fail(c, node, "cannot call extern function '%s' at compile time", name);
+        goto done;
+    }
+
+    int32_t callee_index = volt_bytecode_add_callee(c->chunk, callee);
+    if (callee_index < 0) {
+        volt_comptime_fail(c, node, "too many callees in comptime function '%s'", c->chunk->name);
+        goto done;
+    }
+
+    uint8_t saved = c->free_reg;
+    uint8_t base  = c->free_reg;
+    for (size_t i = 0; i < argc; i++) {
+        uint8_t reg;
+        if (!volt_comptime_reserve(c, node, &reg) ||
+            !volt_comptime_compile_expr(c, volt_vector_get(&arg_nodes, i), reg))
+            goto done;
+    }
+    if (argc == 0 && !volt_comptime_reserve(c, node, &base))
+        goto done;
+
+    volt_comptime_track_line(c, node);
+    if (volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_CALL, base, callee_index, argc)) == SIZE_MAX)
+        goto done;
+    if (dst != base &&
+        volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_MOVE, dst, base, 0)) == SIZE_MAX)
+        goto done;
+
+    c->free_reg = saved;
+    ok          = true;
+
+done:
+    volt_vector_deinit(&arg_nodes);
+    return ok;
+}
+
+static volt_comptime_local_t* volt_comptime_assignable(volt_comptime_compiler_t* c,
+                                                       volt_ast_node_t*          target) {
+    target = volt_ast_unwrap(target);
+    if (!volt_ast_is(target, "primary_expr")) {
+        volt_comptime_fail(c, target, "only local variables can be assigned in comptime code",
+                           NULL);
+        return NULL;
+    }
+
+    const char*            name  = volt_ast_get_identifier(target);
+    volt_comptime_local_t* local = name ? volt_comptime_find_local(c, name) : NULL;
+    if (!local) {
+        volt_comptime_fail(c, target, "'%s' is not a local variable", name ? name : "this");
+        return NULL;
+    }
+    if (!local->is_mutable) {
+        volt_comptime_fail(c, target, "cannot assign to immutable '%s'", name);
+        return NULL;
+    }
+    return local;
+}
+
+static bool volt_comptime_compile_assignment(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                             uint8_t dst) {
+    volt_ast_node_t* rest  = volt_ast_get_child(node, 1);
+    volt_ast_node_t* op    = volt_ast_get_child(rest, 0);
+    volt_ast_node_t* value = volt_ast_get_child(rest, 1);
+
+    volt_comptime_local_t* local = volt_comptime_assignable(c, volt_ast_get_child(node, 0));
+    if (!local)
+        return false;
+
+    uint8_t saved = c->free_reg;
+    uint8_t tmp;
+    if (!volt_comptime_reserve(c, node, &tmp) || !volt_comptime_compile_expr(c, value, tmp))
+        return false;
+
+    volt_token_type_t op_type = volt_ast_get_child(op, 0)->token->type;
+    if (op_type == VOLT_TOKEN_TYPE_EQUAL) {
+        if (volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_MOVE, local->reg, tmp, 0)) == SIZE_MAX)
+            return false;
+    } else {
+        volt_opcode_t opcode = volt_comptime_binary_opcode(op_type);
+        if (volt_comptime_emit(c, VOLT_INSTR_ABC(opcode, local->reg, local->reg, tmp)) == SIZE_MAX)
+            return false;
+    }
+    c->free_reg = saved;
+
+    if (dst != local->reg)
+        return volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_MOVE, dst, local->reg, 0)) != SIZE_MAX;
+    return true;
+}
+
+// `a && b` / `a || b`: the result register doubles as the short-circuit flag
+static bool volt_comptime_compile_logical(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                          uint8_t dst, bool is_or) {
+    if (!volt_comptime_compile_expr(c, volt_ast_get_child(node, 0), dst))
+        return false;
+
+    size_t           exits = VOLT_JUMP_LIST_END;
+    volt_ast_node_t* rest  = volt_ast_get_child(node, 1);
+    if (rest && rest->children.size > 0) {
+        volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_NOT, dst, dst, 0));
+        volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_NOT, dst, dst, 0));
+    }
+
+    while (rest && rest->children.size > 0) {
+        if (volt_comptime_emit_pending_jump(c, is_or ? VOLT_OP_JMPT : VOLT_OP_JMPF, dst,
+                                            &exits) == SIZE_MAX)
+            return false;
+
+        if (!volt_comptime_compile_expr(c, volt_ast_get_child(rest, 1), dst))
+            return false;
+        volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_NOT, dst, dst, 0));
+        volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_NOT, dst, dst, 0));
+        rest = volt_ast_get_child(rest, 2);
+    }
+
+    return volt_comptime_patch_list(c, exits, c->chunk->code_size);
+}
+
+static bool volt_comptime_compile_binary(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                         uint8_t dst) {
+    if (volt_ast_is(node, "logical_or_expr"))
+        return volt_comptime_compile_logical(c, node, dst, true);
+    if (volt_ast_is(node, "logical_and_expr"))
+        return volt_comptime_compile_logical(c, node, dst, false);
+
+    if (!volt_comptime_compile_expr(c, volt_ast_get_child(node, 0), dst))
+        return false;
+
+    uint8_t saved = c->free_reg;
+    uint8_t tmp;
+    if (!volt_comptime_reserve(c, node, &tmp))
+        return false;
+
+    volt_ast_node_t* rest = volt_ast_get_child(node, 1);
+    while (rest && rest->children.size > 0) {
+        volt_ast_node_t* op     = volt_ast_get_child(rest, 0);
+        volt_opcode_t    opcode = volt_comptime_binary_opcode(op->token->type);
+        if (opcode == VOLT_OP_COUNT)
+            return volt_comptime_fail(c, op, "operator '%s' is not supported in comptime code",
+                                      op->token->lexeme);
+
+        if (!volt_comptime_compile_expr(c, volt_ast_get_child(rest, 1), tmp))
+            return false;
+        volt_comptime_track_line(c, op);
+        if (volt_comptime_emit(c, VOLT_INSTR_ABC(opcode, dst, dst, tmp)) == SIZE_MAX)
+            return false;
+        rest = volt_ast_get_child(rest, 2);
+    }
+
+    c->free_reg = saved;
+    return true;
+}
+
+static bool volt_comptime_compile_increment(volt_comptime_compiler_t* c, volt_ast_node_t* target,
+                                            volt_token_type_t op, bool is_prefix, uint8_t dst) {
+    volt_comptime_local_t* local = volt_comptime_assignable(c, target);
+    if (!local)
+        return false;
+
+    uint8_t delta = op == VOLT_TOKEN_TYPE_PLUS_PLUS ? 1 : (uint8_t) 0xFF;  // (int8_t) -1
+    if (!is_prefix && dst != local->reg &&
+        volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_MOVE, dst, local->reg, 0)) == SIZE_MAX)
+        return false;
+    if (volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_ADDI, local->reg, local->reg, delta)) ==
+        SIZE_MAX)
+        return false;
+    if (is_prefix && dst != local->reg)
+        return volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_MOVE, dst, local->reg, 0)) != SIZE_MAX;
+    return true;
+}
+
+static bool volt_comptime_compile_unary(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                        uint8_t dst) {
+    volt_ast_node_t* op      = volt_ast_get_child(node, 0);
+    volt_ast_node_t* operand = volt_ast_get_child(node, 1);
+
+    if (op->type == VOLT_AST_NODE_TOKEN)  // try
+        return volt_comptime_fail(c, node, "'try' is not supported in comptime code", NULL);
+
+    volt_token_t* token = volt_ast_get_child(op, 0)->token;
+    volt_opcode_t opcode;
+    switch (token->type) {
+        case VOLT_TOKEN_TYPE_TACK:
+            opcode = VOLT_OP_NEG;
+            break;
+        case VOLT_TOKEN_TYPE_BANG:
+            opcode = VOLT_OP_NOT;
+            break;
+        case VOLT_TOKEN_TYPE_TILDE:
+            opcode = VOLT_OP_BNOT;
+            break;
+        case VOLT_TOKEN_TYPE_PLUS_PLUS:
+        case VOLT_TOKEN_TYPE_TACK_TACK:
+            return volt_comptime_compile_increment(c, operand, token->type, true, dst);
+        default:
+            return volt_comptime_fail(c, node, "unary '%s' is not supported in comptime code",
+                                      token->lexeme);
+    }
+
+    if (!volt_comptime_compile_expr(c, operand, dst))
+        return false;
+    return volt_comptime_emit(c, VOLT_INSTR_ABC(opcode, dst, dst, 0)) != SIZE_MAX;
+}
+
+static bool volt_comptime_compile_postfix(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                          uint8_t dst) {
+    volt_ast_node_t* primary = volt_ast_get_child(node, 0);
+    volt_vector_t    ops     = volt_vector_default();
+    size_t           count   = volt_ast_collect_list(volt_ast_get_child(node, 1), "postfix_op", &ops);
+    volt_ast_node_t* op      = count == 1 ? volt_ast_get_child(volt_vector_get(&ops, 0), 0) : NULL;
+    volt_vector_deinit(&ops);
+
+    if (op && op->type == VOLT_AST_NODE_TOKEN)
+        return volt_comptime_compile_increment(c, primary, op->token->type, false, dst);
+
+    const char* name = volt_ast_get_identifier(primary);
+    if (op && name && volt_ast_is(op, "call") && !volt_ast_find_child(op, "generic_args"))
+        return volt_comptime_compile_call(c, node, name, volt_ast_find_child(op, "args"), dst);
+
+    return volt_comptime_fail(c, node,
+                              "only direct calls and increments are supported as postfix "
+                              "operations in comptime code",
+                              NULL);
+}
+
+static bool volt_comptime_compile_expr(volt_comptime_compiler_t* c, volt_ast_node_t* node,
+                                       uint8_t dst) {
+    if (c->failed)
+        return false;
+
+    node = volt_ast_unwrap(node);
+    if (!node)
+        return volt_comptime_fail(c, NULL, "missing expression", NULL);
+    volt_comptime_track_line(c, node);
+
+    if (volt_ast_is(node, "assignment_expr"))
+        return volt_comptime_compile_assignment(c, node, dst);
+    if (volt_comptime_is_binary_level(node))
+        return volt_comptime_compile_binary(c, node, dst);
+    if (volt_ast_is(node, "unary_expr"))
+        return volt_comptime_compile_unary(c, node, dst);
+    if (volt_ast_is(node, "postfix_expr"))
+        return volt_comptime_compile_postfix(c, node, dst);
+    if (volt_ast_is(node, "literal"))
+        return volt_comptime_compile_literal(c, node, dst);
+    if (volt_ast_is(node, "paren_expr"))
+        return volt_comptime_compile_expr(c, volt_ast_find_child(node, "expression"), dst);
+    if (volt_ast_is(node, "comptime_fn_call"))
+        return volt_comptime_compile_call(c, node, volt_ast_get_identifier(node),
+                                          volt_ast_find_child(node, "args"), dst);
+
+    if (volt_ast_is(node, "primitive_type")) {
+        volt_comptime_value_t value = {.kind = VOLT_COMPTIME_VALUE_TYPE};
+        value.type                  = volt_type_from_ast(c->ctx->analyzer, node);
+        return volt_comptime_load_constant(c, node, dst, value);
+    }
+
+    if (volt_ast_is(node, "primary_expr")) {
+        const char* name = volt_ast_get_identifier(node);
+        if (name)
+            return volt_comptime_compile_identifier(c, node, name, dst);
+    }
+
+    if (volt_ast_is(node, "range_expr"))
+        return volt_comptime_fail(c, node, "ranges can only be iterated in comptime code", NULL);
+
+    return volt_comptime_fail(c, node, "'%s' is not supported in comptime code",
+                              node->type == VOLT_AST_NODE_TOKEN ? node->token->lexeme
+                                                                : node->expression_name);
+}
+
+// STATEMENTS
+
+static bool volt_comptime_compile_var_decl(volt_comptime_compiler_t* c, volt_ast_node_t* node) {
+    const char* name = volt_ast_get_identifier(node);
+    uint8_t     reg;
+    if (!volt_comptime_reserve(c, node, &reg))
+        return false;
+
+    // The initializer is compiled before the name is visible, so `var x = x + 1` sees the outer x
+    volt_ast_node_t* init = volt_ast_find_child(node, "expression");
+    if (init) {
+        if (!volt_comptime_compile_expr(c, init, reg))
+            return false;
+    } else if (volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_LOADNULL, reg, 0, 0)) == SIZE_MAX) {
+        return false;
+    }
+
+    bool is_mutable = !volt_ast_is(node, "val_decl");
+    return volt_comptime_declare_local(c, node, name, reg, is_mutable);
+}
+
+static volt_comptime_loop_t* volt_comptime_find_loop(volt_comptime_compiler_t* c,
+                                                     volt_ast_node_t*          node) {
+    const char* label = volt_ast_get_identifier(node);
+    for (volt_comptime_loop_t* loop = c->loop; loop; loop = loop->enclosing) {
+        if (!label || (loop->label && strcmp(loop->label, label) == 0))
+            return loop;
+    }
+
+    if (label)
+        volt_comptime_fail(c, node, "no enclosing loop labeled '%s'", label);
+    else
+        volt_comptime_fail(c, node, "break/continue outside of a loop", NULL);
+    return NULL;
+}
+
+static const char* volt_comptime_loop_label(volt_ast_node_t* node) {
+    return volt_ast_get_identifier(volt_ast_find_child(node, "label"));
+}
+
+static bool volt_comptime_end_loop(volt_comptime_compiler_t* c, volt_comptime_loop_t* loop,
+                                   size_t continue_target, size_t exit_target) {
+    c->loop = loop->enclosing;
+    return volt_comptime_patch_list(c, loop->continues, continue_target) &&
+           volt_comptime_patch_list(c, loop->breaks, exit_target);
+}
+
+static bool volt_comptime_compile_if(volt_comptime_compiler_t* c, volt_ast_node_t* node) {
+    uint8_t saved = c->free_reg;
+    uint8_t cond;
+    if (!volt_comptime_reserve(c, node, &cond) ||
+        !volt_comptime_compile_expr(c, volt_ast_find_child(node, "expression"), cond))
+        return false;
+    c->free_reg = saved;
+
+    size_t skip_then =
+        volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_JMPF, cond, VOLT_BYTECODE_SBX_BIAS));
+    if (skip_then == SIZE_MAX || !volt_comptime_compile_block(c, volt_ast_find_child(node, "block")))
+        return false;
+
+    volt_ast_node_t* else_clause = volt_ast_find_child(node, "else_clause");
+    if (!else_clause)
+        return volt_comptime_patch(c, skip_then, c->chunk->code_size);
+
+    size_t skip_else = volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_JMP, 0, VOLT_BYTECODE_SBX_BIAS));
+    if (skip_else == SIZE_MAX || !volt_comptime_patch(c, skip_then, c->chunk->code_size))
+        return false;
+
+    volt_ast_node_t* branch = volt_ast_get_child(else_clause, 0);
+    bool             ok     = volt_ast_is(branch, "if_stmt") ? volt_comptime_compile_if(c, branch)
+                                                             : volt_comptime_compile_block(c, branch);
+    return ok && volt_comptime_patch(c, skip_else, c->chunk->code_size);
+}
+
+static bool volt_comptime_compile_while(volt_comptime_compiler_t* c, volt_ast_node_t* node) {
+    volt_comptime_loop_t loop = {volt_comptime_loop_label(node), VOLT_JUMP_LIST_END,
+                                 VOLT_JUMP_LIST_END, c->loop};
+    size_t               start = c->chunk->code_size;
+
+    uint8_t saved = c->free_reg;
+    uint8_t cond;
+    if (!volt_comptime_reserve(c, node, &cond) ||
+        !volt_comptime_compile_expr(c, volt_ast_find_child(node, "expression"), cond))
+        return false;
+    c->free_reg = saved;
+
+    size_t exit = volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_JMPF, cond, VOLT_BYTECODE_SBX_BIAS));
+    if (exit == SIZE_MAX)
+        return false;
+
+    c->loop = &loop;
+    if (!volt_comptime_compile_block(c, volt_ast_find_child(node, "block")))
+        return false;
+
+    size_t back = volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_JMP, 0, VOLT_BYTECODE_SBX_BIAS));
+    return back != SIZE_MAX && volt_comptime_patch(c, back, start) &&
+           volt_comptime_patch(c, exit, c->chunk->code_size) &&
+           volt_comptime_end_loop(c, &loop, start, c->chunk->code_size);
+}
+
+static bool volt_comptime_compile_loop(volt_comptime_compiler_t* c, volt_ast_node_t* node) {
+    volt_comptime_loop_t loop = {volt_comptime_loop_label(node), VOLT_JUMP_LIST_END,
+                                 VOLT_JUMP_LIST_END, c->loop};
+    size_t               start = c->chunk->code_size;
+
+    c->loop = &loop;
+    if (!volt_comptime_compile_block(c, volt_ast_find_child(node, "block")))
+        return false;
+
+    size_t back = volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_JMP, 0, VOLT_BYTECODE_SBX_BIAS));
+    return back != SIZE_MAX && volt_comptime_patch(c, back, start) &&
+           volt_comptime_end_loop(c, &loop, start, c->chunk->code_size);
+}
+
+// for (value) in a..b |pre| { } / for (value, index) in a..b { }
+// Only integer ranges are iterable at compile time; they lower to FORPREP/FORLOOP over a
+// (counter, limit) register pair.
+static bool volt_comptime_compile_for(volt_comptime_compiler_t* c, volt_ast_node_t* node) {
+    if (volt_ast_find_child(node, "for_captures"))
+        return volt_comptime_fail(c, node, "loop captures are not supported in comptime code",
+                                  NULL);
+
+    volt_ast_node_t* iterable = volt_ast_find_child(node, "for_iterable_expr");
+    if (!iterable)
+        iterable = volt_ast_find_child(node, "expression");
+    iterable              = volt_ast_unwrap(iterable);
+    volt_ast_node_t* rest = volt_ast_get_child(iterable, 1);
+    if (!volt_ast_is(iterable, "range_expr") || !rest || rest->children.size == 0)
+        return volt_comptime_fail(c, node, "only integer ranges can be iterated in comptime code",
+                                  NULL);
+    bool inclusive = volt_ast_get_child(rest, 0)->token->type == VOLT_TOKEN_TYPE_DOT_DOT_EQUAL;
+
+    volt_ast_node_t* binding = volt_ast_find_child(node, "for_binding");
+    volt_vector_t    names   = volt_vector_default();
+    volt_token_t*    single  = volt_ast_find_token(binding, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    volt_ast_node_t* list    = volt_ast_find_child(binding, "identifier_list");
+    for (volt_ast_node_t* it = list; it; it = volt_ast_find_child(it, "identifier_list_rest")) {
+        volt_token_t* name = volt_ast_find_token(it, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+        if (name)
+            volt_vector_push_back(&names, (void*) name->lexeme);
+    }
+    if (single)
+        volt_vector_push_back(&names, (void*) single->lexeme);
+
+    size_t      name_count = names.size;
+    const char* value_name = name_count > 0 ? volt_vector_get(&names, 0) : NULL;
+    const char* index_name = name_count > 1 ? volt_vector_get(&names, 1) : NULL;
+    volt_vector_deinit(&names);
+    if (name_count == 0 || name_count > 2)
+        return volt_comptime_fail(c, node, "range loops bind a value and an optional index", NULL);
+
+    size_t  saved_locals = c->local_count;
+    uint8_t saved        = c->free_reg;
+    uint8_t counter, limit, index = 0, value;
+
+    if (!volt_comptime_reserve(c, node, &counter) || !volt_comptime_reserve(c, node, &limit) ||
+        !volt_comptime_compile_expr(c, volt_ast_get_child(iterable, 0), counter) ||
+        !volt_comptime_compile_expr(c, volt_ast_get_child(rest, 1), limit))
+        return false;
+    if (inclusive && volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_ADDI, limit, limit, 1)) == SIZE_MAX)
+        return false;
+    if (index_name) {
+        volt_comptime_value_t zero = {.kind = VOLT_COMPTIME_VALUE_INT};
+        if (!volt_comptime_reserve(c, node, &index) ||
+            !volt_comptime_load_constant(c, node, index, zero))
+            return false;
+    }
+    if (!volt_comptime_reserve(c, node, &value))
+        return false;
+
+    size_t prep = volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_FORPREP, counter,
+                                                       VOLT_BYTECODE_SBX_BIAS));
+    if (prep == SIZE_MAX)
+        return false;
+    size_t body = c->chunk->code_size;
+
+    if (volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_MOVE, value, counter, 0)) == SIZE_MAX ||
+        !volt_comptime_declare_local(c, node, value_name, value, true))
+        return false;
+    if (index_name && !volt_comptime_declare_local(c, node, index_name, index, false))
+        return false;
+
+    // |expr| maps the raw counter before the body sees it
+    volt_ast_node_t* pre = volt_ast_find_child(node, "for_pre_expr");
+    if (pre) {
+        uint8_t before_pre = c->free_reg;
+        uint8_t tmp;
+        if (!volt_comptime_reserve(c, pre, &tmp) ||
+            !volt_comptime_compile_expr(c, volt_ast_find_child(pre, "expression"), tmp) ||
+            volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_MOVE, value, tmp, 0)) == SIZE_MAX)
+            return false;
+        c->free_reg = before_pre;
+    }
+
+    volt_comptime_loop_t loop = {volt_comptime_loop_label(node), VOLT_JUMP_LIST_END,
+                                 VOLT_JUMP_LIST_END, c->loop};
+    c->loop                   = &loop;
+    if (!volt_comptime_compile_block(c, volt_ast_find_child(node, "block")))
+        return false;
+
+    size_t step = c->chunk->code_size;
+    if (index_name && volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_ADDI, index, index, 1)) == SIZE_MAX)
+        return false;
+    size_t back = volt_comptime_emit(c, VOLT_INSTR_ABX(VOLT_OP_FORLOOP, counter,
+                                                       VOLT_BYTECODE_SBX_BIAS));
+    if (back == SIZE_MAX || !volt_comptime_patch(c, back, body) ||
+        !volt_comptime_patch(c, prep, c->chunk->code_size) ||
+        !volt_comptime_end_loop(c, &loop, step, c->chunk->code_size))
+        return false;
+
+    c->local_count = saved_locals;
+    c->free_reg    = saved;
+    return true;
+}
+
+static bool volt_comptime_compile_statement(volt_comptime_compiler_t* c, volt_ast_node_t* node) {
+    if (c->failed)
+        return false;
+
+    volt_ast_node_t* stmt = volt_ast_is(node, "statement") ? volt_ast_get_child(node, 0) : node;
+    volt_comptime_track_line(c, stmt);
+
+    if (volt_ast_is(stmt, "var_decl") || volt_ast_is(stmt, "val_decl") ||
+        volt_ast_is(stmt, "static_decl"))
+        return volt_comptime_compile_var_decl(c, stmt);
+    if (volt_ast_is(stmt, "block"))
+        return volt_comptime_compile_block(c, stmt);
+    if (volt_ast_is(stmt, "if_stmt"))
+        return volt_comptime_compile_if(c, stmt);
+    if (volt_ast_is(stmt, "while_stmt"))
+        return volt_comptime_compile_while(c, stmt);
+    if (volt_ast_is(stmt, "loop_stmt"))
+        return volt_comptime_compile_loop(c, stmt);
+    if (volt_ast_is(stmt, "for_stmt"))
+        return volt_comptime_compile_for(c, stmt);
+
+    if (volt_ast_is(stmt, "return_stmt")) {
+        volt_ast_node_t* value = volt_ast_find_child(stmt, "expression");
+        if (!value)
+            return volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_RETNONE, 0, 0, 0)) != SIZE_MAX;
+
+        uint8_t saved = c->free_reg;
+        uint8_t reg;
+        if (!volt_comptime_reserve(c, stmt, &reg) || !volt_comptime_compile_expr(c, value, reg))
+            return false;
+        c->free_reg = saved;
+        return volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_RET, reg, 0, 0)) != SIZE_MAX;
+    }
+
+    if (volt_ast_is(stmt, "break_stmt") || volt_ast_is(stmt, "continue_stmt")) {
+        volt_comptime_loop_t* loop = volt_comptime_find_loop(c, stmt);
+        if (!loop)
+            return false;
+        size_t* list = volt_ast_is(stmt, "break_stmt") ? &loop->breaks : &loop->continues;
+        return volt_comptime_emit_pending_jump(c, VOLT_OP_JMP, 0, list) != SIZE_MAX;
+    }
+
+    if (volt_ast_is(stmt, "expr_stmt")) {
+        uint8_t saved = c->free_reg;
+        uint8_t reg;
+        if (!volt_comptime_reserve(c, stmt, &reg) ||
+            !volt_comptime_compile_expr(c, volt_ast_find_child(stmt, "expression"), reg))
+            return false;
+        c->free_reg = saved;
+        return true;
+    }
+
+    return volt_comptime_fail(c, stmt, "'%s' is not supported in comptime code",
+                              stmt ? stmt->expression_name : "statement");
+}
+
+static bool volt_comptime_compile_block(volt_comptime_compiler_t* c, volt_ast_node_t* block) {
+    size_t  saved_locals = c->local_count;
+    uint8_t saved        = c->free_reg;
+
+    volt_vector_t statements = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(block, "statements"), "statement", &statements);
+
+    bool ok = true;
+    for (size_t i = 0; i < statements.size && ok; i++)
+        ok = volt_comptime_compile_statement(c, volt_vector_get(&statements, i));
+    volt_vector_deinit(&statements);
+
+    c->local_count = saved_locals;
+    c->free_reg    = saved;
+    return ok;
+}
+
+// ENTRY POINTS
+
+volt_bytecode_chunk_t* volt_comptime_compile_function(volt_comptime_t* ctx, volt_symbol_t* symbol) {
+    if (symbol->comptime_chunk)
+        return symbol->comptime_chunk;
+
+    volt_ast_node_t* decl = symbol->declaration;
+    volt_ast_node_t* body = volt_ast_body(decl);
+    if (!body) {
+        volt_comptime_set_error(ctx, decl, "'%s' has no body to evaluate at compile time",
+                                symbol->name);
+        return NULL;
+    }
+    if (symbol->is_generic) {
+        volt_comptime_set_error(ctx, decl,
+                                "generic function '%s' cannot be evaluated at compile time yet",
+                                symbol->name);
+        return NULL;
+    }
+
+    volt_comptime_compiler_t* c = ctx->allocator->malloc(sizeof(volt_comptime_compiler_t));
+    if (!c)
+        return NULL;
+    memset(c, 0, sizeof(volt_comptime_compiler_t));
+    c->ctx   = ctx;
+    c->chunk = volt_bytecode_chunk_create(ctx->allocator, symbol->name);
+    c->loop  = NULL;
+    if (!c->chunk) {
+        ctx->allocator->free(c);
+        return NULL;
+    }
+    c->chunk->symbol = symbol;
+    volt_comptime_track_line(c, decl);
+
+    bool ok = true;
+    for (size_t i = 0; i < symbol->parameters.size && ok; i++) {
+        volt_symbol_t* param = volt_vector_get(&symbol->parameters, i);
+        uint8_t        reg;
+        ok = volt_comptime_reserve(c, param->declaration, &reg) &&
+             volt_comptime_declare_local(c, param->declaration, param->name, reg, true);
+    }
+    c->chunk->param_count = (uint8_t) symbol->parameters.size;
+
+    ok = ok && volt_comptime_compile_block(c, body) &&
+         volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_RETNONE, 0, 0, 0)) != SIZE_MAX;
+
+    volt_bytecode_chunk_t* chunk = c->chunk;
+    ctx->allocator->free(c);
+
+    if (!ok) {
+        volt_bytecode_chunk_free(chunk);
+        return NULL;
+    }
+
+    symbol->comptime_chunk = chunk;
+    volt_vector_push_back(&ctx->chunks, chunk);
+    return chunk;
+}
+
+volt_bytecode_chunk_t* volt_comptime_compile_expression(volt_comptime_t*               ctx,
+                                                        volt_ast_node_t*               expression,
+                                                        const volt_comptime_binding_t* bindings,
+                                                        size_t binding_count) {
+    volt_comptime_compiler_t* c = ctx->allocator->malloc(sizeof(volt_comptime_compiler_t));
+    if (!c)
+        return NULL;
+    memset(c, 0, sizeof(volt_comptime_compiler_t));
+    c->ctx           = ctx;
+    c->bindings      = bindings;
+    c->binding_count = binding_count;
+    c->chunk         = volt_bytecode_chunk_create(ctx->allocator, NULL);
+    if (!c->chunk) {
+        ctx->allocator->free(c);
+        return NULL;
+    }
+
+    uint8_t result = 0;
+    bool    ok     = volt_comptime_reserve(c, expression, &result) &&
+              volt_comptime_compile_expr(c, expression, result) &&
+              volt_comptime_emit(c, VOLT_INSTR_ABC(VOLT_OP_RET, result, 0, 0)) != SIZE_MAX;
+
+    volt_bytecode_chunk_t* chunk = c->chunk;
+    ctx->allocator->free(c);
+
+    if (!ok) {
+        volt_bytecode_chunk_free(chunk);
+        return NULL;
+    }
+    return chunk;
+}
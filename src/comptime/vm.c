@@ -0,0 +1,758 @@
+#include <comptime/compiler.h>
+#include <comptime/vm.h>
+#include <pch.h>
+#include <semantic/analyzer.h>
+
+// GCC and Clang support labels-as-values, which lets every handler jump straight to the next
+// one instead of bouncing through a single switch (one indirect branch per opcode site).
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(VOLT_USE_MSVC)
+#    define VOLT_COMPTIME_COMPUTED_GOTO
+#endif
+
+#define MEMO_INITIAL_CAPACITY 64
+
+// CONTEXT
+
+volt_status_code_t volt_comptime_init(volt_comptime_t* ctx, volt_semantic_analyzer_t* analyzer,
+                                      volt_allocator_t* allocator) {
+    if (!ctx)
+        return VOLT_FAILURE;
+
+    memset(ctx, 0, sizeof(volt_comptime_t));
+    ctx->allocator    = allocator ? allocator : &volt_default_allocator;
+    ctx->analyzer     = analyzer;
+    ctx->vm.max_steps = VOLT_COMPTIME_DEFAULT_MAX_STEPS;
+
+    ctx->memo.allocator = ctx->allocator;
+
+    volt_vector_t chunks  = {0};
+    chunks.allocator      = ctx->allocator;
+    chunks.item_allocator = &volt_bytecode_chunk_allocator;
+    volt_vector_init(&chunks);
+    ctx->chunks = chunks;
+
+    volt_vector_t folded  = {0};
+    folded.allocator      = ctx->allocator;
+    folded.item_allocator = ctx->allocator;
+    volt_vector_init(&folded);
+    ctx->folded = folded;
+
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_comptime_deinit(volt_comptime_t* ctx) {
+    if (!ctx)
+        return VOLT_FAILURE;
+
+    volt_allocator_t* allocator = ctx->allocator;
+
+    for (size_t i = 0; i < ctx->memo.capacity; i++) {
+        if (ctx->memo.entries[i].chunk)
+            allocator->free(ctx->memo.entries[i].args);
+    }
+    allocator->free(ctx->memo.entries);
+    allocator->free(ctx->vm.registers);
+    allocator->free(ctx->vm.frames);
+    allocator->free(ctx->vm.memo_stack);
+
+    volt_vector_deinit(&ctx->chunks);
+    volt_vector_deinit(&ctx->folded);
+
+    return VOLT_SUCCESS;
+}
+
+void volt_comptime_set_error(volt_comptime_t* ctx, volt_ast_node_t* node, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(ctx->error_message, sizeof(ctx->error_message), fmt, ap);
+    va_end(ap);
+
+    volt_token_t* token = volt_ast_first_token(node);
+    ctx->error_node     = node;
+    ctx->error_line     = token ? token->line : 0;
+}
+
+volt_comptime_value_t* volt_comptime_fold(volt_comptime_t* ctx, volt_ast_node_t* node,
+                                          volt_comptime_value_t value) {
+    volt_comptime_value_t* folded = ctx->allocator->malloc(sizeof(volt_comptime_value_t));
+    if (!folded)
+        return NULL;
+
+    *folded = value;
+    volt_vector_push_back(&ctx->folded, folded);
+    if (node)
+        node->data = folded;
+    return folded;
+}
+
+// MEMOIZATION
+
+static uint64_t volt_comptime_memo_hash(volt_bytecode_chunk_t*       chunk,
+                                        const volt_comptime_value_t* args, size_t argc) {
+    uint64_t hash = (uint64_t) (uintptr_t) chunk * 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < argc; i++)
+        hash = (hash ^ volt_comptime_value_hash(&args[i])) * 0x100000001B3ull;
+    return hash;
+}
+
+static volt_comptime_memo_entry_t* volt_comptime_memo_lookup(volt_comptime_memo_t*        memo,
+                                                             volt_bytecode_chunk_t*       chunk,
+                                                             uint64_t                     hash,
+                                                             const volt_comptime_value_t* args,
+                                                             size_t                       argc) {
+    if (memo->capacity == 0)
+        return NULL;
+
+    size_t mask = memo->capacity - 1;
+    for (size_t i = (size_t) hash & mask;; i = (i + 1) & mask) {
+        volt_comptime_memo_entry_t* entry = &memo->entries[i];
+        if (!entry->chunk)
+            return NULL;
+        if (entry->hash != hash || entry->chunk != chunk || entry->argc != argc)
+            continue;
+
+        bool same = true;
+        for (size_t a = 0; a < argc && same; a++)
+            same = volt_comptime_value_equals(&entry->args[a], &args[a]);
+        if (same)
+            return entry;
+    }
+}
+
+static volt_status_code_t volt_comptime_memo_grow(volt_comptime_memo_t* memo) {
+    size_t                      new_capacity = memo->capacity ? memo->capacity * 2
+                                                              : MEMO_INITIAL_CAPACITY;
+    volt_comptime_memo_entry_t* entries =
+        memo->allocator->malloc(new_capacity * sizeof(volt_comptime_memo_entry_t));
+    if (!entries)
+        return VOLT_FAILURE;
+    memset(entries, 0, new_capacity * sizeof(volt_comptime_memo_entry_t));
+
+    size_t mask = new_capacity - 1;
+    for (size_t i = 0; i < memo->capacity; i++) {
+        volt_comptime_memo_entry_t* old = &memo->entries[i];
+        if (!old->chunk)
+            continue;
+        size_t slot = (size_t) old->hash & mask;
+        while (entries[slot].chunk)
+            slot = (slot + 1) & mask;
+        entries[slot] = *old;
+    }
+
+    memo->allocator->free(memo->entries);
+    memo->entries  = entries;
+    memo->capacity = new_capacity;
+    return VOLT_SUCCESS;
+}
+
+static void volt_comptime_memo_insert(volt_comptime_memo_t* memo, volt_bytecode_chunk_t* chunk,
+                                      uint64_t hash, const volt_comptime_value_t* args,
+                                      uint8_t argc, volt_comptime_value_t result) {
+    // Keep the load factor under 3/4
+    if ((memo->count + 1) * 4 > memo->capacity * 3 &&
+        volt_comptime_memo_grow(memo) != VOLT_SUCCESS)
+        return;
+
+    volt_comptime_value_t* args_copy = NULL;
+    if (argc > 0) {
+        args_copy = memo->allocator->malloc(argc * sizeof(volt_comptime_value_t));
+        if (!args_copy)
+            return;
+        memcpy(args_copy, args, argc * sizeof(volt_comptime_value_t));
+    }
+
+    size_t mask = memo->capacity - 1;
+    size_t slot = (size_t) hash & mask;
+    while (memo->entries[slot].chunk)
+        slot = (slot + 1) & mask;
+
+    memo->entries[slot] = (volt_comptime_memo_entry_t) {
+        .chunk = chunk, .hash = hash, .args = args_copy, .argc = argc, .result = result};
+    memo->count++;
+}
+
+// VM STACKS
+
+static volt_status_code_t volt_comptime_vm_reserve_registers(volt_comptime_t* ctx, size_t needed) {
+    volt_comptime_vm_t* vm = &ctx->vm;
+    if (needed <= vm->register_capacity)
+        return VOLT_SUCCESS;
+
+    size_t new_capacity = vm->register_capacity ? vm->register_capacity : 256;
+    while (new_capacity < needed)
+        new_capacity *= 2;
+
+    volt_comptime_value_t* registers =
+        ctx->allocator->realloc(vm->registers, new_capacity * sizeof(volt_comptime_value_t));
+    if (!registers)
+        return VOLT_FAILURE;
+
+    vm->registers         = registers;
+    vm->register_capacity = new_capacity;
+    return VOLT_SUCCESS;
+}
+
+static volt_comptime_frame_t* volt_comptime_vm_push_frame(volt_comptime_t*       ctx,
+                                                          volt_bytecode_chunk_t* chunk,
+                                                          size_t base, const volt_comptime_value_t* args,
+                                                          uint8_t argc) {
+    volt_comptime_vm_t* vm = &ctx->vm;
+
+    if (vm->frame_count >= VOLT_COMPTIME_MAX_CALL_DEPTH) {
+        volt_comptime_set_error(ctx, NULL, "comptime call depth exceeded %u while calling '%s'",
+                                VOLT_COMPTIME_MAX_CALL_DEPTH, chunk->name);
+        return NULL;
+    }
+
+    if (vm->frame_count >= vm->frame_capacity) {
+        size_t                 new_capacity = vm->frame_capacity ? vm->frame_capacity * 2 : 16;
+        volt_comptime_frame_t* frames =
+            ctx->allocator->realloc(vm->frames, new_capacity * sizeof(volt_comptime_frame_t));
+        if (!frames)
+            return NULL;
+        vm->frames         = frames;
+        vm->frame_capacity = new_capacity;
+    }
+
+    // Snapshot the arguments: the callee may overwrite its parameter registers, but the memo
+    // key must be the values it was called with.
+    if (vm->memo_stack_size + argc > vm->memo_stack_capacity) {
+        size_t new_capacity = vm->memo_stack_capacity ? vm->memo_stack_capacity * 2 : 64;
+        while (new_capacity < vm->memo_stack_size + argc)
+            new_capacity *= 2;
+        volt_comptime_value_t* stack = ctx->allocator->realloc(
+            vm->memo_stack, new_capacity * sizeof(volt_comptime_value_t));
+        if (!stack)
+            return NULL;
+        vm->memo_stack          = stack;
+        vm->memo_stack_capacity = new_capacity;
+    }
+
+    // `args` may point into the register stack, so copy them out before it can move
+    if (argc > 0)
+        memcpy(&vm->memo_stack[vm->memo_stack_size], args, argc * sizeof(volt_comptime_value_t));
+
+    if (volt_comptime_vm_reserve_registers(ctx, base + chunk->register_count + 1) != VOLT_SUCCESS)
+        return NULL;
+
+    volt_comptime_frame_t* frame = &vm->frames[vm->frame_count++];
+    frame->chunk                 = chunk;
+    frame->ip                    = chunk->code;
+    frame->base                  = base;
+    frame->memo_args             = vm->memo_stack_size;
+    frame->argc                  = argc;
+    vm->memo_stack_size += argc;
+
+    // Parameters arrive in R[0 .. argc); everything above starts out void
+    for (size_t i = base + argc; i < base + chunk->register_count; i++)
+        vm->registers[i].kind = VOLT_COMPTIME_VALUE_VOID;
+
+    return frame;
+}
+
+// VALUE HELPERS
+
+static inline bool volt_comptime_is_number(const volt_comptime_value_t* v) {
+    return v->kind == VOLT_COMPTIME_VALUE_INT || v->kind == VOLT_COMPTIME_VALUE_FLOAT;
+}
+
+static inline float64_t volt_comptime_as_float(const volt_comptime_value_t* v) {
+    return v->kind == VOLT_COMPTIME_VALUE_FLOAT ? v->f : (float64_t) v->i;
+}
+
+static inline volt_comptime_value_t volt_comptime_int(int64_t i) {
+    volt_comptime_value_t v = {.kind = VOLT_COMPTIME_VALUE_INT};
+    v.i                     = i;
+    return v;
+}
+
+static inline volt_comptime_value_t volt_comptime_float(float64_t f) {
+    volt_comptime_value_t v = {.kind = VOLT_COMPTIME_VALUE_FLOAT};
+    v.f                     = f;
+    return v;
+}
+
+static inline volt_comptime_value_t volt_comptime_bool(bool b) {
+    volt_comptime_value_t v = {.kind = VOLT_COMPTIME_VALUE_BOOL};
+    v.b                     = b;
+    return v;
+}
+
+// Integer arithmetic wraps (two's complement) instead of invoking C undefined behaviour
+static bool volt_comptime_arith(volt_opcode_t op, const volt_comptime_value_t* a,
+                                const volt_comptime_value_t* b, volt_comptime_value_t* out,
+                                const char** error) {
+    if (a->kind == VOLT_COMPTIME_VALUE_INT && b->kind == VOLT_COMPTIME_VALUE_INT) {
+        uint64_t x = (uint64_t) a->i, y = (uint64_t) b->i;
+        switch (op) {
+            case VOLT_OP_ADD:
+                *out = volt_comptime_int((int64_t) (x + y));
+                return true;
+            case VOLT_OP_SUB:
+                *out = volt_comptime_int((int64_t) (x - y));
+                return true;
+            case VOLT_OP_MUL:
+                *out = volt_comptime_int((int64_t) (x * y));
+                return true;
+            case VOLT_OP_DIV:
+            case VOLT_OP_MOD:
+                if (b->i == 0) {
+                    *error = "division by zero";
+                    return false;
+                }
+                if (a->i == INT64_MIN && b->i == -1) {
+                    *out = volt_comptime_int(op == VOLT_OP_DIV ? INT64_MIN : 0);
+                    return true;
+                }
+                *out = volt_comptime_int(op == VOLT_OP_DIV ? a->i / b->i : a->i % b->i);
+                return true;
+            case VOLT_OP_BAND:
+                *out = volt_comptime_int((int64_t) (x & y));
+                return true;
+            case VOLT_OP_BOR:
+                *out = volt_comptime_int((int64_t) (x | y));
+                return true;
+            case VOLT_OP_BXOR:
+                *out = volt_comptime_int((int64_t) (x ^ y));
+                return true;
+            case VOLT_OP_SHL:
+            case VOLT_OP_SHR:
+                if (b->i < 0 || b->i > 63) {
+                    *error = "shift amount out of range";
+                    return false;
+                }
+                *out = volt_comptime_int(op == VOLT_OP_SHL ? (int64_t) (x << y) : a->i >> b->i);
+                return true;
+            default:
+                break;
+        }
+    }
+
+    if (volt_comptime_is_number(a) && volt_comptime_is_number(b)) {
+        float64_t x = volt_comptime_as_float(a), y = volt_comptime_as_float(b);
+        switch (op) {
+            case VOLT_OP_ADD:
+                *out = volt_comptime_float(x + y);
+                return true;
+            case VOLT_OP_SUB:
+                *out = volt_comptime_float(x - y);
+                return true;
+            case VOLT_OP_MUL:
+                *out = volt_comptime_float(x * y);
+                return true;
+            case VOLT_OP_DIV:
+                *out = volt_comptime_float(x / y);
+                return true;
+            default:
+                *error = "operator requires integer operands";
+                return false;
+        }
+    }
+
+    *error = "operands of arithmetic must be numbers";
+    return false;
+}
+
+static bool volt_comptime_compare(volt_opcode_t op, const volt_comptime_value_t* a,
+                                  const volt_comptime_value_t* b, volt_comptime_value_t* out,
+                                  const char** error) {
+    if (a->kind == VOLT_COMPTIME_VALUE_INT && b->kind == VOLT_COMPTIME_VALUE_INT) {
+        int64_t x = a->i, y = b->i;
+        bool    r = op == VOLT_OP_EQ   ? x == y
+                    : op == VOLT_OP_NE ? x != y
+                    : op == VOLT_OP_LT ? x < y
+                    : op == VOLT_OP_LE ? x <= y
+                    : op == VOLT_OP_GT ? x > y
+                                       : x >= y;
+        *out = volt_comptime_bool(r);
+        return true;
+    }
+
+    if (volt_comptime_is_number(a) && volt_comptime_is_number(b)) {
+        float64_t x = volt_comptime_as_float(a), y = volt_comptime_as_float(b);
+        bool      r = op == VOLT_OP_EQ   ? x == y
+                      : op == VOLT_OP_NE ? x != y
+                      : op == VOLT_OP_LT ? x < y
+                      : op == VOLT_OP_LE ? x <= y
+                      : op == VOLT_OP_GT ? x > y
+                                         : x >= y;
+        *out = volt_comptime_bool(r);
+        return true;
+    }
+
+    if (op == VOLT_OP_EQ || op == VOLT_OP_NE) {
+        bool equal = volt_comptime_value_equals(a, b);
+        *out       = volt_comptime_bool(op == VOLT_OP_EQ ? equal : !equal);
+        return true;
+    }
+
+    *error = "only numbers can be ordered";
+    return false;
+}
+
+// INTERPRETER
+
+volt_status_code_t volt_comptime_vm_execute(volt_comptime_t* ctx, volt_bytecode_chunk_t* chunk,
+                                            const volt_comptime_value_t* args, size_t argc,
+                                            volt_comptime_value_t* out) {
+    volt_comptime_vm_t* vm = &ctx->vm;
+
+    if (argc != chunk->param_count) {
+        volt_comptime_set_error(ctx, NULL, "'%s' expects %u argument(s), got %zu", chunk->name,
+                                chunk->param_count, argc);
+        return VOLT_FAILURE;
+    }
+
+    size_t entry_depth = vm->frame_count;
+    size_t base        = 0;
+    if (entry_depth == 0)
+        vm->steps = 0;  // The budget applies per top-level evaluation
+    if (entry_depth > 0) {
+        volt_comptime_frame_t* top = &vm->frames[entry_depth - 1];
+        base                       = top->base + top->chunk->register_count;
+    }
+
+    if (volt_comptime_vm_reserve_registers(ctx, base + chunk->register_count + 1) != VOLT_SUCCESS)
+        return VOLT_FAILURE;
+    if (argc > 0)
+        memcpy(&vm->registers[base], args, argc * sizeof(volt_comptime_value_t));
+
+    volt_comptime_frame_t* frame =
+        volt_comptime_vm_push_frame(ctx, chunk, base, args, (uint8_t) argc);
+    if (!frame)
+        return VOLT_FAILURE;
+
+    const volt_instruction_t*    ip = frame->ip;
+    volt_comptime_value_t*       R  = &vm->registers[frame->base];
+    const volt_comptime_value_t* K  = chunk->constants;
+    volt_instruction_t           instr;
+    const char*                  error = NULL;
+
+#ifdef VOLT_COMPTIME_COMPUTED_GOTO
+    static const void* dispatch_table[VOLT_OP_COUNT] = {
+#    define VOLT_OPCODE_LABEL(name) &&op_##name,
+        VOLT_OPCODE_LIST(VOLT_OPCODE_LABEL)
+#    undef VOLT_OPCODE_LABEL
+    };
+#    define VM_DISPATCH()                                  \
+        do {                                               \
+            instr = *ip++;                                 \
+            goto* dispatch_table[VOLT_INSTR_OP(instr)];    \
+        } while (0)
+#    define VM_CASE(name) op_##name:
+#    define VM_NEXT()     VM_DISPATCH()
+    VM_DISPATCH();
+#else
+#    define VM_CASE(name) case VOLT_OP_##name:
+#    define VM_NEXT()     continue
+    for (;;) {
+        instr = *ip++;
+        switch (VOLT_INSTR_OP(instr)) {
+#endif
+
+    VM_CASE(MOVE) {
+        R[VOLT_INSTR_A(instr)] = R[VOLT_INSTR_B(instr)];
+        VM_NEXT();
+    }
+    VM_CASE(LOADK) {
+        R[VOLT_INSTR_A(instr)] = K[VOLT_INSTR_BX(instr)];
+        VM_NEXT();
+    }
+    VM_CASE(LOADI) {
+        R[VOLT_INSTR_A(instr)] = volt_comptime_int(VOLT_INSTR_SBX(instr));
+        VM_NEXT();
+    }
+    VM_CASE(LOADBOOL) {
+        R[VOLT_INSTR_A(instr)] = volt_comptime_bool(VOLT_INSTR_B(instr) != 0);
+        VM_NEXT();
+    }
+    VM_CASE(LOADNULL) {
+        R[VOLT_INSTR_A(instr)].kind = VOLT_COMPTIME_VALUE_NULL;
+        VM_NEXT();
+    }
+
+    VM_CASE(ADD) {
+        volt_comptime_value_t* a = &R[VOLT_INSTR_B(instr)];
+        volt_comptime_value_t* b = &R[VOLT_INSTR_C(instr)];
+        // Fast path: the overwhelmingly common int + int case
+        if (a->kind == VOLT_COMPTIME_VALUE_INT && b->kind == VOLT_COMPTIME_VALUE_INT) {
+            R[VOLT_INSTR_A(instr)] = volt_comptime_int((int64_t) ((uint64_t) a->i + (uint64_t) b->i));
+            VM_NEXT();
+        }
+        goto op_arith;
+    }
+    VM_CASE(SUB) {
+        volt_comptime_value_t* a = &R[VOLT_INSTR_B(instr)];
+        volt_comptime_value_t* b = &R[VOLT_INSTR_C(instr)];
+        if (a->kind == VOLT_COMPTIME_VALUE_INT && b->kind == VOLT_COMPTIME_VALUE_INT) {
+            R[VOLT_INSTR_A(instr)] = volt_comptime_int((int64_t) ((uint64_t) a->i - (uint64_t) b->i));
+            VM_NEXT();
+        }
+        goto op_arith;
+    }
+    VM_CASE(MUL)
+    VM_CASE(DIV)
+    VM_CASE(MOD)
+    VM_CASE(BAND)
+    VM_CASE(BOR)
+    VM_CASE(BXOR)
+    VM_CASE(SHL)
+    VM_CASE(SHR) {
+    op_arith:;
+        volt_comptime_value_t result;
+        if (!volt_comptime_arith(VOLT_INSTR_OP(instr), &R[VOLT_INSTR_B(instr)],
+                                 &R[VOLT_INSTR_C(instr)], &result, &error))
+            goto fail;
+        R[VOLT_INSTR_A(instr)] = result;
+        VM_NEXT();
+    }
+    VM_CASE(ADDI) {
+        volt_comptime_value_t* a     = &R[VOLT_INSTR_B(instr)];
+        int64_t                delta = (int8_t) VOLT_INSTR_C(instr);
+        if (a->kind == VOLT_COMPTIME_VALUE_INT) {
+            R[VOLT_INSTR_A(instr)] = volt_comptime_int((int64_t) ((uint64_t) a->i + (uint64_t) delta));
+        } else if (a->kind == VOLT_COMPTIME_VALUE_FLOAT) {
+            R[VOLT_INSTR_A(instr)] = volt_comptime_float(a->f + (float64_t) delta);
+        } else {
+            error = "increment requires a number";
+            goto fail;
+        }
+        VM_NEXT();
+    }
+
+    VM_CASE(EQ)
+    VM_CASE(NE)
+    VM_CASE(LT)
+    VM_CASE(LE)
+    VM_CASE(GT)
+    VM_CASE(GE) {
+        volt_comptime_value_t result;
+        if (!volt_comptime_compare(VOLT_INSTR_OP(instr), &R[VOLT_INSTR_B(instr)],
+                                   &R[VOLT_INSTR_C(instr)], &result, &error))
+            goto fail;
+        R[VOLT_INSTR_A(instr)] = result;
+        VM_NEXT();
+    }
+
+    VM_CASE(NEG) {
+        volt_comptime_value_t* a = &R[VOLT_INSTR_B(instr)];
+        if (a->kind == VOLT_COMPTIME_VALUE_INT) {
+            R[VOLT_INSTR_A(instr)] = volt_comptime_int((int64_t) (0u - (uint64_t) a->i));
+        } else if (a->kind == VOLT_COMPTIME_VALUE_FLOAT) {
+            R[VOLT_INSTR_A(instr)] = volt_comptime_float(-a->f);
+        } else {
+            error = "negation requires a number";
+            goto fail;
+        }
+        VM_NEXT();
+    }
+    VM_CASE(NOT) {
+        R[VOLT_INSTR_A(instr)] = volt_comptime_bool(!volt_comptime_value_truthy(&R[VOLT_INSTR_B(instr)]));
+        VM_NEXT();
+    }
+    VM_CASE(BNOT) {
+        volt_comptime_value_t* a = &R[VOLT_INSTR_B(instr)];
+        if (a->kind != VOLT_COMPTIME_VALUE_INT) {
+            error = "bitwise not requires an integer";
+            goto fail;
+        }
+        R[VOLT_INSTR_A(instr)] = volt_comptime_int((int64_t) ~(uint64_t) a->i);
+        VM_NEXT();
+    }
+
+    VM_CASE(JMP) {
+        int32_t offset = VOLT_INSTR_SBX(instr);
+        if (offset < 0 && ++vm->steps > vm->max_steps)
+            goto diverged;
+        ip += offset;
+        VM_NEXT();
+    }
+    VM_CASE(JMPF) {
+        if (!volt_comptime_value_truthy(&R[VOLT_INSTR_A(instr)]))
+            ip += VOLT_INSTR_SBX(instr);
+        VM_NEXT();
+    }
+    VM_CASE(JMPT) {
+        if (volt_comptime_value_truthy(&R[VOLT_INSTR_A(instr)]))
+            ip += VOLT_INSTR_SBX(instr);
+        VM_NEXT();
+    }
+
+    VM_CASE(FORPREP) {
+        volt_comptime_value_t* i     = &R[VOLT_INSTR_A(instr)];
+        volt_comptime_value_t* limit = i + 1;
+        if (i->kind != VOLT_COMPTIME_VALUE_INT || limit->kind != VOLT_COMPTIME_VALUE_INT) {
+            error = "range bounds must be integers";
+            goto fail;
+        }
+        if (!(i->i < limit->i))
+            ip += VOLT_INSTR_SBX(instr);
+        VM_NEXT();
+    }
+    VM_CASE(FORLOOP) {
+        volt_comptime_value_t* i = &R[VOLT_INSTR_A(instr)];
+        i->i++;
+        if (i->i < i[1].i) {
+            if (++vm->steps > vm->max_steps)
+                goto diverged;
+            ip += VOLT_INSTR_SBX(instr);
+        }
+        VM_NEXT();
+    }
+
+    VM_CASE(CALL) {
+        uint8_t        a      = VOLT_INSTR_A(instr);
+        uint8_t        argc_c = VOLT_INSTR_C(instr);
+        volt_symbol_t* callee = frame->chunk->callees[VOLT_INSTR_B(instr)];
+
+        if (++vm->steps > vm->max_steps)
+            goto diverged;
+
+        volt_bytecode_chunk_t* target = callee->comptime_chunk;
+        if (!target) {
+            frame->ip = ip;
+            target    = volt_comptime_compile_function(ctx, callee);
+            if (!target)
+                goto propagate;
+        }
+
+        if (target->param_count != argc_c) {
+            error = "argument count mismatch";
+            goto fail;
+        }
+
+        uint64_t                    hash  = volt_comptime_memo_hash(target, &R[a], argc_c);
+        volt_comptime_memo_entry_t* entry = volt_comptime_memo_lookup(&ctx->memo, target, hash,
+                                                                      &R[a], argc_c);
+        if (entry) {
+            ctx->memo.hits++;
+            R[a] = entry->result;
+            VM_NEXT();
+        }
+        ctx->memo.misses++;
+
+        frame->ip                    = ip;
+        size_t                 callee_base = frame->base + a;
+        volt_comptime_frame_t* next =
+            volt_comptime_vm_push_frame(ctx, target, callee_base, &vm->registers[callee_base],
+                                        argc_c);
+        if (!next)
+            goto propagate;
+
+        frame = next;
+        ip    = frame->ip;
+        R     = &vm->registers[frame->base];
+        K     = frame->chunk->constants;
+        VM_NEXT();
+    }
+
+    VM_CASE(RET)
+    VM_CASE(RETNONE) {
+        volt_comptime_value_t result = {.kind = VOLT_COMPTIME_VALUE_VOID};
+        if (VOLT_INSTR_OP(instr) == VOLT_OP_RET)
+            result = R[VOLT_INSTR_A(instr)];
+
+        // Only named functions are memoized; standalone expressions run once
+        if (frame->chunk->symbol) {
+            uint64_t hash = volt_comptime_memo_hash(frame->chunk, &vm->memo_stack[frame->memo_args],
+                                                    frame->argc);
+            volt_comptime_memo_insert(&ctx->memo, frame->chunk, hash,
+                                      &vm->memo_stack[frame->memo_args], frame->argc, result);
+        }
+
+        size_t returning_base = frame->base;
+        vm->memo_stack_size   = frame->memo_args;
+        vm->frame_count--;
+
+        if (vm->frame_count == entry_depth) {
+            *out = result;
+            return VOLT_SUCCESS;
+        }
+
+        frame                          = &vm->frames[vm->frame_count - 1];
+        vm->registers[returning_base]  = result;
+        ip                             = frame->ip;
+        R                              = &vm->registers[frame->base];
+        K                              = frame->chunk->constants;
+        VM_NEXT();
+    }
+
+#ifndef VOLT_COMPTIME_COMPUTED_GOTO
+            default:
+                error = "invalid opcode";
+                goto fail;
+        }
+    }
+#endif
+
+#undef VM_CASE
+#undef VM_NEXT
+#undef VM_DISPATCH
+
+diverged:
+    volt_comptime_set_error(ctx, NULL,
+                            "comptime evaluation of '%s' did not finish within %llu steps",
+                            frame->chunk->name, (unsigned long long) vm->max_steps);
+    ctx->error_line = frame->chunk->lines[ip - frame->chunk->code - 1];
+    goto unwind;
+
+fail:
+    volt_comptime_set_error(ctx, NULL, "comptime evaluation of '%s' failed: %s",
+                            frame->chunk->name, error);
+    ctx->error_line = frame->chunk->lines[ip - frame->chunk->code - 1];
+    goto unwind;
+
+propagate:
+    // The error message was already recorded by the compiler or the frame allocator
+unwind:
+    vm->frame_count     = entry_depth;
+    vm->memo_stack_size = entry_depth > 0 ? vm->frames[entry_depth - 1].memo_args +
+                                                vm->frames[entry_depth - 1].argc
+                                          : 0;
+    return VOLT_FAILURE;
+}
+
+// PUBLIC ENTRY POINTS
+
+volt_status_code_t volt_comptime_call(volt_comptime_t* ctx, volt_symbol_t* symbol,
+                                      const volt_comptime_value_t* args, size_t argc,
+                                      volt_comptime_value_t* out) {
+    if (!ctx || !symbol || !out)
+        return VOLT_FAILURE;
+
+    volt_bytecode_chunk_t* chunk = symbol->comptime_chunk;
+    if (!chunk)
+        chunk = volt_comptime_compile_function(ctx, symbol);
+    if (!chunk)
+        return VOLT_FAILURE;
+
+    if (argc == chunk->param_count) {
+        uint64_t                    hash  = volt_comptime_memo_hash(chunk, args, argc);
+        volt_comptime_memo_entry_t* entry = volt_comptime_memo_lookup(&ctx->memo, chunk, hash,
+                                                                      args, argc);
+        if (entry) {
+            ctx->memo.hits++;
+            *out = entry->result;
+            return VOLT_SUCCESS;
+        }
+        ctx->memo.misses++;
+    }
+
+    return volt_comptime_vm_execute(ctx, chunk, args, argc, out);
+}
+
+volt_status_code_t volt_comptime_eval(volt_comptime_t* ctx, volt_ast_node_t* expression,
+                                      const volt_comptime_binding_t* bindings, size_t binding_count,
+                                      volt_comptime_value_t* out) {
+    if (!ctx || !expression || !out)
+        return VOLT_FAILURE;
+
+    volt_bytecode_chunk_t* chunk =
+        volt_comptime_compile_expression(ctx, expression, bindings, binding_count);
+    if (!chunk)
+        return VOLT_FAILURE;
+
+    volt_status_code_t result = volt_comptime_vm_execute(ctx, chunk, NULL, 0, out);
+    volt_bytecode_chunk_free(chunk);
+    return result;
+}
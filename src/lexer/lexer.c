@@ -72,14 +72,16 @@ volt_status_code_t volt_lexer_init(volt_lexer_t* lexer, volt_allocator_t* alloca
     if (!lexer) {
         return VOLT_FAILURE;
     }
-    lexer->tokens                = volt_vector_default();
-    lexer->tokens.item_allocator = &volt_token_allocator;
-    lexer->tokens.allocator      = allocator ? allocator : &volt_default_allocator;
-    lexer->allocator             = allocator ? allocator : &volt_default_allocator;
-    lexer->input_stream_length   = strlen(lexer->input_stream);
-    lexer->current_position      = 0;
-    lexer->current_line          = 1;
-    lexer->current_column        = 1;
+    lexer->allocator           = allocator ? allocator : &volt_default_allocator;
+    lexer->input_stream_length = strlen(lexer->input_stream);
+    lexer->current_position    = 0;
+    lexer->current_line        = 1;
+    lexer->current_column      = 1;
+
+    // One token per ~4 bytes of source is typical, so most files never regrow the array
+    lexer->tokens.allocator = lexer->allocator;
+    volt_token_vector_init(&lexer->tokens);
+    volt_token_vector_reserve(&lexer->tokens, lexer->input_stream_length / 4 + 1);
     return VOLT_SUCCESS;
 }
 
@@ -91,12 +93,13 @@ volt_status_code_t volt_lexer_deinit(volt_lexer_t* lexer) {
     // Debug token printing
     /*
     for (size_t i = 0; i < lexer->tokens.size; i++) {
-        volt_token_t* token = (volt_token_t*) volt_vector_get(&lexer->tokens, i);
-        volt_token_print(token);
+        volt_token_print(volt_token_vector_get(&lexer->tokens, i));
     }
     */
 
-    volt_vector_deinit(&lexer->tokens);
+    for (size_t i = 0; i < lexer->tokens.size; i++)
+        volt_token_deinit(&lexer->tokens.data[i]);
+    volt_token_vector_deinit(&lexer->tokens);
     lexer->allocator->free((void*) lexer->input_stream);
     return VOLT_SUCCESS;
 }
@@ -130,28 +133,30 @@ bool match_char(volt_lexer_t* lexer, char expected) {
     return true;
 }
 
-volt_token_t* create_token(volt_lexer_t* lexer, volt_token_type_t type, const char* lexeme,
-                           size_t start_line, size_t start_column) {
-    volt_token_t* token = (volt_token_t*) lexer->allocator->malloc(sizeof(volt_token_t));
-    if (!token)
+// Appends the token to lexer->tokens and returns it (valid until the next token is pushed)
+volt_token_t* push_token(volt_lexer_t* lexer, volt_token_type_t type, const char* lexeme,
+                         size_t start_line, size_t start_column) {
+    volt_token_t token = {0};
+    token.allocator    = lexer->allocator;
+    token.type         = type;
+    token.lexeme       = strdup(lexeme);
+    token.line         = start_line;
+    token.column       = start_column;
+    if (!token.lexeme || volt_token_vector_push_back(&lexer->tokens, token) != VOLT_SUCCESS) {
+        free((void*) token.lexeme);
         return NULL;
-
-    token->allocator = lexer->allocator;
-    token->type      = type;
-    token->lexeme    = strdup(lexeme);
-    token->line      = start_line;
-    token->column    = start_column;
-    return token;
+    }
+    return volt_token_vector_back(&lexer->tokens);
 }
 
 volt_token_t* token_identifier_or_kw(volt_lexer_t* lexer, const char* lexeme, size_t start_line,
                                      size_t start_col) {
     for (size_t i = 0; keywords[i].keyword != NULL; i++) {
         if (strcmp(lexeme, keywords[i].keyword) == 0) {
-            return create_token(lexer, keywords[i].token_type, lexeme, start_line, start_col);
+            return push_token(lexer, keywords[i].token_type, lexeme, start_line, start_col);
         }
     }
-    return create_token(lexer, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL, lexeme, start_line, start_col);
+    return push_token(lexer, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL, lexeme, start_line, start_col);
 }
 
 volt_token_t* token_identifier(volt_lexer_t* lexer) {
@@ -214,7 +219,7 @@ volt_token_t* token_number(volt_lexer_t* lexer) {
     lexeme[len] = '\0';
 
     volt_token_t* token =
-        create_token(lexer, VOLT_TOKEN_TYPE_NUMBER_LITERAL, lexeme, start_line, start_col);
+        push_token(lexer, VOLT_TOKEN_TYPE_NUMBER_LITERAL, lexeme, start_line, start_col);
     lexer->allocator->free(lexeme);
     return token;
 }
@@ -253,536 +258,589 @@ volt_token_t* token_string(volt_lexer_t* lexer, char quote_type) {
     }
 
     volt_token_t* token =
-        create_token(lexer, VOLT_TOKEN_TYPE_STRING_LITERAL, lexeme, start_line, start_col);
+        push_token(lexer, VOLT_TOKEN_TYPE_STRING_LITERAL, lexeme, start_line, start_col);
     lexer->allocator->free(lexeme);
     return token;
 }
 
-volt_status_code_t volt_lexer_lex(volt_lexer_t* lexer) {
-    if (!lexer) {
-        return VOLT_FAILURE;
-    }
-
-    while (lexer->current_position < lexer->input_stream_length) {
-        char current_char = lexer->input_stream[lexer->current_position];
-
-        /* helper macros to record start position */
-        size_t start_line = lexer->current_line;
-        size_t start_col  = lexer->current_column;
+// Lexes one token, or skips whitespace or a comment, from the current position
+static void volt_lexer_step(volt_lexer_t* lexer) {
+    char current_char = lexer->input_stream[lexer->current_position];
+
+    /* helper macros to record start position */
+    size_t start_line     = lexer->current_line;
+    size_t start_col      = lexer->current_column;
+    size_t start_position = lexer->current_position;
+    size_t token_count    = lexer->tokens.size;
+
+    /* convenience peek */
+    char next_char = (lexer->current_position + 1 < lexer->input_stream_length)
+                         ? lexer->input_stream[lexer->current_position + 1]
+                         : '\0';
+
+    switch (current_char) {
+        case ' ':
+        case '\t':
+        case '\r':
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
 
-        /* convenience peek */
-        char next_char = (lexer->current_position + 1 < lexer->input_stream_length)
-                             ? lexer->input_stream[lexer->current_position + 1]
-                             : '\0';
+        case '\n':
+            lexer->current_position++;
+            lexer->current_line++;
+            lexer->current_column = 1;
+            break;
 
-        switch (current_char) {
-            case ' ':
-            case '\t':
-            case '\r':
+        case '+': {
+            if (next_char == '+') {
+                push_token(lexer, VOLT_TOKEN_TYPE_PLUS_PLUS, "++", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_PLUS_EQUAL, "+=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_PLUS, "+", start_line, start_col);
                 lexer->current_position++;
                 lexer->current_column++;
-                break;
+            }
+            break;
+        }
 
-            case '\n':
+        case '-': {
+            if (next_char == '-') {
+                push_token(lexer, VOLT_TOKEN_TYPE_TACK_TACK, "--", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_TACK_EQUAL, "-=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else if (next_char == '>') {
+                push_token(lexer, VOLT_TOKEN_TYPE_TACK_RANGLE, "->", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_TACK, "-", start_line, start_col);
                 lexer->current_position++;
-                lexer->current_line++;
-                lexer->current_column = 1;
-                break;
-
-            case '+': {
-                if (next_char == '+') {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_PLUS_PLUS, "++", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_PLUS_EQUAL,
-                                                       "+=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_PLUS, "+", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
+                lexer->current_column++;
             }
+            break;
+        }
 
-            case '-': {
-                if (next_char == '-') {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_TACK_TACK, "--", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_TACK_EQUAL,
-                                                       "-=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else if (next_char == '>') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_TACK_RANGLE, "->",
-                                                       start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_TACK, "-", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
+        case '*': {
+            if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_STAR_EQUAL, "*=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_STAR, "*", start_line, start_col);
+                lexer->current_position++;
+                lexer->current_column++;
             }
+            break;
+        }
 
-            case '*': {
-                if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_STAR_EQUAL,
-                                                       "*=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_STAR, "*", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
+        case '/': {
+            if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_SLASH_EQUAL, "/=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else if (next_char == '/') {
+                /* line comment: consume '//' and rest of line */
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+                while (lexer->current_position < lexer->input_stream_length &&
+                       lexer->input_stream[lexer->current_position] != '\n') {
                     lexer->current_position++;
                     lexer->current_column++;
                 }
-                break;
-            }
-
-            case '/': {
-                if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_SLASH_EQUAL,
-                                                       "/=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else if (next_char == '/') {
-                    /* line comment: consume '//' and rest of line */
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                    while (lexer->current_position < lexer->input_stream_length &&
-                           lexer->input_stream[lexer->current_position] != '\n') {
+            } else if (next_char == '*') {
+                /* block comment: */
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+                while (lexer->current_position < lexer->input_stream_length) {
+                    if (lexer->input_stream[lexer->current_position] == '*' &&
+                        lexer->current_position + 1 < lexer->input_stream_length &&
+                        lexer->input_stream[lexer->current_position + 1] == '/') {
+                        lexer->current_position += 2;
+                        lexer->current_column += 2;
+                        break;
+                    }
+                    if (lexer->input_stream[lexer->current_position] == '\n') {
+                        lexer->current_position++;
+                        lexer->current_line++;
+                        lexer->current_column = 1;
+                    } else {
                         lexer->current_position++;
                         lexer->current_column++;
                     }
-                } else if (next_char == '*') {
-                    /* block comment: */
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                    while (lexer->current_position < lexer->input_stream_length) {
-                        if (lexer->input_stream[lexer->current_position] == '*' &&
-                            lexer->current_position + 1 < lexer->input_stream_length &&
-                            lexer->input_stream[lexer->current_position + 1] == '/') {
-                            lexer->current_position += 2;
-                            lexer->current_column += 2;
-                            break;
-                        }
-                        if (lexer->input_stream[lexer->current_position] == '\n') {
-                            lexer->current_position++;
-                            lexer->current_line++;
-                            lexer->current_column = 1;
-                        } else {
-                            lexer->current_position++;
-                            lexer->current_column++;
-                        }
-                    }
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_SLASH, "/", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
                 }
-                break;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_SLASH, "/", start_line, start_col);
+                lexer->current_position++;
+                lexer->current_column++;
             }
+            break;
+        }
 
-            case '=': {
-                if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_EQUAL_EQUAL,
-                                                       "==", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else if (next_char == '>') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_EQUAL_RANGLE, "=>",
-                                                       start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_EQUAL, "=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
+        case '=': {
+            if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_EQUAL_EQUAL, "==", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else if (next_char == '>') {
+                push_token(lexer, VOLT_TOKEN_TYPE_EQUAL_RANGLE, "=>", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_EQUAL, "=", start_line, start_col);
+                lexer->current_position++;
+                lexer->current_column++;
             }
+            break;
+        }
 
-            case '%': {
-                if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_PERCENT_EQUAL,
-                                                       "%=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_PERCENT, "%", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
+        case '%': {
+            if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_PERCENT_EQUAL, "%=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_PERCENT, "%", start_line, start_col);
+                lexer->current_position++;
+                lexer->current_column++;
             }
+            break;
+        }
 
-            case '.': {
-                if (next_char == '.') {
-                    /* .. or ..= */
-                    if (lexer->current_position + 2 < lexer->input_stream_length &&
-                        lexer->input_stream[lexer->current_position + 2] == '=') {
-                        volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_DOT_DOT_EQUAL,
-                                                           "..=", start_line, start_col);
-                        volt_vector_push_back(&lexer->tokens, token);
-                        lexer->current_position += 3;
-                        lexer->current_column += 3;
-                    } else {
-                        volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_DOT_DOT, "..",
-                                                           start_line, start_col);
-                        volt_vector_push_back(&lexer->tokens, token);
-                        lexer->current_position += 2;
-                        lexer->current_column += 2;
-                    }
+        case '.': {
+            if (next_char == '.') {
+                /* .. or ..= */
+                if (lexer->current_position + 2 < lexer->input_stream_length &&
+                    lexer->input_stream[lexer->current_position + 2] == '=') {
+                    push_token(lexer, VOLT_TOKEN_TYPE_DOT_DOT_EQUAL, "..=", start_line,
+                               start_col);
+                    lexer->current_position += 3;
+                    lexer->current_column += 3;
                 } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_DOT, ".", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
-            }
-
-            case ':': {
-                if (next_char == ':') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_COLON_COLON,
-                                                       "::", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
+                    push_token(lexer, VOLT_TOKEN_TYPE_DOT_DOT, "..", start_line, start_col);
                     lexer->current_position += 2;
                     lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_COLON, ":", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
                 }
-                break;
-            }
-
-            case '(': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_LPAREN, "(", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_DOT, ".", start_line, start_col);
                 lexer->current_position++;
                 lexer->current_column++;
-                break;
             }
+            break;
+        }
 
-            case ')': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_RPAREN, ")", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
+        case ':': {
+            if (next_char == ':') {
+                push_token(lexer, VOLT_TOKEN_TYPE_COLON_COLON, "::", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_COLON, ":", start_line, start_col);
                 lexer->current_position++;
                 lexer->current_column++;
-                break;
             }
+            break;
+        }
 
-            case '{': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_LBRACE, "{", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
-                lexer->current_position++;
-                lexer->current_column++;
-                break;
-            }
+        case '(': {
+            push_token(lexer, VOLT_TOKEN_TYPE_LPAREN, "(", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
 
-            case '}': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_RBRACE, "}", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
-                lexer->current_position++;
-                lexer->current_column++;
-                break;
-            }
+        case ')': {
+            push_token(lexer, VOLT_TOKEN_TYPE_RPAREN, ")", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
 
-            case '[': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_LBRACKET, "[", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
-                lexer->current_position++;
-                lexer->current_column++;
-                break;
-            }
+        case '{': {
+            push_token(lexer, VOLT_TOKEN_TYPE_LBRACE, "{", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
 
-            case ']': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_RBRACKET, "]", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
-                lexer->current_position++;
-                lexer->current_column++;
-                break;
-            }
+        case '}': {
+            push_token(lexer, VOLT_TOKEN_TYPE_RBRACE, "}", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
 
-            case '<': {
-                if (next_char == '<') {
-                    if (lexer->current_position + 2 < lexer->input_stream_length &&
-                        lexer->input_stream[lexer->current_position + 2] == '=') {
-                        volt_token_t* token =
-                            create_token(lexer, VOLT_TOKEN_TYPE_LANGLE_LANGLE_EQUAL,
-                                         "<<=", start_line, start_col);
-                        volt_vector_push_back(&lexer->tokens, token);
-                        lexer->current_position += 3;
-                        lexer->current_column += 3;
-                    } else {
-                        volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_LANGLE_LANGLE,
-                                                           "<<", start_line, start_col);
-                        volt_vector_push_back(&lexer->tokens, token);
-                        lexer->current_position += 2;
-                        lexer->current_column += 2;
-                    }
-                } else if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_LANGLE_EQUAL,
-                                                       "<=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_LANGLE, "<", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
-            }
+        case '[': {
+            push_token(lexer, VOLT_TOKEN_TYPE_LBRACKET, "[", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
 
-            case '>': {
-                if (next_char == '>') {
-                    if (lexer->current_position + 2 < lexer->input_stream_length &&
-                        lexer->input_stream[lexer->current_position + 2] == '=') {
-                        volt_token_t* token =
-                            create_token(lexer, VOLT_TOKEN_TYPE_RANGLE_RANGLE_EQUAL,
-                                         ">>=", start_line, start_col);
-                        volt_vector_push_back(&lexer->tokens, token);
-                        lexer->current_position += 3;
-                        lexer->current_column += 3;
-                    } else {
-                        volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_RANGLE_RANGLE,
-                                                           ">>", start_line, start_col);
-                        volt_vector_push_back(&lexer->tokens, token);
-                        lexer->current_position += 2;
-                        lexer->current_column += 2;
-                    }
-                } else if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_RANGLE_EQUAL,
-                                                       ">=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
+        case ']': {
+            push_token(lexer, VOLT_TOKEN_TYPE_RBRACKET, "]", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
+
+        case '<': {
+            if (next_char == '<') {
+                if (lexer->current_position + 2 < lexer->input_stream_length &&
+                    lexer->input_stream[lexer->current_position + 2] == '=') {
+                    push_token(lexer, VOLT_TOKEN_TYPE_LANGLE_LANGLE_EQUAL, "<<=", start_line,
+                               start_col);
+                    lexer->current_position += 3;
+                    lexer->current_column += 3;
+                } else {
+                    push_token(lexer, VOLT_TOKEN_TYPE_LANGLE_LANGLE, "<<", start_line,
+                               start_col);
                     lexer->current_position += 2;
                     lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_RANGLE, ">", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
                 }
-                break;
-            }
-
-            case '@': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_AT, "@", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
+            } else if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_LANGLE_EQUAL, "<=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_LANGLE, "<", start_line, start_col);
                 lexer->current_position++;
                 lexer->current_column++;
-                break;
             }
+            break;
+        }
 
-            case '!': {
-                if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_BANG_EQUAL,
-                                                       "!=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
+        case '>': {
+            if (next_char == '>') {
+                if (lexer->current_position + 2 < lexer->input_stream_length &&
+                    lexer->input_stream[lexer->current_position + 2] == '=') {
+                    push_token(lexer, VOLT_TOKEN_TYPE_RANGLE_RANGLE_EQUAL, ">>=", start_line,
+                               start_col);
+                    lexer->current_position += 3;
+                    lexer->current_column += 3;
+                } else {
+                    push_token(lexer, VOLT_TOKEN_TYPE_RANGLE_RANGLE, ">>", start_line,
+                               start_col);
                     lexer->current_position += 2;
                     lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_BANG, "!", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
                 }
-                break;
-            }
-
-            case '#': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_HASH, "#", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
+            } else if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_RANGLE_EQUAL, ">=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_RANGLE, ">", start_line, start_col);
                 lexer->current_position++;
                 lexer->current_column++;
-                break;
             }
+            break;
+        }
 
-            case '^': {
-                if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_CARET_EQUAL,
-                                                       "^=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_CARET, "^", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
-            }
+        case '@': {
+            push_token(lexer, VOLT_TOKEN_TYPE_AT, "@", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
 
-            case '~': {
-                if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_TILDE_EQUAL,
-                                                       "~=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_TILDE, "~", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
+        case '!': {
+            if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_BANG_EQUAL, "!=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_BANG, "!", start_line, start_col);
+                lexer->current_position++;
+                lexer->current_column++;
             }
+            break;
+        }
 
-            case '&': {
-                if (next_char == '&') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_AMPERSAND_AMPERSAND,
-                                                       "&&", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else if (next_char == '=') {
-                    volt_token_t* token = create_token(lexer, VOLT_TOKEN_TYPE_AMPERSAND_EQUAL,
-                                                       "&=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_AMPERSAND, "&", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
+        case '#': {
+            push_token(lexer, VOLT_TOKEN_TYPE_HASH, "#", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
+
+        case '^': {
+            if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_CARET_EQUAL, "^=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_CARET, "^", start_line, start_col);
+                lexer->current_position++;
+                lexer->current_column++;
             }
+            break;
+        }
 
-            case '|': {
-                if (next_char == '|') {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_BAR_BAR, "||", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else if (next_char == '=') {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_BAR_EQUAL, "|=", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position += 2;
-                    lexer->current_column += 2;
-                } else {
-                    volt_token_t* token =
-                        create_token(lexer, VOLT_TOKEN_TYPE_BAR, "|", start_line, start_col);
-                    volt_vector_push_back(&lexer->tokens, token);
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
-                break;
+        case '~': {
+            if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_TILDE_EQUAL, "~=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_TILDE, "~", start_line, start_col);
+                lexer->current_position++;
+                lexer->current_column++;
             }
+            break;
+        }
 
-            case ',': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_COMMA, ",", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
+        case '&': {
+            if (next_char == '&') {
+                push_token(lexer, VOLT_TOKEN_TYPE_AMPERSAND_AMPERSAND, "&&", start_line,
+                           start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_AMPERSAND_EQUAL, "&=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_AMPERSAND, "&", start_line, start_col);
                 lexer->current_position++;
                 lexer->current_column++;
-                break;
             }
+            break;
+        }
 
-            case ';': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_SEMICOLON, ";", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
+        case '|': {
+            if (next_char == '|') {
+                push_token(lexer, VOLT_TOKEN_TYPE_BAR_BAR, "||", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else if (next_char == '=') {
+                push_token(lexer, VOLT_TOKEN_TYPE_BAR_EQUAL, "|=", start_line, start_col);
+                lexer->current_position += 2;
+                lexer->current_column += 2;
+            } else {
+                push_token(lexer, VOLT_TOKEN_TYPE_BAR, "|", start_line, start_col);
                 lexer->current_position++;
                 lexer->current_column++;
-                break;
             }
+            break;
+        }
+
+        case ',': {
+            push_token(lexer, VOLT_TOKEN_TYPE_COMMA, ",", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
 
-            case '?': {
-                volt_token_t* token =
-                    create_token(lexer, VOLT_TOKEN_TYPE_QUESTION, "?", start_line, start_col);
-                volt_vector_push_back(&lexer->tokens, token);
+        case ';': {
+            push_token(lexer, VOLT_TOKEN_TYPE_SEMICOLON, ";", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
+
+        case '?': {
+            push_token(lexer, VOLT_TOKEN_TYPE_QUESTION, "?", start_line, start_col);
+            lexer->current_position++;
+            lexer->current_column++;
+            break;
+        }
+
+        default: {
+            if (is_alpha(current_char)) {
+                /* token_identifier consumes characters and advances
+                 * lexer->current_position/column */
+                token_identifier(lexer);
+            } else if (is_digit(current_char)) {
+                token_number(lexer);
+            } else if (current_char == '"' || current_char == '\'') {
+                /* consume opening quote then let token_string handle the content+closing quote
+                 */
+                char quote_type = current_char;
+                lexer->current_position++;
+                lexer->current_column++;
+                token_string(lexer, quote_type);
+            } else {
+                volt_error_t error = {0};
+                volt_error_init(lexer->error_handler, &error,
+                                "Unexpected character in input stream", VOLT_ERROR_TYPE_ERROR,
+                                lexer->input_stream_name, lexer->current_line,
+                                lexer->current_column);
+                volt_error_handler_push_error(lexer->error_handler, &error);
+                /* prevent infinite loop by advancing one */
                 lexer->current_position++;
                 lexer->current_column++;
-                break;
             }
+            break;
+        }
+    } /* switch */
 
-            default: {
-                if (is_alpha(current_char)) {
-                    /* token_identifier consumes characters and advances
-                     * lexer->current_position/column */
-                    volt_token_t* token = token_identifier(lexer);
-                    volt_vector_push_back(&lexer->tokens, token);
-                } else if (is_digit(current_char)) {
-                    volt_token_t* token = token_number(lexer);
-                    volt_vector_push_back(&lexer->tokens, token);
-                } else if (current_char == '"' || current_char == '\'') {
-                    /* consume opening quote then let token_string handle the content+closing quote
-                     */
-                    char quote_type = current_char;
-                    lexer->current_position++;
-                    lexer->current_column++;
-                    volt_token_t* token = token_string(lexer, quote_type);
-                    volt_vector_push_back(&lexer->tokens, token);
-                } else {
-                    volt_error_t error = {0};
-                    volt_error_init(lexer->error_handler, &error,
-                                    "Unexpected character in input stream", VOLT_ERROR_TYPE_ERROR,
-                                    lexer->input_stream_name, lexer->current_line,
-                                    lexer->current_column);
-                    volt_error_handler_push_error(lexer->error_handler, &error);
-                    /* prevent infinite loop by advancing one */
-                    lexer->current_position++;
-                    lexer->current_column++;
-                }
+    // Where the token came from, so an edit can be mapped onto the tokens it touches
+    if (lexer->tokens.size > token_count) {
+        volt_token_t* token = volt_token_vector_back(&lexer->tokens);
+        token->offset       = start_position;
+        token->length       = lexer->current_position - start_position;
+    }
+}
+
+volt_status_code_t volt_lexer_lex(volt_lexer_t* lexer) {
+    if (!lexer) {
+        return VOLT_FAILURE;
+    }
+
+    while (lexer->current_position < lexer->input_stream_length)
+        volt_lexer_step(lexer);
+
+    return VOLT_SUCCESS;
+}
+
+// INCREMENTAL RELEXING
+
+// A token's end is read at most this many bytes ahead (`1..` and `<<=` look two past it), so an
+// edit further away than that cannot change it
+#define VOLT_LEXER_LOOKAHEAD 2
+
+// First token whose characters, or the ones its lexing peeked at, may have changed at `offset`
+static size_t volt_lexer_first_damaged(volt_token_vector_t* tokens, size_t offset) {
+    size_t low  = 0;
+    size_t high = tokens->size;
+    while (low < high) {
+        size_t        middle = low + (high - low) / 2;
+        volt_token_t* token  = &tokens->data[middle];
+        if (token->offset + token->length + VOLT_LEXER_LOOKAHEAD > offset)
+            high = middle;
+        else
+            low = middle + 1;
+    }
+    return low;
+}
+
+// Puts the lexer right after `token`, where it was when it went on to the next one
+static void volt_lexer_resume_after(volt_lexer_t* lexer, volt_token_t* token) {
+    lexer->current_position = token->offset;
+    lexer->current_line     = token->line;
+    lexer->current_column   = token->column;
+
+    // Only strings span lines
+    for (size_t end = token->offset + token->length; lexer->current_position < end;) {
+        if (lexer->input_stream[lexer->current_position++] == '\n') {
+            lexer->current_line++;
+            lexer->current_column = 1;
+        } else {
+            lexer->current_column++;
+        }
+    }
+}
+
+volt_status_code_t volt_lexer_relex(volt_lexer_t* lexer, size_t offset, size_t removed,
+                                    const char* text, volt_token_edit_t* edit) {
+    if (!lexer || !text || offset > lexer->input_stream_length ||
+        removed > lexer->input_stream_length - offset)
+        return VOLT_FAILURE;
+
+    // Splice the edit into a new buffer
+    size_t inserted   = strlen(text);
+    size_t length     = lexer->input_stream_length - removed + inserted;
+    char*  new_stream = lexer->allocator->malloc(length + 1);
+    if (!new_stream)
+        return VOLT_FAILURE;
+
+    memcpy(new_stream, lexer->input_stream, offset);
+    memcpy(new_stream + offset, text, inserted);
+    memcpy(new_stream + offset + inserted, lexer->input_stream + offset + removed,
+           lexer->input_stream_length - offset - removed);
+    new_stream[length] = '\0';
+
+    lexer->allocator->free((void*) lexer->input_stream);
+    lexer->input_stream        = new_stream;
+    lexer->input_stream_length = length;
+
+    // Restart after the last token the edit cannot have touched; the text before it is the same
+    volt_token_vector_t tokens = lexer->tokens;
+    size_t              first  = volt_lexer_first_damaged(&tokens, offset);
+    if (first > 0) {
+        volt_lexer_resume_after(lexer, &tokens.data[first - 1]);
+    } else {
+        lexer->current_position = 0;
+        lexer->current_line     = 1;
+        lexer->current_column   = 1;
+    }
+
+    // Lex into a side vector until the new stream lines up with an old token past the edit. From
+    // there on the text and the lexer's state are the same as before, so the old tokens stand.
+    lexer->tokens.data     = NULL;
+    lexer->tokens.size     = 0;
+    lexer->tokens.capacity = 0;
+
+    size_t edit_end = offset + inserted;
+    size_t resync   = first;
+    bool   resynced = false;
+    while (lexer->current_position < lexer->input_stream_length) {
+        if (lexer->current_position >= edit_end) {
+            size_t old_position = lexer->current_position - inserted + removed;
+            while (resync < tokens.size && tokens.data[resync].offset < old_position)
+                resync++;
+            if (resync < tokens.size && tokens.data[resync].offset == old_position) {
+                resynced = true;
                 break;
             }
-        } /* switch */
-    } /* while */
+        }
+        volt_lexer_step(lexer);
+    }
+    if (!resynced)
+        resync = tokens.size;
+
+    volt_token_vector_t fresh = lexer->tokens;
+    lexer->tokens             = tokens;
+
+    size_t tail = tokens.size - resync;
+    size_t size = first + fresh.size + tail;
+    if (volt_token_vector_reserve(&lexer->tokens, size) != VOLT_SUCCESS) {
+        // Nothing from the edit on can be trusted, so drop it all and let the caller relex
+        for (size_t i = 0; i < fresh.size; i++)
+            volt_token_deinit(&fresh.data[i]);
+        for (size_t i = first; i < tokens.size; i++)
+            volt_token_deinit(&tokens.data[i]);
+        volt_token_vector_deinit(&fresh);
+        lexer->tokens.size = first;
+        return VOLT_FAILURE;
+    }
+
+    // Lines and columns after the edit move by where the first kept token now starts
+    volt_token_t* kept   = lexer->tokens.data + resync;
+    size_t        line   = tail > 0 ? kept->line : 0;
+    size_t        column = tail > 0 ? kept->column : 0;
+    for (size_t i = 0; i < tail; i++) {
+        if (kept[i].line == line)
+            kept[i].column = kept[i].column + lexer->current_column - column;
+        kept[i].line   = kept[i].line + lexer->current_line - line;
+        kept[i].offset = kept[i].offset - removed + inserted;
+    }
+
+    // Splice the new tokens over the ones they replace
+    for (size_t i = first; i < resync; i++)
+        volt_token_deinit(&lexer->tokens.data[i]);
+
+    memmove(lexer->tokens.data + first + fresh.size, kept, tail * sizeof(volt_token_t));
+    if (fresh.size > 0)
+        memcpy(lexer->tokens.data + first, fresh.data, fresh.size * sizeof(volt_token_t));
+    lexer->tokens.size = size;
+
+    if (edit) {
+        edit->first    = first;
+        edit->removed  = resync - first;
+        edit->inserted = fresh.size;
+    }
+    volt_token_vector_deinit(&fresh);
 
+    lexer->current_position = lexer->input_stream_length;
     return VOLT_SUCCESS;
 }
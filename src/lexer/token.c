@@ -3,16 +3,10 @@
 
 #include "util/types/types.h"
 
-volt_allocator_t volt_token_allocator = {NULL, NULL, .free = volt_vtoken_deinit, NULL};
-
-void volt_vtoken_deinit(void* vtoken) {
-    volt_token_deinit((volt_token_t*) vtoken);
-}
-
 volt_status_code_t volt_token_deinit(volt_token_t* token) {
     volt_allocator_t* allocator = token->allocator ? token->allocator : &volt_default_allocator;
     allocator->free((void*) token->lexeme);
-    allocator->free((void*) token);
+    token->lexeme = NULL;
 
     return VOLT_SUCCESS;
 }
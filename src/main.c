@@ -1,5 +1,6 @@
 #include <pch.h>
 #include <stdlib.h>
+#include <volt/lsp.h>
 #include <volt/volt.h>
 
 #include "util/fmt.h"
@@ -19,6 +20,12 @@ int32_t main(int32_t argc, char** argv) {
     compiler.allocator       = &volt_default_allocator;
 
     volt_init(&compiler);
+    if (compiler.args.lsp) {
+        volt_status_code_t status = volt_lsp_run(&compiler);
+        volt_deinit(&compiler);
+        return status == VOLT_SUCCESS ? 0 : 1;
+    }
+
     volt_lex(&compiler);
     volt_parse(&compiler);
     volt_analyze(&compiler);
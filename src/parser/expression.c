@@ -26,10 +26,10 @@ volt_status_code_t volt_expression_registry_deinit(volt_expression_registry_t* r
         return VOLT_FAILURE;
 
     for (size_t i = 0; i < registry->count; i++) {
-        volt_expression_free(registry->expressions[i]);
+        volt_expression_free((volt_expression_t*) registry->expressions[i]);
     }
 
-    registry->allocator->free(registry->expressions);
+    registry->allocator->free((void*) registry->expressions);
 
     return VOLT_SUCCESS;
 }
@@ -38,32 +38,54 @@ void volt_expression_registry_add(volt_expression_registry_t* registry, volt_exp
     if (!registry || !expr)
         return;
 
+    // Registries built here own their arrays; only the generated tables are really const
+    volt_expression_t** exprs = (volt_expression_t**) registry->expressions;
     if (registry->count >= registry->capacity) {
-        size_t              new_capacity = registry->capacity * 2;
-        volt_expression_t** new_exprs    = registry->allocator->realloc(
-            registry->expressions, new_capacity * sizeof(volt_expression_t*));
-        if (!new_exprs)
+        size_t new_capacity = registry->capacity * 2;
+        exprs = registry->allocator->realloc(exprs, new_capacity * sizeof(volt_expression_t*));
+        if (!exprs)
             return;
 
-        registry->expressions = new_exprs;
+        registry->expressions = (const volt_expression_t* const*) exprs;
         registry->capacity    = new_capacity;
     }
 
-    registry->expressions[registry->count++] = expr;
+    exprs[registry->count++] = expr;
 }
 
-volt_expression_t* volt_expression_registry_get(volt_expression_registry_t* registry,
-                                                const char*                 name) {
-    if (!registry || !name)
-        return NULL;
+void volt_expression_registry_resolve(volt_expression_registry_t* registry) {
+    if (!registry)
+        return;
 
     for (size_t i = 0; i < registry->count; i++) {
-        if (strcmp(registry->expressions[i]->expression_name, name) == 0) {
-            return registry->expressions[i];
+        const volt_expression_t* expr = registry->expressions[i];
+        for (size_t alt = 0; alt < expr->num_alternatives; alt++) {
+            volt_subexpression_t* subs = (volt_subexpression_t*) expr->alternatives[alt];
+            for (size_t j = 0; j < expr->alternative_lengths[alt]; j++) {
+                if (subs[j].is_subexpression)
+                    subs[j].rule = volt_expression_registry_index(registry, subs[j].subexpression);
+            }
         }
     }
+}
 
-    return NULL;
+size_t volt_expression_registry_index(const volt_expression_registry_t* registry,
+                                      const char*                       name) {
+    if (!registry || !name)
+        return 0;
+
+    for (size_t i = 0; i < registry->count; i++) {
+        if (strcmp(registry->expressions[i]->expression_name, name) == 0)
+            return i;
+    }
+
+    return registry->count;
+}
+
+const volt_expression_t* volt_expression_registry_get(const volt_expression_registry_t* registry,
+                                                      const char*                       name) {
+    size_t index = volt_expression_registry_index(registry, name);
+    return registry && index < registry->count ? registry->expressions[index] : NULL;
 }
 
 // Expression Construction - REQUIRED elements
@@ -88,6 +110,12 @@ volt_subexpression_t volt_sub_opt_expr(const char* name) {
         .subexpression = name, .is_subexpression = true, .is_optional = true};
 }
 
+// Expression Construction - function bodies
+volt_subexpression_t volt_sub_body(const char* name) {
+    return (volt_subexpression_t) {
+        .subexpression = name, .is_subexpression = true, .is_optional = false, .is_body = true};
+}
+
 volt_expression_t* volt_expression_create(const char* name) {
     volt_expression_t* expr = malloc(sizeof(volt_expression_t));
     if (!expr)
@@ -98,6 +126,7 @@ volt_expression_t* volt_expression_create(const char* name) {
     expr->capacity            = 4;
     expr->alternatives        = calloc(expr->capacity, sizeof(volt_subexpression_t*));
     expr->alternative_lengths = calloc(expr->capacity, sizeof(size_t));
+    expr->is_list             = false;
 
     if (!expr->alternatives || !expr->alternative_lengths) {
         volt_expression_free(expr);
@@ -107,36 +136,51 @@ volt_expression_t* volt_expression_create(const char* name) {
     return expr;
 }
 
+volt_expression_t* volt_expression_create_list(const char* name) {
+    volt_expression_t* expr = volt_expression_create(name);
+    if (expr)
+        expr->is_list = true;
+    return expr;
+}
+
 void volt_expression_add_alt(volt_expression_t* expr, volt_subexpression_t* subs, size_t count) {
     if (!expr)
         return;
 
+    // Built expressions own their arrays; only the generated tables are really const
+    volt_subexpression_t** alts    = (volt_subexpression_t**) expr->alternatives;
+    size_t*                lengths = (size_t*) expr->alternative_lengths;
+
     if (expr->num_alternatives >= expr->capacity) {
         size_t new_capacity = expr->capacity * 2;
 
         volt_subexpression_t** new_alts =
-            realloc(expr->alternatives, new_capacity * sizeof(volt_subexpression_t*));
-        size_t* new_lengths = realloc(expr->alternative_lengths, new_capacity * sizeof(size_t));
+            realloc(alts, new_capacity * sizeof(volt_subexpression_t*));
+        size_t* new_lengths = realloc(lengths, new_capacity * sizeof(size_t));
 
+        if (new_alts)
+            expr->alternatives = (const volt_subexpression_t* const*) new_alts;
+        if (new_lengths)
+            expr->alternative_lengths = new_lengths;
         if (!new_alts || !new_lengths)
             return;
 
-        expr->alternatives        = new_alts;
-        expr->alternative_lengths = new_lengths;
-        expr->capacity            = new_capacity;
+        alts           = new_alts;
+        lengths        = new_lengths;
+        expr->capacity = new_capacity;
 
-        memset(expr->alternatives + expr->num_alternatives, 0,
+        memset(alts + expr->num_alternatives, 0,
                (new_capacity - expr->num_alternatives) * sizeof(volt_subexpression_t*));
-        memset(expr->alternative_lengths + expr->num_alternatives, 0,
+        memset(lengths + expr->num_alternatives, 0,
                (new_capacity - expr->num_alternatives) * sizeof(size_t));
     }
 
-    expr->alternatives[expr->num_alternatives] = malloc(count * sizeof(volt_subexpression_t));
-    if (!expr->alternatives[expr->num_alternatives])
+    alts[expr->num_alternatives] = malloc(count * sizeof(volt_subexpression_t));
+    if (!alts[expr->num_alternatives])
         return;
 
-    memcpy(expr->alternatives[expr->num_alternatives], subs, count * sizeof(volt_subexpression_t));
-    expr->alternative_lengths[expr->num_alternatives] = count;
+    memcpy(alts[expr->num_alternatives], subs, count * sizeof(volt_subexpression_t));
+    lengths[expr->num_alternatives] = count;
     expr->num_alternatives++;
 }
 
@@ -146,11 +190,11 @@ void volt_expression_free(volt_expression_t* expr) {
 
     if (expr->alternatives) {
         for (size_t i = 0; i < expr->num_alternatives; i++) {
-            free(expr->alternatives[i]);
+            free((void*) expr->alternatives[i]);
         }
-        free(expr->alternatives);
+        free((void*) expr->alternatives);
     }
-    free(expr->alternative_lengths);
+    free((void*) expr->alternative_lengths);
     free(expr);
 }
 
@@ -169,7 +213,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // items_rest ::= item items_rest | ε
-    expr = volt_expression_create("items_rest");
+    expr = volt_expression_create_list("items_rest");
     VOLT_ALT(expr, volt_expr("item"), volt_expr("items_rest"));
     VOLT_ALT(expr);  // Empty
     volt_expression_registry_add(registry, expr);
@@ -191,10 +235,14 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     // ATTRIBUTES
 
     // attributes ::= @ IDENTIFIER LPAREN array_literal RPAREN
+    //              | @ IDENTIFIER LPAREN STRING_LITERAL RPAREN
     expr = volt_expression_create("attributes");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_AT), volt_token(VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL),
              volt_token(VOLT_TOKEN_TYPE_LPAREN), volt_expr("array_literal"),
              volt_token(VOLT_TOKEN_TYPE_RPAREN));
+    VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_AT), volt_token(VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL),
+             volt_token(VOLT_TOKEN_TYPE_LPAREN), volt_token(VOLT_TOKEN_TYPE_STRING_LITERAL),
+             volt_token(VOLT_TOKEN_TYPE_RPAREN));
     volt_expression_registry_add(registry, expr);
 
     // use_decl ::= use use_path SEMICOLON
@@ -217,7 +265,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // use_path_rest ::= :: IDENTIFIER use_path_rest | ε
-    expr = volt_expression_create("use_path_rest");
+    expr = volt_expression_create_list("use_path_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COLON_COLON),
              volt_token(VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL), volt_expr("use_path_rest"));
     VOLT_ALT(expr);  // Empty
@@ -229,7 +277,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // string_list_rest ::= COMMA STRING_LITERAL string_list_rest | ε
-    expr = volt_expression_create("string_list_rest");
+    expr = volt_expression_create_list("string_list_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_token(VOLT_TOKEN_TYPE_STRING_LITERAL),
              volt_expr("string_list_rest"));
     VOLT_ALT(expr);  // Empty
@@ -249,7 +297,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // namespace_path_rest ::= :: IDENTIFIER namespace_path_rest | ε
-    expr = volt_expression_create("namespace_path_rest");
+    expr = volt_expression_create_list("namespace_path_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COLON_COLON),
              volt_token(VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL), volt_expr("namespace_path_rest"));
     VOLT_ALT(expr);  // Empty
@@ -263,7 +311,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
              volt_opt_token(VOLT_TOKEN_TYPE_ATTACH_KW), volt_token(VOLT_TOKEN_TYPE_FN_KW),
              volt_token(VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL), volt_token(VOLT_TOKEN_TYPE_LPAREN),
              volt_expr("params"), volt_token(VOLT_TOKEN_TYPE_RPAREN), volt_opt_expr("error_type"),
-             volt_token(VOLT_TOKEN_TYPE_TACK_RANGLE), volt_expr("type"), volt_expr("block"));
+             volt_token(VOLT_TOKEN_TYPE_TACK_RANGLE), volt_expr("type"), volt_body("block"));
     volt_expression_registry_add(registry, expr);
 
     // visibility ::= public | intern
@@ -295,7 +343,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
              volt_opt_token(VOLT_TOKEN_TYPE_STRING_LITERAL), volt_token(VOLT_TOKEN_TYPE_FN_KW),
              volt_token(VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL), volt_token(VOLT_TOKEN_TYPE_LPAREN),
              volt_expr("params"), volt_token(VOLT_TOKEN_TYPE_RPAREN), volt_opt_expr("error_type"),
-             volt_token(VOLT_TOKEN_TYPE_TACK_RANGLE), volt_expr("type"), volt_expr("block"));
+             volt_token(VOLT_TOKEN_TYPE_TACK_RANGLE), volt_expr("type"), volt_body("block"));
     volt_expression_registry_add(registry, expr);
 
     // generics ::= LANGLE generic_params RANGLE (for definitions)
@@ -316,7 +364,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // generic_params_rest ::= COMMA generic_param generic_params_rest | ε
-    expr = volt_expression_create("generic_params_rest");
+    expr = volt_expression_create_list("generic_params_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("generic_param"),
              volt_expr("generic_params_rest"));
     VOLT_ALT(expr);  // Empty
@@ -359,7 +407,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // params_rest ::= COMMA param params_rest | ε
-    expr = volt_expression_create("params_rest");
+    expr = volt_expression_create_list("params_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("param"), volt_expr("params_rest"));
     VOLT_ALT(expr);  // Empty
     volt_expression_registry_add(registry, expr);
@@ -470,7 +518,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // type_list_rest ::= COMMA tuple_field type_list_rest | ε
-    expr = volt_expression_create("type_list_rest");
+    expr = volt_expression_create_list("type_list_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("tuple_field"),
              volt_expr("type_list_rest"));
     VOLT_ALT(expr);  // Empty
@@ -501,7 +549,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // type_suffixes_rest ::= type_suffix type_suffixes_rest | ε
-    expr = volt_expression_create("type_suffixes_rest");
+    expr = volt_expression_create_list("type_suffixes_rest");
     VOLT_ALT(expr, volt_expr("type_suffix"), volt_expr("type_suffixes_rest"));
     VOLT_ALT(expr);  // Empty
     volt_expression_registry_add(registry, expr);
@@ -539,7 +587,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // fields_rest ::= field fields_rest | ε
-    expr = volt_expression_create("fields_rest");
+    expr = volt_expression_create_list("fields_rest");
     VOLT_ALT(expr, volt_expr("field"), volt_expr("fields_rest"));
     VOLT_ALT(expr);  // Empty
     volt_expression_registry_add(registry, expr);
@@ -566,7 +614,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // enum_variants_rest ::= COMMA enum_variant enum_variants_rest | COMMA | ε
-    expr = volt_expression_create("enum_variants_rest");
+    expr = volt_expression_create_list("enum_variants_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("enum_variant"),
              volt_expr("enum_variants_rest"));
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA));  // Trailing comma
@@ -604,7 +652,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // trait_items_rest ::= trait_item trait_items_rest | ε
-    expr = volt_expression_create("trait_items_rest");
+    expr = volt_expression_create_list("trait_items_rest");
     VOLT_ALT(expr, volt_expr("trait_item"), volt_expr("trait_items_rest"));
     VOLT_ALT(expr);  // Empty
     volt_expression_registry_add(registry, expr);
@@ -640,7 +688,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // statements_rest ::= statement statements_rest | ε
-    expr = volt_expression_create("statements_rest");
+    expr = volt_expression_create_list("statements_rest");
     VOLT_ALT(expr, volt_expr("statement"), volt_expr("statements_rest"));
     VOLT_ALT(expr);  // Empty
     volt_expression_registry_add(registry, expr);
@@ -794,7 +842,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // capture_list_rest ::= COMMA capture capture_list_rest | ε
-    expr = volt_expression_create("capture_list_rest");
+    expr = volt_expression_create_list("capture_list_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("capture"),
              volt_expr("capture_list_rest"));
     VOLT_ALT(expr);  // Empty
@@ -829,7 +877,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // match_arms_rest ::= match_arm match_arms_rest | ε
-    expr = volt_expression_create("match_arms_rest");
+    expr = volt_expression_create_list("match_arms_rest");
     VOLT_ALT(expr, volt_expr("match_arm"), volt_expr("match_arms_rest"));
     VOLT_ALT(expr);  // Empty
     volt_expression_registry_add(registry, expr);
@@ -1117,7 +1165,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // args_rest ::= COMMA expression args_rest | ε
-    expr = volt_expression_create("args_rest");
+    expr = volt_expression_create_list("args_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("expression"),
              volt_expr("args_rest"));
     VOLT_ALT(expr);  // Empty
@@ -1207,7 +1255,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // field_inits_rest ::= COMMA field_init field_inits_rest | ε
-    expr = volt_expression_create("field_inits_rest");
+    expr = volt_expression_create_list("field_inits_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("field_init"),
              volt_expr("field_inits_rest"));
     VOLT_ALT(expr);  // Empty
@@ -1234,7 +1282,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // array_elements_rest ::= COMMA expression array_elements_rest | ε
-    expr = volt_expression_create("array_elements_rest");
+    expr = volt_expression_create_list("array_elements_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("expression"),
              volt_expr("array_elements_rest"));
     VOLT_ALT(expr);  // Empty
@@ -1254,7 +1302,7 @@ void volt_define_expressions(volt_expression_registry_t* registry) {
     volt_expression_registry_add(registry, expr);
 
     // closure_captures_rest ::= COMMA closure_capture closure_captures_rest | ε
-    expr = volt_expression_create("closure_captures_rest");
+    expr = volt_expression_create_list("closure_captures_rest");
     VOLT_ALT(expr, volt_token(VOLT_TOKEN_TYPE_COMMA), volt_expr("closure_capture"),
              volt_expr("closure_captures_rest"));
     VOLT_ALT(expr);  // Empty
@@ -5,10 +5,12 @@
 // HELPER FUNCTIONS
 static volt_token_t* volt_parser_peek(volt_parser_t* parser, size_t offset) {
     size_t index = parser->current + offset;
+    if (index >= parser->examined)
+        parser->examined = index + 1;
     if (index >= parser->tokens->size) {
         return NULL;
     }
-    return (volt_token_t*) volt_vector_get(parser->tokens, index);
+    return volt_token_vector_get(parser->tokens, index);
 }
 
 static volt_token_t* volt_parser_current_token(volt_parser_t* parser) {
@@ -25,31 +27,104 @@ static void volt_parser_advance(volt_parser_t* parser) {
     }
 }
 
+// Token types named in a parse error before the rest are summarized as "and N more"
+#define VOLT_PARSER_EXPECTED_LISTED 8
+
+// Forgets the recorded failure, so the next one at or after `position` is the furthest
+static void volt_parser_clear_failure(volt_parser_t* parser, size_t position) {
+    parser->furthest_error_pos  = position;
+    parser->furthest_error_rule = NULL;
+    parser->furthest_error_msg  = NULL;
+    parser->error_reported      = false;
+    memset(parser->furthest_expected, 0, sizeof(parser->furthest_expected));
+}
+
+// Failures are only recorded while backtracking; the message is built once, at report time.
+// Returns false when something already failed further in.
+static bool volt_parser_fail_at(volt_parser_t* parser, size_t position) {
+    if (position < parser->furthest_error_pos)
+        return false;
+
+    if (position > parser->furthest_error_pos)
+        volt_parser_clear_failure(parser, position);
+    return true;
+}
+
+static void volt_parser_expect(volt_parser_t* parser, volt_token_type_t expected) {
+    if (volt_parser_fail_at(parser, parser->current))
+        parser->furthest_expected[expected / 64] |= (uint64_t) 1 << (expected % 64);
+}
+
+static bool volt_parser_was_expected(volt_parser_t* parser, size_t type) {
+    return (parser->furthest_expected[type / 64] >> (type % 64)) & 1;
+}
+
+static void volt_parser_fail_rule(volt_parser_t* parser, const volt_expression_t* rule) {
+    // Inner rules fail first, so the first one recorded at a position is the most specific
+    if (volt_parser_fail_at(parser, parser->current) && !parser->furthest_error_rule)
+        parser->furthest_error_rule = rule;
+}
+
 static void volt_parser_error(volt_parser_t* parser, const char* message) {
-    // Only track the error that got furthest
-    if (parser->current > parser->furthest_error_pos) {
-        parser->furthest_error_pos = parser->current;
-        snprintf(parser->furthest_error_msg, sizeof(parser->furthest_error_msg), "%s", message);
-        parser->error_reported = false;
-    }
+    if (volt_parser_fail_at(parser, parser->current) && !parser->furthest_error_rule &&
+        !parser->furthest_error_msg)
+        parser->furthest_error_msg = message;
 }
 
 static void volt_parser_report_error(volt_parser_t* parser) {
     if (parser->error_reported)
         return;
 
-    volt_error_t  error = {0};
-    volt_token_t* token =
-        (volt_token_t*) volt_vector_get(parser->tokens, parser->furthest_error_pos);
+    volt_error_t  error  = {0};
+    volt_token_t* token  = volt_token_vector_get(parser->tokens, parser->furthest_error_pos);
+    bool          at_end = !token;
 
     if (!token && parser->furthest_error_pos > 0) {
-        token = (volt_token_t*) volt_vector_get(parser->tokens, parser->furthest_error_pos - 1);
+        token = volt_token_vector_get(parser->tokens, parser->furthest_error_pos - 1);
+    }
+
+    char   message[512];
+    size_t length;
+    int    written;
+    if (parser->furthest_error_rule) {
+        written = snprintf(message, sizeof(message), "Failed to parse '%s'",
+                           parser->furthest_error_rule->expression_name);
+    } else if (parser->furthest_error_msg) {
+        written = snprintf(message, sizeof(message), "%s", parser->furthest_error_msg);
+    } else if (at_end) {
+        written = snprintf(message, sizeof(message), "Unexpected end of input");
+    } else {
+        written = snprintf(message, sizeof(message), "Unexpected '%s'", token->lexeme);
+    }
+    length = written > 0 ? (size_t) written : 0;
+
+    size_t expected_count = 0;
+    for (size_t type = 0; type < VOLT_TOKEN_TYPE_COUNT; type++)
+        expected_count += volt_parser_was_expected(parser, type);
+
+    const char* separator = expected_count == 1 ? ", expected " : ", expected one of: ";
+    size_t      listed    = 0;
+    for (size_t type = 0; type < VOLT_TOKEN_TYPE_COUNT && length < sizeof(message); type++) {
+        if (!volt_parser_was_expected(parser, type))
+            continue;
+
+        if (listed == VOLT_PARSER_EXPECTED_LISTED) {
+            written = snprintf(message + length, sizeof(message) - length, " and %zu more",
+                               expected_count - listed);
+            length += written > 0 ? (size_t) written : 0;
+            break;
+        }
+
+        written = snprintf(message + length, sizeof(message) - length, "%s%s", separator,
+                           volt_token_type_to_string((volt_token_type_t) type));
+        length += written > 0 ? (size_t) written : 0;
+        separator = ", ";
+        listed++;
     }
 
     if (token) {
-        volt_error_init(parser->error_handler, &error, parser->furthest_error_msg,
-                        VOLT_ERROR_TYPE_ERROR, parser->input_stream_name, token->line,
-                        token->column);
+        volt_error_init(parser->error_handler, &error, message, VOLT_ERROR_TYPE_ERROR,
+                        parser->input_stream_name, token->line, token->column);
         volt_error_handler_push_error(parser->error_handler, &error);
     }
 
@@ -57,149 +132,411 @@ static void volt_parser_report_error(volt_parser_t* parser) {
 }
 
 // AST NODE FUNCTIONS
+
+// Children arrays are carved out of the node arena at their final size. The AST is not edited
+// after parsing, so this allocator only has to keep the arena's memory away from free().
+static void* volt_ast_children_malloc(size_t size) {
+    (void) size;
+    return NULL;
+}
+
+static void* volt_ast_children_realloc(void* ptr, size_t size) {
+    (void) ptr;
+    (void) size;
+    return NULL;
+}
+
+static void volt_ast_children_free(void* ptr) {
+    (void) ptr;
+}
+
+static volt_allocator_t volt_ast_children_allocator = {.malloc    = volt_ast_children_malloc,
+                                                       .realloc   = volt_ast_children_realloc,
+                                                       .free      = volt_ast_children_free,
+                                                       .user_data = NULL};
+
 volt_ast_node_t* volt_ast_node_create(volt_parser_t* parser, volt_ast_node_type_t type,
-                                      const char* expression_name) {
-    volt_ast_node_t* node = (volt_ast_node_t*) parser->allocator->malloc(sizeof(volt_ast_node_t));
+                                      const char* expression_name, volt_ast_node_t** children,
+                                      size_t child_count) {
+    volt_ast_node_t* node = volt_arena_alloc(&parser->nodes, sizeof(volt_ast_node_t));
 
     if (!node)
         return NULL;
 
     node->type            = type;
+    node->skipped         = false;
     node->expression_name = expression_name;
     node->token           = NULL;
+    node->data            = NULL;
 
-    volt_vector_t vector = {0};
-    vector.allocator     = parser->allocator;
-    volt_vector_init(&vector);
+    volt_small_vector_t vector = {0};
+    vector.allocator           = &volt_ast_children_allocator;
+    volt_small_vector_init(&vector);
 
-    node->children = vector;
-    node->data     = NULL;
+    if (child_count > VOLT_SMALL_VECTOR_INLINE) {
+        vector.heap = volt_arena_alloc(&parser->nodes, child_count * sizeof(volt_ast_node_t*));
+        if (!vector.heap)
+            return NULL;
+        vector.capacity = child_count;
+    }
+    if (child_count > 0)
+        memcpy(volt_small_vector_data(&vector), children, child_count * sizeof(volt_ast_node_t*));
+    vector.size = child_count;
 
+    node->children = vector;
     return node;
 }
 
-void volt_ast_node_add_child(volt_ast_node_t* parent, volt_ast_node_t* child) {
-    if (parent && child) {
-        volt_vector_push_back(&parent->children, child);
+// AST QUERY FUNCTIONS
+bool volt_ast_is(volt_ast_node_t* node, const char* expression_name) {
+    return node && node->type == VOLT_AST_NODE_EXPRESSION && node->expression_name &&
+           strcmp(node->expression_name, expression_name) == 0;
+}
+
+volt_ast_node_t* volt_ast_get_child(volt_ast_node_t* node, size_t index) {
+    if (!node)
+        return NULL;
+    return (volt_ast_node_t*) volt_small_vector_get(&node->children, index);
+}
+
+volt_ast_node_t* volt_ast_find_child(volt_ast_node_t* node, const char* expression_name) {
+    if (!node)
+        return NULL;
+    for (size_t i = 0; i < node->children.size; i++) {
+        volt_ast_node_t* child = volt_ast_get_child(node, i);
+        if (volt_ast_is(child, expression_name))
+            return child;
     }
+    return NULL;
 }
 
-void volt_ast_node_free(volt_parser_t* parser, volt_ast_node_t* node) {
+volt_token_t* volt_ast_find_token(volt_ast_node_t* node, volt_token_type_t type) {
     if (!node)
-        return;
+        return NULL;
+    for (size_t i = 0; i < node->children.size; i++) {
+        volt_ast_node_t* child = volt_ast_get_child(node, i);
+        if (child && child->type == VOLT_AST_NODE_TOKEN && child->token &&
+            child->token->type == type) {
+            return child->token;
+        }
+    }
+    return NULL;
+}
 
+volt_token_t* volt_ast_first_token(volt_ast_node_t* node) {
+    if (!node)
+        return NULL;
+    if (node->type == VOLT_AST_NODE_TOKEN)
+        return node->token;
     for (size_t i = 0; i < node->children.size; i++) {
-        volt_ast_node_t* child = (volt_ast_node_t*) volt_vector_get(&node->children, i);
-        volt_ast_node_free(parser, child);
+        volt_token_t* token = volt_ast_first_token(volt_ast_get_child(node, i));
+        if (token)
+            return token;
     }
+    return NULL;
+}
+
+const char* volt_ast_get_identifier(volt_ast_node_t* node) {
+    volt_token_t* token = volt_ast_find_token(node, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    return token ? token->lexeme : NULL;
+}
+
+static bool volt_ast_is_empty_rest(volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION || node->children.size != 0)
+        return false;
+    size_t len = strlen(node->expression_name);
+    return len > 5 && strcmp(node->expression_name + len - 5, "_rest") == 0;
+}
 
-    volt_vector_deinit(&node->children);
+// Strips the precedence-climbing wrappers (expression -> assignment_expr -> ... -> primary_expr)
+// down to the first node that actually carries an operator, token or construct.
+volt_ast_node_t* volt_ast_unwrap(volt_ast_node_t* node) {
+    while (node && node->type == VOLT_AST_NODE_EXPRESSION) {
+        volt_ast_node_t* inner = NULL;
+        for (size_t i = 0; i < node->children.size; i++) {
+            volt_ast_node_t* child = volt_ast_get_child(node, i);
+            if (volt_ast_is_empty_rest(child))
+                continue;
+            if (inner || child->type != VOLT_AST_NODE_EXPRESSION) {
+                inner = NULL;
+                break;
+            }
+            inner = child;
+        }
+        if (!inner)
+            break;
+        node = inner;
+    }
+    return node;
+}
 
-    parser->allocator->free(node);
+// Collects the items of a list (`x ::= item x_rest`, `x_rest ::= sep? item x_rest | ε`) into
+// `out`, in source order. List rules already parse x_rest flat; nested rests are followed too.
+// Returns the number of items appended.
+size_t volt_ast_collect_list(volt_ast_node_t* list, const char* item_name, volt_vector_t* out) {
+    if (!list)
+        return 0;
+
+    size_t count = 0;
+    for (size_t i = 0; i < list->children.size; i++) {
+        volt_ast_node_t* child = volt_ast_get_child(list, i);
+        if (!child || child->type != VOLT_AST_NODE_EXPRESSION)
+            continue;
+        if (volt_ast_is(child, item_name)) {
+            volt_vector_push_back(out, child);
+            count++;
+            continue;
+        }
+        size_t len = strlen(child->expression_name);
+        if (len > 5 && strcmp(child->expression_name + len - 5, "_rest") == 0)
+            count += volt_ast_collect_list(child, item_name, out);
+    }
+    return count;
 }
 
 // PARSING FUNCTIONS
 // Forward declaration
-static volt_ast_node_t* volt_parser_parse_expression(volt_parser_t*     parser,
-                                                     volt_expression_t* expr);
+static volt_ast_node_t* volt_parser_parse_expression(volt_parser_t*           parser,
+                                                     const volt_expression_t* expr);
 
 // Try to match a specific token type
 static volt_ast_node_t* volt_parser_match_token(volt_parser_t* parser, volt_token_type_t expected) {
     volt_token_t* token = volt_parser_current_token(parser);
 
-    if (!token) {
-        volt_parser_error(parser, "Unexpected end of input");
-        return NULL;
-    }
-
-    if (token->type != expected) {
+    if (!token || token->type != expected) {
+        volt_parser_expect(parser, expected);
         return NULL;
     }
 
     // Create AST node for token
-    volt_ast_node_t* node = volt_ast_node_create(parser, VOLT_AST_NODE_TOKEN, "token");
-    node->token           = token;
+    volt_ast_node_t* node = volt_ast_node_create(parser, VOLT_AST_NODE_TOKEN, "token", NULL, 0);
+    if (!node)
+        return NULL;
+    node->token = token;
 
     volt_parser_advance(parser);
     return node;
 }
 
-// Try to parse a subexpression by name
-static volt_ast_node_t* volt_parser_parse_subexpression(volt_parser_t* parser,
-                                                        const char*    expr_name) {
-    volt_expression_t* expr = volt_expression_registry_get(parser->registry, expr_name);
+static volt_ast_node_t* volt_parser_unknown_rule(volt_parser_t* parser) {
+    volt_parser_error(parser, "Unknown expression");
+    return NULL;
+}
+
+// Try to parse a subexpression through the rule index resolved for it
+static volt_ast_node_t* volt_parser_parse_subexpression(volt_parser_t*              parser,
+                                                        const volt_subexpression_t* sub) {
+    if (sub->rule >= parser->registry->count)
+        return volt_parser_unknown_rule(parser);
 
-    if (!expr) {
-        volt_parser_error(parser, "Unknown expression");
+    return volt_parser_parse_expression(parser, parser->registry->expressions[sub->rule]);
+}
+
+// A function body skipped by lazy parsing: enough to parse it in place later
+typedef struct volt_parser_skipped_body_t volt_parser_skipped_body_t;
+struct volt_parser_skipped_body_t {
+    volt_parser_t*              parser;
+    const volt_subexpression_t* element;  // The body element of the grammar, for its rule
+    size_t                      start;    // Token index of the opening brace
+    size_t                      length;   // Tokens it spans, braces included
+    bool                        failed;   // Parsed once already, with a syntax error
+};
+
+// Index of the brace closing the one at `start`, or the token count when it is never closed
+static size_t volt_parser_body_end(volt_parser_t* parser, size_t start) {
+    size_t depth = 0;
+    size_t end   = start;
+    for (; end < parser->tokens->size; end++) {
+        volt_token_type_t type = parser->tokens->data[end].type;
+        if (type == VOLT_TOKEN_TYPE_LBRACE)
+            depth++;
+        else if (type == VOLT_TOKEN_TYPE_RBRACE && --depth == 0)
+            break;
+    }
+
+    if (end + 1 > parser->examined)
+        parser->examined = end + 1;
+    return end;
+}
+
+// Steps over a brace-balanced body without parsing it, leaving a childless placeholder named
+// after the body's rule for volt_ast_parse_body
+static volt_ast_node_t* volt_parser_skip_body(volt_parser_t*              parser,
+                                              const volt_subexpression_t* element) {
+    volt_token_t* token = volt_parser_current_token(parser);
+    if (!token || token->type != VOLT_TOKEN_TYPE_LBRACE) {
+        volt_parser_expect(parser, VOLT_TOKEN_TYPE_LBRACE);
+        return NULL;
+    }
+
+    size_t start = parser->current;
+    size_t end   = volt_parser_body_end(parser, start);
+
+    if (end == parser->tokens->size) {
+        // The closing brace is missing, so the input ends inside the body
+        parser->current = end;
+        volt_parser_expect(parser, VOLT_TOKEN_TYPE_RBRACE);
+        parser->current = start;
         return NULL;
     }
 
-    return volt_parser_parse_expression(parser, expr);
+    volt_parser_skipped_body_t* skipped =
+        volt_arena_alloc(&parser->nodes, sizeof(volt_parser_skipped_body_t));
+    volt_ast_node_t* node =
+        volt_ast_node_create(parser, VOLT_AST_NODE_EXPRESSION, element->subexpression, NULL, 0);
+    if (!skipped || !node)
+        return NULL;
+
+    skipped->parser  = parser;
+    skipped->element = element;
+    skipped->start   = start;
+    skipped->length  = end + 1 - start;
+    skipped->failed  = false;
+    node->skipped    = true;
+    node->data       = skipped;
+
+    parser->current = end + 1;
+    return node;
+}
+
+// Where an alternative started: everything after it is undone if the alternative fails
+typedef struct volt_parser_checkpoint_t volt_parser_checkpoint_t;
+struct volt_parser_checkpoint_t {
+    size_t            position;
+    volt_arena_mark_t nodes;
+    size_t            first_child;
+};
+
+static volt_parser_checkpoint_t volt_parser_checkpoint(volt_parser_t* parser) {
+    volt_parser_checkpoint_t checkpoint;
+    checkpoint.position    = parser->current;
+    checkpoint.nodes       = volt_arena_mark(&parser->nodes);
+    checkpoint.first_child = parser->pending.size;
+    return checkpoint;
 }
 
-// Try to parse a single alternative
-static volt_ast_node_t* volt_parser_try_alternative(volt_parser_t* parser, volt_expression_t* expr,
-                                                    size_t alt_index) {
-    size_t                saved_position = parser->current;
-    volt_subexpression_t* alt            = expr->alternatives[alt_index];
-    size_t                alt_len        = expr->alternative_lengths[alt_index];
+// Drops the pending children and every node made since the checkpoint, and rewinds
+static void volt_parser_backtrack(volt_parser_t* parser, volt_parser_checkpoint_t checkpoint) {
+    parser->pending.size = checkpoint.first_child;
+    volt_arena_release(&parser->nodes, checkpoint.nodes);
+    parser->current = checkpoint.position;
+}
+
+// Holds a matched child until the whole alternative has matched. False when it didn't match.
+static bool volt_parser_push_child(volt_parser_t* parser, volt_ast_node_t* child) {
+    return child && volt_ast_node_vector_push_back(&parser->pending, child) == VOLT_SUCCESS;
+}
 
-    // Create parent node for this alternative
-    volt_ast_node_t* parent =
-        volt_ast_node_create(parser, VOLT_AST_NODE_EXPRESSION, expr->expression_name);
+// Same for an optional element, where a missing child is fine
+static bool volt_parser_push_optional(volt_parser_t* parser, volt_ast_node_t* child) {
+    return !child || volt_parser_push_child(parser, child);
+}
+
+// Match `count` elements of an alternative, leaving their nodes on parser->pending. On failure
+// everything is rolled back (position, pending children and nodes) and false is returned.
+static bool volt_parser_match_sequence(volt_parser_t* parser, const volt_subexpression_t* alt,
+                                       size_t count) {
+    volt_parser_checkpoint_t checkpoint = volt_parser_checkpoint(parser);
 
     // Try to match each element in the alternative
-    for (size_t i = 0; i < alt_len; i++) {
+    for (size_t i = 0; i < count; i++) {
         volt_ast_node_t* child = NULL;
 
-        if (alt[i].is_subexpression) {
+        if (alt[i].is_subexpression && alt[i].is_body && parser->lazy_bodies) {
+            // Function body, parsed when first needed
+            child = volt_parser_skip_body(parser, &alt[i]);
+        } else if (alt[i].is_subexpression) {
             // Parse subexpression
-            child = volt_parser_parse_subexpression(parser, alt[i].subexpression);
-
-            if (!child) {
-                if (alt[i].is_optional) {
-                    // Optional element not present - that's OK
-                    continue;
-                } else {
-                    // Required element failed - backtrack
-                    volt_ast_node_free(parser, parent);
-                    parser->current = saved_position;
-                    return NULL;
-                }
-            }
+            child = volt_parser_parse_subexpression(parser, &alt[i]);
         } else {
             // Match token
             child = volt_parser_match_token(parser, alt[i].token_type);
+        }
 
-            if (!child) {
-                if (alt[i].is_optional) {
-                    // Optional token not present - that's OK
-                    continue;
-                } else {
-                    // Required token failed - backtrack
-                    volt_ast_node_free(parser, parent);
-                    parser->current = saved_position;
-                    return NULL;
-                }
-            }
+        bool matched = alt[i].is_optional ? volt_parser_push_optional(parser, child)
+                                          : volt_parser_push_child(parser, child);
+        if (!matched) {
+            // Required element failed - backtrack, dropping every node made since the mark
+            volt_parser_backtrack(parser, checkpoint);
+            return false;
         }
+    }
+
+    return true;
+}
+
+// Wrap the children pushed since `first_child` into a node for `expr`
+static volt_ast_node_t* volt_parser_reduce(volt_parser_t* parser, const volt_expression_t* expr,
+                                           size_t first_child) {
+    volt_ast_node_t* node =
+        volt_ast_node_create(parser, VOLT_AST_NODE_EXPRESSION, expr->expression_name,
+                             parser->pending.data + first_child, parser->pending.size - first_child);
+    parser->pending.size = first_child;
+    return node;
+}
+
+// Try to parse a single alternative
+static volt_ast_node_t* volt_parser_try_alternative(volt_parser_t*           parser,
+                                                    const volt_expression_t* expr,
+                                                    size_t                   alt_index) {
+    size_t first_child = parser->pending.size;
+    if (!volt_parser_match_sequence(parser, expr->alternatives[alt_index],
+                                    expr->alternative_lengths[alt_index]))
+        return NULL;
+
+    // Success! Build the parent around the children it matched
+    return volt_parser_reduce(parser, expr, first_child);
+}
 
-        // Add successfully parsed child
-        if (child) {
-            volt_ast_node_add_child(parent, child);
+// Whether the alternative ends by recursing into its own rule (`x_rest ::= sep? item x_rest`)
+static bool volt_parser_is_tail_recursive(volt_parser_t* parser, const volt_expression_t* expr,
+                                          size_t alt_index) {
+    size_t length = expr->alternative_lengths[alt_index];
+    if (length == 0)
+        return false;
+
+    const volt_subexpression_t* last = &expr->alternatives[alt_index][length - 1];
+    return last->is_subexpression && last->rule < parser->registry->count &&
+           parser->registry->expressions[last->rule] == expr;
+}
+
+// A list rule is matched in a loop instead of recursing once per item, so long files don't grow
+// the C stack. Each round matches the first alternative that fits; a tail-recursive one goes
+// around again without its last element, anything else (the separator-only or ε alternative)
+// ends the list. Every item and separator ends up a direct child of one `x_rest` node.
+static volt_ast_node_t* volt_parser_parse_list(volt_parser_t*           parser,
+                                               const volt_expression_t* expr) {
+    size_t first_child = parser->pending.size;
+
+    bool more = true;
+    while (more) {
+        size_t start = parser->current;
+        more         = false;
+
+        for (size_t i = 0; i < expr->num_alternatives; i++) {
+            bool   tail   = volt_parser_is_tail_recursive(parser, expr, i);
+            size_t length = expr->alternative_lengths[i] - (tail ? 1 : 0);
+            if (volt_parser_match_sequence(parser, expr->alternatives[i], length)) {
+                // A round that consumed nothing would go around forever
+                more = tail && parser->current > start;
+                break;
+            }
         }
     }
 
-    // Success!
-    return parent;
+    // List rules always end in ε, so running out of alternatives just ends the list
+    return volt_parser_reduce(parser, expr, first_child);
 }
 
 // Parse an expression by trying all alternatives
-static volt_ast_node_t* volt_parser_parse_expression(volt_parser_t*     parser,
-                                                     volt_expression_t* expr) {
+static volt_ast_node_t* volt_parser_parse_expression(volt_parser_t*           parser,
+                                                     const volt_expression_t* expr) {
     if (!expr)
         return NULL;
 
+    if (expr->is_list)
+        return volt_parser_parse_list(parser, expr);
+
     // Try each alternative in order
     for (size_t i = 0; i < expr->num_alternatives; i++) {
         volt_ast_node_t* result = volt_parser_try_alternative(parser, expr, i);
@@ -211,57 +548,189 @@ static volt_ast_node_t* volt_parser_parse_expression(volt_parser_t*     parser,
     }
 
     // None of the alternatives matched - track error
-    char error_msg[256];
-    snprintf(error_msg, sizeof(error_msg), "Failed to parse '%s'", expr->expression_name);
-    volt_parser_error(parser, error_msg);
+    volt_parser_fail_rule(parser, expr);
     return NULL;
 }
 
-volt_status_code_t volt_parser_init(volt_parser_t* parser, volt_allocator_t* allocator,
-                                    volt_vector_t* tokens, volt_error_handler_t* error_handler,
-                                    const char* input_stream_name) {
-    static volt_expression_registry_t expression_registry  = {0};
-    static bool                       registry_initialized = false;
+#ifdef VOLT_GENERATED_PARSER
+static volt_token_type_t volt_parser_lookahead(volt_parser_t* parser) {
+    volt_token_t* token = volt_parser_current_token(parser);
+    return token ? token->type : VOLT_TOKEN_TYPE_NONE;
+}
 
-    if (!registry_initialized) {
-        volt_expression_registry_init(&expression_registry, allocator);
-        volt_define_expressions(&expression_registry);
-        registry_initialized = true;
+// The grammar as read-only tables (volt_grammar) and one function per rule and alternative,
+// generated from volt_define_expressions by tools/volt_pgen.c
+#include <parser_generated.inc>
+#else
+// Without the generator the grammar is assembled on first use and kept for the whole process
+static const volt_expression_registry_t* volt_parser_grammar(void) {
+    static volt_expression_registry_t registry    = {0};
+    static bool                       initialized = false;
+
+    if (!initialized) {
+        volt_expression_registry_init(&registry, NULL);
+        volt_define_expressions(&registry);
+        volt_expression_registry_resolve(&registry);
+        initialized = true;
     }
+    return &registry;
+}
+#endif
+
+// Parses one rule through the generated parser when there is one, else through the grammar
+static volt_ast_node_t* volt_parser_parse_rule(volt_parser_t* parser, size_t rule) {
+    if (rule >= parser->registry->count)
+        return volt_parser_unknown_rule(parser);
+
+#ifdef VOLT_GENERATED_PARSER
+    if (!parser->interpreted && volt_gen_rules[rule])
+        return volt_gen_rules[rule](parser);
+#endif
+    return volt_parser_parse_expression(parser, parser->registry->expressions[rule]);
+}
 
+volt_status_code_t volt_parser_init(volt_parser_t* parser, volt_allocator_t* allocator,
+                                    volt_token_vector_t* tokens, volt_error_handler_t* error_handler,
+                                    const char* input_stream_name) {
     parser->allocator         = allocator ? allocator : &volt_default_allocator;
     parser->tokens            = tokens;
     parser->current           = 0;
-    parser->registry          = &expression_registry;
+#ifdef VOLT_GENERATED_PARSER
+    parser->registry          = &volt_grammar;
+    parser->interpreted       = false;
+#else
+    parser->registry          = volt_parser_grammar();
+    parser->interpreted       = true;
+#endif
     parser->root              = NULL;
     parser->error_handler     = error_handler;
+    parser->pending.allocator = parser->allocator;
     parser->input_stream_name = input_stream_name;
+    parser->lazy_bodies       = false;
+    parser->items.allocator   = parser->allocator;
+    parser->token_data        = NULL;
+    parser->examined          = 0;
+    parser->stale             = 0;
+    parser->generation        = 0;
+
+    parser->top_level           = volt_small_vector_default();
+    parser->top_level.allocator = parser->allocator;
+
+    volt_arena_init(&parser->nodes, parser->allocator);
+    volt_ast_node_vector_init(&parser->pending);
+    volt_parser_item_vector_init(&parser->items);
 
     // Initialize error tracking
-    parser->furthest_error_pos    = 0;
-    parser->furthest_error_msg[0] = '\0';
-    parser->error_reported        = false;
+    volt_parser_clear_failure(parser, 0);
 
     return VOLT_SUCCESS;
 }
 
-volt_status_code_t volt_parser_parse(volt_parser_t* parser) {
-    if (!parser || !parser->tokens || !parser->registry) {
-        return VOLT_FAILURE;
+// TOP-LEVEL ITEMS
+
+// The unit is matched one top-level item at a time, as `items` would match them, so each item's
+// token range is known and volt_parser_reparse can keep the items an edit did not reach
+
+// Parses the item at the current token and records the tokens it covered and looked at
+static bool volt_parser_parse_item(volt_parser_t* parser, size_t rule) {
+    volt_parser_item_t item = {0};
+    item.start              = parser->current;
+    parser->examined        = parser->current;
+
+    // An item that matched nothing would be matched forever, so it ends the list like ε
+    item.node = volt_parser_parse_rule(parser, rule);
+    if (!item.node || parser->current == item.start)
+        return false;
+
+    item.end      = parser->current;
+    item.examined = parser->examined > item.end ? parser->examined : item.end;
+    parser->stale += item.end - item.start;
+    return volt_parser_item_vector_push_back(&parser->items, item) == VOLT_SUCCESS;
+}
+
+// Wraps the items in the nodes the grammar builds around them: unit(items(item, items_rest))
+static volt_ast_node_t* volt_parser_build_unit(volt_parser_t* parser) {
+    const volt_expression_t* unit  = volt_expression_registry_get(parser->registry, "unit");
+    const volt_expression_t* items = volt_expression_registry_get(parser->registry, "items");
+    const volt_expression_t* rest  = volt_expression_registry_get(parser->registry, "items_rest");
+    if (!unit || !items || !rest)
+        return NULL;
+
+    size_t first_child = parser->pending.size;
+    bool   built       = true;
+    if (parser->items.size > 0) {
+        // The list can be long, so its children live in a buffer each reparse refills instead
+        // of a new copy in the arena every time
+        volt_ast_node_t* list = volt_ast_node_create(parser, VOLT_AST_NODE_EXPRESSION,
+                                                     rest->expression_name, NULL, 0);
+        parser->top_level.size = 0;
+        for (size_t i = 1; i < parser->items.size && built; i++)
+            built = volt_small_vector_push_back(&parser->top_level, parser->items.data[i].node) ==
+                    VOLT_SUCCESS;
+        if (list)
+            list->children = parser->top_level;
+
+        built = built && volt_parser_push_child(parser, parser->items.data[0].node) &&
+                volt_parser_push_child(parser, list);
     }
+    built = built && volt_parser_push_child(parser, volt_parser_reduce(parser, items, first_child));
 
-    // Start parsing from the "unit" expression (top-level)
-    volt_expression_t* unit_expr = volt_expression_registry_get(parser->registry, "unit");
+    if (!built) {
+        parser->pending.size = first_child;
+        return NULL;
+    }
+    return volt_parser_reduce(parser, unit, first_child);
+}
 
-    if (!unit_expr) {
-        volt_parser_error(parser, "No 'unit' expression defined in grammar");
-        volt_parser_report_error(parser);  // Report immediately
-        return VOLT_FAILURE;
+// Points a kept node at its tokens' new place, `index` being where its first token is now, and
+// returns the index after its last. Leaves come in token order, so the walk only has to count.
+static size_t volt_parser_rebase(volt_parser_t* parser, volt_ast_node_t* node, size_t index) {
+    if (node->type == VOLT_AST_NODE_TOKEN) {
+        node->token = &parser->tokens->data[index];
+        return index + 1;
     }
 
-    // Parse the entire input
-    parser->root = volt_parser_parse_expression(parser, unit_expr);
+    if (node->skipped) {
+        volt_parser_skipped_body_t* skipped = node->data;
+        skipped->start                      = index;
+        return index + skipped->length;
+    }
 
+    void** children = volt_small_vector_data(&node->children);
+    for (size_t i = 0; i < node->children.size; i++)
+        index = volt_parser_rebase(parser, children[i], index);
+    return index;
+}
+
+// Parses items from the current token to the end of the input. Once the parse reaches the start
+// of one of the `kept` old items (starts already moved to the new token indices), that item and
+// the ones after it are taken as they are: from there on the tokens are the same as before.
+static volt_status_code_t volt_parser_parse_items(volt_parser_t* parser, volt_parser_item_t* kept,
+                                                  size_t kept_count, bool moved) {
+    size_t rule = volt_expression_registry_index(parser->registry, "item");
+    size_t next = 0;
+
+    while (!volt_parser_is_at_end(parser)) {
+        while (next < kept_count && kept[next].start < parser->current)
+            next++;
+
+        if (next < kept_count && kept[next].start == parser->current) {
+            for (; next < kept_count; next++) {
+                if (moved)
+                    volt_parser_rebase(parser, kept[next].node, kept[next].start);
+                if (volt_parser_item_vector_push_back(&parser->items, kept[next]) != VOLT_SUCCESS)
+                    return VOLT_FAILURE;
+                parser->current = kept[next].end;
+            }
+            continue;
+        }
+
+        if (!volt_parser_parse_item(parser, rule))
+            break;
+    }
+
+    parser->root       = volt_parser_build_unit(parser);
+    parser->token_data = parser->tokens->data;
     if (!parser->root) {
         volt_parser_report_error(parser);  // Report the furthest error
         return VOLT_FAILURE;
@@ -277,6 +746,115 @@ volt_status_code_t volt_parser_parse(volt_parser_t* parser) {
     return VOLT_SUCCESS;
 }
 
+volt_status_code_t volt_parser_parse(volt_parser_t* parser) {
+    if (!parser || !parser->tokens || !parser->registry) {
+        return VOLT_FAILURE;
+    }
+
+    // The tree is built around the "unit" expression (top-level)
+    const volt_expression_t* unit_expr = volt_expression_registry_get(parser->registry, "unit");
+
+    if (!unit_expr) {
+        volt_parser_error(parser, "No 'unit' expression defined in grammar");
+        volt_parser_report_error(parser);  // Report immediately
+        return VOLT_FAILURE;
+    }
+
+    // Nodes of an earlier parse go with it
+    volt_arena_mark_t empty = {0};
+    volt_arena_release(&parser->nodes, empty);
+    volt_parser_clear_failure(parser, 0);
+    parser->current    = 0;
+    parser->items.size = 0;
+
+    // Parse the entire input
+    volt_status_code_t status = volt_parser_parse_items(parser, NULL, 0, false);
+    parser->stale             = 0;
+    parser->generation++;
+    return status;
+}
+
+volt_status_code_t volt_parser_reparse(volt_parser_t* parser, const volt_token_edit_t* edit) {
+    if (!parser || !edit || !parser->root || parser->stale > parser->tokens->size)
+        return volt_parser_parse(parser);
+
+    volt_parser_item_vector_t old = parser->items;
+    parser->items.data            = NULL;
+    parser->items.size            = 0;
+    parser->items.capacity        = 0;
+
+    // Items that never looked at the replaced tokens are kept where they are
+    size_t kept = 0;
+    while (kept < old.size && old.data[kept].examined <= edit->first)
+        kept++;
+
+    bool moved = parser->tokens->data != parser->token_data;
+    for (size_t i = 0; i < kept; i++) {
+        if (moved)
+            volt_parser_rebase(parser, old.data[i].node, old.data[i].start);
+        volt_parser_item_vector_push_back(&parser->items, old.data[i]);
+    }
+
+    // Items starting after them only moved, and are kept if the parse lines up with them again
+    size_t after = kept;
+    while (after < old.size && old.data[after].start < edit->first + edit->removed)
+        after++;
+    for (size_t i = after; i < old.size; i++) {
+        old.data[i].start    = old.data[i].start - edit->removed + edit->inserted;
+        old.data[i].end      = old.data[i].end - edit->removed + edit->inserted;
+        old.data[i].examined = old.data[i].examined - edit->removed + edit->inserted;
+    }
+
+    volt_parser_clear_failure(parser, 0);
+    parser->current = kept > 0 ? old.data[kept - 1].end : 0;
+
+    volt_status_code_t status = volt_parser_parse_items(
+        parser, old.data + after, old.size - after, moved || edit->removed != edit->inserted);
+
+    // The nodes wrapping the old items are left behind as well
+    parser->stale++;
+    volt_parser_item_vector_deinit(&old);
+    return status;
+}
+
+// LAZY FUNCTION BODIES
+
+volt_ast_node_t* volt_ast_parse_body(volt_ast_node_t* node) {
+    if (!node || !node->skipped)
+        return node;
+
+    volt_parser_skipped_body_t* skipped = node->data;
+    if (skipped->failed)
+        return NULL;
+
+    volt_parser_t* parser     = skipped->parser;
+    size_t         saved      = parser->current;
+    bool           saved_lazy = parser->lazy_bodies;
+    parser->current           = skipped->start;
+    parser->lazy_bodies       = false;  // Functions nested in the body are parsed with it
+    volt_parser_clear_failure(parser, skipped->start);
+
+    volt_ast_node_t* body = volt_parser_parse_rule(parser, skipped->element->rule);
+    if (!body)
+        volt_parser_report_error(parser);
+
+    parser->current     = saved;
+    parser->lazy_bodies = saved_lazy;
+    if (!body) {
+        skipped->failed = true;
+        return NULL;
+    }
+
+    node->children = body->children;
+    node->skipped  = false;
+    node->data     = NULL;
+    return node;
+}
+
+volt_ast_node_t* volt_ast_body(volt_ast_node_t* declaration) {
+    return volt_ast_parse_body(volt_ast_find_child(declaration, "block"));
+}
+
 void volt_ast_print_tree(volt_ast_node_t* node, int32_t indent) {
     if (!node)
         return;
@@ -299,6 +877,8 @@ void volt_ast_print_tree(volt_ast_node_t* node, int32_t indent) {
         printf("\n");
     } else if (node->type == VOLT_AST_NODE_EMPTY) {
         printf("EMPTY\n");
+    } else if (node->skipped) {
+        printf("EXPR: %s (skipped)\n", node->expression_name);
     } else {
         printf("EXPR: %s (%zu children)\n",
                node->expression_name ? node->expression_name : "unnamed", node->children.size);
@@ -306,7 +886,7 @@ void volt_ast_print_tree(volt_ast_node_t* node, int32_t indent) {
 
     // Print children recursively
     for (size_t i = 0; i < node->children.size; i++) {
-        volt_ast_node_t* child = (volt_ast_node_t*) volt_vector_get(&node->children, i);
+        volt_ast_node_t* child = (volt_ast_node_t*) volt_small_vector_get(&node->children, i);
         volt_ast_print_tree(child, indent + 1);
     }
 }
@@ -315,11 +895,12 @@ volt_status_code_t volt_parser_deinit(volt_parser_t* parser) {
     if (!parser)
         return VOLT_FAILURE;
 
-    // Free AST
-    if (parser->root) {
-        volt_ast_node_free(parser, parser->root);
-        parser->root = NULL;
-    }
+    // Free AST: every node lives in the arena
+    volt_arena_deinit(&parser->nodes);
+    volt_ast_node_vector_deinit(&parser->pending);
+    volt_parser_item_vector_deinit(&parser->items);
+    volt_small_vector_deinit(&parser->top_level);
+    parser->root = NULL;
 
     return VOLT_SUCCESS;
 }
\ No newline at end of file
@@ -1,16 +1,25 @@
 #include <pch.h>
 #include <semantic/analyzer.h>
+#include <semantic/coroutine.h>
+#include <semantic/devirt.h>
+#include <semantic/escape.h>
+#include <semantic/fallible.h>
+#include <semantic/format.h>
+#include <semantic/layout.h>
+#include <semantic/loop.h>
+#include <semantic/match.h>
 
 // HELPER FUNCTIONS
 
-static void volt_semantic_error(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* node,
-                                const char* message) {
+void volt_semantic_error(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* node,
+                         const char* message) {
     volt_error_t error = {0};
 
-    size_t line = 0, column = 0;
-    if (node && node->token) {
-        line   = node->token->line;
-        column = node->token->column;
+    size_t        line = 0, column = 0;
+    volt_token_t* token = volt_ast_first_token(node);
+    if (token) {
+        line   = token->line;
+        column = token->column;
     }
 
     const char* filename = analyzer->current_file_index < analyzer->ast_count
@@ -25,49 +34,8 @@ static void volt_semantic_error(volt_semantic_analyzer_t* analyzer, volt_ast_nod
     analyzer->error_count++;
 }
 
-// Helper function for getting node name
-static const char* volt_get_node_name(volt_ast_node_t* node) {
-    if (!node)
-        return NULL;
-    if (node->type == VOLT_AST_NODE_TOKEN && node->token) {
-        return node->token->lexeme;
-    }
-    return node->expression_name;
-}
-
-// Helper to find child node by expression name
-static volt_ast_node_t* volt_find_child(volt_ast_node_t* node, const char* expr_name) {
-    if (!node)
-        return NULL;
-    for (size_t i = 0; i < node->children.size; i++) {
-        volt_ast_node_t* child = (volt_ast_node_t*) volt_vector_get(&node->children, i);
-        if (child && child->expression_name && strcmp(child->expression_name, expr_name) == 0) {
-            return child;
-        }
-    }
-    return NULL;
-}
-
-// Helper to get token child by type
-static volt_token_t* volt_find_token(volt_ast_node_t* node, volt_token_type_t type) {
-    if (!node)
-        return NULL;
-    for (size_t i = 0; i < node->children.size; i++) {
-        volt_ast_node_t* child = (volt_ast_node_t*) volt_vector_get(&node->children, i);
-        if (child && child->type == VOLT_AST_NODE_TOKEN && child->token &&
-            child->token->type == type) {
-            return child->token;
-        }
-    }
-    return NULL;
-}
-
-// Helper to get identifier token from node
-static const char* volt_get_identifier(volt_ast_node_t* node) {
-    if (!node)
-        return NULL;
-    volt_token_t* id_token = volt_find_token(node, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
-    return id_token ? id_token->lexeme : NULL;
+bool volt_semantic_checks(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* declaration) {
+    return !analyzer->checks || analyzer->checks(analyzer->checks_context, declaration);
 }
 
 // SCOPE MANAGEMENT
@@ -77,37 +45,87 @@ volt_scope_t* volt_scope_create(volt_semantic_analyzer_t* analyzer, volt_scope_t
     if (!scope)
         return NULL;
 
-    scope->parent      = parent;
-    scope->scope_type  = parent ? VOLT_SCOPE_BLOCK : VOLT_SCOPE_GLOBAL;
-    scope->return_type = NULL;
+    scope->parent         = parent;
+    scope->scope_type     = parent ? VOLT_SCOPE_BLOCK : VOLT_SCOPE_GLOBAL;
+    scope->return_type    = NULL;
+    scope->index          = NULL;
+    scope->index_capacity = 0;
+    scope->index_count    = 0;
 
-    volt_vector_t symbols = {0};
-    symbols.allocator     = analyzer->allocator;
-    volt_vector_init(&symbols);
+    volt_small_vector_t symbols = {0};
+    symbols.allocator           = analyzer->allocator;
+    volt_small_vector_init(&symbols);
     scope->symbols = symbols;
 
-    volt_vector_t children = {0};
-    children.allocator     = analyzer->allocator;
-    volt_vector_init(&children);
+    volt_small_vector_t children = {0};
+    children.allocator           = analyzer->allocator;
+    volt_small_vector_init(&children);
     scope->children = children;
 
     if (parent) {
-        volt_vector_push_back(&parent->children, scope);
+        volt_small_vector_push_back(&parent->children, scope);
     }
 
     return scope;
 }
 
+static uint64_t volt_scope_hash(const char* name) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const unsigned char* c = (const unsigned char*) name; *c; c++)
+        hash = (hash ^ *c) * 0x100000001B3ull;
+    return hash;
+}
+
+// The slot holding the first symbol called `name`, or the empty one it would go in. Names are
+// only compared when the hashes match, so probing past other symbols touches the index alone.
+static volt_scope_slot_t* volt_scope_slot(volt_scope_t* scope, const char* name, uint64_t hash) {
+    size_t mask = scope->index_capacity - 1;
+    for (size_t i = (size_t) hash & mask;; i = (i + 1) & mask) {
+        volt_scope_slot_t* slot = &scope->index[i];
+        if (!slot->symbol || (slot->hash == hash && strcmp(slot->symbol->name, name) == 0))
+            return slot;
+    }
+}
+
+static volt_status_code_t volt_scope_index_grow(volt_semantic_analyzer_t* analyzer,
+                                                volt_scope_t*             scope) {
+    size_t             old_capacity = scope->index_capacity;
+    volt_scope_slot_t* old_index    = scope->index;
+    size_t             new_capacity = old_capacity ? old_capacity * 2 : 16;
+
+    volt_scope_slot_t* new_index =
+        analyzer->allocator->malloc(new_capacity * sizeof(volt_scope_slot_t));
+    if (!new_index)
+        return VOLT_FAILURE;
+    memset(new_index, 0, new_capacity * sizeof(volt_scope_slot_t));
+
+    // Names are unique in the index, so entries move by their hashes alone
+    scope->index          = new_index;
+    scope->index_capacity = new_capacity;
+    size_t mask           = new_capacity - 1;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (!old_index[i].symbol)
+            continue;
+        size_t j = (size_t) old_index[i].hash & mask;
+        while (new_index[j].symbol)
+            j = (j + 1) & mask;
+        new_index[j] = old_index[i];
+    }
+
+    if (old_index)
+        analyzer->allocator->free(old_index);
+    return VOLT_SUCCESS;
+}
+
 volt_symbol_t* volt_scope_lookup(volt_scope_t* scope, const char* name, bool recursive) {
     if (!scope || !name)
         return NULL;
 
     // Look in current scope
-    for (size_t i = 0; i < scope->symbols.size; i++) {
-        volt_symbol_t* sym = (volt_symbol_t*) volt_vector_get(&scope->symbols, i);
-        if (sym && sym->name && strcmp(sym->name, name) == 0) {
+    if (scope->index_count > 0) {
+        volt_symbol_t* sym = volt_scope_slot(scope, name, volt_scope_hash(name))->symbol;
+        if (sym)
             return sym;
-        }
     }
 
     // Look in parent scopes if recursive
@@ -118,22 +136,78 @@ volt_symbol_t* volt_scope_lookup(volt_scope_t* scope, const char* name, bool rec
     return NULL;
 }
 
+volt_symbol_t* volt_scope_lookup_function(volt_scope_t* scope, const char* name, size_t argc) {
+    if (!scope || !name)
+        return NULL;
+
+    volt_symbol_t* fallback = NULL;
+    volt_symbol_t* first =
+        scope->index_count > 0 ? volt_scope_slot(scope, name, volt_scope_hash(name))->symbol : NULL;
+    for (volt_symbol_t* sym = first; sym; sym = sym->overload) {
+        if (sym->kind != VOLT_SYMBOL_FUNCTION || sym->parameters.size != argc)
+            continue;
+        if (volt_ast_find_child(sym->declaration, "block"))
+            return sym;
+        if (!fallback)
+            fallback = sym;
+    }
+
+    if (fallback)
+        return fallback;
+    return volt_scope_lookup_function(scope->parent, name, argc);
+}
+
 volt_symbol_t* volt_scope_insert(volt_semantic_analyzer_t* analyzer, volt_scope_t* scope,
                                  volt_symbol_t* symbol) {
     if (!scope || !symbol)
         return NULL;
 
-    // Check for duplicate in current scope
-    volt_symbol_t* existing = volt_scope_lookup(scope, symbol->name, false);
-    if (existing) {
+    // Check for duplicate in current scope (functions may be overloaded)
+    uint64_t       hash     = symbol->name ? volt_scope_hash(symbol->name) : 0;
+    volt_symbol_t* existing = symbol->name && scope->index_count > 0
+                                  ? volt_scope_slot(scope, symbol->name, hash)->symbol
+                                  : NULL;
+    if (existing &&
+        !(existing->kind == VOLT_SYMBOL_FUNCTION && symbol->kind == VOLT_SYMBOL_FUNCTION)) {
         char error_msg[256];
         snprintf(error_msg, sizeof(error_msg), "Redefinition of symbol '%s'", symbol->name);
         volt_semantic_error(analyzer, symbol->declaration, error_msg);
         return NULL;
     }
 
-    symbol->scope = scope;
-    volt_vector_push_back(&scope->symbols, symbol);
+    symbol->scope      = scope;
+    symbol->file_index = analyzer->current_file_index;
+    volt_small_vector_push_back(&scope->symbols, symbol);
+
+    // Overloads are chained in declaration order behind the first symbol of their name
+    if (!symbol->name)
+        return symbol;
+    if (existing) {
+        while (existing->overload)
+            existing = existing->overload;
+        existing->overload = symbol;
+        return symbol;
+    }
+
+    // Keep the load factor under 3/4 so probes stay short
+    if ((scope->index_count + 1) * 4 > scope->index_capacity * 3 &&
+        volt_scope_index_grow(analyzer, scope) != VOLT_SUCCESS)
+        return symbol;
+    volt_scope_slot_t* slot = volt_scope_slot(scope, symbol->name, hash);
+    slot->hash              = hash;
+    slot->symbol            = symbol;
+    scope->index_count++;
+    return symbol;
+}
+
+volt_symbol_t* volt_symbol_create(volt_semantic_analyzer_t* analyzer, volt_symbol_kind_t kind) {
+    volt_symbol_t* symbol = (volt_symbol_t*) analyzer->allocator->malloc(sizeof(volt_symbol_t));
+    if (!symbol)
+        return NULL;
+
+    memset(symbol, 0, sizeof(volt_symbol_t));
+    symbol->kind = kind;
+    volt_vector_push_back(&analyzer->owned_symbols, symbol);
     return symbol;
 }
 
@@ -157,21 +231,22 @@ volt_type_info_t* volt_type_create(volt_semantic_analyzer_t* analyzer, volt_type
     type->is_complete   = false;
     type->size_computed = false;
 
-    volt_vector_t element_types = {0};
-    element_types.allocator     = analyzer->allocator;
-    volt_vector_init(&element_types);
+    volt_small_vector_t element_types = {0};
+    element_types.allocator           = analyzer->allocator;
+    volt_small_vector_init(&element_types);
     type->element_types = element_types;
 
-    volt_vector_t fields = {0};
-    fields.allocator     = analyzer->allocator;
-    volt_vector_init(&fields);
+    volt_small_vector_t fields = {0};
+    fields.allocator           = analyzer->allocator;
+    volt_small_vector_init(&fields);
     type->fields = fields;
 
-    volt_vector_t variants = {0};
-    variants.allocator     = analyzer->allocator;
-    volt_vector_init(&variants);
+    volt_small_vector_t variants = {0};
+    variants.allocator           = analyzer->allocator;
+    volt_small_vector_init(&variants);
     type->variants = variants;
 
+    volt_vector_push_back(&analyzer->owned_types, type);
     return type;
 }
 
@@ -222,51 +297,273 @@ static volt_type_info_t* volt_get_builtin_type(volt_semantic_analyzer_t* analyze
     return NULL;
 }
 
+const char* volt_type_own_name(volt_semantic_analyzer_t* analyzer, const char* name) {
+    size_t length = strlen(name) + 1;
+    char*  owned  = analyzer->allocator->malloc(length);
+    if (!owned)
+        return name;
+
+    memcpy(owned, name, length);
+    volt_vector_push_back(&analyzer->type_names, owned);
+    return owned;
+}
+
+volt_type_info_t* volt_type_derive(volt_semantic_analyzer_t* analyzer, volt_type_kind_t kind,
+                                   volt_type_info_t* base, size_t array_length) {
+    for (size_t i = 0; i < analyzer->derived_types.size; i++) {
+        volt_type_info_t* type = (volt_type_info_t*) volt_vector_get(&analyzer->derived_types, i);
+        if (type->kind == kind && type->base_type == base && type->array_length == array_length)
+            return type;
+    }
+
+    volt_type_info_t* type = volt_type_create(analyzer, kind);
+    if (!type)
+        return analyzer->type_unknown;
+
+    type->base_type    = base;
+    type->array_length = array_length;
+    type->is_nullable  = kind == VOLT_TYPE_POINTER || kind == VOLT_TYPE_OPTIONAL;
+    type->is_complete  = true;
+
+    char        name[512];
+    const char* base_name = volt_type_to_string(base);
+    switch (kind) {
+        case VOLT_TYPE_REFERENCE:
+            snprintf(name, sizeof(name), "%s*", base_name);
+            break;
+        case VOLT_TYPE_POINTER:
+            snprintf(name, sizeof(name), "%s*?", base_name);
+            break;
+        case VOLT_TYPE_OPTIONAL:
+            snprintf(name, sizeof(name), "%s?", base_name);
+            break;
+        case VOLT_TYPE_ARRAY:
+            if (array_length)
+                snprintf(name, sizeof(name), "%s[%zu]", base_name, array_length);
+            else
+                snprintf(name, sizeof(name), "%s[]", base_name);
+            break;
+        case VOLT_TYPE_SLICE:
+            snprintf(name, sizeof(name), "%s[..]", base_name);
+            break;
+        case VOLT_TYPE_ERROR:
+            snprintf(name, sizeof(name), "error!%s", base_name);
+            break;
+        default:
+            snprintf(name, sizeof(name), "%s", base_name);
+            break;
+    }
+    type->name = volt_type_own_name(analyzer, name);
+
+    volt_vector_push_back(&analyzer->derived_types, type);
+    return type;
+}
+
+volt_type_info_t* volt_type_tuple(volt_semantic_analyzer_t* analyzer, volt_type_info_t** elements,
+                                  size_t count) {
+    for (size_t i = 0; i < analyzer->derived_types.size; i++) {
+        volt_type_info_t* type = (volt_type_info_t*) volt_vector_get(&analyzer->derived_types, i);
+        if (type->kind != VOLT_TYPE_TUPLE || type->element_types.size != count)
+            continue;
+
+        bool same = true;
+        for (size_t j = 0; j < count && same; j++)
+            same = volt_small_vector_get(&type->element_types, j) == elements[j];
+        if (same)
+            return type;
+    }
+
+    volt_type_info_t* type = volt_type_create(analyzer, VOLT_TYPE_TUPLE);
+    if (!type)
+        return analyzer->type_unknown;
+    type->is_complete = true;
+
+    char   name[512];
+    size_t length = 0;
+    name[length++] = '(';
+    for (size_t i = 0; i < count; i++) {
+        volt_small_vector_push_back(&type->element_types, elements[i]);
+        int written = snprintf(name + length, sizeof(name) - length, "%s%s", i ? ", " : "",
+                               volt_type_to_string(elements[i]));
+        length = written > 0 ? length + (size_t) written : length;
+        if (length >= sizeof(name) - 2)
+            length = sizeof(name) - 2;
+    }
+    name[length++] = ')';
+    name[length]   = '\0';
+    type->name     = volt_type_own_name(analyzer, name);
+
+    volt_vector_push_back(&analyzer->derived_types, type);
+    return type;
+}
+
+static volt_type_info_t* volt_type_from_suffixes(volt_semantic_analyzer_t* analyzer,
+                                                 volt_type_info_t*         type,
+                                                 volt_ast_node_t*          suffix_list) {
+    volt_vector_t suffixes = volt_vector_default();
+    volt_ast_collect_list(suffix_list, "type_suffix", &suffixes);
+
+    for (size_t i = 0; i < suffixes.size; i++) {
+        volt_ast_node_t* suffix = (volt_ast_node_t*) volt_vector_get(&suffixes, i);
+        volt_token_t*    token  = volt_ast_first_token(suffix);
+        if (!token)
+            continue;
+
+        switch (token->type) {
+            case VOLT_TOKEN_TYPE_STAR: {
+                // `*?` lexes as two suffixes; together they form a nullable pointer
+                volt_ast_node_t* next = (volt_ast_node_t*) volt_vector_get(&suffixes, i + 1);
+                volt_token_t*    next_token = volt_ast_first_token(next);
+                if (i + 1 < suffixes.size && next_token &&
+                    next_token->type == VOLT_TOKEN_TYPE_QUESTION) {
+                    type = volt_type_derive(analyzer, VOLT_TYPE_POINTER, type, 0);
+                    i++;
+                } else {
+                    type = volt_type_derive(analyzer, VOLT_TYPE_REFERENCE, type, 0);
+                }
+                break;
+            }
+            case VOLT_TOKEN_TYPE_QUESTION:
+                type = volt_type_derive(analyzer, VOLT_TYPE_OPTIONAL, type, 0);
+                break;
+            case VOLT_TOKEN_TYPE_LBRACKET: {
+                volt_ast_node_t* length_expr = volt_ast_find_child(suffix, "expression");
+                if (volt_ast_find_token(suffix, VOLT_TOKEN_TYPE_DOT_DOT)) {
+                    type = volt_type_derive(analyzer, VOLT_TYPE_SLICE, type, 0);
+                } else if (!length_expr) {
+                    type = volt_type_derive(analyzer, VOLT_TYPE_ARRAY, type, 0);
+                } else {
+                    volt_comptime_value_t length;
+                    if (volt_comptime_eval(&analyzer->comptime, length_expr,
+                                           analyzer->generic_bindings,
+                                           analyzer->generic_binding_count,
+                                           &length) != VOLT_SUCCESS) {
+                        volt_semantic_error(analyzer, length_expr,
+                                            analyzer->comptime.error_message);
+                    } else if (length.kind != VOLT_COMPTIME_VALUE_INT || length.i <= 0) {
+                        volt_semantic_error(analyzer, length_expr,
+                                            "Array length must be a positive compile-time integer");
+                    } else {
+                        type = volt_type_derive(analyzer, VOLT_TYPE_ARRAY, type, (size_t) length.i);
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    volt_vector_deinit(&suffixes);
+    return type;
+}
+
+static volt_type_info_t* volt_type_from_named(volt_semantic_analyzer_t* analyzer,
+                                              volt_ast_node_t*          type_node) {
+    volt_ast_node_t* path = volt_ast_find_child(type_node, "path");
+    const char*      name = volt_ast_get_identifier(path);
+    if (!name)
+        return analyzer->type_unknown;
+
+    bool qualified = volt_ast_find_child(path, "path_rest") &&
+                     volt_ast_find_child(path, "path_rest")->children.size > 0;
+
+    // Generic parameters of the instance being analyzed shadow everything else
+    if (!qualified) {
+        for (size_t i = 0; i < analyzer->generic_binding_count; i++) {
+            const volt_comptime_binding_t* binding = &analyzer->generic_bindings[i];
+            if (strcmp(binding->name, name) == 0 &&
+                binding->value.kind == VOLT_COMPTIME_VALUE_TYPE)
+                return binding->value.type;
+        }
+
+        volt_type_info_t* builtin = volt_get_builtin_type(analyzer, name);
+        if (builtin)
+            return builtin;
+    }
+
+    volt_symbol_t* sym = volt_scope_lookup(analyzer->current_scope, name, true);
+    if (!sym || sym->kind != VOLT_SYMBOL_TYPE) {
+        // Type not yet resolved - return unknown for now
+        return analyzer->type_unknown;
+    }
+
+    volt_ast_node_t* generic_args = volt_ast_find_child(type_node, "generic_args");
+    if (sym->is_generic && generic_args) {
+        volt_instance_t* instance =
+            volt_generic_instantiate(analyzer, sym, generic_args, type_node);
+        return instance && instance->type ? instance->type : analyzer->type_unknown;
+    }
+
+    return sym->type;
+}
+
 volt_type_info_t* volt_type_from_ast(volt_semantic_analyzer_t* analyzer,
                                      volt_ast_node_t*          type_node) {
-    if (!type_node)
+    if (!type_node || type_node->type != VOLT_AST_NODE_EXPRESSION)
         return analyzer->type_unknown;
 
+    // Wrappers around a single type
+    if (volt_ast_is(type_node, "base_type"))
+        return volt_type_from_ast(analyzer, volt_ast_get_child(type_node, 0));
+    if (volt_ast_is(type_node, "tuple_field") || volt_ast_is(type_node, "type_constraint"))
+        return volt_type_from_ast(analyzer, volt_ast_find_child(type_node, "type"));
+
+    if (volt_ast_is(type_node, "type")) {
+        volt_type_info_t* base =
+            volt_type_from_ast(analyzer, volt_ast_find_child(type_node, "base_type"));
+        return volt_type_from_suffixes(analyzer, base,
+                                       volt_ast_find_child(type_node, "type_suffixes"));
+    }
+
     // Handle primitive types
-    if (strcmp(type_node->expression_name, "primitive_type") == 0) {
-        if (type_node->children.size > 0) {
-            volt_ast_node_t* token_node =
-                (volt_ast_node_t*) volt_vector_get(&type_node->children, 0);
-            if (token_node && token_node->token) {
-                volt_type_info_t* builtin =
-                    volt_get_builtin_type(analyzer, token_node->token->lexeme);
-                if (builtin)
-                    return builtin;
-            }
+    if (volt_ast_is(type_node, "primitive_type")) {
+        volt_token_t* token = volt_ast_first_token(type_node);
+        if (token) {
+            volt_type_info_t* builtin = volt_get_builtin_type(analyzer, token->lexeme);
+            if (builtin)
+                return builtin;
         }
     }
 
     // Handle named types - look up in symbol table
-    if (strcmp(type_node->expression_name, "named_type") == 0) {
-        // Find path child
-        for (size_t i = 0; i < type_node->children.size; i++) {
-            volt_ast_node_t* child = (volt_ast_node_t*) volt_vector_get(&type_node->children, i);
-            if (child && strcmp(child->expression_name, "path") == 0) {
-                // Get identifier from path
-                if (child->children.size > 0) {
-                    volt_ast_node_t* id_node =
-                        (volt_ast_node_t*) volt_vector_get(&child->children, 0);
-                    if (id_node && id_node->token) {
-                        const char*    type_name = id_node->token->lexeme;
-                        volt_symbol_t* sym =
-                            volt_scope_lookup(analyzer->current_scope, type_name, true);
-                        if (sym && sym->kind == VOLT_SYMBOL_TYPE) {
-                            return sym->type;
-                        }
-                        // Type not yet resolved - return unknown for now
-                        return analyzer->type_unknown;
-                    }
-                }
-            }
+    if (volt_ast_is(type_node, "named_type"))
+        return volt_type_from_named(analyzer, type_node);
+
+    // `error!T` and `some_error<...>!T`
+    if (volt_ast_is(type_node, "error_wrapper_type") ||
+        volt_ast_is(type_node, "named_error_wrapper")) {
+        volt_ast_node_t* generic_args = volt_ast_find_child(type_node, "generic_args");
+        if (generic_args) {
+            volt_symbol_t* sym = volt_scope_lookup(
+                analyzer->current_scope,
+                volt_ast_get_identifier(volt_ast_find_child(type_node, "path")), true);
+            if (sym && sym->kind == VOLT_SYMBOL_TYPE && sym->is_generic)
+                volt_generic_instantiate(analyzer, sym, generic_args, type_node);
         }
+
+        volt_type_info_t* payload =
+            volt_type_from_ast(analyzer, volt_ast_find_child(type_node, "type"));
+        return volt_type_derive(analyzer, VOLT_TYPE_ERROR, payload, 0);
     }
 
-    // Handle pointer/array types - will implement in pass 2
+    if (volt_ast_is(type_node, "tuple_type")) {
+        volt_vector_t fields = volt_vector_default();
+        volt_ast_collect_list(volt_ast_find_child(type_node, "type_list"), "tuple_field", &fields);
+
+        volt_type_info_t** elements =
+            analyzer->allocator->malloc((fields.size + 1) * sizeof(volt_type_info_t*));
+        volt_type_info_t* tuple = analyzer->type_unknown;
+        if (elements) {
+            for (size_t i = 0; i < fields.size; i++)
+                elements[i] = volt_type_from_ast(analyzer, volt_vector_get(&fields, i));
+            tuple = volt_type_tuple(analyzer, elements, fields.size);
+            analyzer->allocator->free(elements);
+        }
+
+        volt_vector_deinit(&fields);
+        return tuple;
+    }
 
     return analyzer->type_unknown;
 }
@@ -418,6 +715,17 @@ volt_status_code_t volt_semantic_analyzer_init(volt_semantic_analyzer_t* analyze
     analyzer->had_error         = false;
     analyzer->error_count       = 0;
 
+    // Everything created from here on is owned by these
+    volt_vector_t owned_symbols = {0};
+    owned_symbols.allocator     = analyzer->allocator;
+    volt_vector_init(&owned_symbols);
+    analyzer->owned_symbols = owned_symbols;
+
+    volt_vector_t owned_types = {0};
+    owned_types.allocator     = analyzer->allocator;
+    volt_vector_init(&owned_types);
+    analyzer->owned_types = owned_types;
+
     // Initialize builtin types
     volt_init_builtin_types(analyzer);
 
@@ -425,13 +733,71 @@ volt_status_code_t volt_semantic_analyzer_init(volt_semantic_analyzer_t* analyze
     analyzer->global_scope  = volt_scope_create(analyzer, NULL);
     analyzer->current_scope = analyzer->global_scope;
 
+    volt_vector_t derived_types = {0};
+    derived_types.allocator     = analyzer->allocator;
+    volt_vector_init(&derived_types);
+    analyzer->derived_types = derived_types;
+
+    volt_vector_t formats = {0};
+    formats.allocator     = analyzer->allocator;
+    volt_vector_init(&formats);
+    analyzer->formats = formats;
+
+    volt_vector_t coroutines = {0};
+    coroutines.allocator     = analyzer->allocator;
+    volt_vector_init(&coroutines);
+    analyzer->coroutines = coroutines;
+
+    volt_vector_t loops = {0};
+    loops.allocator     = analyzer->allocator;
+    volt_vector_init(&loops);
+    analyzer->loops = loops;
+
+    volt_vector_t matches = {0};
+    matches.allocator     = analyzer->allocator;
+    volt_vector_init(&matches);
+    analyzer->matches = matches;
+
+    volt_vector_t closures = {0};
+    closures.allocator     = analyzer->allocator;
+    volt_vector_init(&closures);
+    analyzer->closures = closures;
+
+    volt_vector_t fallibles = {0};
+    fallibles.allocator     = analyzer->allocator;
+    volt_vector_init(&fallibles);
+    analyzer->fallibles = fallibles;
+
+    volt_vector_t traits = {0};
+    traits.allocator     = analyzer->allocator;
+    volt_vector_init(&traits);
+    analyzer->traits = traits;
+
+    volt_vector_t dispatches = {0};
+    dispatches.allocator     = analyzer->allocator;
+    volt_vector_init(&dispatches);
+    analyzer->dispatches = dispatches;
+
+    volt_vector_t type_names  = {0};
+    type_names.allocator      = analyzer->allocator;
+    type_names.item_allocator = analyzer->allocator;
+    volt_vector_init(&type_names);
+    analyzer->type_names = type_names;
+
+    analyzer->current_instance      = NULL;
+    analyzer->current_owner         = NULL;
+    analyzer->generic_bindings      = NULL;
+    analyzer->generic_binding_count = 0;
+    if (volt_instance_cache_init(&analyzer->instances, analyzer->allocator) != VOLT_SUCCESS)
+        return VOLT_FAILURE;
+
     // Initialize unresolved symbols list
     volt_vector_t unresolved = {0};
     unresolved.allocator     = analyzer->allocator;
     volt_vector_init(&unresolved);
     analyzer->unresolved_symbols = unresolved;
 
-    return VOLT_SUCCESS;
+    return volt_comptime_init(&analyzer->comptime, analyzer, analyzer->allocator);
 }
 
 static volt_status_code_t volt_analyze_pass1_declarations(volt_semantic_analyzer_t* analyzer,
@@ -440,6 +806,7 @@ static volt_status_code_t volt_analyze_pass2_types(volt_semantic_analyzer_t* ana
                                                    volt_ast_node_t*          node);
 static volt_status_code_t volt_analyze_pass3_expressions(volt_semantic_analyzer_t* analyzer,
                                                          volt_ast_node_t*          node);
+static volt_status_code_t volt_analyze_pass3_instances(volt_semantic_analyzer_t* analyzer);
 
 volt_status_code_t volt_semantic_analyzer_analyze(volt_semantic_analyzer_t* analyzer) {
     if (!analyzer || !analyzer->asts || analyzer->ast_count == 0) {
@@ -467,6 +834,20 @@ volt_status_code_t volt_semantic_analyzer_analyze(volt_semantic_analyzer_t* anal
             return VOLT_FAILURE;
         }
     }
+    for (size_t i = 0; i < analyzer->global_scope->symbols.size; i++) {
+        volt_symbol_t* symbol = volt_small_vector_get(&analyzer->global_scope->symbols, i);
+        if (symbol->kind == VOLT_SYMBOL_FUNCTION &&
+            !volt_semantic_checks(analyzer, symbol->declaration))
+            continue;
+        if (volt_generic_collect_symbol(analyzer, symbol) != VOLT_SUCCESS) {
+            return VOLT_FAILURE;
+        }
+    }
+    if (volt_generic_analyze_instances(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
+    volt_generic_log_stats(analyzer);
+    volt_layout_compute_all(analyzer);
 
     // Pass 3: Analyze expressions and type check ALL files
     volt_fmt_logf(VOLT_FMT_LEVEL_INFO, "Pass 3: Type checking...");
@@ -476,12 +857,37 @@ volt_status_code_t volt_semantic_analyzer_analyze(volt_semantic_analyzer_t* anal
             return VOLT_FAILURE;
         }
     }
+    if (volt_analyze_pass3_instances(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
+    if (volt_format_expand_all(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
 
     if (analyzer->had_error) {
         volt_fmt_logf(VOLT_FMT_LEVEL_ERROR, "Semantic analysis failed with %zu errors", analyzer->error_count);
         return VOLT_FAILURE;
     }
 
+    if (volt_coroutine_lower_all(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
+    if (volt_loop_lower_all(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
+    if (volt_match_lower_all(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
+    if (volt_escape_analyze_all(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
+    if (volt_fallible_lower_all(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
+    if (volt_devirt_resolve_all(analyzer) != VOLT_SUCCESS) {
+        return VOLT_FAILURE;
+    }
+
     volt_fmt_logf(VOLT_FMT_LEVEL_INFO, "Semantic analysis completed successfully");
     return VOLT_SUCCESS;
 }
@@ -490,37 +896,72 @@ volt_status_code_t volt_semantic_analyzer_analyze(volt_semantic_analyzer_t* anal
 static volt_status_code_t volt_pass1_collect_item(volt_semantic_analyzer_t* analyzer,
                                                    volt_ast_node_t*          node);
 
+static void volt_pass1_parameters(volt_semantic_analyzer_t* analyzer, volt_symbol_t* function,
+                                  volt_ast_node_t* params) {
+    // The nodes are collected straight into the parameter list and replaced by their symbols,
+    // which saves a temporary vector for every function of every file
+    volt_vector_t* parameters = &function->parameters;
+    volt_ast_collect_list(params, "param", parameters);
+
+    // Variadic form: `Args: type[]`
+    if (parameters->size == 0 && volt_ast_get_identifier(params))
+        volt_vector_push_back(parameters, params);
+
+    for (size_t i = 0; i < parameters->size; i++) {
+        volt_ast_node_t* param_node = (volt_ast_node_t*) volt_vector_get(parameters, i);
+
+        volt_symbol_t* param = volt_symbol_create(analyzer, VOLT_SYMBOL_VARIABLE);
+        if (!param) {
+            parameters->size = i;
+            break;
+        }
+
+        const char* name   = volt_ast_get_identifier(param_node);
+        param->name        = name ? name : "this";
+        param->declaration = param_node;
+        param->is_mutable  = true;
+        param->is_static   = volt_ast_find_token(param_node, VOLT_TOKEN_TYPE_STATIC_KW) != NULL;
+
+        parameters->data[i] = param;
+    }
+}
+
 static volt_status_code_t volt_pass1_function_decl(volt_semantic_analyzer_t* analyzer,
                                                     volt_ast_node_t*          node) {
     // Find function name
-    volt_ast_node_t* ident_node = volt_find_child(node, "path");
-    if (!ident_node)
-        ident_node = volt_find_child(node, "identifier");
-
-    const char* func_name = volt_get_identifier(ident_node);
+    const char* func_name = volt_ast_get_identifier(node);
     if (!func_name) {
         volt_semantic_error(analyzer, node, "Function declaration missing name");
         return VOLT_FAILURE;
     }
 
     // Create function symbol
-    volt_symbol_t* symbol =
-        (volt_symbol_t*) analyzer->allocator->malloc(sizeof(volt_symbol_t));
-    memset(symbol, 0, sizeof(volt_symbol_t));
+    volt_symbol_t* symbol = volt_symbol_create(analyzer, VOLT_SYMBOL_FUNCTION);
+    if (!symbol)
+        return VOLT_FAILURE;
 
-    symbol->kind        = VOLT_SYMBOL_FUNCTION;
     symbol->name        = func_name;
     symbol->declaration = node;
     symbol->is_resolved = false;
 
-    // Check for modifiers (async, comptime, extern)
-    symbol->is_async    = volt_find_token(node, VOLT_TOKEN_TYPE_ASYNC_KW) != NULL;
-    symbol->is_comptime = volt_find_token(node, VOLT_TOKEN_TYPE_COMPTIME_KW) != NULL;
-    symbol->is_extern   = volt_find_token(node, VOLT_TOKEN_TYPE_EXTERN_KW) != NULL;
+    // Check for modifiers (async, comptime, extern, generic) in one pass over the children;
+    // every declaration of every file comes through here on each analysis
+    for (size_t i = 0; i < node->children.size; i++) {
+        volt_ast_node_t* child = volt_ast_get_child(node, i);
+        if (child->type == VOLT_AST_NODE_EXPRESSION) {
+            symbol->is_generic |= volt_ast_is(child, "generics");
+            continue;
+        }
+        volt_token_type_t type = child->token ? child->token->type : VOLT_TOKEN_TYPE_NONE;
+        symbol->is_async    |= type == VOLT_TOKEN_TYPE_ASYNC_KW;
+        symbol->is_comptime |= type == VOLT_TOKEN_TYPE_COMPTIME_KW;
+        symbol->is_extern   |= type == VOLT_TOKEN_TYPE_EXTERN_KW;
+    }
 
     // Initialize parameters vector
     symbol->parameters.allocator = analyzer->allocator;
     volt_vector_init(&symbol->parameters);
+    volt_pass1_parameters(analyzer, symbol, volt_ast_find_child(node, "params"));
 
     // Insert into current scope
     volt_scope_insert(analyzer, analyzer->current_scope, symbol);
@@ -531,7 +972,7 @@ static volt_status_code_t volt_pass1_function_decl(volt_semantic_analyzer_t* ana
 static volt_status_code_t volt_pass1_struct_decl(volt_semantic_analyzer_t* analyzer,
                                                   volt_ast_node_t*          node) {
     // Find struct name
-    const char* struct_name = volt_get_identifier(node);
+    const char* struct_name = volt_ast_get_identifier(node);
     if (!struct_name) {
         volt_semantic_error(analyzer, node, "Struct declaration missing name");
         return VOLT_FAILURE;
@@ -540,18 +981,19 @@ static volt_status_code_t volt_pass1_struct_decl(volt_semantic_analyzer_t* analy
     // Create type for this struct
     volt_type_info_t* struct_type = volt_type_create(analyzer, VOLT_TYPE_STRUCT);
     struct_type->name             = struct_name;
+    struct_type->declaration      = node;
     struct_type->is_complete      = false;  // Will be filled in Pass 2
 
     // Create symbol for this type
-    volt_symbol_t* symbol =
-        (volt_symbol_t*) analyzer->allocator->malloc(sizeof(volt_symbol_t));
-    memset(symbol, 0, sizeof(volt_symbol_t));
+    volt_symbol_t* symbol = volt_symbol_create(analyzer, VOLT_SYMBOL_TYPE);
+    if (!symbol)
+        return VOLT_FAILURE;
 
-    symbol->kind        = VOLT_SYMBOL_TYPE;
     symbol->name        = struct_name;
     symbol->type        = struct_type;
     symbol->declaration = node;
     symbol->is_resolved = false;
+    symbol->is_generic  = volt_ast_find_child(node, "generics") != NULL;
 
     // Insert into current scope
     volt_scope_insert(analyzer, analyzer->current_scope, symbol);
@@ -562,27 +1004,29 @@ static volt_status_code_t volt_pass1_struct_decl(volt_semantic_analyzer_t* analy
 static volt_status_code_t volt_pass1_enum_decl(volt_semantic_analyzer_t* analyzer,
                                                 volt_ast_node_t*          node) {
     // Find enum name
-    const char* enum_name = volt_get_identifier(node);
+    const char* enum_name = volt_ast_get_identifier(node);
     if (!enum_name) {
         volt_semantic_error(analyzer, node, "Enum declaration missing name");
         return VOLT_FAILURE;
     }
 
-    // Create type for this enum
-    volt_type_info_t* enum_type = volt_type_create(analyzer, VOLT_TYPE_ENUM);
+    // Create type for this enum (error sets are enums of error variants)
+    volt_type_info_t* enum_type = volt_type_create(
+        analyzer, volt_ast_is(node, "error_decl") ? VOLT_TYPE_ERROR : VOLT_TYPE_ENUM);
     enum_type->name             = enum_name;
+    enum_type->declaration      = node;
     enum_type->is_complete      = false;  // Will be filled in Pass 2
 
     // Create symbol for this type
-    volt_symbol_t* symbol =
-        (volt_symbol_t*) analyzer->allocator->malloc(sizeof(volt_symbol_t));
-    memset(symbol, 0, sizeof(volt_symbol_t));
+    volt_symbol_t* symbol = volt_symbol_create(analyzer, VOLT_SYMBOL_TYPE);
+    if (!symbol)
+        return VOLT_FAILURE;
 
-    symbol->kind        = VOLT_SYMBOL_TYPE;
     symbol->name        = enum_name;
     symbol->type        = enum_type;
     symbol->declaration = node;
     symbol->is_resolved = false;
+    symbol->is_generic  = volt_ast_find_child(node, "generics") != NULL;
 
     // Insert into current scope
     volt_scope_insert(analyzer, analyzer->current_scope, symbol);
@@ -593,25 +1037,24 @@ static volt_status_code_t volt_pass1_enum_decl(volt_semantic_analyzer_t* analyze
 static volt_status_code_t volt_pass1_var_decl(volt_semantic_analyzer_t* analyzer,
                                                volt_ast_node_t*          node) {
     // Find variable name
-    const char* var_name = volt_get_identifier(node);
+    const char* var_name = volt_ast_get_identifier(node);
     if (!var_name) {
         volt_semantic_error(analyzer, node, "Variable declaration missing name");
         return VOLT_FAILURE;
     }
 
     // Create variable symbol
-    volt_symbol_t* symbol =
-        (volt_symbol_t*) analyzer->allocator->malloc(sizeof(volt_symbol_t));
-    memset(symbol, 0, sizeof(volt_symbol_t));
+    volt_symbol_t* symbol = volt_symbol_create(analyzer, VOLT_SYMBOL_VARIABLE);
+    if (!symbol)
+        return VOLT_FAILURE;
 
-    symbol->kind        = VOLT_SYMBOL_VARIABLE;
     symbol->name        = var_name;
     symbol->declaration = node;
     symbol->is_resolved = false;
 
     // Check if it's mutable (var) or immutable (val)
-    symbol->is_mutable = volt_find_token(node, VOLT_TOKEN_TYPE_VAR_KW) != NULL;
-    symbol->is_static  = volt_find_token(node, VOLT_TOKEN_TYPE_STATIC_KW) != NULL;
+    symbol->is_mutable = volt_ast_find_token(node, VOLT_TOKEN_TYPE_VAR_KW) != NULL;
+    symbol->is_static  = volt_ast_find_token(node, VOLT_TOKEN_TYPE_STATIC_KW) != NULL;
 
     // Insert into current scope
     volt_scope_insert(analyzer, analyzer->current_scope, symbol);
@@ -619,31 +1062,56 @@ static volt_status_code_t volt_pass1_var_decl(volt_semantic_analyzer_t* analyzer
     return VOLT_SUCCESS;
 }
 
+static void volt_pass1_attributes(volt_symbol_t* symbol, volt_ast_node_t* attributes) {
+    symbol->attributes = attributes;
+
+    // @repr("C")
+    const char*   name  = volt_ast_get_identifier(attributes);
+    volt_token_t* value = volt_ast_find_token(attributes, VOLT_TOKEN_TYPE_STRING_LITERAL);
+    if (symbol->type && name && strcmp(name, "repr") == 0 && value &&
+        strcmp(value->lexeme, "C") == 0)
+        symbol->type->is_repr_c = true;
+}
+
 static volt_status_code_t volt_pass1_collect_item(volt_semantic_analyzer_t* analyzer,
                                                    volt_ast_node_t*          node) {
     if (!node)
         return VOLT_SUCCESS;
 
-    const char* expr_name = volt_get_node_name(node);
-    if (!expr_name)
+    if (node->type != VOLT_AST_NODE_EXPRESSION || !node->expression_name)
         return VOLT_SUCCESS;
+    const char* expr_name = node->expression_name;
 
     // Handle different declaration types
-    if (strcmp(expr_name, "fn_decl") == 0 || strcmp(expr_name, "attached_fn_decl") == 0) {
+    if (strcmp(expr_name, "func_def") == 0 || strcmp(expr_name, "extern_decl") == 0 ||
+        strcmp(expr_name, "export_decl") == 0) {
         return volt_pass1_function_decl(analyzer, node);
     } else if (strcmp(expr_name, "struct_decl") == 0) {
         return volt_pass1_struct_decl(analyzer, node);
-    } else if (strcmp(expr_name, "enum_decl") == 0) {
+    } else if (strcmp(expr_name, "enum_decl") == 0 || strcmp(expr_name, "error_decl") == 0) {
         return volt_pass1_enum_decl(analyzer, node);
     } else if (strcmp(expr_name, "var_decl") == 0 || strcmp(expr_name, "val_decl") == 0) {
         return volt_pass1_var_decl(analyzer, node);
     }
 
+    // Attributes belong to the declaration that follows them
+    if (strcmp(expr_name, "item") == 0 && volt_ast_find_child(node, "attributes")) {
+        volt_ast_node_t* attributes  = volt_ast_find_child(node, "attributes");
+        volt_ast_node_t* declaration = volt_ast_get_child(node, 1);
+        if (volt_pass1_collect_item(analyzer, declaration) != VOLT_SUCCESS)
+            return VOLT_FAILURE;
+
+        volt_symbol_t* symbol = volt_small_vector_get_back(&analyzer->current_scope->symbols);
+        if (symbol && symbol->declaration == declaration)
+            volt_pass1_attributes(symbol, attributes);
+        return VOLT_SUCCESS;
+    }
+
     // For unit/items, recursively process children
     if (strcmp(expr_name, "unit") == 0 || strcmp(expr_name, "items") == 0 ||
-        strcmp(expr_name, "item") == 0) {
+        strcmp(expr_name, "items_rest") == 0 || strcmp(expr_name, "item") == 0) {
         for (size_t i = 0; i < node->children.size; i++) {
-            volt_ast_node_t* child = (volt_ast_node_t*) volt_vector_get(&node->children, i);
+            volt_ast_node_t* child = (volt_ast_node_t*) volt_small_vector_get(&node->children, i);
             if (volt_pass1_collect_item(analyzer, child) != VOLT_SUCCESS) {
                 return VOLT_FAILURE;
             }
@@ -664,28 +1132,219 @@ static volt_status_code_t volt_analyze_pass1_declarations(volt_semantic_analyzer
 
 static volt_status_code_t volt_analyze_pass2_types(volt_semantic_analyzer_t* analyzer,
                                                    volt_ast_node_t*          node) {
-    (void) analyzer;
-    (void) node;
-    // TODO: Resolve all type references
+    // Resolves every type reference in non-generic code; generic arguments found along the way
+    // are queued as instances and analyzed once all files have been walked. Declarations with a
+    // symbol are walked afterwards so their instances can be attributed to them.
+    return volt_generic_collect(analyzer, node);
+}
+
+// Pass 3: comptime evaluation
+// `comptime var/val` initializers, `comptime if` conditions and calls to comptime functions are
+// run through the bytecode VM and the results are attached to the AST (node->data). Comptime
+// locals already evaluated in the same function are visible to later comptime expressions.
+// Generic instances share their AST, so their results are checked but never folded.
+typedef struct volt_pass3_context_t volt_pass3_context_t;
+struct volt_pass3_context_t {
+    volt_semantic_analyzer_t* analyzer;
+    volt_comptime_binding_t*  bindings;
+    size_t                    binding_count;
+    size_t                    binding_capacity;
+    bool                      fold;
+};
+
+static bool volt_pass3_eval(volt_pass3_context_t* pass, volt_ast_node_t* node,
+                            volt_comptime_value_t* out) {
+    volt_semantic_analyzer_t* analyzer = pass->analyzer;
+    if (volt_comptime_eval(&analyzer->comptime, node, pass->bindings, pass->binding_count, out) ==
+        VOLT_SUCCESS) {
+        if (pass->fold)
+            volt_comptime_fold(&analyzer->comptime, node, *out);
+        return true;
+    }
+
+    volt_semantic_error(analyzer,
+                        analyzer->comptime.error_node ? analyzer->comptime.error_node : node,
+                        analyzer->comptime.error_message);
+    return false;
+}
+
+static void volt_pass3_bind(volt_pass3_context_t* pass, const char* name,
+                            volt_comptime_value_t value) {
+    if (pass->binding_count >= pass->binding_capacity) {
+        size_t                   new_capacity = pass->binding_capacity ? pass->binding_capacity * 2
+                                                                       : 8;
+        volt_comptime_binding_t* bindings     = pass->analyzer->allocator->realloc(
+            pass->bindings, new_capacity * sizeof(volt_comptime_binding_t));
+        if (!bindings)
+            return;
+        pass->bindings         = bindings;
+        pass->binding_capacity = new_capacity;
+    }
+    pass->bindings[pass->binding_count++] = (volt_comptime_binding_t) {name, value};
+}
+
+static bool volt_pass3_is_comptime_call(volt_pass3_context_t* pass, volt_ast_node_t* node) {
+    volt_ast_node_t* rest = volt_ast_get_child(node, 1);
+    volt_ast_node_t* op   = volt_ast_get_child(rest, 0);
+    volt_ast_node_t* call = volt_ast_get_child(op, 0);
+    const char*      name = volt_ast_get_identifier(volt_ast_get_child(node, 0));
+    if (!name || !volt_ast_is(call, "call") || volt_ast_get_child(rest, 1)->children.size > 0)
+        return false;
+
+    volt_vector_t args = volt_vector_default();
+    size_t argc = volt_ast_collect_list(volt_ast_find_child(call, "args"), "expression", &args);
+    volt_vector_deinit(&args);
+
+    volt_symbol_t* callee =
+        volt_scope_lookup_function(pass->analyzer->global_scope, name, argc);
+    return callee && callee->is_comptime && !callee->is_generic;
+}
+
+static void volt_pass3_walk(volt_pass3_context_t* pass, volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    volt_comptime_value_t value;
+    bool is_comptime = volt_ast_find_token(node, VOLT_TOKEN_TYPE_COMPTIME_KW) != NULL;
+
+    if (is_comptime && (volt_ast_is(node, "var_decl") || volt_ast_is(node, "val_decl"))) {
+        volt_ast_node_t* init = volt_ast_find_child(node, "expression");
+        if (init && volt_pass3_eval(pass, init, &value))
+            volt_pass3_bind(pass, volt_ast_get_identifier(node), value);
+        return;
+    }
+
+    if (is_comptime && volt_ast_is(node, "if_stmt"))
+        volt_pass3_eval(pass, volt_ast_find_child(node, "expression"), &value);
+
+    if (volt_ast_is(node, "postfix_expr") && volt_pass3_is_comptime_call(pass, node)) {
+        volt_pass3_eval(pass, node, &value);
+        return;
+    }
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_pass3_walk(pass, volt_ast_get_child(node, i));
+}
+
+static volt_status_code_t volt_pass3_function(volt_semantic_analyzer_t* analyzer,
+                                              volt_ast_node_t*          node) {
+    // Comptime function bodies run entirely in the VM when called; generic bodies need their
+    // parameters bound first
+    if (volt_ast_find_token(node, VOLT_TOKEN_TYPE_COMPTIME_KW) ||
+        volt_ast_find_child(node, "generics"))
+        return VOLT_SUCCESS;
+
+    volt_pass3_context_t pass = {analyzer, NULL, 0, 0, true};
+    volt_pass3_walk(&pass, volt_ast_body(node));
+    analyzer->allocator->free(pass.bindings);
+    return VOLT_SUCCESS;
+}
+
+static volt_status_code_t volt_analyze_pass3_instances(volt_semantic_analyzer_t* analyzer) {
+    for (size_t i = 0; i < analyzer->instances.instances.size; i++) {
+        volt_instance_t* instance =
+            (volt_instance_t*) volt_vector_get(&analyzer->instances.instances, i);
+        if (instance->generic->kind != VOLT_SYMBOL_FUNCTION || instance->generic->is_comptime)
+            continue;
+
+        // Generic parameters come first so comptime code in the body can refer to them
+        volt_pass3_context_t pass = {analyzer, NULL, 0, 0, false};
+        for (size_t j = 0; j < instance->arg_count; j++)
+            volt_pass3_bind(&pass, instance->bindings[j].name, instance->bindings[j].value);
+
+        analyzer->current_file_index = instance->generic->file_index;
+        volt_pass3_walk(&pass, volt_ast_body(instance->generic->declaration));
+        analyzer->allocator->free(pass.bindings);
+    }
+
     return VOLT_SUCCESS;
 }
 
 static volt_status_code_t volt_analyze_pass3_expressions(volt_semantic_analyzer_t* analyzer,
                                                          volt_ast_node_t*          node) {
-    (void) analyzer;
-    (void) node;
-    // TODO: Type check all expressions
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return VOLT_SUCCESS;
+
+    if (volt_ast_is(node, "func_def") || volt_ast_is(node, "export_decl"))
+        return volt_semantic_checks(analyzer, node) ? volt_pass3_function(analyzer, node)
+                                                    : VOLT_SUCCESS;
+
+    if (volt_ast_is(node, "unit") || volt_ast_is(node, "items") ||
+        volt_ast_is(node, "items_rest") || volt_ast_is(node, "item")) {
+        for (size_t i = 0; i < node->children.size; i++) {
+            if (volt_analyze_pass3_expressions(analyzer, volt_ast_get_child(node, i)) !=
+                VOLT_SUCCESS)
+                return VOLT_FAILURE;
+        }
+    }
+
     return VOLT_SUCCESS;
 }
 
-
 volt_status_code_t volt_semantic_analyzer_deinit(volt_semantic_analyzer_t* analyzer) {
-    if (!analyzer) {
+    // Never initialized, or already deinitialized
+    if (!analyzer || !analyzer->allocator) {
         return VOLT_FAILURE;
     }
 
-    // Cleanup would free all scopes, symbols, types
-    // For now, rely on allocator cleanup
+    volt_comptime_deinit(&analyzer->comptime);
+    volt_instance_cache_deinit(&analyzer->instances);
+    volt_vector_deinit(&analyzer->type_names);
+    volt_vector_deinit(&analyzer->derived_types);
+    for (size_t i = 0; i < analyzer->formats.size; i++)
+        volt_format_destroy(analyzer, volt_vector_get(&analyzer->formats, i));
+    volt_vector_deinit(&analyzer->formats);
+    for (size_t i = 0; i < analyzer->coroutines.size; i++)
+        volt_coroutine_destroy(analyzer, volt_vector_get(&analyzer->coroutines, i));
+    volt_vector_deinit(&analyzer->coroutines);
+    for (size_t i = 0; i < analyzer->loops.size; i++)
+        volt_loop_destroy(analyzer, volt_vector_get(&analyzer->loops, i));
+    volt_vector_deinit(&analyzer->loops);
+    for (size_t i = 0; i < analyzer->matches.size; i++)
+        volt_match_destroy(analyzer, volt_vector_get(&analyzer->matches, i));
+    volt_vector_deinit(&analyzer->matches);
+    for (size_t i = 0; i < analyzer->closures.size; i++)
+        volt_escape_destroy(analyzer, volt_vector_get(&analyzer->closures, i));
+    volt_vector_deinit(&analyzer->closures);
+    for (size_t i = 0; i < analyzer->fallibles.size; i++)
+        volt_fallible_destroy(analyzer, volt_vector_get(&analyzer->fallibles, i));
+    volt_vector_deinit(&analyzer->fallibles);
+    for (size_t i = 0; i < analyzer->dispatches.size; i++)
+        volt_devirt_destroy_dispatch(analyzer, volt_vector_get(&analyzer->dispatches, i));
+    volt_vector_deinit(&analyzer->dispatches);
+    for (size_t i = 0; i < analyzer->traits.size; i++)
+        volt_devirt_destroy_trait(analyzer, volt_vector_get(&analyzer->traits, i));
+    volt_vector_deinit(&analyzer->traits);
+    volt_vector_deinit(&analyzer->unresolved_symbols);
+
+    volt_scope_t* global = analyzer->global_scope;
+    if (global) {
+        volt_small_vector_deinit(&global->symbols);
+        volt_small_vector_deinit(&global->children);
+        if (global->index)
+            analyzer->allocator->free(global->index);
+        analyzer->allocator->free(global);
+        analyzer->global_scope  = NULL;
+        analyzer->current_scope = NULL;
+    }
+
+    for (size_t i = 0; i < analyzer->owned_symbols.size; i++) {
+        volt_symbol_t* symbol = volt_vector_get(&analyzer->owned_symbols, i);
+        volt_vector_deinit(&symbol->parameters);
+        volt_vector_deinit(&symbol->instances);
+        analyzer->allocator->free(symbol);
+    }
+    volt_vector_deinit(&analyzer->owned_symbols);
+
+    for (size_t i = 0; i < analyzer->owned_types.size; i++) {
+        volt_type_info_t* type = volt_vector_get(&analyzer->owned_types, i);
+        volt_small_vector_deinit(&type->element_types);
+        volt_small_vector_deinit(&type->fields);
+        volt_small_vector_deinit(&type->variants);
+        analyzer->allocator->free(type);
+    }
+    volt_vector_deinit(&analyzer->owned_types);
 
+    analyzer->allocator = NULL;
     return VOLT_SUCCESS;
 }
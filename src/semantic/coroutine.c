@@ -0,0 +1,396 @@
+#include <pch.h>
+#include <semantic/coroutine.h>
+#include <semantic/layout.h>
+#include <util/types/value_vector.h>
+
+// Liveness is computed on positions rather than a control-flow graph: every identifier use and
+// every suspend gets the next position while the body is walked in program order. A local
+// crosses a suspend when it is declared before the suspend and used after it. Branches are
+// covered because positions only grow, loops by extending uses to the end of the loop.
+
+// Start positions of the loops being walked, outermost first; a loop's depth is its index + 1
+VOLT_VECTOR_DEFINE(loop_start, size_t)
+
+typedef struct volt_coroutine_walk_t volt_coroutine_walk_t;
+struct volt_coroutine_walk_t {
+    volt_semantic_analyzer_t* analyzer;
+    volt_coroutine_t*         coroutine;
+    volt_loop_start_vector_t  loops;
+    size_t                    position;
+};
+
+// HELPER FUNCTIONS
+
+static volt_coroutine_local_t* volt_coroutine_local(volt_coroutine_walk_t* walk, size_t index) {
+    return (volt_coroutine_local_t*) volt_vector_get(&walk->coroutine->locals, index);
+}
+
+// Locals declared without a type take the type of a literal initializer, or a register-sized
+// slot until local inference exists
+static volt_type_info_t* volt_coroutine_guess_type(volt_semantic_analyzer_t* analyzer,
+                                                   volt_ast_node_t*          initializer) {
+    volt_ast_node_t* literal = volt_ast_unwrap(initializer);
+    volt_token_t*    token   = volt_ast_is(literal, "literal") ? volt_ast_first_token(literal)
+                                                               : NULL;
+    if (!token)
+        return analyzer->type_usize;
+
+    switch (token->type) {
+        case VOLT_TOKEN_TYPE_NUMBER_LITERAL:
+            return strchr(token->lexeme, '.') ? analyzer->type_f64 : analyzer->type_i32;
+        case VOLT_TOKEN_TYPE_STRING_LITERAL:
+            return analyzer->type_str;
+        case VOLT_TOKEN_TYPE_TRUE_KW:
+        case VOLT_TOKEN_TYPE_FALSE_KW:
+            return analyzer->type_bool;
+        default:
+            return analyzer->type_usize;
+    }
+}
+
+static void volt_coroutine_declare(volt_coroutine_walk_t* walk, const char* name,
+                                   volt_type_info_t* type, volt_ast_node_t* declaration) {
+    volt_allocator_t*       allocator = walk->analyzer->allocator;
+    volt_coroutine_local_t* local     = allocator->malloc(sizeof(volt_coroutine_local_t));
+    if (!local)
+        return;
+
+    memset(local, 0, sizeof(volt_coroutine_local_t));
+    local->name        = name;
+    local->type        = type;
+    local->declaration = declaration;
+    local->declared    = walk->position;
+    local->last_use    = walk->position;
+    local->in_scope    = true;
+    volt_vector_push_back(&walk->coroutine->locals, local);
+}
+
+// `for x` or `for (a, b)`; element types are not inferred yet
+static void volt_coroutine_declare_bindings(volt_coroutine_walk_t* walk, volt_ast_node_t* node,
+                                            volt_ast_node_t* binding) {
+    if (node->type == VOLT_AST_NODE_TOKEN) {
+        if (node->token && node->token->type == VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL)
+            volt_coroutine_declare(walk, node->token->lexeme, walk->analyzer->type_usize,
+                                   binding);
+        return;
+    }
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_coroutine_declare_bindings(walk, volt_ast_get_child(node, i), binding);
+}
+
+static void volt_coroutine_use(volt_coroutine_walk_t* walk, const char* name) {
+    volt_coroutine_local_t* local = NULL;
+    for (size_t i = walk->coroutine->locals.size; i > 0 && !local; i--) {
+        volt_coroutine_local_t* candidate = volt_coroutine_local(walk, i - 1);
+        if (candidate->in_scope && strcmp(candidate->name, name) == 0)
+            local = candidate;
+    }
+    if (!local)
+        return;
+
+    local->last_use = ++walk->position;
+
+    // The outermost loop entered after the declaration runs this use again
+    for (size_t i = 0; i < walk->loops.size; i++) {
+        if (walk->loops.data[i] > local->declared) {
+            if (!local->loop || i + 1 < local->loop)
+                local->loop = i + 1;
+            break;
+        }
+    }
+}
+
+static void volt_coroutine_walk(volt_coroutine_walk_t* walk, volt_ast_node_t* node) {
+    if (!node)
+        return;
+
+    if (node->type == VOLT_AST_NODE_TOKEN) {
+        if (node->token && node->token->type == VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL)
+            volt_coroutine_use(walk, node->token->lexeme);
+        return;
+    }
+
+    // Type names and nested function bodies hold no locals of this frame
+    if (volt_ast_is(node, "type") || volt_ast_is(node, "generic_args") ||
+        volt_ast_is(node, "func_def"))
+        return;
+
+    if (volt_ast_is(node, "suspend_stmt")) {
+        volt_coroutine_suspend_t* suspend =
+            walk->analyzer->allocator->malloc(sizeof(volt_coroutine_suspend_t));
+        if (!suspend)
+            return;
+        suspend->node     = node;
+        suspend->position = ++walk->position;
+        volt_vector_push_back(&walk->coroutine->suspends, suspend);
+        return;
+    }
+
+    if (volt_ast_is(node, "var_decl") || volt_ast_is(node, "val_decl")) {
+        volt_ast_node_t* initializer = volt_ast_find_child(node, "expression");
+        volt_ast_node_t* type_node   = volt_ast_find_child(node, "type");
+        volt_coroutine_walk(walk, initializer);
+        volt_coroutine_declare(walk, volt_ast_get_identifier(node),
+                               type_node ? volt_type_from_ast(walk->analyzer, type_node)
+                                         : volt_coroutine_guess_type(walk->analyzer, initializer),
+                               node);
+        return;
+    }
+
+    if (volt_ast_is(node, "for_binding")) {
+        volt_coroutine_declare_bindings(walk, node, node);
+        return;
+    }
+
+    bool   is_loop = volt_ast_is(node, "while_stmt") || volt_ast_is(node, "loop_stmt") ||
+                     volt_ast_is(node, "for_stmt");
+    bool   scoped  = is_loop || volt_ast_is(node, "block");
+    size_t mark    = walk->coroutine->locals.size;
+
+    size_t depth = 0;
+    if (is_loop) {
+        // Entering takes a position of its own, so locals declared just before the loop are
+        // told apart from those declared first thing inside it
+        is_loop = volt_loop_start_vector_push_back(&walk->loops, ++walk->position) == VOLT_SUCCESS;
+        depth   = walk->loops.size;
+    }
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_coroutine_walk(walk, volt_ast_get_child(node, i));
+
+    if (is_loop) {
+        walk->loops.size = depth - 1;
+        size_t end       = ++walk->position;
+        for (size_t i = 0; i < walk->coroutine->locals.size; i++) {
+            volt_coroutine_local_t* local = volt_coroutine_local(walk, i);
+            if (local->loop == depth) {
+                local->last_use = end;
+                local->loop     = 0;
+            }
+        }
+    }
+
+    for (size_t i = mark; scoped && i < walk->coroutine->locals.size; i++)
+        volt_coroutine_local(walk, i)->in_scope = false;
+}
+
+// Whether some suspend lies strictly between `from` and `to`
+static bool volt_coroutine_crosses(volt_coroutine_t* coroutine, size_t from, size_t to) {
+    for (size_t i = 0; i < coroutine->suspends.size; i++) {
+        volt_coroutine_suspend_t* suspend = volt_vector_get(&coroutine->suspends, i);
+        if (suspend->position > from && suspend->position < to)
+            return true;
+    }
+    return false;
+}
+
+static bool volt_coroutine_interferes(volt_coroutine_t* coroutine, volt_coroutine_local_t* a,
+                                      volt_coroutine_local_t* b) {
+    size_t from = a->declared > b->declared ? a->declared : b->declared;
+    size_t to   = a->last_use < b->last_use ? a->last_use : b->last_use;
+    return from < to && volt_coroutine_crosses(coroutine, from, to);
+}
+
+static volt_symbol_t* volt_coroutine_field(volt_semantic_analyzer_t* analyzer, const char* name,
+                                           volt_type_info_t* type) {
+    volt_symbol_t* field = volt_symbol_create(analyzer, VOLT_SYMBOL_VARIABLE);
+    if (!field)
+        return NULL;
+
+    field->name        = name;
+    field->type        = type;
+    field->is_mutable  = true;
+    field->is_resolved = true;
+    return field;
+}
+
+// A struct with no declaration, so the layout pass takes the fields as given
+static volt_type_info_t* volt_coroutine_frame_type(volt_semantic_analyzer_t* analyzer,
+                                                   volt_coroutine_t*         coroutine) {
+    char name[256];
+    snprintf(name, sizeof(name), "%s.frame", coroutine->function->name);
+
+    volt_type_info_t* frame = volt_type_create(analyzer, VOLT_TYPE_STRUCT);
+    if (!frame)
+        return NULL;
+    frame->name        = volt_type_own_name(analyzer, name);
+    frame->is_complete = true;
+
+    volt_small_vector_push_back(&frame->fields,
+                          volt_coroutine_field(analyzer, ".state", analyzer->type_u32));
+    volt_ast_node_t* result_node = volt_ast_find_child(coroutine->function->declaration, "type");
+    volt_type_info_t* result = result_node ? volt_type_from_ast(analyzer, result_node) : NULL;
+    volt_layout_compute(analyzer, result);
+    if (result && result->kind != VOLT_TYPE_VOID && result->size > 0)
+        volt_small_vector_push_back(&frame->fields,
+                                    volt_coroutine_field(analyzer, ".result", result));
+    return frame;
+}
+
+// Greedy slot sharing: a local joins the first slot none of whose locals it interferes with,
+// provided the slot's type is at least as large and as aligned
+static void volt_coroutine_assign_slots(volt_semantic_analyzer_t* analyzer,
+                                        volt_coroutine_t*         coroutine) {
+    for (size_t i = 0; i < coroutine->locals.size; i++) {
+        volt_coroutine_local_t* local = volt_vector_get(&coroutine->locals, i);
+        if (!volt_coroutine_crosses(coroutine, local->declared, local->last_use))
+            continue;
+
+        coroutine->spilled++;
+        volt_layout_compute(analyzer, local->type);
+
+        for (size_t j = 0; j < i && !local->slot; j++) {
+            volt_coroutine_local_t* other = volt_vector_get(&coroutine->locals, j);
+            if (!other->slot || other->slot->type->size < local->type->size ||
+                other->slot->type->alignment < local->type->alignment)
+                continue;
+
+            bool free = true;
+            for (size_t k = 0; k < i && free; k++) {
+                volt_coroutine_local_t* sharer = volt_vector_get(&coroutine->locals, k);
+                free = sharer->slot != other->slot ||
+                       !volt_coroutine_interferes(coroutine, local, sharer);
+            }
+            if (free)
+                local->slot = other->slot;
+        }
+
+        if (!local->slot) {
+            local->slot = volt_coroutine_field(analyzer, local->name, local->type);
+            volt_small_vector_push_back(&coroutine->frame->fields, local->slot);
+        }
+    }
+}
+
+static size_t volt_coroutine_unshared_size(volt_semantic_analyzer_t* analyzer,
+                                           volt_coroutine_t*         coroutine) {
+    volt_type_info_t* frame = volt_coroutine_frame_type(analyzer, coroutine);
+    if (!frame)
+        return 0;
+
+    for (size_t i = 0; i < coroutine->locals.size; i++) {
+        volt_coroutine_local_t* local = volt_vector_get(&coroutine->locals, i);
+        volt_small_vector_push_back(&frame->fields,
+                              volt_coroutine_field(analyzer, local->name, local->type));
+    }
+    volt_layout_compute(analyzer, frame);
+    return frame->size;
+}
+
+static volt_coroutine_t* volt_coroutine_lower(volt_semantic_analyzer_t* analyzer,
+                                              volt_symbol_t*            function) {
+    volt_ast_node_t* body = volt_ast_body(function->declaration);
+    if (!body)
+        return NULL;
+
+    volt_coroutine_t* coroutine = analyzer->allocator->malloc(sizeof(volt_coroutine_t));
+    if (!coroutine)
+        return NULL;
+
+    memset(coroutine, 0, sizeof(volt_coroutine_t));
+    coroutine->function           = function;
+    coroutine->suspends.allocator = analyzer->allocator;
+    coroutine->locals.allocator   = analyzer->allocator;
+    volt_vector_init(&coroutine->suspends);
+    volt_vector_init(&coroutine->locals);
+
+    volt_coroutine_walk_t walk = {0};
+    walk.analyzer              = analyzer;
+    walk.coroutine             = coroutine;
+    walk.loops.allocator       = analyzer->allocator;
+    volt_loop_start_vector_init(&walk.loops);
+
+    for (size_t i = 0; i < function->parameters.size; i++) {
+        volt_symbol_t*   param     = volt_vector_get(&function->parameters, i);
+        volt_ast_node_t* type_node = volt_ast_find_child(param->declaration, "type");
+        volt_coroutine_declare(&walk, param->name,
+                               type_node ? volt_type_from_ast(analyzer, type_node)
+                                         : analyzer->type_unknown,
+                               param->declaration);
+    }
+    volt_coroutine_walk(&walk, body);
+    volt_loop_start_vector_deinit(&walk.loops);
+
+    coroutine->frame = volt_coroutine_frame_type(analyzer, coroutine);
+    if (coroutine->frame) {
+        volt_coroutine_assign_slots(analyzer, coroutine);
+        volt_layout_compute(analyzer, coroutine->frame);
+    }
+    coroutine->unshared_size = volt_coroutine_unshared_size(analyzer, coroutine);
+    return coroutine;
+}
+
+// LOWERING
+
+volt_status_code_t volt_coroutine_lower_all(volt_semantic_analyzer_t* analyzer) {
+    if (!analyzer)
+        return VOLT_FAILURE;
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_FUNCTION || !symbol->is_async || symbol->is_generic ||
+            !volt_semantic_checks(analyzer, symbol->declaration))
+            continue;
+
+        analyzer->current_file_index = symbol->file_index;
+        volt_coroutine_t* coroutine  = volt_coroutine_lower(analyzer, symbol);
+        if (coroutine)
+            volt_vector_push_back(&analyzer->coroutines, coroutine);
+    }
+
+    return VOLT_SUCCESS;
+}
+
+void volt_coroutine_destroy(volt_semantic_analyzer_t* analyzer, volt_coroutine_t* coroutine) {
+    if (!coroutine)
+        return;
+
+    for (size_t i = 0; i < coroutine->suspends.size; i++)
+        analyzer->allocator->free(volt_vector_get(&coroutine->suspends, i));
+    for (size_t i = 0; i < coroutine->locals.size; i++)
+        analyzer->allocator->free(volt_vector_get(&coroutine->locals, i));
+    volt_vector_deinit(&coroutine->suspends);
+    volt_vector_deinit(&coroutine->locals);
+    analyzer->allocator->free(coroutine);
+}
+
+// REPORT
+
+void volt_coroutine_print(volt_semantic_analyzer_t* analyzer) {
+    printf("== coroutines ==\n");
+
+    for (size_t i = 0; i < analyzer->coroutines.size; i++) {
+        volt_coroutine_t* coroutine = volt_vector_get(&analyzer->coroutines, i);
+        volt_type_info_t* frame     = coroutine->frame;
+        if (!frame)
+            continue;
+
+        printf("async    %s: %zu suspend(s), %zu of %zu local(s) in frame, "
+               "frame %zu bytes (%zu without liveness), align %zu\n",
+               coroutine->function->name, coroutine->suspends.size, coroutine->spilled,
+               coroutine->locals.size, frame->size, coroutine->unshared_size, frame->alignment);
+
+        for (size_t j = 0; j < frame->fields.size; j++) {
+            volt_symbol_t* field = volt_small_vector_get(&frame->fields, j);
+            printf("  +%-5zu %-16s %s (%zu)\n", field->offset, field->name,
+                   volt_type_to_string(field->type), field->type->size);
+        }
+
+        for (size_t j = 0; j < coroutine->suspends.size; j++) {
+            volt_coroutine_suspend_t* suspend = volt_vector_get(&coroutine->suspends, j);
+            volt_token_t*             token   = volt_ast_first_token(suspend->node);
+            printf("  state %-3zu line %-5zu live:", j + 1, token ? token->line : 0);
+            for (size_t k = 0; k < coroutine->locals.size; k++) {
+                volt_coroutine_local_t* local = volt_vector_get(&coroutine->locals, k);
+                if (local->declared >= suspend->position || suspend->position >= local->last_use)
+                    continue;
+                if (local->slot->name == local->name)
+                    printf(" %s", local->name);
+                else
+                    printf(" %s (in %s)", local->name, local->slot->name);
+            }
+            printf("\n");
+        }
+    }
+}
@@ -0,0 +1,340 @@
+#include <pch.h>
+#include <semantic/dce.h>
+#include <semantic/devirt.h>
+
+// Reachability over the global symbol table. A declaration's body is walked once it is marked;
+// every identifier naming a global function or variable marks it in turn (direct calls are
+// narrowed by arity), and the instances recorded for it during pass 2 are marked as well.
+// Folded comptime expressions are skipped: their callees never run at runtime.
+//
+// Methods of attach blocks are in no scope; trait method calls reach them through the bindings
+// devirtualization recorded. A direct call marks the method it was bound to, a call through a
+// vtable that method in every implementation of the trait, and a call whose receiver type is
+// unknown every method of that name.
+
+typedef struct volt_dce_t volt_dce_t;
+struct volt_dce_t {
+    volt_semantic_analyzer_t* analyzer;
+    volt_symbol_t**           by_name;  // Global symbols sorted by name
+    size_t                    count;
+    volt_dispatch_t**         dispatches;  // Trait method calls sorted by call node
+    size_t                    dispatch_count;
+    volt_vector_t             symbols;    // Worklist of marked symbols
+    volt_vector_t             instances;  // Worklist of marked instances
+};
+
+// HELPER FUNCTIONS
+
+static int volt_dce_compare_names(const void* a, const void* b) {
+    const volt_symbol_t* left  = *(const volt_symbol_t* const*) a;
+    const volt_symbol_t* right = *(const volt_symbol_t* const*) b;
+    return strcmp(left->name, right->name);
+}
+
+// First symbol called `name` in the sorted table, or `count` when there is none
+static size_t volt_dce_find(volt_dce_t* dce, const char* name) {
+    size_t low = 0, high = dce->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (strcmp(dce->by_name[mid]->name, name) < 0)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low < dce->count && strcmp(dce->by_name[low]->name, name) == 0 ? low : dce->count;
+}
+
+static int volt_dce_compare_nodes(const void* a, const void* b) {
+    uintptr_t left  = (uintptr_t) (*(const volt_dispatch_t* const*) a)->node;
+    uintptr_t right = (uintptr_t) (*(const volt_dispatch_t* const*) b)->node;
+    return left < right ? -1 : left > right;
+}
+
+// First dispatch recorded for `node`, or `dispatch_count` when there is none
+static size_t volt_dce_find_dispatch(volt_dce_t* dce, volt_ast_node_t* node) {
+    size_t low = 0, high = dce->dispatch_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if ((uintptr_t) dce->dispatches[mid]->node < (uintptr_t) node)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low < dce->dispatch_count && dce->dispatches[low]->node == node ? low
+                                                                           : dce->dispatch_count;
+}
+
+static bool volt_dce_is_code(volt_symbol_t* symbol) {
+    return (symbol->kind == VOLT_SYMBOL_FUNCTION || symbol->kind == VOLT_SYMBOL_VARIABLE) &&
+           !symbol->is_generic;
+}
+
+static void volt_dce_mark_symbol(volt_dce_t* dce, volt_symbol_t* symbol) {
+    if (symbol->is_reachable)
+        return;
+    symbol->is_reachable = true;
+    volt_vector_push_back(&dce->symbols, symbol);
+}
+
+static void volt_dce_mark_instance(volt_dce_t* dce, volt_instance_t* instance) {
+    if (instance->is_reachable)
+        return;
+    instance->is_reachable = true;
+    volt_vector_push_back(&dce->instances, instance);
+}
+
+static void volt_dce_mark_name(volt_dce_t* dce, const char* name) {
+    for (size_t i = volt_dce_find(dce, name);
+         i < dce->count && strcmp(dce->by_name[i]->name, name) == 0; i++) {
+        if (volt_dce_is_code(dce->by_name[i]))
+            volt_dce_mark_symbol(dce, dce->by_name[i]);
+    }
+}
+
+// `method` in every implementation of `trait`, or of any trait when it is NULL
+static void volt_dce_mark_methods(volt_dce_t* dce, volt_trait_t* trait, const char* method) {
+    volt_vector_t* traits = &dce->analyzer->traits;
+    for (size_t i = 0; i < traits->size; i++) {
+        volt_trait_t* candidate = volt_vector_get(traits, i);
+        if (trait && candidate != trait)
+            continue;
+
+        for (size_t j = 0; j < candidate->impls.size; j++) {
+            volt_trait_impl_t* impl = volt_vector_get(&candidate->impls, j);
+            for (size_t k = 0; k < impl->methods.size; k++) {
+                volt_symbol_t* symbol = volt_vector_get(&impl->methods, k);
+                if (strcmp(symbol->name, method) == 0)
+                    volt_dce_mark_symbol(dce, symbol);
+            }
+        }
+    }
+}
+
+// A generic function's calls are bound once per instance; all of them are marked
+static void volt_dce_mark_dispatches(volt_dce_t* dce, volt_ast_node_t* postfix) {
+    for (size_t i = volt_dce_find_dispatch(dce, postfix);
+         i < dce->dispatch_count && dce->dispatches[i]->node == postfix; i++) {
+        volt_dispatch_t* dispatch = dce->dispatches[i];
+        switch (dispatch->kind) {
+            case VOLT_DISPATCH_DIRECT:
+                if (dispatch->target)
+                    volt_dce_mark_symbol(dce, dispatch->target);
+                break;
+            case VOLT_DISPATCH_VIRTUAL:
+                volt_dce_mark_methods(dce, dispatch->trait, dispatch->method);
+                break;
+            case VOLT_DISPATCH_UNRESOLVED:
+                volt_dce_mark_methods(dce, NULL, dispatch->method);
+                break;
+        }
+    }
+}
+
+static void volt_dce_mark_uses(volt_dce_t* dce, volt_vector_t* uses) {
+    for (size_t i = 0; i < uses->size; i++)
+        volt_dce_mark_instance(dce, (volt_instance_t*) volt_vector_get(uses, i));
+}
+
+// `name(args)` resolves to a single overload when one matches the arity
+static bool volt_dce_mark_call(volt_dce_t* dce, volt_ast_node_t* postfix) {
+    volt_ast_node_t* primary = volt_ast_get_child(postfix, 0);
+    volt_ast_node_t* ident   = volt_ast_get_child(primary, 0);
+    volt_ast_node_t* op      = volt_ast_get_child(volt_ast_get_child(postfix, 1), 0);
+    volt_ast_node_t* call    = volt_ast_get_child(op, 0);
+    if (!ident || !ident->token || ident->token->type != VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL ||
+        !volt_ast_is(call, "call") || volt_ast_find_child(call, "generic_args"))
+        return false;
+
+    volt_vector_t args = volt_vector_default();
+    size_t argc = volt_ast_collect_list(volt_ast_find_child(call, "args"), "expression", &args);
+    volt_vector_deinit(&args);
+
+    volt_symbol_t* callee = volt_scope_lookup_function(dce->analyzer->global_scope,
+                                                       ident->token->lexeme, argc);
+    if (!callee || callee->is_generic)
+        return false;
+
+    volt_dce_mark_symbol(dce, callee);
+    return true;
+}
+
+static void volt_dce_walk(volt_dce_t* dce, volt_ast_node_t* node) {
+    if (!node)
+        return;
+
+    if (node->type == VOLT_AST_NODE_TOKEN) {
+        if (node->token && node->token->type == VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL)
+            volt_dce_mark_name(dce, node->token->lexeme);
+        return;
+    }
+
+    // Function bodies no earlier pass needed may still be skipped
+    node = volt_ast_parse_body(node);
+    if (!node)
+        return;
+
+    // Folded by comptime evaluation
+    if (node->data)
+        return;
+
+    size_t first = 0;
+    if (volt_ast_is(node, "postfix_expr")) {
+        volt_dce_mark_dispatches(dce, node);
+        if (volt_dce_mark_call(dce, node))
+            first = 1;
+    }
+
+    for (size_t i = first; i < node->children.size; i++)
+        volt_dce_walk(dce, volt_ast_get_child(node, i));
+}
+
+// The declared name itself is not a use, and generic parameters are already bound
+static void volt_dce_walk_declaration(volt_dce_t* dce, volt_ast_node_t* declaration) {
+    for (size_t i = 0; i < declaration->children.size; i++) {
+        volt_ast_node_t* child = volt_ast_get_child(declaration, i);
+        if (child->type == VOLT_AST_NODE_TOKEN || volt_ast_is(child, "generics"))
+            continue;
+        volt_dce_walk(dce, child);
+    }
+}
+
+static bool volt_dce_is_root(volt_symbol_t* symbol) {
+    if (symbol->kind != VOLT_SYMBOL_FUNCTION || symbol->is_generic)
+        return false;
+    return strcmp(symbol->name, "main") == 0 || volt_ast_is(symbol->declaration, "export_decl") ||
+           volt_ast_is(symbol->declaration, "extern_decl");
+}
+
+// DCE
+
+volt_status_code_t volt_dce_run(volt_semantic_analyzer_t* analyzer, volt_dce_stats_t* stats) {
+    if (!analyzer || !stats)
+        return VOLT_FAILURE;
+
+    volt_scope_t* global = analyzer->global_scope;
+    volt_dce_t    dce    = {0};
+    dce.analyzer         = analyzer;
+    dce.count            = global->symbols.size;
+    dce.by_name          = analyzer->allocator->malloc((dce.count + 1) * sizeof(volt_symbol_t*));
+    if (!dce.by_name)
+        return VOLT_FAILURE;
+
+    memcpy(dce.by_name, volt_small_vector_data(&global->symbols),
+           dce.count * sizeof(volt_symbol_t*));
+    qsort(dce.by_name, dce.count, sizeof(volt_symbol_t*), volt_dce_compare_names);
+
+    dce.dispatch_count = analyzer->dispatches.size;
+    dce.dispatches =
+        analyzer->allocator->malloc((dce.dispatch_count + 1) * sizeof(volt_dispatch_t*));
+    if (!dce.dispatches) {
+        analyzer->allocator->free(dce.by_name);
+        return VOLT_FAILURE;
+    }
+    memcpy(dce.dispatches, analyzer->dispatches.data,
+           dce.dispatch_count * sizeof(volt_dispatch_t*));
+    qsort(dce.dispatches, dce.dispatch_count, sizeof(volt_dispatch_t*), volt_dce_compare_nodes);
+
+    dce.symbols.allocator   = analyzer->allocator;
+    dce.instances.allocator = analyzer->allocator;
+    volt_vector_init(&dce.symbols);
+    volt_vector_init(&dce.instances);
+
+    for (size_t i = 0; i < dce.count; i++) {
+        if (volt_dce_is_root(dce.by_name[i]))
+            volt_dce_mark_symbol(&dce, dce.by_name[i]);
+    }
+
+    while (dce.symbols.size > 0 || dce.instances.size > 0) {
+        if (dce.symbols.size > 0) {
+            volt_symbol_t* symbol = (volt_symbol_t*) volt_vector_get_back(&dce.symbols);
+            volt_vector_pop_back(&dce.symbols);
+            volt_dce_walk_declaration(&dce, symbol->declaration);
+            volt_dce_mark_uses(&dce, &symbol->instances);
+            continue;
+        }
+
+        volt_instance_t* instance = (volt_instance_t*) volt_vector_get_back(&dce.instances);
+        volt_vector_pop_back(&dce.instances);
+
+        volt_dce_walk_declaration(&dce, instance->generic->declaration);
+        volt_dce_mark_uses(&dce, &instance->instances);
+    }
+
+    memset(stats, 0, sizeof(volt_dce_stats_t));
+    for (size_t i = 0; i < dce.count; i++) {
+        volt_symbol_t* symbol = dce.by_name[i];
+        if (symbol->kind != VOLT_SYMBOL_FUNCTION || symbol->is_generic)
+            continue;
+        stats->functions++;
+        stats->functions_dropped += symbol->is_reachable ? 0 : 1;
+    }
+    for (size_t i = 0; i < analyzer->traits.size; i++) {
+        volt_trait_t* trait = volt_vector_get(&analyzer->traits, i);
+        for (size_t j = 0; j < trait->impls.size; j++) {
+            volt_trait_impl_t* impl = volt_vector_get(&trait->impls, j);
+            for (size_t k = 0; k < impl->methods.size; k++) {
+                volt_symbol_t* method = volt_vector_get(&impl->methods, k);
+                stats->functions++;
+                stats->functions_dropped += method->is_reachable ? 0 : 1;
+            }
+        }
+    }
+    for (size_t i = 0; i < analyzer->instances.instances.size; i++) {
+        volt_instance_t* instance = volt_vector_get(&analyzer->instances.instances, i);
+        stats->instances++;
+        stats->instances_dropped += instance->is_reachable ? 0 : 1;
+    }
+
+    volt_fmt_logf(VOLT_FMT_LEVEL_INFO,
+                  "DCE: dropped {u64} of {u64} function(s), {u64} of {u64} instance(s)",
+                  (uint64_t) stats->functions_dropped, (uint64_t) stats->functions,
+                  (uint64_t) stats->instances_dropped, (uint64_t) stats->instances);
+
+    volt_vector_deinit(&dce.symbols);
+    volt_vector_deinit(&dce.instances);
+    analyzer->allocator->free(dce.dispatches);
+    analyzer->allocator->free(dce.by_name);
+    return VOLT_SUCCESS;
+}
+
+void volt_dce_print(volt_semantic_analyzer_t* analyzer, const volt_dce_stats_t* stats) {
+    printf("== dead code elimination: %zu/%zu function(s), %zu/%zu instance(s) dropped ==\n",
+           stats->functions_dropped, stats->functions, stats->instances_dropped,
+           stats->instances);
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_FUNCTION || symbol->is_generic || symbol->is_reachable)
+            continue;
+
+        volt_token_t* token    = volt_ast_first_token(symbol->declaration);
+        bool          attached = volt_ast_find_token(symbol->declaration,
+                                                     VOLT_TOKEN_TYPE_ATTACH_KW) != NULL;
+        printf("  %-9s %s (%s:%zu)\n", attached ? "attach fn" : "fn", symbol->name,
+               analyzer->input_stream_names[symbol->file_index], token ? token->line : 0);
+    }
+
+    for (size_t i = 0; i < analyzer->traits.size; i++) {
+        volt_trait_t* trait = volt_vector_get(&analyzer->traits, i);
+        for (size_t j = 0; j < trait->impls.size; j++) {
+            volt_trait_impl_t* impl = volt_vector_get(&trait->impls, j);
+            for (size_t k = 0; k < impl->methods.size; k++) {
+                volt_symbol_t* method = volt_vector_get(&impl->methods, k);
+                if (method->is_reachable)
+                    continue;
+
+                volt_token_t* token = volt_ast_first_token(method->declaration);
+                printf("  %-9s %s::%s (%s:%zu)\n", "method", impl->type ? impl->type : "<any>",
+                       method->name, analyzer->input_stream_names[method->file_index],
+                       token ? token->line : 0);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < analyzer->instances.instances.size; i++) {
+        volt_instance_t* instance = volt_vector_get(&analyzer->instances.instances, i);
+        if (!instance->is_reachable)
+            printf("  %-9s %s\n", "instance", instance->name);
+    }
+}
@@ -0,0 +1,561 @@
+#include <pch.h>
+#include <semantic/devirt.h>
+#include <semantic/layout.h>
+#include <util/types/value_vector.h>
+
+// What is in scope while a function body is walked
+typedef struct volt_devirt_walk_t volt_devirt_walk_t;
+struct volt_devirt_walk_t {
+    volt_semantic_analyzer_t*      analyzer;
+    volt_ast_node_t*               function;  // func_def
+    volt_ast_node_t*               generics;  // Unbound generic parameters, NULL when none
+    volt_trait_impl_t*             impl;      // Attach block the function belongs to
+    const volt_comptime_binding_t* bindings;  // Instance being walked
+    size_t                         binding_count;
+    const char*                    caller;
+    size_t                         file_index;
+};
+
+// HELPER FUNCTIONS
+
+// `std::mem::default_allocator` names `default_allocator`
+static const char* volt_devirt_path_last(volt_ast_node_t* path) {
+    const char* name = NULL;
+    while (path) {
+        const char* segment = volt_ast_get_identifier(path);
+        if (segment)
+            name = segment;
+        path = volt_ast_find_child(path, "path_rest");
+    }
+    return name;
+}
+
+// Types are matched by name, ignoring generic arguments and pointer, optional or reference
+// suffixes: method calls dereference their receiver
+static bool volt_devirt_same_type(const char* a, const char* b) {
+    size_t length = strcspn(a, "<*?&[ ");
+    return length == strcspn(b, "<*?&[ ") && strncmp(a, b, length) == 0;
+}
+
+static volt_trait_t* volt_devirt_find_trait(volt_semantic_analyzer_t* analyzer, const char* name) {
+    for (size_t i = 0; name && i < analyzer->traits.size; i++) {
+        volt_trait_t* trait = volt_vector_get(&analyzer->traits, i);
+        if (strcmp(trait->name, name) == 0)
+            return trait;
+    }
+    return NULL;
+}
+
+static bool volt_devirt_declares(volt_trait_t* trait, const char* method) {
+    for (size_t i = 0; i < trait->methods.size; i++) {
+        if (strcmp(volt_vector_get(&trait->methods, i), method) == 0)
+            return true;
+    }
+    return false;
+}
+
+static volt_symbol_t* volt_devirt_impl_method(volt_trait_impl_t* impl, const char* method) {
+    for (size_t i = 0; i < impl->methods.size; i++) {
+        volt_symbol_t* function = volt_vector_get(&impl->methods, i);
+        if (strcmp(function->name, method) == 0)
+            return function;
+    }
+    return NULL;
+}
+
+static bool volt_devirt_is_parameter(volt_ast_node_t* generics, const char* name) {
+    volt_vector_t params = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(generics, "generic_params"), "generic_param",
+                          &params);
+
+    bool found = false;
+    for (size_t i = 0; i < params.size && !found; i++) {
+        const char* param = volt_ast_get_identifier(volt_vector_get(&params, i));
+        found             = param && strcmp(param, name) == 0;
+    }
+    volt_vector_deinit(&params);
+    return found;
+}
+
+// Name of the type a value declared as `type` dispatches on. Generic parameters take their
+// binding in the instance being walked; NULL when the type is not known.
+static const char* volt_devirt_type_name(volt_devirt_walk_t* walk, volt_ast_node_t* type) {
+    volt_ast_node_t* base = volt_ast_get_child(volt_ast_find_child(type, "base_type"), 0);
+    if (volt_ast_is(base, "primitive_type")) {
+        volt_token_t* token = volt_ast_first_token(base);
+        return token ? token->lexeme : NULL;
+    }
+    if (!volt_ast_is(base, "named_type"))
+        return NULL;
+
+    volt_ast_node_t* path = volt_ast_find_child(base, "path");
+    const char*      name = volt_devirt_path_last(path);
+    volt_ast_node_t* rest = volt_ast_find_child(path, "path_rest");
+    if (!name || (rest && rest->children.size > 0))
+        return name;
+
+    for (size_t i = 0; i < walk->binding_count; i++) {
+        const volt_comptime_binding_t* binding = &walk->bindings[i];
+        if (strcmp(binding->name, name) != 0)
+            continue;
+        // Qualified defaults are bound to the unknown type until namespaces are modelled
+        bool known = binding->value.kind == VOLT_COMPTIME_VALUE_TYPE &&
+                     binding->value.type != walk->analyzer->type_unknown;
+        return known ? binding->value.type->name : NULL;
+    }
+    return volt_devirt_is_parameter(walk->generics, name) ? NULL : name;
+}
+
+// Declared type of `name` in the function being walked: a parameter, or else a typed local.
+// Shadowing locals are not told apart; an untyped one leaves the receiver unresolved.
+static volt_ast_node_t* volt_devirt_find_local(volt_ast_node_t* node, const char* name) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return NULL;
+
+    if (volt_ast_is(node, "var_decl") || volt_ast_is(node, "val_decl")) {
+        const char* local = volt_ast_get_identifier(node);
+        if (local && strcmp(local, name) == 0)
+            return node;
+    }
+    for (size_t i = 0; i < node->children.size; i++) {
+        volt_ast_node_t* found = volt_devirt_find_local(volt_ast_get_child(node, i), name);
+        if (found)
+            return found;
+    }
+    return NULL;
+}
+
+static const char* volt_devirt_receiver_type(volt_devirt_walk_t* walk, volt_token_t* receiver) {
+    bool          is_this = receiver->type == VOLT_TOKEN_TYPE_THIS_KW;
+    volt_vector_t params  = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(walk->function, "params"), "param", &params);
+
+    volt_ast_node_t* declaration = NULL;
+    for (size_t i = 0; i < params.size && !declaration; i++) {
+        volt_ast_node_t* param = volt_vector_get(&params, i);
+        const char*      name  = volt_ast_get_identifier(param);
+        if (is_this ? volt_ast_find_token(param, VOLT_TOKEN_TYPE_THIS_KW) != NULL
+                    : name && strcmp(name, receiver->lexeme) == 0)
+            declaration = param;
+    }
+    volt_vector_deinit(&params);
+
+    if (!declaration && !is_this)
+        declaration = volt_devirt_find_local(volt_ast_body(walk->function), receiver->lexeme);
+
+    volt_ast_node_t* type = volt_ast_find_child(declaration, "type");
+    if (type)
+        return volt_devirt_type_name(walk, type);
+    // `this` in an attach block is the implementing type
+    return is_this && walk->impl ? walk->impl->type : NULL;
+}
+
+// Vtable slots are per instantiated method: `malloc<i32>` and `malloc<u8>` are separate entries
+static size_t volt_devirt_slot(volt_devirt_walk_t* walk, volt_trait_t* trait, const char* method,
+                               volt_ast_node_t* call) {
+    char   signature[256];
+    size_t length = (size_t) snprintf(signature, sizeof(signature), "%s", method);
+
+    volt_vector_t args = volt_vector_default();
+    volt_ast_collect_list(
+        volt_ast_find_child(volt_ast_find_child(call, "generic_args"), "type_list"),
+        "tuple_field", &args);
+    for (size_t i = 0; i < args.size && length < sizeof(signature); i++) {
+        volt_ast_node_t* type     = volt_ast_find_child(volt_vector_get(&args, i), "type");
+        const char*      name     = volt_devirt_type_name(walk, type);
+        volt_token_t*    token    = volt_ast_first_token(type);
+        volt_ast_node_t* suffixes = volt_ast_find_child(type, "type_suffixes");
+        length += (size_t) snprintf(signature + length, sizeof(signature) - length, "%s%s",
+                                    i == 0 ? "<" : ", ",
+                                    name ? name : (token ? token->lexeme : "?"));
+
+        // `*`, `?` and `&` suffixes are single tokens
+        volt_vector_t list = volt_vector_default();
+        volt_ast_collect_list(suffixes, "type_suffix", &list);
+        for (size_t j = 0; j < list.size && length < sizeof(signature); j++) {
+            volt_token_t* suffix = volt_ast_first_token(volt_vector_get(&list, j));
+            length += (size_t) snprintf(signature + length, sizeof(signature) - length, "%s",
+                                        suffix ? suffix->lexeme : "");
+        }
+        volt_vector_deinit(&list);
+    }
+    if (args.size > 0 && length < sizeof(signature))
+        snprintf(signature + length, sizeof(signature) - length, ">");
+    volt_vector_deinit(&args);
+
+    for (size_t i = 0; i < trait->slots.size; i++) {
+        if (strcmp(volt_vector_get(&trait->slots, i), signature) == 0)
+            return i;
+    }
+
+    size_t size  = strlen(signature) + 1;
+    char*  owned = walk->analyzer->allocator->malloc(size);
+    if (owned) {
+        memcpy(owned, signature, size);
+        volt_vector_push_back(&trait->slots, owned);
+    }
+    return trait->slots.size - 1;
+}
+
+static void volt_devirt_record(volt_devirt_walk_t* walk, volt_dispatch_kind_t kind,
+                               volt_ast_node_t* node, const char* method, volt_trait_t* trait,
+                               volt_trait_impl_t* impl, volt_ast_node_t* call) {
+    volt_semantic_analyzer_t* analyzer = walk->analyzer;
+    volt_dispatch_t*          dispatch = analyzer->allocator->malloc(sizeof(volt_dispatch_t));
+    if (!dispatch)
+        return;
+
+    memset(dispatch, 0, sizeof(volt_dispatch_t));
+    dispatch->kind       = kind;
+    dispatch->node       = node;
+    dispatch->caller     = walk->caller;
+    dispatch->owner      = walk->impl ? walk->impl->type : NULL;
+    dispatch->file_index = walk->file_index;
+    dispatch->method     = method;
+    dispatch->trait      = trait;
+    dispatch->impl       = impl;
+    if (kind == VOLT_DISPATCH_DIRECT)
+        dispatch->target = volt_devirt_impl_method(impl, method);
+    else if (kind == VOLT_DISPATCH_VIRTUAL)
+        dispatch->slot = volt_devirt_slot(walk, trait, method, call);
+
+    volt_vector_push_back(&analyzer->dispatches, dispatch);
+}
+
+// COLLECTION
+
+static volt_trait_t* volt_devirt_add_trait(volt_semantic_analyzer_t* analyzer,
+                                           volt_ast_node_t* node, size_t file_index) {
+    volt_trait_t* trait = analyzer->allocator->malloc(sizeof(volt_trait_t));
+    if (!trait)
+        return NULL;
+
+    memset(trait, 0, sizeof(volt_trait_t));
+    trait->name        = volt_ast_get_identifier(node);
+    trait->declaration = node;
+    trait->file_index  = file_index;
+
+    trait->methods.allocator = analyzer->allocator;
+    trait->impls.allocator   = analyzer->allocator;
+    trait->slots.allocator      = analyzer->allocator;
+    trait->slots.item_allocator = analyzer->allocator;
+    volt_vector_init(&trait->methods);
+    volt_vector_init(&trait->impls);
+    volt_vector_init(&trait->slots);
+
+    volt_vector_t items = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(node, "trait_items"), "trait_item", &items);
+    for (size_t i = 0; i < items.size; i++) {
+        const char* method = volt_ast_get_identifier(volt_vector_get(&items, i));
+        if (method)
+            volt_vector_push_back(&trait->methods, (void*) method);
+    }
+    volt_vector_deinit(&items);
+
+    volt_vector_push_back(&analyzer->traits, trait);
+    return trait;
+}
+
+static void volt_devirt_add_impl(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* node,
+                                 size_t file_index) {
+    volt_trait_t* trait =
+        volt_devirt_find_trait(analyzer, volt_devirt_path_last(volt_ast_find_child(node, "path")));
+    if (!trait)
+        return;
+
+    volt_trait_impl_t* impl = analyzer->allocator->malloc(sizeof(volt_trait_impl_t));
+    if (!impl)
+        return;
+
+    // `<T: type> attach t -> T` covers every type: its target stays NULL
+    volt_devirt_walk_t walk = {.analyzer = analyzer,
+                               .generics = volt_ast_find_child(node, "generics")};
+    memset(impl, 0, sizeof(volt_trait_impl_t));
+    impl->trait       = trait;
+    impl->type        = volt_devirt_type_name(&walk, volt_ast_find_child(node, "type"));
+    impl->declaration = node;
+    impl->file_index  = file_index;
+
+    impl->methods.allocator = analyzer->allocator;
+    volt_vector_init(&impl->methods);
+
+    // Methods are not in any scope, but dead code elimination tracks them like functions
+    volt_vector_t items = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(node, "items"), "item", &items);
+    for (size_t i = 0; i < items.size; i++) {
+        volt_ast_node_t* function = volt_ast_find_child(volt_vector_get(&items, i), "func_def");
+        const char*      name     = volt_ast_get_identifier(function);
+        if (!name)
+            continue;
+
+        volt_symbol_t* method = volt_symbol_create(analyzer, VOLT_SYMBOL_FUNCTION);
+        if (!method)
+            continue;
+        method->name        = name;
+        method->declaration = function;
+        method->file_index  = file_index;
+        volt_vector_push_back(&impl->methods, method);
+    }
+    volt_vector_deinit(&items);
+
+    volt_vector_push_back(&trait->impls, impl);
+}
+
+// Attach blocks met while collecting, added once every trait is known
+typedef struct volt_devirt_pending_t volt_devirt_pending_t;
+struct volt_devirt_pending_t {
+    volt_ast_node_t* node;
+    size_t           file_index;
+};
+
+VOLT_VECTOR_DEFINE(devirt_pending, volt_devirt_pending_t)
+
+// Traits and attach blocks are found anywhere among the items, namespaces included, in a single
+// walk. Attach blocks are deferred so one may precede its trait, even in another file.
+static void volt_devirt_collect(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* node,
+                                size_t file_index, volt_devirt_pending_vector_t* impls) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    if (volt_ast_is(node, "trait_decl")) {
+        volt_devirt_add_trait(analyzer, node, file_index);
+        return;
+    }
+    if (volt_ast_is(node, "attach_decl")) {
+        volt_devirt_pending_vector_push_back(impls,
+                                             (volt_devirt_pending_t) {node, file_index});
+        return;
+    }
+
+    if (volt_ast_is(node, "unit") || volt_ast_is(node, "items") ||
+        volt_ast_is(node, "items_rest") || volt_ast_is(node, "item") ||
+        volt_ast_is(node, "namespace_decl")) {
+        for (size_t i = 0; i < node->children.size; i++)
+            volt_devirt_collect(analyzer, volt_ast_get_child(node, i), file_index, impls);
+    }
+}
+
+// RESOLUTION
+
+static volt_trait_impl_t* volt_devirt_find_impl(volt_semantic_analyzer_t* analyzer,
+                                                const char* type, const char* method) {
+    volt_trait_impl_t* blanket = NULL;
+    for (size_t i = 0; i < analyzer->traits.size; i++) {
+        volt_trait_t* trait = volt_vector_get(&analyzer->traits, i);
+        if (!volt_devirt_declares(trait, method))
+            continue;
+
+        for (size_t j = 0; j < trait->impls.size; j++) {
+            volt_trait_impl_t* impl = volt_vector_get(&trait->impls, j);
+            if (!volt_devirt_impl_method(impl, method))
+                continue;
+            if (impl->type && volt_devirt_same_type(impl->type, type))
+                return impl;
+            if (!impl->type && !blanket)
+                blanket = impl;
+        }
+    }
+    return blanket;
+}
+
+static volt_trait_t* volt_devirt_declaring_trait(volt_semantic_analyzer_t* analyzer,
+                                                 const char*               method) {
+    for (size_t i = 0; i < analyzer->traits.size; i++) {
+        volt_trait_t* trait = volt_vector_get(&analyzer->traits, i);
+        if (volt_devirt_declares(trait, method))
+            return trait;
+    }
+    return NULL;
+}
+
+// `receiver.method(...)` and `receiver.method<...>(...)`, receiver being a name or `this`
+static void volt_devirt_call(volt_devirt_walk_t* walk, volt_ast_node_t* node) {
+    volt_ast_node_t* primary = volt_ast_get_child(node, 0);
+    volt_ast_node_t* rest    = volt_ast_get_child(node, 1);
+    volt_ast_node_t* access  = volt_ast_find_child(volt_ast_get_child(rest, 0), "member_access");
+    volt_ast_node_t* call    = volt_ast_find_child(
+        volt_ast_get_child(volt_ast_find_child(rest, "postfix_expr_rest"), 0), "call");
+    if (!volt_ast_is(primary, "primary_expr") || primary->children.size != 1 || !call ||
+        !volt_ast_find_token(access, VOLT_TOKEN_TYPE_DOT))
+        return;
+
+    volt_token_t* receiver = volt_ast_first_token(primary);
+    const char*   method   = volt_ast_get_identifier(access);
+    if (!receiver || !method ||
+        (receiver->type != VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL &&
+         receiver->type != VOLT_TOKEN_TYPE_THIS_KW))
+        return;
+
+    // Calls of anything no trait declares are plain method calls
+    volt_semantic_analyzer_t* analyzer = walk->analyzer;
+    volt_trait_t*             declarer = volt_devirt_declaring_trait(analyzer, method);
+    if (!declarer)
+        return;
+
+    const char* type = volt_devirt_receiver_type(walk, receiver);
+    if (!type) {
+        volt_devirt_record(walk, VOLT_DISPATCH_UNRESOLVED, node, method, declarer, NULL, call);
+        return;
+    }
+
+    volt_trait_t* object = volt_devirt_find_trait(analyzer, type);
+    if (object) {
+        if (volt_devirt_declares(object, method))
+            volt_devirt_record(walk, VOLT_DISPATCH_VIRTUAL, node, method, object, NULL, call);
+        return;
+    }
+
+    volt_trait_impl_t* impl = volt_devirt_find_impl(analyzer, type, method);
+    if (impl)
+        volt_devirt_record(walk, VOLT_DISPATCH_DIRECT, node, method, impl->trait, impl, call);
+}
+
+static void volt_devirt_walk(volt_devirt_walk_t* walk, volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    if (volt_ast_is(node, "postfix_expr"))
+        volt_devirt_call(walk, node);
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_devirt_walk(walk, volt_ast_get_child(node, i));
+}
+
+volt_status_code_t volt_devirt_resolve_all(volt_semantic_analyzer_t* analyzer) {
+    if (!analyzer)
+        return VOLT_FAILURE;
+
+    volt_devirt_pending_vector_t impls = {.allocator = analyzer->allocator};
+    volt_devirt_pending_vector_init(&impls);
+    for (size_t i = 0; i < analyzer->ast_count; i++)
+        volt_devirt_collect(analyzer, analyzer->asts[i], i, &impls);
+    for (size_t i = 0; i < impls.size; i++)
+        volt_devirt_add_impl(analyzer, impls.data[i].node, impls.data[i].file_index);
+    volt_devirt_pending_vector_deinit(&impls);
+
+    // Non-generic functions, attached ones included
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_FUNCTION || symbol->is_generic ||
+            !volt_semantic_checks(analyzer, symbol->declaration))
+            continue;
+
+        volt_devirt_walk_t walk = {.analyzer   = analyzer,
+                                   .function   = symbol->declaration,
+                                   .caller     = symbol->name,
+                                   .file_index = symbol->file_index};
+        volt_devirt_walk(&walk, volt_ast_body(symbol->declaration));
+    }
+
+    // Methods of attach blocks; generic blocks are walked once with their parameters unbound
+    for (size_t i = 0; i < analyzer->traits.size; i++) {
+        volt_trait_t* trait = volt_vector_get(&analyzer->traits, i);
+        for (size_t j = 0; j < trait->impls.size; j++) {
+            volt_trait_impl_t* impl = volt_vector_get(&trait->impls, j);
+            if (!volt_semantic_checks(analyzer, impl->declaration))
+                continue;
+            for (size_t k = 0; k < impl->methods.size; k++) {
+                volt_symbol_t*     method = volt_vector_get(&impl->methods, k);
+                volt_devirt_walk_t walk   = {
+                      .analyzer   = analyzer,
+                      .function   = method->declaration,
+                      .generics   = volt_ast_find_child(impl->declaration, "generics"),
+                      .impl       = impl,
+                      .caller     = method->name,
+                      .file_index = impl->file_index};
+                volt_devirt_walk(&walk, volt_ast_body(method->declaration));
+            }
+        }
+    }
+
+    // Generic functions once per instance, where their parameters have concrete bindings
+    volt_instance_cache_t* cache = &analyzer->instances;
+    for (size_t i = 0; i < cache->instances.size; i++) {
+        volt_instance_t* instance = volt_vector_get(&cache->instances, i);
+        if (instance->generic->kind != VOLT_SYMBOL_FUNCTION)
+            continue;
+
+        volt_ast_node_t*   declaration = instance->generic->declaration;
+        volt_devirt_walk_t walk        = {.analyzer      = analyzer,
+                                          .function      = declaration,
+                                          .bindings      = instance->bindings,
+                                          .binding_count = instance->arg_count,
+                                          .caller        = instance->name,
+                                          .file_index    = instance->generic->file_index};
+        volt_devirt_walk(&walk, volt_ast_body(declaration));
+    }
+
+    return VOLT_SUCCESS;
+}
+
+void volt_devirt_destroy_trait(volt_semantic_analyzer_t* analyzer, volt_trait_t* trait) {
+    if (!trait)
+        return;
+
+    for (size_t i = 0; i < trait->impls.size; i++) {
+        volt_trait_impl_t* impl = volt_vector_get(&trait->impls, i);
+        volt_vector_deinit(&impl->methods);
+        analyzer->allocator->free(impl);
+    }
+    volt_vector_deinit(&trait->methods);
+    volt_vector_deinit(&trait->impls);
+    volt_vector_deinit(&trait->slots);
+    analyzer->allocator->free(trait);
+}
+
+void volt_devirt_destroy_dispatch(volt_semantic_analyzer_t* analyzer, volt_dispatch_t* dispatch) {
+    if (dispatch)
+        analyzer->allocator->free(dispatch);
+}
+
+// REPORT
+
+void volt_devirt_print(volt_semantic_analyzer_t* analyzer) {
+    printf("== devirtualization ==\n");
+
+    size_t counts[3] = {0};
+    for (size_t i = 0; i < analyzer->dispatches.size; i++) {
+        volt_dispatch_t* dispatch = volt_vector_get(&analyzer->dispatches, i);
+        volt_token_t*    token    = volt_ast_first_token(dispatch->node);
+        counts[dispatch->kind]++;
+
+        printf("%s:%zu (%s%s%s): %s.%s", analyzer->input_stream_names[dispatch->file_index],
+               token ? token->line : 0, dispatch->owner ? dispatch->owner : "",
+               dispatch->owner ? "::" : "", dispatch->caller, token ? token->lexeme : "?",
+               dispatch->method);
+        switch (dispatch->kind) {
+            case VOLT_DISPATCH_DIRECT:
+                printf(", direct call to %s::%s (%s)\n",
+                       dispatch->impl->type ? dispatch->impl->type : "<any>", dispatch->method,
+                       dispatch->trait->name);
+                break;
+            case VOLT_DISPATCH_VIRTUAL:
+                printf(", through %s vtable slot %zu (%s)\n", dispatch->trait->name,
+                       dispatch->slot,
+                       (const char*) volt_vector_get(&dispatch->trait->slots, dispatch->slot));
+                break;
+            case VOLT_DISPATCH_UNRESOLVED:
+                printf(", receiver type unknown (%s)\n", dispatch->trait->name);
+                break;
+        }
+    }
+
+    for (size_t i = 0; i < analyzer->traits.size; i++) {
+        volt_trait_t* trait = volt_vector_get(&analyzer->traits, i);
+        if (trait->slots.size == 0)
+            continue;
+
+        printf("vtable %s: %zu slot(s), %zu bytes, one per implementation (%zu):",
+               trait->name, trait->slots.size, trait->slots.size * VOLT_LAYOUT_POINTER_SIZE,
+               trait->impls.size);
+        for (size_t j = 0; j < trait->slots.size; j++)
+            printf(" %s", (const char*) volt_vector_get(&trait->slots, j));
+        printf("\n");
+    }
+
+    printf("%zu devirtualized, %zu dynamic", counts[VOLT_DISPATCH_DIRECT],
+           counts[VOLT_DISPATCH_VIRTUAL]);
+    if (counts[VOLT_DISPATCH_UNRESOLVED])
+        printf(", %zu unresolved", counts[VOLT_DISPATCH_UNRESOLVED]);
+    printf("\n");
+}
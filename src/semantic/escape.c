@@ -0,0 +1,276 @@
+#include <pch.h>
+#include <semantic/escape.h>
+
+// How a value is used by the node around it
+typedef enum {
+    VOLT_ESCAPE_USE_DISCARDED,
+    VOLT_ESCAPE_USE_CALLED,
+    VOLT_ESCAPE_USE_BOUND,  // Initializer of a `val` / `var`
+    VOLT_ESCAPE_USE_RETURNED,
+    VOLT_ESCAPE_USE_PASSED,
+    VOLT_ESCAPE_USE_STORED,
+} volt_escape_use_t;
+
+typedef struct volt_escape_walk_t volt_escape_walk_t;
+struct volt_escape_walk_t {
+    volt_semantic_analyzer_t* analyzer;
+    volt_symbol_t*            function;
+    volt_vector_t             ancestors;  // From the function body down to the current node
+    size_t                    first;      // First closure of this function in analyzer->closures
+
+    volt_closure_t* closure;  // Whose uses are being counted, during the second walk
+};
+
+// HELPER FUNCTIONS
+
+// Classifies the use of the top of `ancestors`, climbing past the precedence wrappers and
+// parentheses around it
+static volt_escape_use_t volt_escape_classify(volt_vector_t* ancestors, volt_ast_node_t** site) {
+    size_t           index = ancestors->size - 1;
+    volt_ast_node_t* value = volt_vector_get(ancestors, index);
+    while (index > 0) {
+        volt_ast_node_t* above = volt_vector_get(ancestors, index - 1);
+        if (volt_ast_is(above, "paren_expr"))
+            value = above;
+        else if (volt_ast_unwrap(above) != value)
+            break;
+        index--;
+    }
+
+    volt_ast_node_t* outer  = volt_vector_get(ancestors, index);
+    volt_ast_node_t* parent = index > 0 ? volt_vector_get(ancestors, index - 1) : NULL;
+    *site                   = parent ? parent : outer;
+
+    if (!parent || volt_ast_is(parent, "expr_stmt"))
+        return VOLT_ESCAPE_USE_DISCARDED;
+    if (volt_ast_is(parent, "val_decl") || volt_ast_is(parent, "var_decl"))
+        return VOLT_ESCAPE_USE_BOUND;
+    if (volt_ast_is(parent, "return_stmt"))
+        return VOLT_ESCAPE_USE_RETURNED;
+    // A lone argument unwraps through `args` up to the call itself
+    if (volt_ast_is(parent, "call") || volt_ast_is(parent, "args") ||
+        volt_ast_is(parent, "args_rest"))
+        return VOLT_ESCAPE_USE_PASSED;
+
+    if (volt_ast_is(parent, "postfix_expr") && volt_ast_get_child(parent, 0) == outer) {
+        volt_ast_node_t* rest = volt_ast_find_child(parent, "postfix_expr_rest");
+        if (volt_ast_find_child(volt_ast_find_child(rest, "postfix_op"), "call"))
+            return VOLT_ESCAPE_USE_CALLED;
+    }
+    return VOLT_ESCAPE_USE_STORED;
+}
+
+static volt_escape_reason_t volt_escape_reason(volt_escape_use_t use) {
+    switch (use) {
+        case VOLT_ESCAPE_USE_RETURNED:
+            return VOLT_ESCAPE_RETURNED;
+        case VOLT_ESCAPE_USE_PASSED:
+            return VOLT_ESCAPE_PASSED;
+        case VOLT_ESCAPE_USE_STORED:
+        case VOLT_ESCAPE_USE_BOUND:  // Aliased into another local
+            return VOLT_ESCAPE_STORED;
+        default:
+            return VOLT_ESCAPE_NONE;
+    }
+}
+
+static void volt_escape_mark(volt_closure_t* closure, volt_escape_reason_t reason,
+                             volt_ast_node_t* site) {
+    if (closure->reason != VOLT_ESCAPE_NONE || reason == VOLT_ESCAPE_NONE)
+        return;
+    closure->reason = reason;
+    closure->escape = site;
+}
+
+static void volt_escape_captures(volt_closure_t* closure) {
+    volt_vector_t captures = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(closure->node, "closure_captures"), "closure_capture",
+                          &captures);
+    closure->captures = captures.size;
+    for (size_t i = 0; i < captures.size; i++) {
+        if (volt_ast_find_token(volt_vector_get(&captures, i), VOLT_TOKEN_TYPE_STAR))
+            closure->by_reference++;
+    }
+    volt_vector_deinit(&captures);
+}
+
+static void volt_escape_found(volt_escape_walk_t* walk, volt_ast_node_t* node) {
+    volt_semantic_analyzer_t* analyzer = walk->analyzer;
+    volt_closure_t*           closure  = analyzer->allocator->malloc(sizeof(volt_closure_t));
+    if (!closure)
+        return;
+
+    memset(closure, 0, sizeof(volt_closure_t));
+    closure->node     = node;
+    closure->function = walk->function;
+    volt_escape_captures(closure);
+
+    volt_ast_node_t*  site;
+    volt_escape_use_t use = volt_escape_classify(&walk->ancestors, &site);
+    if (use == VOLT_ESCAPE_USE_BOUND)
+        closure->binding = volt_ast_get_identifier(site);
+    else if (use == VOLT_ESCAPE_USE_CALLED)
+        closure->direct_calls++;
+    else
+        volt_escape_mark(closure, volt_escape_reason(use), site);
+
+    volt_vector_push_back(&analyzer->closures, closure);
+}
+
+// First walk: every closure and the context it is created in
+static void volt_escape_collect(volt_escape_walk_t* walk, volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    volt_vector_push_back(&walk->ancestors, node);
+    if (volt_ast_is(node, "closure"))
+        volt_escape_found(walk, node);
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_escape_collect(walk, volt_ast_get_child(node, i));
+    volt_vector_pop_back(&walk->ancestors);
+}
+
+// Second walk: every use of a bound closure's name. Shadowing locals are not told apart, which
+// only ever makes the answer more conservative.
+static void volt_escape_uses(volt_escape_walk_t* walk, volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    volt_closure_t* closure = walk->closure;
+    volt_vector_push_back(&walk->ancestors, node);
+
+    if (volt_ast_is(node, "primary_expr") && node->children.size == 1) {
+        volt_token_t* token = volt_ast_find_token(node, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+        if (token && strcmp(token->lexeme, closure->binding) == 0) {
+            volt_ast_node_t*  site;
+            volt_escape_use_t use = volt_escape_classify(&walk->ancestors, &site);
+            if (use == VOLT_ESCAPE_USE_CALLED)
+                closure->direct_calls++;
+            else
+                volt_escape_mark(closure, volt_escape_reason(use), site);
+        }
+    }
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_escape_uses(walk, volt_ast_get_child(node, i));
+    volt_vector_pop_back(&walk->ancestors);
+}
+
+// Whether `closure` names `binding` in its capture list
+static bool volt_escape_captures_name(volt_closure_t* closure, const char* binding) {
+    volt_vector_t captures = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(closure->node, "closure_captures"), "closure_capture",
+                          &captures);
+
+    bool found = false;
+    for (size_t i = 0; i < captures.size && !found; i++) {
+        const char* name = volt_ast_get_identifier(volt_vector_get(&captures, i));
+        found            = name && strcmp(name, binding) == 0;
+    }
+    volt_vector_deinit(&captures);
+    return found;
+}
+
+// A closure captured by an escaping closure escapes with it; repeats until nothing changes
+static void volt_escape_propagate(volt_semantic_analyzer_t* analyzer, size_t first) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = first; i < analyzer->closures.size; i++) {
+            volt_closure_t* captured = volt_vector_get(&analyzer->closures, i);
+            if (!captured->binding || captured->reason != VOLT_ESCAPE_NONE)
+                continue;
+
+            for (size_t j = first; j < analyzer->closures.size; j++) {
+                volt_closure_t* holder = volt_vector_get(&analyzer->closures, j);
+                if (holder != captured && holder->reason != VOLT_ESCAPE_NONE &&
+                    volt_escape_captures_name(holder, captured->binding)) {
+                    volt_escape_mark(captured, VOLT_ESCAPE_CAPTURED, holder->node);
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static const char* volt_escape_reason_name(volt_escape_reason_t reason) {
+    switch (reason) {
+        case VOLT_ESCAPE_RETURNED:
+            return "returned";
+        case VOLT_ESCAPE_PASSED:
+            return "passed to a call";
+        case VOLT_ESCAPE_STORED:
+            return "stored";
+        case VOLT_ESCAPE_CAPTURED:
+            return "captured by an escaping closure";
+        default:
+            return "does not escape";
+    }
+}
+
+// ANALYSIS
+
+volt_status_code_t volt_escape_analyze_all(volt_semantic_analyzer_t* analyzer) {
+    if (!analyzer)
+        return VOLT_FAILURE;
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_FUNCTION ||
+            !volt_semantic_checks(analyzer, symbol->declaration))
+            continue;
+
+        volt_escape_walk_t walk = {0};
+        walk.analyzer           = analyzer;
+        walk.function           = symbol;
+        walk.first              = analyzer->closures.size;
+        walk.ancestors          = volt_vector_default();
+
+        volt_ast_node_t* body = volt_ast_body(symbol->declaration);
+        volt_escape_collect(&walk, body);
+
+        for (size_t j = walk.first; j < analyzer->closures.size; j++) {
+            walk.closure = volt_vector_get(&analyzer->closures, j);
+            if (walk.closure->binding)
+                volt_escape_uses(&walk, body);
+        }
+        volt_escape_propagate(analyzer, walk.first);
+        volt_vector_deinit(&walk.ancestors);
+    }
+
+    return VOLT_SUCCESS;
+}
+
+void volt_escape_destroy(volt_semantic_analyzer_t* analyzer, volt_closure_t* closure) {
+    if (closure)
+        analyzer->allocator->free(closure);
+}
+
+// REPORT
+
+void volt_escape_print(volt_semantic_analyzer_t* analyzer) {
+    printf("== escapes ==\n");
+
+    for (size_t i = 0; i < analyzer->closures.size; i++) {
+        volt_closure_t* closure = volt_vector_get(&analyzer->closures, i);
+        volt_token_t*   token   = volt_ast_first_token(closure->node);
+        printf("%s:%zu (%s): closure", analyzer->input_stream_names[closure->function->file_index],
+               token ? token->line : 0, closure->function->name);
+        if (closure->binding)
+            printf(" `%s`", closure->binding);
+
+        if (closure->reason == VOLT_ESCAPE_NONE) {
+            printf(", stack environment, %zu direct call(s)\n", closure->direct_calls);
+            continue;
+        }
+
+        volt_token_t* site = volt_ast_first_token(closure->escape);
+        printf(", escapes (%s on line %zu), heap environment through the allocator",
+               volt_escape_reason_name(closure->reason), site ? site->line : 0);
+        if (closure->by_reference)
+            printf(", %zu by-reference capture(s) outlive the frame", closure->by_reference);
+        printf("\n");
+    }
+}
@@ -0,0 +1,151 @@
+#include <pch.h>
+#include <semantic/fallible.h>
+#include <semantic/layout.h>
+
+// HELPER FUNCTIONS
+
+// `error!T` and `some_error!T` derive an error type around their payload; error set
+// declarations have a declaration instead
+static bool volt_fallible_is_union(volt_type_info_t* type) {
+    return type && type->kind == VOLT_TYPE_ERROR && !type->declaration;
+}
+
+static volt_fallible_convention_t volt_fallible_convention(volt_type_info_t* result) {
+    volt_type_info_t* payload = result->base_type;
+    if (!payload || payload->kind == VOLT_TYPE_VOID || payload->size == 0)
+        return VOLT_FALLIBLE_CODE_ONLY;
+    return payload->size <= VOLT_LAYOUT_POINTER_SIZE ? VOLT_FALLIBLE_REGISTERS
+                                                     : VOLT_FALLIBLE_OUT_PAYLOAD;
+}
+
+static void volt_fallible_add_site(volt_semantic_analyzer_t* analyzer, volt_fallible_t* fallible,
+                                   volt_fallible_site_kind_t kind, volt_ast_node_t* node) {
+    volt_fallible_site_t* site = analyzer->allocator->malloc(sizeof(volt_fallible_site_t));
+    if (!site)
+        return;
+
+    site->kind    = kind;
+    site->node    = node;
+    site->handler = kind == VOLT_FALLIBLE_CATCH ? volt_ast_find_child(node, "block") : NULL;
+
+    volt_token_t* binding = kind == VOLT_FALLIBLE_CATCH
+                                ? volt_ast_find_token(node, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL)
+                                : NULL;
+    site->binding         = binding ? binding->lexeme : NULL;
+
+    if (kind == VOLT_FALLIBLE_TRY)
+        fallible->propagations++;
+    volt_vector_push_back(&fallible->sites, site);
+}
+
+static void volt_fallible_walk(volt_semantic_analyzer_t* analyzer, volt_fallible_t* fallible,
+                               volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    // `try_catch` and the postfix `catch_clause` are the two spellings of a handler
+    if (volt_ast_is(node, "unary_expr") && volt_ast_find_token(node, VOLT_TOKEN_TYPE_TRY_KW))
+        volt_fallible_add_site(analyzer, fallible, VOLT_FALLIBLE_TRY, node);
+    else if (volt_ast_is(node, "try_catch") || volt_ast_is(node, "catch_clause"))
+        volt_fallible_add_site(analyzer, fallible, VOLT_FALLIBLE_CATCH, node);
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_fallible_walk(analyzer, fallible, volt_ast_get_child(node, i));
+}
+
+static const char* volt_fallible_convention_name(volt_fallible_convention_t convention) {
+    switch (convention) {
+        case VOLT_FALLIBLE_CODE_ONLY:
+            return "error code in the return register";
+        case VOLT_FALLIBLE_REGISTERS:
+            return "payload and error code in two return registers";
+        default:
+            return "payload through a hidden pointer, error code in the return register";
+    }
+}
+
+// LOWERING
+
+volt_status_code_t volt_fallible_lower_all(volt_semantic_analyzer_t* analyzer) {
+    if (!analyzer)
+        return VOLT_FAILURE;
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_FUNCTION || symbol->is_extern ||
+            !volt_semantic_checks(analyzer, symbol->declaration))
+            continue;
+
+        volt_fallible_t* fallible = analyzer->allocator->malloc(sizeof(volt_fallible_t));
+        if (!fallible)
+            return VOLT_FAILURE;
+
+        memset(fallible, 0, sizeof(volt_fallible_t));
+        fallible->function        = symbol;
+        fallible->sites.allocator = analyzer->allocator;
+        volt_vector_init(&fallible->sites);
+
+        volt_ast_node_t*  result_node = volt_ast_find_child(symbol->declaration, "type");
+        volt_type_info_t* result = result_node ? volt_type_from_ast(analyzer, result_node) : NULL;
+        if (volt_fallible_is_union(result)) {
+            volt_layout_compute(analyzer, result);
+            fallible->result     = result;
+            fallible->convention = volt_fallible_convention(result);
+        }
+
+        volt_fallible_walk(analyzer, fallible, volt_ast_body(symbol->declaration));
+
+        if (!fallible->result && fallible->sites.size == 0)
+            volt_fallible_destroy(analyzer, fallible);
+        else
+            volt_vector_push_back(&analyzer->fallibles, fallible);
+    }
+
+    return VOLT_SUCCESS;
+}
+
+void volt_fallible_destroy(volt_semantic_analyzer_t* analyzer, volt_fallible_t* fallible) {
+    if (!fallible)
+        return;
+
+    for (size_t i = 0; i < fallible->sites.size; i++)
+        analyzer->allocator->free(volt_vector_get(&fallible->sites, i));
+    volt_vector_deinit(&fallible->sites);
+    analyzer->allocator->free(fallible);
+}
+
+// REPORT
+
+void volt_fallible_print(volt_semantic_analyzer_t* analyzer) {
+    printf("== fallible ==\n");
+
+    for (size_t i = 0; i < analyzer->fallibles.size; i++) {
+        volt_fallible_t* fallible = volt_vector_get(&analyzer->fallibles, i);
+        volt_symbol_t*   function = fallible->function;
+        volt_token_t*    token    = volt_ast_first_token(function->declaration);
+        printf("%s:%zu (%s): ", analyzer->input_stream_names[function->file_index],
+               token ? token->line : 0, function->name);
+
+        if (fallible->result)
+            printf("%s", volt_fallible_convention_name(fallible->convention));
+        else
+            printf("no error union returned");
+        if (fallible->propagations)
+            printf(", %zu propagation(s) into one cold exit", fallible->propagations);
+        printf("\n");
+
+        for (size_t j = 0; j < fallible->sites.size; j++) {
+            volt_fallible_site_t* site  = volt_vector_get(&fallible->sites, j);
+            volt_token_t*         first = volt_ast_first_token(site->node);
+            size_t                line  = first ? first->line : 0;
+            if (site->kind == VOLT_FALLIBLE_TRY)
+                printf("  line %zu: try, error branch weighted %u:%u\n", line,
+                       VOLT_FALLIBLE_COLD_WEIGHT, VOLT_FALLIBLE_HOT_WEIGHT);
+            else if (site->binding)
+                printf("  line %zu: catch |%s|, handler cold\n", line, site->binding);
+            else
+                printf("  line %zu: catch, handler cold\n", line);
+        }
+    }
+}
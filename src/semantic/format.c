@@ -0,0 +1,359 @@
+#include <pch.h>
+#include <semantic/format.h>
+
+// HELPER FUNCTIONS
+
+// `std::io::print(ln)(...)` or `io::print(ln)(...)`: the call node, NULL otherwise
+static volt_ast_node_t* volt_format_match_call(volt_ast_node_t* postfix, bool* newline) {
+    volt_ast_node_t* primary = volt_ast_get_child(postfix, 0);
+    volt_token_t*    root    = volt_ast_find_token(primary, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    if (!root || primary->children.size != 1)
+        return NULL;
+
+    const char* path[3];
+    size_t      length = 0;
+    path[length++]     = root->lexeme;
+
+    volt_ast_node_t* rest = volt_ast_find_child(postfix, "postfix_expr_rest");
+    while (rest && rest->children.size != 0) {
+        volt_ast_node_t* op     = volt_ast_find_child(rest, "postfix_op");
+        volt_ast_node_t* access = volt_ast_find_child(op, "member_access");
+        volt_ast_node_t* call   = volt_ast_find_child(op, "call");
+        volt_ast_node_t* next   = volt_ast_find_child(rest, "postfix_expr_rest");
+
+        if (call) {
+            if (next && next->children.size != 0)
+                return NULL;  // The call's result is used further
+            if (length == 3 && strcmp(path[0], "std") != 0)
+                return NULL;
+            if (length < 2 || strcmp(path[length - 2], "io") != 0)
+                return NULL;
+            if (strcmp(path[length - 1], "println") == 0)
+                *newline = true;
+            else if (strcmp(path[length - 1], "print") == 0)
+                *newline = false;
+            else
+                return NULL;
+            return call;
+        }
+
+        volt_token_t* name = volt_ast_find_token(access, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+        if (!access || !volt_ast_find_token(access, VOLT_TOKEN_TYPE_COLON_COLON) || !name ||
+            length == 3)
+            return NULL;
+        path[length++] = name->lexeme;
+        rest           = next;
+    }
+    return NULL;
+}
+
+static volt_format_write_t volt_format_write_for(volt_type_info_t* type) {
+    if (!type)
+        return VOLT_FORMAT_WRITE_VALUE;
+
+    switch (type->kind) {
+        case VOLT_TYPE_I8:
+        case VOLT_TYPE_I16:
+        case VOLT_TYPE_I32:
+        case VOLT_TYPE_I64:
+        case VOLT_TYPE_I128:
+        case VOLT_TYPE_ISIZE:
+            return VOLT_FORMAT_WRITE_INT;
+        case VOLT_TYPE_U8:
+        case VOLT_TYPE_U16:
+        case VOLT_TYPE_U32:
+        case VOLT_TYPE_U64:
+        case VOLT_TYPE_U128:
+        case VOLT_TYPE_USIZE:
+            return VOLT_FORMAT_WRITE_UINT;
+        case VOLT_TYPE_F16:
+        case VOLT_TYPE_F32:
+        case VOLT_TYPE_F64:
+        case VOLT_TYPE_F128:
+            return VOLT_FORMAT_WRITE_FLOAT;
+        case VOLT_TYPE_BOOL:
+            return VOLT_FORMAT_WRITE_BOOL;
+        case VOLT_TYPE_STR:
+        case VOLT_TYPE_CSTR:
+            return VOLT_FORMAT_WRITE_STR;
+        default:
+            return VOLT_FORMAT_WRITE_VALUE;
+    }
+}
+
+// The `type` of the first `val` / `var` called `name`, if it has one
+static volt_ast_node_t* volt_format_find_local(volt_ast_node_t* node, const char* name) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return NULL;
+
+    if (volt_ast_is(node, "var_decl") || volt_ast_is(node, "val_decl")) {
+        const char* declared = volt_ast_get_identifier(node);
+        if (declared && strcmp(declared, name) == 0)
+            return volt_ast_find_child(node, "type");
+    }
+
+    for (size_t i = 0; i < node->children.size; i++) {
+        volt_ast_node_t* type = volt_format_find_local(volt_ast_get_child(node, i), name);
+        if (type)
+            return type;
+    }
+    return NULL;
+}
+
+// The declared type of a parameter or explicitly typed local called `name`
+static volt_type_info_t* volt_format_type_of(volt_semantic_analyzer_t* analyzer,
+                                             volt_symbol_t* function, const char* name) {
+    for (size_t i = 0; i < function->parameters.size; i++) {
+        volt_symbol_t* param = (volt_symbol_t*) volt_vector_get(&function->parameters, i);
+        if (strcmp(param->name, name) == 0) {
+            if (param->type)
+                return param->type;
+            volt_ast_node_t* type = volt_ast_find_child(param->declaration, "type");
+            return type ? volt_type_from_ast(analyzer, type) : NULL;
+        }
+    }
+
+    volt_ast_node_t* type = volt_format_find_local(volt_ast_body(function->declaration), name);
+    return type ? volt_type_from_ast(analyzer, type) : NULL;
+}
+
+static void volt_format_add_text(volt_semantic_analyzer_t* analyzer, volt_format_t* format,
+                                 const char* text, size_t length) {
+    if (length == 0)
+        return;
+
+    volt_format_piece_t* last = format->pieces.size ? volt_vector_get_back(&format->pieces) : NULL;
+    if (!last || last->write != VOLT_FORMAT_WRITE_TEXT) {
+        last = analyzer->allocator->malloc(sizeof(volt_format_piece_t));
+        if (!last)
+            return;
+        memset(last, 0, sizeof(volt_format_piece_t));
+        last->write = VOLT_FORMAT_WRITE_TEXT;
+        volt_vector_push_back(&format->pieces, last);
+    }
+
+    char* grown = analyzer->allocator->realloc(last->text, last->length + length + 1);
+    if (!grown)
+        return;
+    memcpy(grown + last->length, text, length);
+    last->length += length;
+    grown[last->length] = '\0';
+    last->text          = grown;
+}
+
+// Constants and string literals become text; everything else a writer picked by type
+static void volt_format_add_value(volt_semantic_analyzer_t* analyzer, volt_format_t* format,
+                                  volt_ast_node_t* argument) {
+    volt_ast_node_t* inner = volt_ast_unwrap(argument);
+    volt_token_t*    token = volt_ast_is(inner, "literal") ? volt_ast_first_token(inner) : NULL;
+    if (token && token->type == VOLT_TOKEN_TYPE_STRING_LITERAL) {
+        volt_format_add_text(analyzer, format, token->lexeme, strlen(token->lexeme));
+        return;
+    }
+
+    volt_comptime_value_t constant;
+    if (volt_comptime_eval(&analyzer->comptime, argument, NULL, 0, &constant) == VOLT_SUCCESS) {
+        char   digits[32];
+        size_t length = 0;
+        if (constant.kind == VOLT_COMPTIME_VALUE_INT)
+            length = (size_t) snprintf(digits, sizeof(digits), "%lld", (long long) constant.i);
+        else if (constant.kind == VOLT_COMPTIME_VALUE_BOOL)
+            length = (size_t) snprintf(digits, sizeof(digits), "%s",
+                                       constant.b ? "true" : "false");
+        if (length) {
+            volt_format_add_text(analyzer, format, digits, length);
+            return;
+        }
+    }
+
+    volt_format_piece_t* piece = analyzer->allocator->malloc(sizeof(volt_format_piece_t));
+    if (!piece)
+        return;
+    memset(piece, 0, sizeof(volt_format_piece_t));
+    piece->argument = argument;
+
+    volt_token_t* name = volt_ast_is(inner, "primary_expr") && inner->children.size == 1
+                             ? volt_ast_find_token(inner, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL)
+                             : NULL;
+    if (name)
+        piece->write = volt_format_write_for(
+            volt_format_type_of(analyzer, format->function, name->lexeme));
+    else if (token && token->type == VOLT_TOKEN_TYPE_NUMBER_LITERAL)
+        piece->write = VOLT_FORMAT_WRITE_FLOAT;  // Integers were folded above
+    else
+        piece->write = VOLT_FORMAT_WRITE_VALUE;
+    volt_vector_push_back(&format->pieces, piece);
+}
+
+static bool volt_format_fail(volt_semantic_analyzer_t* analyzer, volt_format_t* format,
+                             const char* message) {
+    analyzer->current_file_index = format->function->file_index;
+    volt_semantic_error(analyzer, format->node, message);
+    return false;
+}
+
+// Splits the literal into text and one value per `{}`; `{{` and `}}` are literal braces
+static bool volt_format_parse(volt_semantic_analyzer_t* analyzer, volt_format_t* format,
+                              const char* literal, volt_vector_t* arguments) {
+    size_t used = 0;
+    for (size_t i = 0; literal[i];) {
+        char c = literal[i];
+        if (c == '{' && literal[i + 1] == '{') {
+            volt_format_add_text(analyzer, format, "{", 1);
+            i += 2;
+        } else if (c == '}' && literal[i + 1] == '}') {
+            volt_format_add_text(analyzer, format, "}", 1);
+            i += 2;
+        } else if (c == '{' && literal[i + 1] == '}') {
+            if (used < arguments->size)
+                volt_format_add_value(analyzer, format, volt_vector_get(arguments, used));
+            used++;
+            i += 2;
+        } else if (c == '{' || c == '}') {
+            return volt_format_fail(analyzer, format,
+                                    c == '{' ? "Format placeholders must be written `{}`"
+                                             : "Unmatched `}` in format string (use `}}`)");
+        } else {
+            size_t run = strcspn(literal + i, "{}");
+            volt_format_add_text(analyzer, format, literal + i, run);
+            i += run;
+        }
+    }
+
+    if (used != arguments->size) {
+        char message[160];
+        snprintf(message, sizeof(message),
+                 "Format string has %zu placeholder(s) but %zu argument(s) were given", used,
+                 arguments->size);
+        return volt_format_fail(analyzer, format, message);
+    }
+    return true;
+}
+
+static void volt_format_expand(volt_semantic_analyzer_t* analyzer, volt_symbol_t* function,
+                               volt_ast_node_t* node) {
+    bool             newline = false;
+    volt_ast_node_t* call    = volt_format_match_call(node, &newline);
+    if (!call)
+        return;
+
+    volt_format_t* format = analyzer->allocator->malloc(sizeof(volt_format_t));
+    if (!format)
+        return;
+
+    memset(format, 0, sizeof(volt_format_t));
+    format->node             = node;
+    format->function         = function;
+    format->newline          = newline;
+    format->pieces.allocator = analyzer->allocator;
+    volt_vector_init(&format->pieces);
+    volt_vector_push_back(&analyzer->formats, format);
+
+    volt_vector_t arguments = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(call, "args"), "expression", &arguments);
+
+    volt_ast_node_t* first   = arguments.size ? volt_vector_get(&arguments, 0) : NULL;
+    volt_ast_node_t* literal = volt_ast_unwrap(first);
+    volt_token_t*    token =
+        volt_ast_is(literal, "literal") ? volt_ast_first_token(literal) : NULL;
+
+    if (token && token->type == VOLT_TOKEN_TYPE_STRING_LITERAL) {
+        volt_vector_remove(&arguments, 0);
+        volt_format_parse(analyzer, format, token->lexeme, &arguments);
+    } else if (arguments.size == 1) {
+        volt_format_add_value(analyzer, format, first);  // `println(value)`
+    } else if (arguments.size > 1) {
+        volt_format_fail(analyzer, format, "Format string must be a string literal");
+    }
+
+    if (newline)
+        volt_format_add_text(analyzer, format, "\n", 1);
+    volt_vector_deinit(&arguments);
+}
+
+static void volt_format_walk(volt_semantic_analyzer_t* analyzer, volt_symbol_t* function,
+                             volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    if (volt_ast_is(node, "postfix_expr"))
+        volt_format_expand(analyzer, function, node);
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_format_walk(analyzer, function, volt_ast_get_child(node, i));
+}
+
+static const char* volt_format_write_name(volt_format_write_t write) {
+    switch (write) {
+        case VOLT_FORMAT_WRITE_TEXT:
+            return "write_bytes";
+        case VOLT_FORMAT_WRITE_INT:
+            return "write_int";
+        case VOLT_FORMAT_WRITE_UINT:
+            return "write_uint";
+        case VOLT_FORMAT_WRITE_FLOAT:
+            return "write_float";
+        case VOLT_FORMAT_WRITE_BOOL:
+            return "write_bool";
+        case VOLT_FORMAT_WRITE_STR:
+            return "write_str";
+        default:
+            return "write_value";
+    }
+}
+
+// EXPANSION
+
+volt_status_code_t volt_format_expand_all(volt_semantic_analyzer_t* analyzer) {
+    if (!analyzer)
+        return VOLT_FAILURE;
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind == VOLT_SYMBOL_FUNCTION &&
+            volt_semantic_checks(analyzer, symbol->declaration))
+            volt_format_walk(analyzer, symbol, volt_ast_body(symbol->declaration));
+    }
+
+    return VOLT_SUCCESS;
+}
+
+void volt_format_destroy(volt_semantic_analyzer_t* analyzer, volt_format_t* format) {
+    if (!format)
+        return;
+
+    for (size_t i = 0; i < format->pieces.size; i++) {
+        volt_format_piece_t* piece = volt_vector_get(&format->pieces, i);
+        if (piece->text)
+            analyzer->allocator->free(piece->text);
+        analyzer->allocator->free(piece);
+    }
+    volt_vector_deinit(&format->pieces);
+    analyzer->allocator->free(format);
+}
+
+// REPORT
+
+void volt_format_print(volt_semantic_analyzer_t* analyzer) {
+    printf("== formats ==\n");
+
+    for (size_t i = 0; i < analyzer->formats.size; i++) {
+        volt_format_t* format = volt_vector_get(&analyzer->formats, i);
+        volt_token_t*  token  = volt_ast_first_token(format->node);
+        printf("%s:%zu (%s):", analyzer->input_stream_names[format->function->file_index],
+               token ? token->line : 0, format->function->name);
+
+        for (size_t j = 0; j < format->pieces.size; j++) {
+            volt_format_piece_t* piece = volt_vector_get(&format->pieces, j);
+            printf("%s %s", j ? "," : "", volt_format_write_name(piece->write));
+            if (piece->write == VOLT_FORMAT_WRITE_TEXT) {
+                printf("(%zu)", piece->length);
+            } else {
+                volt_token_t* first = volt_ast_first_token(piece->argument);
+                printf("(%s)", first ? first->lexeme : "...");
+            }
+        }
+        printf("\n");
+    }
+}
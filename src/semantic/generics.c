@@ -0,0 +1,628 @@
+#include <pch.h>
+#include <semantic/analyzer.h>
+#include <semantic/generics.h>
+
+#define INSTANCE_CACHE_INITIAL_CAPACITY 64
+
+// CACHE
+
+volt_status_code_t volt_instance_cache_init(volt_instance_cache_t* cache,
+                                            volt_allocator_t*      allocator) {
+    if (!cache)
+        return VOLT_FAILURE;
+
+    memset(cache, 0, sizeof(volt_instance_cache_t));
+    cache->allocator = allocator ? allocator : &volt_default_allocator;
+    cache->capacity  = INSTANCE_CACHE_INITIAL_CAPACITY;
+    cache->slots     = cache->allocator->malloc(cache->capacity * sizeof(volt_instance_t*));
+    if (!cache->slots)
+        return VOLT_FAILURE;
+    memset(cache->slots, 0, cache->capacity * sizeof(volt_instance_t*));
+
+    volt_vector_t instances = {0};
+    instances.allocator     = cache->allocator;
+    if (volt_vector_init(&instances) != VOLT_SUCCESS)
+        return VOLT_FAILURE;
+
+    cache->instances = instances;
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_instance_cache_deinit(volt_instance_cache_t* cache) {
+    if (!cache || !cache->allocator)
+        return VOLT_FAILURE;
+
+    for (size_t i = 0; i < cache->instances.size; i++) {
+        volt_instance_t* instance = (volt_instance_t*) volt_vector_get(&cache->instances, i);
+        if (instance->instances.allocator)
+            volt_vector_deinit(&instance->instances);
+        cache->allocator->free(instance->bindings);
+        cache->allocator->free((char*) instance->name);
+        cache->allocator->free(instance);
+    }
+
+    volt_vector_deinit(&cache->instances);
+    cache->allocator->free(cache->slots);
+    cache->slots    = NULL;
+    cache->capacity = 0;
+    return VOLT_SUCCESS;
+}
+
+static uint64_t volt_instance_hash(volt_symbol_t* generic, const volt_comptime_binding_t* args,
+                                   size_t count) {
+    uint64_t hash = (uint64_t) (uintptr_t) generic * 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < count; i++)
+        hash = (hash ^ volt_comptime_value_hash(&args[i].value)) * 0x100000001B3ull;
+    return hash ^ (hash >> 29);
+}
+
+static bool volt_instance_matches(volt_instance_t* instance, volt_symbol_t* generic,
+                                  const volt_comptime_binding_t* args, size_t count,
+                                  uint64_t hash) {
+    if (instance->hash != hash || instance->generic != generic || instance->arg_count != count)
+        return false;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!volt_comptime_value_equals(&instance->bindings[i].value, &args[i].value))
+            return false;
+    }
+    return true;
+}
+
+static volt_instance_t* volt_instance_cache_find(volt_instance_cache_t* cache,
+                                                 volt_symbol_t*         generic,
+                                                 const volt_comptime_binding_t* args,
+                                                 size_t count, uint64_t hash) {
+    size_t mask = cache->capacity - 1;
+    for (size_t i = (size_t) hash & mask;; i = (i + 1) & mask) {
+        volt_instance_t* instance = cache->slots[i];
+        if (!instance)
+            return NULL;
+        if (volt_instance_matches(instance, generic, args, count, hash))
+            return instance;
+    }
+}
+
+static volt_status_code_t volt_instance_cache_insert(volt_instance_cache_t* cache,
+                                                     volt_instance_t*       instance) {
+    // Keep the load factor under 3/4 so probes stay short
+    if ((cache->instances.size + 1) * 4 > cache->capacity * 3) {
+        size_t            new_capacity = cache->capacity * 2;
+        volt_instance_t** new_slots =
+            cache->allocator->malloc(new_capacity * sizeof(volt_instance_t*));
+        if (!new_slots)
+            return VOLT_FAILURE;
+        memset(new_slots, 0, new_capacity * sizeof(volt_instance_t*));
+
+        for (size_t i = 0; i < cache->capacity; i++) {
+            volt_instance_t* moved = cache->slots[i];
+            if (!moved)
+                continue;
+            size_t j = (size_t) moved->hash & (new_capacity - 1);
+            while (new_slots[j])
+                j = (j + 1) & (new_capacity - 1);
+            new_slots[j] = moved;
+        }
+
+        cache->allocator->free(cache->slots);
+        cache->slots    = new_slots;
+        cache->capacity = new_capacity;
+    }
+
+    // Own the instance before publishing it, so a failed insert leaves no slot pointing at it
+    if (volt_vector_push_back(&cache->instances, instance) != VOLT_SUCCESS)
+        return VOLT_FAILURE;
+
+    size_t mask = cache->capacity - 1;
+    size_t i    = (size_t) instance->hash & mask;
+    while (cache->slots[i])
+        i = (i + 1) & mask;
+    cache->slots[i] = instance;
+    return VOLT_SUCCESS;
+}
+
+// NAMES
+
+typedef struct volt_name_builder_t volt_name_builder_t;
+struct volt_name_builder_t {
+    char*             data;
+    size_t            length;
+    size_t            capacity;
+    volt_allocator_t* allocator;
+};
+
+static void volt_name_append(volt_name_builder_t* builder, const char* text) {
+    size_t text_length = strlen(text);
+    if (builder->length + text_length + 1 > builder->capacity) {
+        size_t new_capacity = (builder->length + text_length + 1) * 2;
+        char*  new_data     = builder->allocator->realloc(builder->data, new_capacity);
+        if (!new_data)
+            return;
+        builder->data     = new_data;
+        builder->capacity = new_capacity;
+    }
+
+    memcpy(builder->data + builder->length, text, text_length + 1);
+    builder->length += text_length;
+}
+
+// Canonical spelling, e.g. "some_struct<i32, 0>"
+static char* volt_instance_name(volt_allocator_t* allocator, const char* generic_name,
+                                const volt_comptime_binding_t* args, size_t count) {
+    volt_name_builder_t builder = {NULL, 0, 0, allocator};
+    volt_name_append(&builder, generic_name);
+    volt_name_append(&builder, "<");
+
+    for (size_t i = 0; i < count; i++) {
+        const volt_comptime_value_t* value = &args[i].value;
+        if (i > 0)
+            volt_name_append(&builder, ", ");
+        if (value->kind == VOLT_COMPTIME_VALUE_TYPE) {
+            volt_name_append(&builder, volt_type_to_string(value->type));
+            continue;
+        }
+
+        char text[64];
+        switch (value->kind) {
+            case VOLT_COMPTIME_VALUE_INT:
+                snprintf(text, sizeof(text), "%lld", (long long) value->i);
+                break;
+            case VOLT_COMPTIME_VALUE_FLOAT:
+                snprintf(text, sizeof(text), "%g", value->f);
+                break;
+            case VOLT_COMPTIME_VALUE_BOOL:
+                snprintf(text, sizeof(text), "%s", value->b ? "true" : "false");
+                break;
+            default:
+                snprintf(text, sizeof(text), "%s", volt_comptime_value_kind_to_string(value->kind));
+                break;
+        }
+        volt_name_append(&builder, text);
+    }
+
+    volt_name_append(&builder, ">");
+    return builder.data;
+}
+
+// ARGUMENTS
+
+static volt_ast_node_t* volt_generic_param_constraint(volt_ast_node_t* param) {
+    return volt_ast_find_child(volt_ast_find_child(param, "type_constraint"), "type");
+}
+
+// `N: i32` declares a const parameter; `T: type`, `Args: type[]` and trait constraints take types
+static bool volt_generic_param_takes_type(volt_ast_node_t* param) {
+    volt_ast_node_t* type = volt_generic_param_constraint(param);
+    volt_ast_node_t* base = volt_ast_get_child(volt_ast_find_child(type, "base_type"), 0);
+    if (!volt_ast_is(base, "primitive_type"))
+        return true;
+
+    volt_token_t* token = volt_ast_first_token(base);
+    return token && token->type == VOLT_TOKEN_TYPE_TYPE_KW;
+}
+
+static bool volt_generic_param_is_pack(volt_ast_node_t* param) {
+    volt_ast_node_t* suffixes =
+        volt_ast_find_child(volt_generic_param_constraint(param), "type_suffixes");
+    return suffixes && suffixes->children.size > 0;
+}
+
+// Const arguments name a const parameter of the enclosing instance (the grammar only admits
+// types between angle brackets)
+static bool volt_generic_const_argument(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* arg,
+                                        volt_comptime_value_t* out) {
+    volt_ast_node_t* type  = volt_ast_find_child(arg, "type");
+    volt_ast_node_t* named = volt_ast_get_child(volt_ast_find_child(type, "base_type"), 0);
+    if (!volt_ast_is(named, "named_type") || volt_ast_find_child(type, "type_suffixes"))
+        return false;
+
+    const char* name = volt_ast_get_identifier(volt_ast_find_child(named, "path"));
+    for (size_t i = 0; name && i < analyzer->generic_binding_count; i++) {
+        const volt_comptime_binding_t* binding = &analyzer->generic_bindings[i];
+        if (strcmp(binding->name, name) == 0 && binding->value.kind != VOLT_COMPTIME_VALUE_TYPE) {
+            *out = binding->value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool volt_generic_default_argument(volt_semantic_analyzer_t* analyzer,
+                                          volt_symbol_t* generic, volt_ast_node_t* param,
+                                          const volt_comptime_binding_t* bound, size_t count,
+                                          volt_comptime_value_t* out) {
+    char             message[256];
+    const char*      name          = volt_ast_get_identifier(param);
+    volt_ast_node_t* default_value = volt_ast_find_child(param, "expression");
+    if (!default_value) {
+        snprintf(message, sizeof(message), "Missing generic argument '%s' for '%s'", name,
+                 generic->name);
+        volt_semantic_error(analyzer, param, message);
+        return false;
+    }
+
+    // Defaults may refer to earlier parameters of the same declaration
+    if (volt_comptime_eval(&analyzer->comptime, default_value, bound, count, out) == VOLT_SUCCESS)
+        return true;
+
+    if (volt_generic_param_takes_type(param)) {
+        // Qualified defaults (`std::mem::default_allocator`) need namespace resolution, which is
+        // not modelled yet
+        *out = (volt_comptime_value_t) {.kind = VOLT_COMPTIME_VALUE_TYPE,
+                                        .type = analyzer->type_unknown};
+        return true;
+    }
+
+    volt_semantic_error(analyzer, default_value, analyzer->comptime.error_message);
+    return false;
+}
+
+// Builds the canonical argument list: one binding per parameter (a pack binds every trailing
+// argument), defaults evaluated in declaration order
+static volt_comptime_binding_t* volt_generic_resolve_arguments(volt_semantic_analyzer_t* analyzer,
+                                                               volt_symbol_t*   generic,
+                                                               volt_ast_node_t* generic_args,
+                                                               volt_ast_node_t* site,
+                                                               size_t*          out_count) {
+    volt_ast_node_t* generics = volt_ast_find_child(generic->declaration, "generics");
+    volt_vector_t    params   = volt_vector_default();
+    volt_vector_t    args     = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(generics, "generic_params"), "generic_param",
+                          &params);
+    volt_ast_collect_list(volt_ast_find_child(generic_args, "type_list"), "tuple_field", &args);
+
+    size_t                   capacity = (params.size > args.size ? params.size : args.size) + 1;
+    volt_comptime_binding_t* bindings =
+        analyzer->allocator->malloc(capacity * sizeof(volt_comptime_binding_t));
+    size_t count = 0, next_arg = 0;
+    bool   ok    = bindings != NULL;
+    char   message[256];
+
+    for (size_t i = 0; ok && i < params.size; i++) {
+        volt_ast_node_t* param = (volt_ast_node_t*) volt_vector_get(&params, i);
+        const char*      name  = volt_ast_get_identifier(param);
+        bool             takes_type = volt_generic_param_takes_type(param);
+
+        if (takes_type && volt_generic_param_is_pack(param)) {
+            while (next_arg < args.size) {
+                volt_type_info_t* type =
+                    volt_type_from_ast(analyzer, volt_vector_get(&args, next_arg++));
+                bindings[count++] = (volt_comptime_binding_t) {
+                    name, {.kind = VOLT_COMPTIME_VALUE_TYPE, .type = type}};
+            }
+            continue;
+        }
+
+        volt_comptime_value_t value;
+        if (next_arg >= args.size) {
+            // Defaults are written, and reported, in the generic's own file
+            size_t saved_file            = analyzer->current_file_index;
+            analyzer->current_file_index = generic->file_index;
+            ok = volt_generic_default_argument(analyzer, generic, param, bindings, count, &value);
+            analyzer->current_file_index = saved_file;
+        } else if (takes_type) {
+            value.kind = VOLT_COMPTIME_VALUE_TYPE;
+            value.type = volt_type_from_ast(analyzer, volt_vector_get(&args, next_arg++));
+        } else {
+            volt_ast_node_t* arg = (volt_ast_node_t*) volt_vector_get(&args, next_arg++);
+            ok                   = volt_generic_const_argument(analyzer, arg, &value);
+            if (!ok) {
+                snprintf(message, sizeof(message),
+                         "Generic argument '%s' of '%s' must be a compile-time value", name,
+                         generic->name);
+                volt_semantic_error(analyzer, arg, message);
+            }
+        }
+
+        if (ok)
+            bindings[count++] = (volt_comptime_binding_t) {name, value};
+    }
+
+    if (ok && next_arg < args.size) {
+        snprintf(message, sizeof(message), "Too many generic arguments for '%s' (expected %zu)",
+                 generic->name, params.size);
+        volt_semantic_error(analyzer, site, message);
+        ok = false;
+    }
+
+    volt_vector_deinit(&params);
+    volt_vector_deinit(&args);
+
+    if (!ok) {
+        analyzer->allocator->free(bindings);
+        return NULL;
+    }
+
+    *out_count = count;
+    return bindings;
+}
+
+// INSTANTIATION
+
+// Remembers that the declaration being walked references `instance`, for reachability
+static void volt_generic_record_use(volt_semantic_analyzer_t* analyzer,
+                                    volt_instance_t*          instance) {
+    volt_vector_t* uses = analyzer->current_instance ? &analyzer->current_instance->instances
+                          : analyzer->current_owner  ? &analyzer->current_owner->instances
+                                                     : NULL;
+    if (!uses)
+        return;
+
+    if (!uses->allocator) {
+        uses->allocator = analyzer->allocator;
+        volt_vector_init(uses);
+    }
+
+    for (size_t i = 0; i < uses->size; i++) {
+        if (volt_vector_get(uses, i) == instance)
+            return;
+    }
+    volt_vector_push_back(uses, instance);
+}
+
+// Frees an instance that never made it into the cache. Its type was the last one created, so it
+// is taken back off the analyzer's owned types rather than left for deinit to free a second time
+static void volt_generic_discard_instance(volt_semantic_analyzer_t* analyzer,
+                                          volt_instance_t*          instance) {
+    volt_instance_cache_t* cache = &analyzer->instances;
+    cache->bytes -= sizeof(volt_instance_t) +
+                    instance->arg_count * sizeof(volt_comptime_binding_t) +
+                    (instance->name ? strlen(instance->name) + 1 : 0);
+
+    volt_type_info_t* type  = instance->type;
+    volt_vector_t*    owned = &analyzer->owned_types;
+    if (type && owned->size > 0 && volt_vector_get(owned, owned->size - 1) == type) {
+        volt_vector_pop_back(owned);
+        volt_small_vector_deinit(&type->element_types);
+        volt_small_vector_deinit(&type->fields);
+        volt_small_vector_deinit(&type->variants);
+        analyzer->allocator->free(type);
+        cache->bytes -= sizeof(volt_type_info_t);
+    }
+
+    analyzer->allocator->free(instance->bindings);
+    analyzer->allocator->free((char*) instance->name);
+    analyzer->allocator->free(instance);
+}
+
+volt_instance_t* volt_generic_instantiate(volt_semantic_analyzer_t* analyzer,
+                                          volt_symbol_t* generic, volt_ast_node_t* generic_args,
+                                          volt_ast_node_t* site) {
+    volt_instance_cache_t* cache = &analyzer->instances;
+    cache->requests++;
+
+    size_t                   count = 0;
+    volt_comptime_binding_t* bindings =
+        volt_generic_resolve_arguments(analyzer, generic, generic_args, site, &count);
+    if (!bindings)
+        return NULL;
+
+    uint64_t         hash     = volt_instance_hash(generic, bindings, count);
+    volt_instance_t* instance = volt_instance_cache_find(cache, generic, bindings, count, hash);
+    if (instance) {
+        cache->hits++;
+        instance->uses++;
+        analyzer->allocator->free(bindings);
+        volt_generic_record_use(analyzer, instance);
+        return instance;
+    }
+
+    size_t depth = analyzer->current_instance ? analyzer->current_instance->depth + 1 : 1;
+    if (depth > VOLT_GENERIC_MAX_DEPTH) {
+        char message[256];
+        snprintf(message, sizeof(message),
+                 "Instantiating '%s' exceeds the maximum generic depth of %u", generic->name,
+                 VOLT_GENERIC_MAX_DEPTH);
+        volt_semantic_error(analyzer, site, message);
+        analyzer->allocator->free(bindings);
+        return NULL;
+    }
+
+    instance = analyzer->allocator->malloc(sizeof(volt_instance_t));
+    if (!instance) {
+        analyzer->allocator->free(bindings);
+        return NULL;
+    }
+
+    memset(instance, 0, sizeof(volt_instance_t));
+    instance->generic    = generic;
+    instance->bindings   = bindings;
+    instance->arg_count  = count;
+    instance->hash       = hash;
+    instance->name       = volt_instance_name(analyzer->allocator, generic->name, bindings, count);
+    instance->first_use  = site;
+    instance->file_index = analyzer->current_file_index;
+    instance->depth      = depth;
+    instance->uses       = 1;
+
+    cache->bytes += sizeof(volt_instance_t) + count * sizeof(volt_comptime_binding_t) +
+                    (instance->name ? strlen(instance->name) + 1 : 0);
+
+    if (generic->kind == VOLT_SYMBOL_TYPE && generic->type) {
+        instance->type = volt_type_create(analyzer, generic->type->kind);
+        if (!instance->type) {
+            volt_generic_discard_instance(analyzer, instance);
+            volt_semantic_error(analyzer, site, "Out of memory while instantiating generic");
+            return NULL;
+        }
+        instance->type->name        = instance->name;
+        instance->type->instance    = instance;
+        instance->type->declaration = generic->declaration;
+        instance->type->is_repr_c   = generic->type->is_repr_c;
+        cache->bytes += sizeof(volt_type_info_t);
+    }
+
+    if (volt_instance_cache_insert(cache, instance) != VOLT_SUCCESS) {
+        volt_generic_discard_instance(analyzer, instance);
+        volt_semantic_error(analyzer, site, "Out of memory while instantiating generic");
+        return NULL;
+    }
+
+    volt_generic_record_use(analyzer, instance);
+    return instance;
+}
+
+// SITE COLLECTION
+
+// Generic functions are looked up by name, preferring an exact arity match
+static volt_symbol_t* volt_generic_lookup_function(volt_semantic_analyzer_t* analyzer,
+                                                   const char* name, size_t argc) {
+    volt_symbol_t* fallback = NULL;
+    volt_scope_t*  scope    = analyzer->global_scope;
+    for (size_t i = 0; name && i < scope->symbols.size; i++) {
+        volt_symbol_t* sym = (volt_symbol_t*) volt_small_vector_get(&scope->symbols, i);
+        if (sym->kind != VOLT_SYMBOL_FUNCTION || !sym->is_generic || strcmp(sym->name, name) != 0)
+            continue;
+        if (sym->parameters.size == argc)
+            return sym;
+        if (!fallback)
+            fallback = sym;
+    }
+    return fallback;
+}
+
+static void volt_generic_instantiate_call(volt_semantic_analyzer_t* analyzer, const char* name,
+                                          volt_ast_node_t* call, volt_ast_node_t* site) {
+    volt_ast_node_t* generic_args = volt_ast_find_child(call, "generic_args");
+    if (!generic_args)
+        return;
+
+    volt_vector_t args = volt_vector_default();
+    size_t argc = volt_ast_collect_list(volt_ast_find_child(call, "args"), "expression", &args);
+    volt_vector_deinit(&args);
+
+    volt_symbol_t* callee = volt_generic_lookup_function(analyzer, name, argc);
+    if (callee)
+        volt_generic_instantiate(analyzer, callee, generic_args, site);
+}
+
+static void volt_generic_walk(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    // Declarations are walked whole, so this is where skipped function bodies are first needed
+    node = volt_ast_parse_body(node);
+    if (!node)
+        return;
+
+    // Nested generic declarations are analyzed per instance, with their parameters bound
+    if (volt_ast_find_child(node, "generics"))
+        return;
+
+    // Resolving a type instantiates any generic arguments it names
+    if (volt_ast_is(node, "type")) {
+        volt_type_from_ast(analyzer, node);
+        return;
+    }
+
+    // name<T>(...)
+    if (volt_ast_is(node, "generic_call")) {
+        volt_generic_instantiate_call(analyzer, volt_ast_get_identifier(node),
+                                      volt_ast_find_child(node, "call"), node);
+    } else if (volt_ast_is(node, "postfix_expr")) {
+        volt_ast_node_t* primary = volt_ast_get_child(node, 0);
+        volt_ast_node_t* op      = volt_ast_get_child(volt_ast_get_child(node, 1), 0);
+        volt_ast_node_t* call    = volt_ast_get_child(op, 0);
+        volt_token_t*    token   = volt_ast_get_child(primary, 0)
+                                       ? volt_ast_get_child(primary, 0)->token
+                                       : NULL;
+        if (token && token->type == VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL && volt_ast_is(call, "call"))
+            volt_generic_instantiate_call(analyzer, token->lexeme, call, node);
+    }
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_generic_walk(analyzer, volt_ast_get_child(node, i));
+}
+
+// Top-level declarations collected in pass 1 are walked through their symbols instead
+static void volt_generic_walk_items(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* node) {
+    if (volt_ast_is(node, "unit") || volt_ast_is(node, "items") ||
+        volt_ast_is(node, "items_rest") || volt_ast_is(node, "item")) {
+        for (size_t i = 0; i < node->children.size; i++)
+            volt_generic_walk_items(analyzer, volt_ast_get_child(node, i));
+        return;
+    }
+
+    if (volt_ast_is(node, "func_def") || volt_ast_is(node, "extern_decl") ||
+        volt_ast_is(node, "export_decl") || volt_ast_is(node, "struct_decl") ||
+        volt_ast_is(node, "enum_decl") || volt_ast_is(node, "error_decl") ||
+        volt_ast_is(node, "var_decl") || volt_ast_is(node, "val_decl"))
+        return;
+
+    if (volt_semantic_checks(analyzer, node))
+        volt_generic_walk(analyzer, node);
+}
+
+volt_status_code_t volt_generic_collect(volt_semantic_analyzer_t* analyzer,
+                                        volt_ast_node_t*          root) {
+    if (!analyzer || !root)
+        return VOLT_FAILURE;
+
+    volt_generic_walk_items(analyzer, root);
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_generic_collect_symbol(volt_semantic_analyzer_t* analyzer,
+                                               volt_symbol_t*            symbol) {
+    if (!analyzer || !symbol)
+        return VOLT_FAILURE;
+    if (symbol->is_generic || !symbol->declaration)
+        return VOLT_SUCCESS;
+
+    volt_symbol_t* saved_owner = analyzer->current_owner;
+    size_t         saved_file  = analyzer->current_file_index;
+
+    analyzer->current_owner      = symbol;
+    analyzer->current_file_index = symbol->file_index;
+    volt_generic_walk(analyzer, symbol->declaration);
+
+    analyzer->current_owner      = saved_owner;
+    analyzer->current_file_index = saved_file;
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_generic_analyze_instances(volt_semantic_analyzer_t* analyzer) {
+    volt_instance_cache_t* cache = &analyzer->instances;
+
+    // Instances found while walking a body are appended and picked up by later iterations
+    for (size_t i = 0; i < cache->instances.size; i++) {
+        volt_instance_t* instance = (volt_instance_t*) volt_vector_get(&cache->instances, i);
+        if (instance->analyzed)
+            continue;
+        instance->analyzed = true;
+
+        volt_instance_t*               saved_instance = analyzer->current_instance;
+        const volt_comptime_binding_t* saved_bindings = analyzer->generic_bindings;
+        size_t                         saved_count    = analyzer->generic_binding_count;
+        size_t                         saved_file     = analyzer->current_file_index;
+
+        analyzer->current_instance      = instance;
+        analyzer->generic_bindings      = instance->bindings;
+        analyzer->generic_binding_count = instance->arg_count;
+        analyzer->current_file_index    = instance->generic->file_index;
+
+        // Everything but the parameter list itself
+        volt_ast_node_t* declaration = instance->generic->declaration;
+        for (size_t j = 0; j < declaration->children.size; j++) {
+            volt_ast_node_t* child = volt_ast_get_child(declaration, j);
+            if (!volt_ast_is(child, "generics"))
+                volt_generic_walk(analyzer, child);
+        }
+
+        analyzer->current_instance      = saved_instance;
+        analyzer->generic_bindings      = saved_bindings;
+        analyzer->generic_binding_count = saved_count;
+        analyzer->current_file_index    = saved_file;
+    }
+
+    return VOLT_SUCCESS;
+}
+
+void volt_generic_log_stats(volt_semantic_analyzer_t* analyzer) {
+    volt_instance_cache_t* cache = &analyzer->instances;
+    volt_fmt_logf(VOLT_FMT_LEVEL_INFO,
+                  "Generics: {u64} instantiation request(s), {u64} unique, {u64} cache hit(s), "
+                  "{u64} bytes",
+                  (uint64_t) cache->requests, (uint64_t) cache->instances.size,
+                  (uint64_t) cache->hits, (uint64_t) cache->bytes);
+}
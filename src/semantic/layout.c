@@ -0,0 +1,537 @@
+#include <pch.h>
+#include <semantic/layout.h>
+
+// HELPER FUNCTIONS
+
+static size_t volt_layout_align_up(size_t value, size_t alignment) {
+    return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+}
+
+static size_t volt_layout_max(size_t a, size_t b) {
+    return a > b ? a : b;
+}
+
+static void volt_layout_set(volt_type_info_t* type, size_t size, size_t alignment) {
+    type->size      = size;
+    type->alignment = alignment ? alignment : 1;
+}
+
+static void volt_layout_set_niche(volt_type_info_t* type, size_t offset, size_t width,
+                                  uint64_t start, uint64_t count) {
+    type->niche_offset = offset;
+    type->niche_width  = count ? width : 0;
+    type->niche_start  = start;
+    type->niche_count  = count;
+}
+
+// An aggregate inherits the largest niche among its members
+static void volt_layout_inherit_niche(volt_type_info_t* type, volt_small_vector_t* members) {
+    for (size_t i = 0; i < members->size; i++) {
+        volt_symbol_t* member = (volt_symbol_t*) volt_small_vector_get(members, i);
+        if (member->type && member->type->niche_count > type->niche_count)
+            volt_layout_set_niche(type, member->offset + member->type->niche_offset,
+                                  member->type->niche_width, member->type->niche_start,
+                                  member->type->niche_count);
+    }
+}
+
+// Enum discriminants use the smallest unsigned integer that can number every variant; error
+// codes are global, so error sets always use 16 bits
+static size_t volt_layout_tag_size(volt_type_info_t* type) {
+    if (type->kind == VOLT_TYPE_ERROR)
+        return 2;
+    if (type->variants.size <= 0x100)
+        return 1;
+    return type->variants.size <= 0x10000 ? 2 : 4;
+}
+
+static volt_symbol_t* volt_layout_member(volt_semantic_analyzer_t* analyzer,
+                                         volt_symbol_kind_t kind, const char* name,
+                                         volt_type_info_t* type, volt_ast_node_t* declaration) {
+    volt_symbol_t* member = volt_symbol_create(analyzer, kind);
+    if (!member)
+        return NULL;
+
+    member->name        = name;
+    member->type        = type;
+    member->declaration = declaration;
+    member->is_resolved = true;
+    return member;
+}
+
+// Struct fields and enum variants are read from the declaration, with the instance's generic
+// parameters bound when the type is an instantiation
+static void volt_layout_resolve_members(volt_semantic_analyzer_t* analyzer,
+                                        volt_type_info_t*         type) {
+    if (type->is_complete || !type->declaration)
+        return;
+    type->is_complete = true;
+
+    const volt_comptime_binding_t* saved_bindings = analyzer->generic_bindings;
+    size_t                         saved_count    = analyzer->generic_binding_count;
+    if (type->instance) {
+        analyzer->generic_bindings      = type->instance->bindings;
+        analyzer->generic_binding_count = type->instance->arg_count;
+    }
+
+    volt_vector_t nodes = volt_vector_default();
+    if (type->kind == VOLT_TYPE_STRUCT) {
+        volt_ast_collect_list(volt_ast_find_child(type->declaration, "fields"), "field", &nodes);
+        for (size_t i = 0; i < nodes.size; i++) {
+            volt_ast_node_t* field  = (volt_ast_node_t*) volt_vector_get(&nodes, i);
+            volt_symbol_t*   member = volt_layout_member(
+                analyzer, VOLT_SYMBOL_VARIABLE, volt_ast_get_identifier(field),
+                volt_type_from_ast(analyzer, volt_ast_find_child(field, "type")), field);
+            if (member)
+                volt_small_vector_push_back(&type->fields, member);
+        }
+    } else {
+        volt_ast_collect_list(volt_ast_find_child(type->declaration, "enum_variants"),
+                              "enum_variant", &nodes);
+        for (size_t i = 0; i < nodes.size; i++) {
+            volt_ast_node_t* variant = (volt_ast_node_t*) volt_vector_get(&nodes, i);
+            volt_ast_node_t* payload = volt_ast_find_child(variant, "type");
+            volt_symbol_t*   member  = volt_layout_member(
+                analyzer, VOLT_SYMBOL_ENUM_VARIANT, volt_ast_get_identifier(variant),
+                payload ? volt_type_from_ast(analyzer, payload) : NULL, variant);
+            if (member)
+                volt_small_vector_push_back(&type->variants, member);
+        }
+    }
+    volt_vector_deinit(&nodes);
+
+    analyzer->generic_bindings      = saved_bindings;
+    analyzer->generic_binding_count = saved_count;
+}
+
+// Places the members one after another. Unless `keep_order`, members go by decreasing
+// alignment (stable), which leaves no interior padding for power-of-two alignments.
+static void volt_layout_aggregate(volt_semantic_analyzer_t* analyzer, volt_type_info_t* type,
+                                  bool keep_order) {
+    size_t          count = type->fields.size;
+    volt_symbol_t** order = analyzer->allocator->malloc((count + 1) * sizeof(volt_symbol_t*));
+    if (!order)
+        return;
+
+    for (size_t i = 0; i < count; i++) {
+        order[i]            = (volt_symbol_t*) volt_small_vector_get(&type->fields, i);
+        type->layout_member = order[i];
+        volt_layout_compute(analyzer, order[i]->type);
+    }
+    type->layout_member = NULL;
+
+    for (size_t i = 1; !keep_order && i < count; i++) {
+        volt_symbol_t* member = order[i];
+        size_t         j      = i;
+        while (j > 0 && order[j - 1]->type->alignment < member->type->alignment) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = member;
+    }
+
+    size_t offset = 0, alignment = 1;
+    for (size_t i = 0; i < count; i++) {
+        volt_type_info_t* member_type = order[i]->type;
+        offset                        = volt_layout_align_up(offset, member_type->alignment);
+        order[i]->offset              = offset;
+        offset += member_type->size;
+        alignment = volt_layout_max(alignment, member_type->alignment);
+    }
+
+    volt_layout_set(type, volt_layout_align_up(offset, alignment), alignment);
+    analyzer->allocator->free(order);
+}
+
+// Discriminant first, then the largest payload
+static void volt_layout_tagged(volt_semantic_analyzer_t* analyzer, volt_type_info_t* type) {
+    size_t payload_size = 0, payload_alignment = 1;
+    for (size_t i = 0; i < type->variants.size; i++) {
+        volt_symbol_t* variant = (volt_symbol_t*) volt_small_vector_get(&type->variants, i);
+        if (!variant->type)
+            continue;
+        type->layout_member = variant;
+        volt_layout_compute(analyzer, variant->type);
+        payload_size      = volt_layout_max(payload_size, variant->type->size);
+        payload_alignment = volt_layout_max(payload_alignment, variant->type->alignment);
+    }
+    type->layout_member = NULL;
+
+    size_t tag_size       = volt_layout_tag_size(type);
+    size_t payload_offset = payload_size ? volt_layout_align_up(tag_size, payload_alignment) : 0;
+    for (size_t i = 0; i < type->variants.size; i++) {
+        volt_symbol_t* variant = (volt_symbol_t*) volt_small_vector_get(&type->variants, i);
+        variant->offset        = variant->type ? payload_offset : 0;
+    }
+
+    size_t alignment = volt_layout_max(tag_size, payload_alignment);
+    size_t size      = payload_size ? payload_offset + payload_size : tag_size;
+    volt_layout_set(type, volt_layout_align_up(size, alignment), alignment);
+
+    // Error code 0 means success, so no error set uses it; enums leave every discriminant past
+    // the last variant unused
+    if (type->kind == VOLT_TYPE_ERROR)
+        volt_layout_set_niche(type, 0, tag_size, 0, 1);
+    else
+        volt_layout_set_niche(type, 0, tag_size, type->variants.size,
+                              ((uint64_t) 1 << (8 * tag_size)) - type->variants.size);
+}
+
+static void volt_layout_tuple_members(volt_semantic_analyzer_t* analyzer, volt_type_info_t* type) {
+    if (type->fields.size == type->element_types.size)
+        return;
+
+    for (size_t i = 0; i < type->element_types.size; i++) {
+        volt_type_info_t* element =
+            (volt_type_info_t*) volt_small_vector_get(&type->element_types, i);
+        volt_symbol_t*    member =
+            volt_layout_member(analyzer, VOLT_SYMBOL_VARIABLE, NULL, element, NULL);
+        if (member)
+            volt_small_vector_push_back(&type->fields, member);
+    }
+}
+
+// CYCLES
+
+// Input file that declares the named type, for reporting; instances live in their generic's file
+static size_t volt_layout_file_of(volt_semantic_analyzer_t* analyzer, volt_type_info_t* type) {
+    if (type->instance)
+        return type->instance->generic->file_index;
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind == VOLT_SYMBOL_TYPE && symbol->type == type)
+            return symbol->file_index;
+    }
+    return analyzer->current_file_index;
+}
+
+// `type` was reached again while its own layout is in progress. The members being laid out lead
+// from it back to itself; they are listed as the path, and the one that closes the cycle is
+// reported in the file of the type declaring it.
+static void volt_layout_report_cycle(volt_semantic_analyzer_t* analyzer, volt_type_info_t* type) {
+    char              path[192] = "";
+    size_t            length    = 0;
+    volt_symbol_t*    closing   = NULL;
+    volt_type_info_t* owner     = type;
+    volt_type_info_t* current   = type;
+
+    // Anonymous wrappers (arrays, optionals, `error!T`) are followed through their base type
+    for (size_t steps = 0; current && steps < 64; steps++) {
+        volt_symbol_t* member = current->layout_member;
+        if (member && member->name && length < sizeof(path)) {
+            length += (size_t) snprintf(path + length, sizeof(path) - length, "%s%s.%s",
+                                        length ? " -> " : "", volt_type_to_string(current),
+                                        member->name);
+            closing = member;
+            owner   = current;
+        }
+
+        current = member ? member->type : current->base_type;
+        if (current == type)
+            break;
+    }
+
+    char message[512];
+    if (closing)
+        snprintf(message, sizeof(message),
+                 "Type '%s' contains itself by value through %s; use a pointer (%s*?) instead",
+                 volt_type_to_string(type), path, volt_type_to_string(type));
+    else
+        snprintf(message, sizeof(message),
+                 "Type '%s' contains itself by value; use a pointer (%s*?) instead",
+                 volt_type_to_string(type), volt_type_to_string(type));
+
+    size_t saved_file            = analyzer->current_file_index;
+    analyzer->current_file_index = volt_layout_file_of(analyzer, owner);
+    volt_semantic_error(analyzer, closing ? closing->declaration : type->declaration, message);
+    analyzer->current_file_index = saved_file;
+}
+
+// LAYOUT
+
+volt_status_code_t volt_layout_compute(volt_semantic_analyzer_t* analyzer,
+                                       volt_type_info_t*         type) {
+    if (!type || type->size_computed)
+        return VOLT_SUCCESS;
+
+    if (type->layout_in_progress) {
+        volt_layout_report_cycle(analyzer, type);
+        return VOLT_FAILURE;
+    }
+    type->layout_in_progress = true;
+
+    switch (type->kind) {
+        case VOLT_TYPE_VOID:
+        case VOLT_TYPE_UNKNOWN:
+        case VOLT_TYPE_GENERIC:
+            volt_layout_set(type, 0, 1);
+            break;
+        case VOLT_TYPE_I8:
+        case VOLT_TYPE_U8:
+            volt_layout_set(type, 1, 1);
+            break;
+        case VOLT_TYPE_BOOL:
+            volt_layout_set(type, 1, 1);
+            volt_layout_set_niche(type, 0, 1, 2, 254);
+            break;
+        case VOLT_TYPE_I16:
+        case VOLT_TYPE_U16:
+        case VOLT_TYPE_F16:
+            volt_layout_set(type, 2, 2);
+            break;
+        case VOLT_TYPE_I32:
+        case VOLT_TYPE_U32:
+        case VOLT_TYPE_F32:
+            volt_layout_set(type, 4, 4);
+            break;
+        case VOLT_TYPE_I64:
+        case VOLT_TYPE_U64:
+        case VOLT_TYPE_F64:
+        case VOLT_TYPE_ISIZE:
+        case VOLT_TYPE_USIZE:
+            volt_layout_set(type, 8, 8);
+            break;
+        case VOLT_TYPE_I128:
+        case VOLT_TYPE_U128:
+        case VOLT_TYPE_F128:
+            volt_layout_set(type, 16, 16);
+            break;
+        case VOLT_TYPE_CSTR:
+        case VOLT_TYPE_TYPE:
+        case VOLT_TYPE_POINTER:
+            volt_layout_set(type, VOLT_LAYOUT_POINTER_SIZE, VOLT_LAYOUT_POINTER_SIZE);
+            break;
+        case VOLT_TYPE_REFERENCE:
+        case VOLT_TYPE_FUNCTION:
+            // Never null
+            volt_layout_set(type, VOLT_LAYOUT_POINTER_SIZE, VOLT_LAYOUT_POINTER_SIZE);
+            volt_layout_set_niche(type, 0, VOLT_LAYOUT_POINTER_SIZE, 0, 1);
+            break;
+        case VOLT_TYPE_STR:
+        case VOLT_TYPE_SLICE:
+            // Pointer and length; the pointer is never null
+            volt_layout_set(type, 2 * VOLT_LAYOUT_POINTER_SIZE, VOLT_LAYOUT_POINTER_SIZE);
+            volt_layout_set_niche(type, 0, VOLT_LAYOUT_POINTER_SIZE, 0, 1);
+            break;
+        case VOLT_TYPE_ARRAY:
+            if (!type->array_length) {
+                // Unsized arrays are passed around like slices
+                volt_layout_set(type, 2 * VOLT_LAYOUT_POINTER_SIZE, VOLT_LAYOUT_POINTER_SIZE);
+                volt_layout_set_niche(type, 0, VOLT_LAYOUT_POINTER_SIZE, 0, 1);
+                break;
+            }
+            volt_layout_compute(analyzer, type->base_type);
+            volt_layout_set(type, type->base_type->size * type->array_length,
+                            type->base_type->alignment);
+            volt_layout_set_niche(type, type->base_type->niche_offset,
+                                  type->base_type->niche_width, type->base_type->niche_start,
+                                  type->base_type->niche_count);
+            break;
+        case VOLT_TYPE_OPTIONAL: {
+            volt_type_info_t* base = type->base_type;
+            volt_layout_compute(analyzer, base);
+            if (base->niche_count > 0) {
+                // `none` is the payload's first unused value
+                volt_layout_set(type, base->size, base->alignment);
+                volt_layout_set_niche(type, base->niche_offset, base->niche_width,
+                                      base->niche_start + 1, base->niche_count - 1);
+            } else {
+                // Payload followed by a presence flag (0 = none, 1 = some)
+                volt_layout_set(type, volt_layout_align_up(base->size + 1, base->alignment),
+                                base->alignment);
+                volt_layout_set_niche(type, base->size, 1, 2, 254);
+            }
+            break;
+        }
+        case VOLT_TYPE_TUPLE:
+            volt_layout_tuple_members(analyzer, type);
+            volt_layout_aggregate(analyzer, type, false);
+            volt_layout_inherit_niche(type, &type->fields);
+            break;
+        case VOLT_TYPE_STRUCT:
+            volt_layout_resolve_members(analyzer, type);
+            volt_layout_aggregate(analyzer, type, type->is_repr_c);
+            volt_layout_inherit_niche(type, &type->fields);
+            break;
+        case VOLT_TYPE_ENUM:
+            volt_layout_resolve_members(analyzer, type);
+            volt_layout_tagged(analyzer, type);
+            break;
+        case VOLT_TYPE_ERROR:
+            if (type->declaration) {
+                volt_layout_resolve_members(analyzer, type);
+                volt_layout_tagged(analyzer, type);
+            } else {
+                // `error!T`: a 16-bit error code, 0 meaning success, then the payload
+                volt_type_info_t* payload = type->base_type;
+                volt_layout_compute(analyzer, payload);
+                size_t payload_offset = volt_layout_align_up(2, payload->alignment);
+                size_t alignment      = volt_layout_max(2, payload->alignment);
+                volt_layout_set(type,
+                                volt_layout_align_up(payload_offset + payload->size, alignment),
+                                alignment);
+            }
+            break;
+    }
+
+    type->size_computed      = true;
+    type->layout_in_progress = false;
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_layout_compute_all(volt_semantic_analyzer_t* analyzer) {
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_TYPE || symbol->is_generic)
+            continue;
+        analyzer->current_file_index = symbol->file_index;
+        volt_layout_compute(analyzer, symbol->type);
+    }
+
+    for (size_t i = 0; i < analyzer->instances.instances.size; i++) {
+        volt_instance_t* instance = volt_vector_get(&analyzer->instances.instances, i);
+        analyzer->current_file_index = instance->generic->file_index;
+        volt_layout_compute(analyzer, instance->type);
+    }
+
+    for (size_t i = 0; i < analyzer->derived_types.size; i++)
+        volt_layout_compute(analyzer, volt_vector_get(&analyzer->derived_types, i));
+
+    return analyzer->had_error ? VOLT_FAILURE : VOLT_SUCCESS;
+}
+
+size_t volt_layout_wasted(volt_type_info_t* type) {
+    size_t used = 0;
+    switch (type->kind) {
+        case VOLT_TYPE_STRUCT:
+        case VOLT_TYPE_TUPLE:
+            for (size_t i = 0; i < type->fields.size; i++)
+                used += ((volt_symbol_t*) volt_small_vector_get(&type->fields, i))->type->size;
+            break;
+        case VOLT_TYPE_ENUM:
+        case VOLT_TYPE_ERROR:
+            if (type->declaration || !type->base_type) {
+                for (size_t i = 0; i < type->variants.size; i++) {
+                    volt_symbol_t* variant = volt_small_vector_get(&type->variants, i);
+                    if (variant->type)
+                        used = volt_layout_max(used, variant->type->size);
+                }
+                used += volt_layout_tag_size(type);
+            } else {
+                used = 2 + type->base_type->size;
+            }
+            break;
+        case VOLT_TYPE_OPTIONAL:
+            used = type->base_type->size + (type->base_type->niche_count > 0 ? 0 : 1);
+            break;
+        default:
+            used = type->size;
+            break;
+    }
+    return type->size > used ? type->size - used : 0;
+}
+
+bool volt_layout_test(volt_type_info_t* type, volt_layout_test_t* test) {
+    if (!type || !type->size_computed || !type->base_type)
+        return false;
+
+    if (type->kind == VOLT_TYPE_OPTIONAL) {
+        volt_type_info_t* base = type->base_type;
+        test->uses_niche       = base->niche_count > 0;
+        test->offset           = test->uses_niche ? base->niche_offset : base->size;
+        test->width            = test->uses_niche ? base->niche_width : 1;
+        test->value            = test->uses_niche ? base->niche_start : 0;
+        return true;
+    }
+
+    if (type->kind == VOLT_TYPE_ERROR && !type->declaration) {
+        test->uses_niche = true;
+        test->offset     = 0;
+        test->width      = 2;
+        test->value      = 0;
+        return true;
+    }
+
+    return false;
+}
+
+// REPORT
+
+static void volt_layout_print_type(volt_semantic_analyzer_t* analyzer, volt_type_info_t* type,
+                                   const char* what) {
+    bool                 aggregate = type->kind == VOLT_TYPE_STRUCT ||
+                                     type->kind == VOLT_TYPE_TUPLE;
+    volt_small_vector_t* members   = aggregate ? &type->fields : &type->variants;
+
+    // Members in memory order; payloads of a tagged type all share one offset
+    size_t          count = members->size;
+    volt_symbol_t** order = analyzer->allocator->malloc((count + 1) * sizeof(volt_symbol_t*));
+    if (!order)
+        return;
+
+    bool reordered = false;
+    for (size_t i = 0; i < count; i++) {
+        volt_symbol_t* member = (volt_symbol_t*) volt_small_vector_get(members, i);
+        size_t         j      = i;
+        while (aggregate && j > 0 && order[j - 1]->offset > member->offset) {
+            order[j] = order[j - 1];
+            reordered = true;
+            j--;
+        }
+        order[j] = member;
+    }
+
+    printf("%-8s %s: size %zu, align %zu, wasted %zu%s\n", what, volt_type_to_string(type),
+           type->size, type->alignment, volt_layout_wasted(type), reordered ? " (reordered)" : "");
+
+    volt_layout_test_t test;
+    if (volt_layout_test(type, &test))
+        printf("  %s when u%zu at +%zu == %llu%s\n",
+               type->kind == VOLT_TYPE_OPTIONAL ? "none" : "ok", test.width * 8, test.offset,
+               (unsigned long long) test.value, test.uses_niche ? " (niche)" : "");
+
+    for (size_t i = 0; i < count; i++) {
+        volt_symbol_t* member = order[i];
+        if (member->type)
+            printf("  +%-5zu %-16s %s (%zu)\n", member->offset, member->name ? member->name : "_",
+                   volt_type_to_string(member->type), member->type->size);
+        else
+            printf("  %-6s %s\n", "", member->name);
+    }
+
+    analyzer->allocator->free(order);
+}
+
+void volt_layout_print(volt_semantic_analyzer_t* analyzer) {
+    printf("== layouts ==\n");
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_TYPE || symbol->is_generic)
+            continue;
+        const char* what = symbol->type->kind == VOLT_TYPE_STRUCT ? "struct"
+                           : symbol->type->kind == VOLT_TYPE_ENUM ? "enum"
+                                                                  : "error";
+        volt_layout_print_type(analyzer, symbol->type, what);
+    }
+
+    for (size_t i = 0; i < analyzer->instances.instances.size; i++) {
+        volt_instance_t* instance = volt_vector_get(&analyzer->instances.instances, i);
+        if (instance->type)
+            volt_layout_print_type(analyzer, instance->type, "instance");
+    }
+
+    for (size_t i = 0; i < analyzer->derived_types.size; i++) {
+        volt_type_info_t* type = volt_vector_get(&analyzer->derived_types, i);
+        if (type->kind == VOLT_TYPE_TUPLE || type->kind == VOLT_TYPE_OPTIONAL ||
+            type->kind == VOLT_TYPE_ERROR)
+            volt_layout_print_type(analyzer, type,
+                                   type->kind == VOLT_TYPE_TUPLE      ? "tuple"
+                                   : type->kind == VOLT_TYPE_OPTIONAL ? "optional"
+                                                                      : "error");
+    }
+}
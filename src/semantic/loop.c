@@ -0,0 +1,319 @@
+#include <pch.h>
+#include <semantic/loop.h>
+
+typedef struct volt_loop_walk_t volt_loop_walk_t;
+struct volt_loop_walk_t {
+    volt_semantic_analyzer_t* analyzer;
+    volt_symbol_t*            function;
+    volt_ast_node_t*          body;
+};
+
+// HELPER FUNCTIONS
+
+// `a..b` or `a..=b`
+static bool volt_loop_match_range(volt_ast_node_t* expression, volt_ast_node_t** start,
+                                  volt_ast_node_t** end, bool* inclusive) {
+    volt_ast_node_t* range = volt_ast_unwrap(expression);
+    volt_ast_node_t* rest  = volt_ast_find_child(range, "range_expr_rest");
+    if (!volt_ast_is(range, "range_expr") || !rest || rest->children.size == 0)
+        return false;
+
+    *start     = volt_ast_get_child(range, 0);
+    *end       = volt_ast_find_child(rest, "additive_expr");
+    *inclusive = volt_ast_find_token(rest, VOLT_TOKEN_TYPE_DOT_DOT_EQUAL) != NULL;
+    return true;
+}
+
+// The name when `expression` is a bare identifier
+static const char* volt_loop_match_identifier(volt_ast_node_t* expression) {
+    volt_ast_node_t* primary = volt_ast_unwrap(expression);
+    if (!volt_ast_is(primary, "primary_expr") || primary->children.size != 1)
+        return NULL;
+    volt_token_t* token = volt_ast_find_token(primary, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    return token ? token->lexeme : NULL;
+}
+
+static volt_ast_node_t* volt_loop_iterable(volt_ast_node_t* loop) {
+    volt_ast_node_t* iterable = volt_ast_find_child(loop, "for_iterable_expr");
+    return iterable ? iterable : volt_ast_find_child(loop, "expression");
+}
+
+typedef struct volt_loop_uses_t volt_loop_uses_t;
+struct volt_loop_uses_t {
+    const char*      name;
+    size_t           tokens;       // Every occurrence, declarations included
+    size_t           iterated;     // As the whole iterable of a `for`
+    volt_ast_node_t* declaration;  // `val name = a..b;` when it is the only declaration
+    size_t           declarations;
+};
+
+static void volt_loop_count_uses(volt_loop_uses_t* uses, volt_ast_node_t* node) {
+    if (!node)
+        return;
+
+    if (node->type == VOLT_AST_NODE_TOKEN) {
+        if (node->token && node->token->type == VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL &&
+            strcmp(node->token->lexeme, uses->name) == 0)
+            uses->tokens++;
+        return;
+    }
+
+    const char* declared = volt_ast_is(node, "var_decl") || volt_ast_is(node, "val_decl")
+                               ? volt_ast_get_identifier(node)
+                               : NULL;
+    if (declared && strcmp(declared, uses->name) == 0) {
+        volt_ast_node_t *start, *end;
+        bool             inclusive;
+        uses->declarations++;
+        if (volt_loop_match_range(volt_ast_find_child(node, "expression"), &start, &end,
+                                  &inclusive))
+            uses->declaration = node;
+    }
+
+    if (volt_ast_is(node, "for_stmt")) {
+        const char* name = volt_loop_match_identifier(volt_loop_iterable(node));
+        if (name && strcmp(name, uses->name) == 0)
+            uses->iterated++;
+    }
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_loop_count_uses(uses, volt_ast_get_child(node, i));
+}
+
+// Calls, exits and suspends keep the loop scalar
+static bool volt_loop_is_straight(volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return true;
+
+    static const char* const blockers[] = {
+        "call",        "type_scoped_call", "closure",     "break_stmt", "continue_stmt",
+        "return_stmt", "suspend_stmt",     "resume_stmt", "for_stmt",   "while_stmt",
+        "loop_stmt",   "try_catch",
+    };
+    for (size_t i = 0; i < sizeof(blockers) / sizeof(blockers[0]); i++) {
+        if (volt_ast_is(node, blockers[i]))
+            return false;
+    }
+
+    for (size_t i = 0; i < node->children.size; i++) {
+        if (!volt_loop_is_straight(volt_ast_get_child(node, i)))
+            return false;
+    }
+    return true;
+}
+
+// `&name`, or a closure capturing `name*` by reference
+static volt_ast_node_t* volt_loop_find_escape(volt_ast_node_t* node, const char* name) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return NULL;
+
+    if (volt_ast_is(node, "unary_expr")) {
+        volt_ast_node_t* op = volt_ast_find_child(node, "unary_op");
+        if (op && volt_ast_find_token(op, VOLT_TOKEN_TYPE_AMPERSAND)) {
+            const char* operand = volt_loop_match_identifier(volt_ast_get_child(node, 1));
+            if (operand && strcmp(operand, name) == 0)
+                return node;
+        }
+    }
+
+    if (volt_ast_is(node, "closure_capture") && volt_ast_find_token(node, VOLT_TOKEN_TYPE_STAR)) {
+        const char* captured = volt_ast_get_identifier(node);
+        if (captured && strcmp(captured, name) == 0)
+            return node;
+    }
+
+    for (size_t i = 0; i < node->children.size; i++) {
+        volt_ast_node_t* escape = volt_loop_find_escape(volt_ast_get_child(node, i), name);
+        if (escape)
+            return escape;
+    }
+    return NULL;
+}
+
+static void volt_loop_trip_count(volt_semantic_analyzer_t* analyzer, volt_loop_t* loop) {
+    volt_comptime_value_t start, end;
+    if (volt_comptime_eval(&analyzer->comptime, loop->start, NULL, 0, &start) != VOLT_SUCCESS ||
+        volt_comptime_eval(&analyzer->comptime, loop->end, NULL, 0, &end) != VOLT_SUCCESS ||
+        start.kind != VOLT_COMPTIME_VALUE_INT || end.kind != VOLT_COMPTIME_VALUE_INT)
+        return;
+
+    int64_t last     = loop->inclusive ? end.i : end.i - 1;
+    loop->constant   = true;
+    loop->trip_count = last >= start.i ? (uint64_t) (last - start.i) + 1 : 0;
+}
+
+static void volt_loop_bindings(volt_loop_t* loop) {
+    volt_ast_node_t* binding = volt_ast_find_child(loop->node, "for_binding");
+    volt_ast_node_t* list    = volt_ast_find_child(binding, "identifier_list");
+
+    volt_token_t* first = volt_ast_find_token(list ? list : binding,
+                                              VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    loop->value         = first ? first->lexeme : NULL;
+
+    volt_ast_node_t* rest   = volt_ast_find_child(list, "identifier_list_rest");
+    volt_token_t*    second = volt_ast_find_token(rest, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    loop->index             = second ? second->lexeme : NULL;
+}
+
+static void volt_loop_captures(volt_semantic_analyzer_t* analyzer, volt_loop_t* loop) {
+    volt_vector_t nodes = volt_vector_default();
+    volt_ast_collect_list(
+        volt_ast_find_child(volt_ast_find_child(loop->node, "for_captures"), "capture_list"),
+        "capture", &nodes);
+
+    volt_ast_node_t* body = volt_ast_find_child(loop->node, "block");
+    for (size_t i = 0; i < nodes.size; i++) {
+        volt_loop_capture_t* capture = analyzer->allocator->malloc(sizeof(volt_loop_capture_t));
+        if (!capture)
+            break;
+
+        capture->node        = (volt_ast_node_t*) volt_vector_get(&nodes, i);
+        capture->name        = volt_ast_get_identifier(capture->node);
+        capture->escape      = capture->name ? volt_loop_find_escape(body, capture->name) : NULL;
+        capture->in_register = capture->escape == NULL;
+        volt_vector_push_back(&loop->captures, capture);
+    }
+    volt_vector_deinit(&nodes);
+}
+
+static void volt_loop_plan(volt_loop_walk_t* walk, volt_ast_node_t* node) {
+    volt_semantic_analyzer_t* analyzer = walk->analyzer;
+    volt_loop_t*              loop     = analyzer->allocator->malloc(sizeof(volt_loop_t));
+    if (!loop)
+        return;
+
+    memset(loop, 0, sizeof(volt_loop_t));
+    loop->node               = node;
+    loop->function           = walk->function;
+    loop->captures.allocator = analyzer->allocator;
+    volt_vector_init(&loop->captures);
+
+    volt_ast_node_t* iterable = volt_loop_iterable(node);
+    if (volt_loop_match_range(iterable, &loop->start, &loop->end, &loop->inclusive)) {
+        loop->kind = VOLT_LOOP_RANGE;
+    } else {
+        // A local holding a range that is only ever iterated is never built as an array
+        const char*      name = volt_loop_match_identifier(iterable);
+        volt_loop_uses_t uses = {0};
+        uses.name             = name;
+        if (name)
+            volt_loop_count_uses(&uses, walk->body);
+
+        if (uses.declaration && uses.declarations == 1 &&
+            uses.tokens == uses.iterated + uses.declarations) {
+            loop->kind   = VOLT_LOOP_RANGE;
+            loop->source = uses.declaration;
+            volt_loop_match_range(volt_ast_find_child(uses.declaration, "expression"),
+                                  &loop->start, &loop->end, &loop->inclusive);
+        } else {
+            loop->kind     = VOLT_LOOP_INDEXED;
+            loop->iterable = iterable;
+        }
+    }
+
+    if (loop->kind == VOLT_LOOP_RANGE)
+        volt_loop_trip_count(analyzer, loop);
+
+    volt_loop_bindings(loop);
+    volt_loop_captures(analyzer, loop);
+
+    volt_ast_node_t* pre = volt_ast_find_child(node, "for_pre_expr");
+    loop->transform      = volt_ast_find_child(pre, "expression");
+    loop->vectorizable   = volt_loop_is_straight(loop->transform) &&
+                         volt_loop_is_straight(volt_ast_find_child(node, "block"));
+
+    volt_vector_push_back(&analyzer->loops, loop);
+}
+
+static void volt_loop_walk(volt_loop_walk_t* walk, volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    if (volt_ast_is(node, "for_stmt"))
+        volt_loop_plan(walk, node);
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_loop_walk(walk, volt_ast_get_child(node, i));
+}
+
+// Bounds are printed when they are a single token
+static const char* volt_loop_describe(volt_ast_node_t* expression) {
+    volt_ast_node_t* inner = volt_ast_unwrap(expression);
+    volt_ast_node_t* leaf  = volt_ast_is(inner, "literal") ? inner : NULL;
+    if (!leaf && volt_ast_is(inner, "primary_expr") && inner->children.size == 1)
+        leaf = inner;
+
+    volt_token_t* token = leaf ? volt_ast_first_token(leaf) : NULL;
+    return token ? token->lexeme : "(...)";
+}
+
+// LOWERING
+
+volt_status_code_t volt_loop_lower_all(volt_semantic_analyzer_t* analyzer) {
+    if (!analyzer)
+        return VOLT_FAILURE;
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_FUNCTION ||
+            !volt_semantic_checks(analyzer, symbol->declaration))
+            continue;
+
+        volt_loop_walk_t walk = {0};
+        walk.analyzer         = analyzer;
+        walk.function         = symbol;
+        walk.body             = volt_ast_body(symbol->declaration);
+        volt_loop_walk(&walk, walk.body);
+    }
+
+    return VOLT_SUCCESS;
+}
+
+void volt_loop_destroy(volt_semantic_analyzer_t* analyzer, volt_loop_t* loop) {
+    if (!loop)
+        return;
+
+    for (size_t i = 0; i < loop->captures.size; i++)
+        analyzer->allocator->free(volt_vector_get(&loop->captures, i));
+    volt_vector_deinit(&loop->captures);
+    analyzer->allocator->free(loop);
+}
+
+// REPORT
+
+void volt_loop_print(volt_semantic_analyzer_t* analyzer) {
+    printf("== loops ==\n");
+
+    for (size_t i = 0; i < analyzer->loops.size; i++) {
+        volt_loop_t*  loop  = volt_vector_get(&analyzer->loops, i);
+        volt_token_t* token = volt_ast_first_token(loop->node);
+        printf("%s:%zu (%s): ", analyzer->input_stream_names[loop->function->file_index],
+               token ? token->line : 0, loop->function->name);
+
+        if (loop->kind == VOLT_LOOP_RANGE) {
+            printf("counted %s%s%s", volt_loop_describe(loop->start),
+                   loop->inclusive ? "..=" : "..", volt_loop_describe(loop->end));
+            if (loop->constant)
+                printf(", %llu iteration(s)", (unsigned long long) loop->trip_count);
+            if (loop->source)
+                printf(", `%s` not materialized", volt_ast_get_identifier(loop->source));
+        } else {
+            printf("indexed over %s", volt_loop_describe(loop->iterable));
+        }
+
+        if (loop->transform)
+            printf(", transform inlined");
+        printf("%s\n", loop->vectorizable ? ", vectorizable" : "");
+
+        for (size_t j = 0; j < loop->captures.size; j++) {
+            volt_loop_capture_t* capture = volt_vector_get(&loop->captures, j);
+            volt_token_t*        escape  = volt_ast_first_token(capture->escape);
+            if (capture->in_register)
+                printf("  capture %s: register\n", capture->name);
+            else
+                printf("  capture %s: memory (address taken on line %zu)\n", capture->name,
+                       escape ? escape->line : 0);
+        }
+    }
+}
@@ -0,0 +1,319 @@
+#include <pch.h>
+#include <semantic/match.h>
+
+typedef struct volt_match_walk_t volt_match_walk_t;
+struct volt_match_walk_t {
+    volt_semantic_analyzer_t* analyzer;
+    volt_symbol_t*            function;
+};
+
+typedef enum {
+    VOLT_MATCH_PATTERN_VALUE,    // Integer or enum variant known at compile time
+    VOLT_MATCH_PATTERN_DEFAULT,  // `default`, or a guard that is always true
+    VOLT_MATCH_PATTERN_NEVER,    // A guard that is always false
+    VOLT_MATCH_PATTERN_RUNTIME,  // Only known at runtime
+} volt_match_pattern_kind_t;
+
+// HELPER FUNCTIONS
+
+static bool volt_match_is_default(volt_ast_node_t* pattern) {
+    if (volt_ast_find_token(pattern, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL))
+        return true;
+
+    volt_ast_node_t* primary = volt_ast_unwrap(volt_ast_find_child(pattern, "expression"));
+    if (!volt_ast_is(primary, "primary_expr") || primary->children.size != 1)
+        return false;
+    volt_token_t* token = volt_ast_find_token(primary, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    return token && strcmp(token->lexeme, "default") == 0;
+}
+
+// `Type::variant` as the discriminant it compares against: the index for enums, the error code
+// (index + 1, since 0 means success) for error sets
+static bool volt_match_variant(volt_semantic_analyzer_t* analyzer, volt_ast_node_t* expression,
+                               int64_t* value) {
+    volt_ast_node_t* postfix = volt_ast_unwrap(expression);
+    if (!volt_ast_is(postfix, "postfix_expr"))
+        return false;
+
+    volt_ast_node_t* rest   = volt_ast_find_child(postfix, "postfix_expr_rest");
+    volt_ast_node_t* access = volt_ast_find_child(volt_ast_find_child(rest, "postfix_op"),
+                                                  "member_access");
+    volt_ast_node_t* next   = volt_ast_find_child(rest, "postfix_expr_rest");
+    if (!access || !volt_ast_find_token(access, VOLT_TOKEN_TYPE_COLON_COLON) ||
+        (next && next->children.size != 0))
+        return false;
+
+    volt_ast_node_t* primary = volt_ast_get_child(postfix, 0);
+    volt_token_t*    owner   = volt_ast_find_token(primary, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    volt_token_t*    name    = volt_ast_find_token(access, VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL);
+    if (!owner || !name || primary->children.size != 1)
+        return false;
+
+    volt_symbol_t* symbol = volt_scope_lookup(analyzer->global_scope, owner->lexeme, false);
+    if (!symbol || symbol->kind != VOLT_SYMBOL_TYPE || !symbol->type ||
+        (symbol->type->kind != VOLT_TYPE_ENUM && symbol->type->kind != VOLT_TYPE_ERROR))
+        return false;
+
+    volt_small_vector_t* variants = &symbol->type->variants;
+    for (size_t i = 0; i < variants->size; i++) {
+        volt_symbol_t* variant = (volt_symbol_t*) volt_small_vector_get(variants, i);
+        if (variant->name && strcmp(variant->name, name->lexeme) == 0) {
+            *value = (int64_t) i + (symbol->type->kind == VOLT_TYPE_ERROR ? 1 : 0);
+            return true;
+        }
+    }
+    return false;
+}
+
+static volt_match_pattern_kind_t volt_match_classify(volt_semantic_analyzer_t* analyzer,
+                                                     volt_ast_node_t* expression,
+                                                     int64_t*         value) {
+    if (volt_match_variant(analyzer, expression, value))
+        return VOLT_MATCH_PATTERN_VALUE;
+
+    volt_comptime_value_t constant;
+    if (volt_comptime_eval(&analyzer->comptime, expression, NULL, 0, &constant) != VOLT_SUCCESS)
+        return VOLT_MATCH_PATTERN_RUNTIME;
+
+    switch (constant.kind) {
+        case VOLT_COMPTIME_VALUE_INT:
+            *value = constant.i;
+            return VOLT_MATCH_PATTERN_VALUE;
+        case VOLT_COMPTIME_VALUE_BOOL:
+            return constant.b ? VOLT_MATCH_PATTERN_DEFAULT : VOLT_MATCH_PATTERN_NEVER;
+        default:
+            return VOLT_MATCH_PATTERN_RUNTIME;
+    }
+}
+
+// Keeps `cases` sorted; returns false when the value is already taken by an earlier arm
+static bool volt_match_insert(volt_match_t* match, int64_t value, volt_ast_node_t* arm) {
+    size_t position = match->case_count;
+    while (position > 0 && match->cases[position - 1].value > value)
+        position--;
+    if (position > 0 && match->cases[position - 1].value == value)
+        return false;
+
+    memmove(&match->cases[position + 1], &match->cases[position],
+            (match->case_count - position) * sizeof(volt_match_case_t));
+    match->cases[position].value = value;
+    match->cases[position].arm   = arm;
+    match->case_count++;
+    return true;
+}
+
+// Greedy: each cluster extends as far as its table stays dense enough, and a run too short for
+// a table is left to the comparisons of the decision tree
+static void volt_match_cluster(volt_semantic_analyzer_t* analyzer, volt_match_t* match) {
+    match->clusters = analyzer->allocator->malloc(match->case_count * sizeof(volt_match_cluster_t));
+    if (!match->clusters)
+        return;
+
+    size_t first = 0;
+    while (first < match->case_count) {
+        size_t last = first;
+        for (size_t j = first + 1; j < match->case_count; j++) {
+            double span = (double) match->cases[j].value - (double) match->cases[first].value;
+            if ((double) (j - first + 1) / (span + 1.0) >= VOLT_MATCH_MIN_DENSITY)
+                last = j;
+        }
+
+        volt_match_cluster_t* cluster = &match->clusters[match->cluster_count++];
+        cluster->first                = first;
+        cluster->count                = last - first + 1;
+        cluster->is_table             = cluster->count >= VOLT_MATCH_MIN_TABLE_CASES;
+        if (!cluster->is_table)
+            cluster->count = 1;
+        first += cluster->count;
+    }
+}
+
+static void volt_match_choose(volt_semantic_analyzer_t* analyzer, volt_match_t* match,
+                              bool has_runtime) {
+    if (has_runtime || match->case_count < VOLT_MATCH_MIN_TABLE_CASES) {
+        match->strategy = VOLT_MATCH_COMPARES;
+        return;
+    }
+
+    volt_match_cluster(analyzer, match);
+    if (match->cluster_count == 1 && match->clusters[0].is_table) {
+        match->strategy = VOLT_MATCH_JUMP_TABLE;
+        return;
+    }
+
+    match->strategy = VOLT_MATCH_DECISION_TREE;
+    while (((size_t) 1 << match->tree_depth) < match->cluster_count)
+        match->tree_depth++;
+}
+
+// With the scrutinee known, the arm is picked here and the others are never emitted
+static bool volt_match_fold(volt_semantic_analyzer_t* analyzer, volt_match_t* match) {
+    volt_ast_node_t* scrutinee = volt_ast_find_child(match->node, "expression");
+    int64_t          value;
+    if (volt_match_classify(analyzer, scrutinee, &value) != VOLT_MATCH_PATTERN_VALUE)
+        return false;
+
+    match->strategy   = VOLT_MATCH_FOLDED;
+    match->folded_arm = match->default_arm;
+    for (size_t i = 0; i < match->case_count; i++) {
+        if (match->cases[i].value == value) {
+            match->folded_arm = match->cases[i].arm;
+            break;
+        }
+    }
+    return true;
+}
+
+static void volt_match_plan(volt_match_walk_t* walk, volt_ast_node_t* node) {
+    volt_semantic_analyzer_t* analyzer = walk->analyzer;
+    volt_match_t*             match    = analyzer->allocator->malloc(sizeof(volt_match_t));
+    if (!match)
+        return;
+
+    memset(match, 0, sizeof(volt_match_t));
+    match->node     = node;
+    match->function = walk->function;
+
+    volt_vector_t arms = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(node, "match_arms"), "match_arm", &arms);
+    match->arm_count = arms.size;
+    match->cases     = analyzer->allocator->malloc((arms.size + 1) * sizeof(volt_match_case_t));
+    if (!match->cases) {
+        volt_vector_deinit(&arms);
+        analyzer->allocator->free(match);
+        return;
+    }
+
+    bool has_runtime = false;
+    for (size_t i = 0; i < arms.size; i++) {
+        volt_ast_node_t* arm     = (volt_ast_node_t*) volt_vector_get(&arms, i);
+        volt_ast_node_t* pattern = volt_ast_find_child(arm, "match_pattern");
+        if (match->default_arm) {
+            match->dropped++;
+            continue;
+        }
+
+        int64_t                   value = 0;
+        volt_match_pattern_kind_t kind =
+            volt_match_is_default(pattern)
+                ? VOLT_MATCH_PATTERN_DEFAULT
+                : volt_match_classify(analyzer, volt_ast_find_child(pattern, "expression"), &value);
+        switch (kind) {
+            case VOLT_MATCH_PATTERN_VALUE:
+                if (!volt_match_insert(match, value, arm))
+                    match->dropped++;
+                break;
+            case VOLT_MATCH_PATTERN_DEFAULT:
+                match->default_arm = arm;
+                break;
+            case VOLT_MATCH_PATTERN_NEVER:
+                match->dropped++;
+                break;
+            case VOLT_MATCH_PATTERN_RUNTIME:
+                has_runtime = true;
+                break;
+        }
+    }
+    volt_vector_deinit(&arms);
+
+    if (has_runtime || !volt_match_fold(analyzer, match))
+        volt_match_choose(analyzer, match, has_runtime);
+
+    volt_vector_push_back(&analyzer->matches, match);
+}
+
+static void volt_match_walk(volt_match_walk_t* walk, volt_ast_node_t* node) {
+    if (!node || node->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    if (volt_ast_is(node, "match_stmt"))
+        volt_match_plan(walk, node);
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_match_walk(walk, volt_ast_get_child(node, i));
+}
+
+static size_t volt_match_arm_line(volt_ast_node_t* arm) {
+    volt_token_t* token = volt_ast_first_token(arm);
+    return token ? token->line : 0;
+}
+
+// LOWERING
+
+volt_status_code_t volt_match_lower_all(volt_semantic_analyzer_t* analyzer) {
+    if (!analyzer)
+        return VOLT_FAILURE;
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (symbol->kind != VOLT_SYMBOL_FUNCTION ||
+            !volt_semantic_checks(analyzer, symbol->declaration))
+            continue;
+
+        volt_match_walk_t walk = {0};
+        walk.analyzer          = analyzer;
+        walk.function          = symbol;
+        volt_match_walk(&walk, volt_ast_body(symbol->declaration));
+    }
+
+    return VOLT_SUCCESS;
+}
+
+void volt_match_destroy(volt_semantic_analyzer_t* analyzer, volt_match_t* match) {
+    if (!match)
+        return;
+
+    analyzer->allocator->free(match->cases);
+    if (match->clusters)
+        analyzer->allocator->free(match->clusters);
+    analyzer->allocator->free(match);
+}
+
+// REPORT
+
+void volt_match_print(volt_semantic_analyzer_t* analyzer) {
+    printf("== matches ==\n");
+
+    for (size_t i = 0; i < analyzer->matches.size; i++) {
+        volt_match_t* match = volt_vector_get(&analyzer->matches, i);
+        volt_token_t* token = volt_ast_first_token(match->node);
+        printf("%s:%zu (%s): ", analyzer->input_stream_names[match->function->file_index],
+               token ? token->line : 0, match->function->name);
+
+        switch (match->strategy) {
+            case VOLT_MATCH_FOLDED:
+                if (match->folded_arm)
+                    printf("folded to the arm on line %zu", volt_match_arm_line(match->folded_arm));
+                else
+                    printf("folded, no arm matches");
+                break;
+            case VOLT_MATCH_COMPARES:
+                printf("%zu comparison(s) in order", match->arm_count - match->dropped -
+                                                         (match->default_arm ? 1 : 0));
+                break;
+            case VOLT_MATCH_JUMP_TABLE:
+                printf("jump table %lld..%lld, %zu case(s)", (long long) match->cases[0].value,
+                       (long long) match->cases[match->case_count - 1].value, match->case_count);
+                break;
+            case VOLT_MATCH_DECISION_TREE:
+                printf("decision tree, depth %zu:", match->tree_depth);
+                for (size_t j = 0; j < match->cluster_count; j++) {
+                    volt_match_cluster_t* cluster = &match->clusters[j];
+                    volt_match_case_t*    first   = &match->cases[cluster->first];
+                    if (cluster->is_table)
+                        printf("%s table %lld..%lld", j ? "," : "", (long long) first->value,
+                               (long long) first[cluster->count - 1].value);
+                    else
+                        printf("%s %lld", j ? "," : "", (long long) first->value);
+                }
+                break;
+        }
+
+        if (match->default_arm && match->strategy != VOLT_MATCH_FOLDED)
+            printf(", default");
+        if (match->dropped)
+            printf(", %zu unreachable arm(s) dropped", match->dropped);
+        printf("\n");
+    }
+}
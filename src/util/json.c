@@ -0,0 +1,357 @@
+#include <pch.h>
+#include <util/json.h>
+
+// Nesting deeper than this is rejected rather than recursed into
+#define VOLT_JSON_MAX_DEPTH 256
+
+typedef struct volt_json_reader_t volt_json_reader_t;
+struct volt_json_reader_t {
+    volt_arena_t* arena;
+    const char*   at;
+    const char*   end;
+    size_t        depth;
+};
+
+// READING
+
+static void volt_json_skip_space(volt_json_reader_t* reader) {
+    while (reader->at < reader->end && (*reader->at == ' ' || *reader->at == '\t' ||
+                                        *reader->at == '\n' || *reader->at == '\r'))
+        reader->at++;
+}
+
+static bool volt_json_expect(volt_json_reader_t* reader, const char* word) {
+    size_t length = strlen(word);
+    if ((size_t) (reader->end - reader->at) < length || memcmp(reader->at, word, length) != 0)
+        return false;
+    reader->at += length;
+    return true;
+}
+
+static int32_t volt_json_hex4(const char* at) {
+    int32_t value = 0;
+    for (size_t i = 0; i < 4; i++) {
+        char c = at[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9')
+            value |= c - '0';
+        else if (c >= 'a' && c <= 'f')
+            value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            value |= c - 'A' + 10;
+        else
+            return -1;
+    }
+    return value;
+}
+
+static size_t volt_json_put_utf8(char* out, uint32_t code) {
+    if (code < 0x80) {
+        out[0] = (char) code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char) (0xC0 | (code >> 6));
+        out[1] = (char) (0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char) (0xE0 | (code >> 12));
+        out[1] = (char) (0x80 | ((code >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (code & 0x3F));
+        return 3;
+    }
+    out[0] = (char) (0xF0 | (code >> 18));
+    out[1] = (char) (0x80 | ((code >> 12) & 0x3F));
+    out[2] = (char) (0x80 | ((code >> 6) & 0x3F));
+    out[3] = (char) (0x80 | (code & 0x3F));
+    return 4;
+}
+
+// Unescapes the string starting at the opening quote. Escapes never grow, so the raw length
+// bounds the output.
+static const char* volt_json_read_string(volt_json_reader_t* reader, size_t* length) {
+    const char* start = ++reader->at;
+    const char* close = start;
+    while (close < reader->end && *close != '"')
+        close += *close == '\\' ? 2 : 1;
+    if (close >= reader->end)
+        return NULL;
+
+    char* out = volt_arena_alloc(reader->arena, (size_t) (close - start) + 1);
+    if (!out)
+        return NULL;
+
+    size_t      size = 0;
+    const char* at   = start;
+    while (at < close) {
+        if (*at != '\\') {
+            out[size++] = *at++;
+            continue;
+        }
+
+        char escape = at[1];
+        at += 2;
+        switch (escape) {
+            case '"':
+            case '\\':
+            case '/':
+                out[size++] = escape;
+                break;
+            case 'b':
+                out[size++] = '\b';
+                break;
+            case 'f':
+                out[size++] = '\f';
+                break;
+            case 'n':
+                out[size++] = '\n';
+                break;
+            case 'r':
+                out[size++] = '\r';
+                break;
+            case 't':
+                out[size++] = '\t';
+                break;
+            case 'u': {
+                int32_t unit = close - at >= 4 ? volt_json_hex4(at) : -1;
+                if (unit < 0)
+                    return NULL;
+                at += 4;
+
+                // A high surrogate followed by a low one is a single code point
+                uint32_t code = (uint32_t) unit;
+                if (code >= 0xD800 && code < 0xDC00 && close - at >= 6 && at[0] == '\\' &&
+                    at[1] == 'u') {
+                    int32_t low = volt_json_hex4(at + 2);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + ((uint32_t) low - 0xDC00);
+                        at += 6;
+                    }
+                }
+                size += volt_json_put_utf8(out + size, code);
+                break;
+            }
+            default:
+                return NULL;
+        }
+    }
+
+    out[size]  = '\0';
+    *length    = size;
+    reader->at = close + 1;
+    return out;
+}
+
+static volt_json_t* volt_json_read_value(volt_json_reader_t* reader);
+
+// Elements of an array or members of an object, the opening bracket already consumed
+static bool volt_json_read_children(volt_json_reader_t* reader, volt_json_t* parent, char close) {
+    volt_json_t** link = &parent->first;
+
+    volt_json_skip_space(reader);
+    if (reader->at < reader->end && *reader->at == close) {
+        reader->at++;
+        return true;
+    }
+
+    for (;;) {
+        const char* key    = NULL;
+        size_t      length = 0;
+        if (parent->kind == VOLT_JSON_OBJECT) {
+            volt_json_skip_space(reader);
+            if (reader->at >= reader->end || *reader->at != '"')
+                return false;
+            key = volt_json_read_string(reader, &length);
+            volt_json_skip_space(reader);
+            if (!key || reader->at >= reader->end || *reader->at != ':')
+                return false;
+            reader->at++;
+        }
+
+        volt_json_t* child = volt_json_read_value(reader);
+        if (!child)
+            return false;
+        child->key = key;
+        *link      = child;
+        link       = &child->next;
+
+        volt_json_skip_space(reader);
+        if (reader->at >= reader->end)
+            return false;
+        if (*reader->at == close) {
+            reader->at++;
+            return true;
+        }
+        if (*reader->at != ',')
+            return false;
+        reader->at++;
+    }
+}
+
+static volt_json_t* volt_json_read_value(volt_json_reader_t* reader) {
+    volt_json_skip_space(reader);
+    if (reader->at >= reader->end || reader->depth >= VOLT_JSON_MAX_DEPTH)
+        return NULL;
+
+    volt_json_t* value = volt_arena_alloc(reader->arena, sizeof(volt_json_t));
+    if (!value)
+        return NULL;
+    memset(value, 0, sizeof(volt_json_t));
+
+    char c = *reader->at;
+    if (c == '{' || c == '[') {
+        value->kind = c == '{' ? VOLT_JSON_OBJECT : VOLT_JSON_ARRAY;
+        reader->at++;
+        reader->depth++;
+        bool read = volt_json_read_children(reader, value, c == '{' ? '}' : ']');
+        reader->depth--;
+        return read ? value : NULL;
+    }
+    if (c == '"') {
+        value->kind   = VOLT_JSON_STRING;
+        value->string = volt_json_read_string(reader, &value->length);
+        return value->string ? value : NULL;
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        // The text ends in a NUL, so strtod cannot run past it
+        char* after   = NULL;
+        value->kind   = VOLT_JSON_NUMBER;
+        value->number = strtod(reader->at, &after);
+        if (!after || after == reader->at || after > reader->end)
+            return NULL;
+        reader->at = after;
+        return value;
+    }
+    if (volt_json_expect(reader, "true")) {
+        value->kind    = VOLT_JSON_BOOL;
+        value->boolean = true;
+        return value;
+    }
+    if (volt_json_expect(reader, "false")) {
+        value->kind = VOLT_JSON_BOOL;
+        return value;
+    }
+    if (volt_json_expect(reader, "null"))
+        return value;
+    return NULL;
+}
+
+volt_json_t* volt_json_parse(volt_arena_t* arena, const char* text, size_t length) {
+    if (!arena || !text)
+        return NULL;
+
+    volt_json_reader_t reader = {.arena = arena, .at = text, .end = text + length};
+    volt_json_t*       value  = volt_json_read_value(&reader);
+    volt_json_skip_space(&reader);
+    return reader.at == reader.end ? value : NULL;
+}
+
+volt_json_t* volt_json_get(volt_json_t* object, const char* key) {
+    if (!object || object->kind != VOLT_JSON_OBJECT)
+        return NULL;
+    for (volt_json_t* member = object->first; member; member = member->next) {
+        if (strcmp(member->key, key) == 0)
+            return member;
+    }
+    return NULL;
+}
+
+const char* volt_json_string(volt_json_t* value) {
+    return value && value->kind == VOLT_JSON_STRING ? value->string : NULL;
+}
+
+int64_t volt_json_int(volt_json_t* value, int64_t fallback) {
+    return value && value->kind == VOLT_JSON_NUMBER ? (int64_t) value->number : fallback;
+}
+
+// WRITING
+
+void volt_json_write_raw(volt_json_text_vector_t* out, const char* text) {
+    volt_json_text_vector_append_range(out, text, strlen(text));
+}
+
+void volt_json_write_string(volt_json_text_vector_t* out, const char* text, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+
+    volt_json_text_vector_push_back(out, '"');
+    size_t plain = 0;  // Start of the run copied as is
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char) text[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        volt_json_text_vector_append_range(out, text + plain, i - plain);
+        plain = i + 1;
+
+        char escape[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+        switch (c) {
+            case '"':
+            case '\\':
+                escape[1] = (char) c;
+                volt_json_text_vector_append_range(out, escape, 2);
+                break;
+            case '\n':
+                volt_json_write_raw(out, "\\n");
+                break;
+            case '\r':
+                volt_json_write_raw(out, "\\r");
+                break;
+            case '\t':
+                volt_json_write_raw(out, "\\t");
+                break;
+            default:
+                volt_json_text_vector_append_range(out, escape, sizeof(escape));
+                break;
+        }
+    }
+    volt_json_text_vector_append_range(out, text + plain, length - plain);
+    volt_json_text_vector_push_back(out, '"');
+}
+
+void volt_json_write_int(volt_json_text_vector_t* out, int64_t value) {
+    char number[32];
+    int  length = snprintf(number, sizeof(number), "%" PRId64, value);
+    volt_json_text_vector_append_range(out, number, length > 0 ? (size_t) length : 0);
+}
+
+void volt_json_write_value(volt_json_text_vector_t* out, volt_json_t* value) {
+    if (!value) {
+        volt_json_write_raw(out, "null");
+        return;
+    }
+
+    switch (value->kind) {
+        case VOLT_JSON_NULL:
+            volt_json_write_raw(out, "null");
+            break;
+        case VOLT_JSON_BOOL:
+            volt_json_write_raw(out, value->boolean ? "true" : "false");
+            break;
+        case VOLT_JSON_NUMBER: {
+            char number[32];
+            int  length = snprintf(number, sizeof(number), "%.17g", value->number);
+            volt_json_text_vector_append_range(out, number, length > 0 ? (size_t) length : 0);
+            break;
+        }
+        case VOLT_JSON_STRING:
+            volt_json_write_string(out, value->string, value->length);
+            break;
+        case VOLT_JSON_ARRAY:
+        case VOLT_JSON_OBJECT: {
+            bool object = value->kind == VOLT_JSON_OBJECT;
+            volt_json_text_vector_push_back(out, object ? '{' : '[');
+            for (volt_json_t* child = value->first; child; child = child->next) {
+                if (child != value->first)
+                    volt_json_text_vector_push_back(out, ',');
+                if (object) {
+                    volt_json_write_string(out, child->key, strlen(child->key));
+                    volt_json_text_vector_push_back(out, ':');
+                }
+                volt_json_write_value(out, child);
+            }
+            volt_json_text_vector_push_back(out, object ? '}' : ']');
+            break;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <pch.h>
+#include <util/memory/arena.h>
+
+volt_status_code_t volt_arena_init(volt_arena_t* arena, volt_allocator_t* allocator) {
+    if (!arena)
+        return VOLT_FAILURE;
+
+    arena->head      = NULL;
+    arena->current   = NULL;
+    arena->allocator = allocator ? allocator : &volt_default_allocator;
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_arena_deinit(volt_arena_t* arena) {
+    if (!arena || !arena->allocator)
+        return VOLT_FAILURE;
+
+    volt_arena_chunk_t* chunk = arena->head;
+    while (chunk) {
+        volt_arena_chunk_t* next = chunk->next;
+        arena->allocator->free(chunk);
+        chunk = next;
+    }
+
+    arena->head    = NULL;
+    arena->current = NULL;
+    return VOLT_SUCCESS;
+}
+
+void* volt_arena_alloc(volt_arena_t* arena, size_t size) {
+    if (!arena)
+        return NULL;
+
+    // Rounding up, or adding the chunk header, must not wrap around to a small size
+    if (size > SIZE_MAX - sizeof(volt_arena_chunk_t) - VOLT_ARENA_ALIGN)
+        return NULL;
+    size = (size + VOLT_ARENA_ALIGN - 1) & ~(VOLT_ARENA_ALIGN - 1);
+
+    volt_arena_chunk_t* chunk = arena->current;
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        // Move on to the chunk after this one, kept from before a release, or splice in a new one
+        volt_arena_chunk_t* next = chunk ? chunk->next : arena->head;
+        if (!next || next->capacity < size) {
+            size_t capacity = size > VOLT_ARENA_CHUNK_SIZE ? size : VOLT_ARENA_CHUNK_SIZE;
+
+            volt_arena_chunk_t* fresh =
+                arena->allocator->malloc(sizeof(volt_arena_chunk_t) + capacity);
+            if (!fresh)
+                return NULL;
+
+            fresh->capacity = capacity;
+            fresh->next     = next;
+            if (chunk)
+                chunk->next = fresh;
+            else
+                arena->head = fresh;
+            next = fresh;
+        }
+
+        next->used     = 0;
+        arena->current = next;
+        chunk          = next;
+    }
+
+    void* ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    return ptr;
+}
+
+volt_arena_mark_t volt_arena_mark(volt_arena_t* arena) {
+    volt_arena_mark_t mark = {0};
+    if (arena && arena->current) {
+        mark.chunk = arena->current;
+        mark.used  = arena->current->used;
+    }
+    return mark;
+}
+
+void volt_arena_release(volt_arena_t* arena, volt_arena_mark_t mark) {
+    if (!arena)
+        return;
+
+    arena->current = mark.chunk;
+    if (mark.chunk)
+        mark.chunk->used = mark.used;
+}
@@ -0,0 +1,123 @@
+#include <pch.h>
+#include <util/types/small_vector.h>
+
+#include "util/memory/allocator.h"
+#include "util/types/types.h"
+
+volt_small_vector_t volt_small_vector_default(void) {
+    volt_small_vector_t vector = {0};
+    vector.capacity            = VOLT_SMALL_VECTOR_INLINE;
+    vector.allocator           = &volt_default_allocator;
+    return vector;
+}
+
+volt_status_code_t volt_small_vector_init(volt_small_vector_t* v) {
+    if (!v)
+        return VOLT_FAILURE;
+    v->size      = 0;
+    v->capacity  = VOLT_SMALL_VECTOR_INLINE;
+    v->allocator = v->allocator ? v->allocator : &volt_default_allocator;
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_small_vector_ensure(volt_small_vector_t* v, size_t extra) {
+    if (!v || !v->allocator)
+        return VOLT_FAILURE;
+
+    // Need at least v->size + extra slots
+    size_t capacity = v->capacity > VOLT_SMALL_VECTOR_INLINE ? v->capacity
+                                                             : VOLT_SMALL_VECTOR_INLINE;
+    if (v->size + extra <= capacity)
+        return VOLT_SUCCESS;
+
+    size_t new_cap = capacity * 2;
+    while (new_cap < v->size + extra)
+        new_cap *= 2;
+
+    void** new_data;
+    if (capacity > VOLT_SMALL_VECTOR_INLINE) {
+        new_data = v->allocator->realloc(v->heap, new_cap * sizeof(void*));
+        if (!new_data)
+            return VOLT_FAILURE;
+    } else {
+        // Spilling: the inline slots are overwritten by the heap pointer once copied out
+        new_data = v->allocator->malloc(new_cap * sizeof(void*));
+        if (!new_data)
+            return VOLT_FAILURE;
+        memcpy(new_data, v->items, v->size * sizeof(void*));
+    }
+
+    v->heap     = new_data;
+    v->capacity = new_cap;
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_small_vector_insert(volt_small_vector_t* v, size_t index, void* item) {
+    if (!v || index > v->size || volt_small_vector_ensure(v, 1) != VOLT_SUCCESS)
+        return VOLT_FAILURE;
+
+    void** data = volt_small_vector_data(v);
+    memmove(&data[index + 1], &data[index], (v->size - index) * sizeof(void*));
+
+    data[index] = item;
+    v->size += 1;
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_small_vector_push_back(volt_small_vector_t* v, void* item) {
+    return volt_small_vector_insert(v, v->size, item);
+}
+
+volt_status_code_t volt_small_vector_remove(volt_small_vector_t* v, size_t index) {
+    if (!v || index >= v->size)
+        return VOLT_FAILURE;
+
+    void** data = volt_small_vector_data(v);
+    void*  item = data[index];
+    if (index + 1 < v->size)
+        memmove(&data[index], &data[index + 1], (v->size - index - 1) * sizeof(void*));
+
+    v->size -= 1;
+
+    if (v->item_allocator && item) {
+        v->item_allocator->free(item);
+    }
+    return VOLT_SUCCESS;
+}
+
+volt_status_code_t volt_small_vector_pop_back(volt_small_vector_t* v) {
+    if (!v || v->size == 0)
+        return VOLT_FAILURE;
+    return volt_small_vector_remove(v, v->size - 1);
+}
+
+void* volt_small_vector_get(volt_small_vector_t* v, size_t index) {
+    if (!v || index >= v->size)
+        return NULL;
+    return volt_small_vector_data(v)[index];
+}
+
+void* volt_small_vector_get_back(volt_small_vector_t* v) {
+    if (!v || v->size == 0)
+        return NULL;
+    return volt_small_vector_data(v)[v->size - 1];
+}
+
+volt_status_code_t volt_small_vector_deinit(volt_small_vector_t* v) {
+    if (!v || !v->allocator)
+        return VOLT_FAILURE;
+
+    void** data = volt_small_vector_data(v);
+    if (v->item_allocator) {
+        for (size_t i = 0; i < v->size; i++) {
+            if (data[i])
+                v->item_allocator->free(data[i]);
+        }
+    }
+    if (v->capacity > VOLT_SMALL_VECTOR_INLINE)
+        v->allocator->free(v->heap);
+    v->heap     = NULL;
+    v->size     = 0;
+    v->capacity = VOLT_SMALL_VECTOR_INLINE;
+    return VOLT_SUCCESS;
+}
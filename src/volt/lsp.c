@@ -0,0 +1,1291 @@
+#include <pch.h>
+#include <time.h>
+#include <util/json.h>
+#include <volt/lsp.h>
+
+#if defined(_WIN32)
+#    include <fcntl.h>
+#    include <io.h>
+#endif
+
+// Largest message body accepted; a longer one is skipped and answered with a parse error
+#define VOLT_LSP_MAX_CONTENT_LENGTH ((size_t) 64 * 1024 * 1024)
+
+// JSON-RPC error codes
+#define VOLT_LSP_PARSE_ERROR      -32700
+#define VOLT_LSP_INVALID_REQUEST  -32600
+#define VOLT_LSP_METHOD_NOT_FOUND -32601
+
+// A semantic error kept with the item it was reported in. Its line counts from the item's first
+// line, so edits above the item move it without the item being analyzed again.
+typedef struct volt_lsp_diagnostic_t volt_lsp_diagnostic_t;
+struct volt_lsp_diagnostic_t {
+    size_t line;
+    size_t column;  // In bytes, from 1
+    char*  message;
+};
+
+VOLT_VECTOR_DEFINE(lsp_diagnostic, volt_lsp_diagnostic_t)
+VOLT_VECTOR_DEFINE(lsp_hash, uint64_t)
+VOLT_VECTOR_DEFINE(lsp_offset, size_t)
+VOLT_VECTOR_DEFINE(lsp_sample, double)
+
+// What is known about a top-level item between analyses; `items` of a document line up with
+// the items of its parser. Sets of names are sorted hashes of the identifiers.
+typedef struct volt_lsp_item_t volt_lsp_item_t;
+struct volt_lsp_item_t {
+    volt_ast_node_t*             node;
+    uint64_t                     signature;   // Its tokens outside function bodies
+    uint64_t                     content;     // All its tokens, and where they are in it
+    volt_lsp_hash_vector_t       names;       // Names it declares
+    volt_lsp_hash_vector_t       interface;   // Identifiers in its signature
+    volt_lsp_hash_vector_t       references;  // Every identifier it mentions
+    volt_lsp_diagnostic_vector_t diagnostics;
+    bool                         dirty;       // Body checked by the next analysis
+    bool                         broken;      // Had a syntax error, reported again on checking
+    bool                         propagated;  // Names already marked changed in this update
+};
+
+VOLT_VECTOR_DEFINE(lsp_item, volt_lsp_item_t)
+
+typedef struct volt_lsp_document_t volt_lsp_document_t;
+struct volt_lsp_document_t {
+    char*                        uri;
+    char*                        path;
+    volt_lexer_t                 lexer;
+    volt_parser_t                parser;      // Skipped bodies point at it: documents never move
+    volt_error_handler_t         syntax;      // Lexer and parser errors of the current text
+    size_t                       generation;  // Parser generation `items` were matched against
+    volt_lsp_item_vector_t       items;
+    volt_lsp_offset_vector_t     lines;       // Offset of each line of the text
+    volt_lsp_diagnostic_vector_t loose;       // Semantic errors outside any item; absolute lines
+    volt_json_text_vector_t      published;   // Diagnostics as last sent
+    bool                         loaded;
+    bool                         workspace;   // Named on the command line; reloaded when closed
+};
+
+// Latencies of one method, for --lsp-replay
+typedef struct volt_lsp_timing_t volt_lsp_timing_t;
+struct volt_lsp_timing_t {
+    char                     method[64];
+    volt_lsp_sample_vector_t samples;  // Milliseconds
+};
+
+VOLT_VECTOR_DEFINE(lsp_timing, volt_lsp_timing_t)
+
+typedef struct volt_lsp_server_t volt_lsp_server_t;
+struct volt_lsp_server_t {
+    volt_compiler_t*         compiler;
+    volt_allocator_t*        allocator;
+    volt_vector_t            documents;  // volt_lsp_document_t*
+    volt_lsp_hash_vector_t   changed;    // Names whose declaration changed since the last analysis
+    volt_ast_node_vector_t   checked;    // Declarations the next analysis checks, sorted
+    volt_ast_node_t**        asts;       // Held by the resident analyzer
+    const char**             names;
+    volt_arena_t             arena;    // The message being handled
+    volt_json_text_vector_t  output;   // The message being written
+    volt_json_text_vector_t  scratch;  // Diagnostics of one document
+    FILE*                    in;
+    FILE*                    out;  // NULL when replaying
+    bool                     shutdown;
+    bool                     exit;
+    volt_lsp_timing_vector_t timings;
+};
+
+// SETS OF NAMES
+
+static uint64_t volt_lsp_hash(const char* name) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const unsigned char* c = (const unsigned char*) name; c && *c; c++)
+        hash = (hash ^ *c) * 0x100000001B3ull;
+    return hash;
+}
+
+static int volt_lsp_compare_hash(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+    return x < y ? -1 : x > y;
+}
+
+// Sorts and drops duplicates
+static void volt_lsp_hash_normalize(volt_lsp_hash_vector_t* hashes) {
+    if (hashes->size < 2)
+        return;
+
+    qsort(hashes->data, hashes->size, sizeof(uint64_t), volt_lsp_compare_hash);
+    size_t kept = 1;
+    for (size_t i = 1; i < hashes->size; i++) {
+        if (hashes->data[i] != hashes->data[kept - 1])
+            hashes->data[kept++] = hashes->data[i];
+    }
+    hashes->size = kept;
+}
+
+// Both sorted; the smaller one is looked up in the larger
+static bool volt_lsp_hash_intersects(volt_lsp_hash_vector_t* a, volt_lsp_hash_vector_t* b) {
+    if (a->size > b->size) {
+        volt_lsp_hash_vector_t* swap = a;
+        a                            = b;
+        b                            = swap;
+    }
+    for (size_t i = 0; i < a->size; i++) {
+        if (bsearch(&a->data[i], b->data, b->size, sizeof(uint64_t), volt_lsp_compare_hash))
+            return true;
+    }
+    return false;
+}
+
+// ITEMS
+
+// The declaration an item wraps, past its attributes
+static volt_ast_node_t* volt_lsp_declaration(volt_ast_node_t* item) {
+    return item && item->children.size > 0
+               ? volt_ast_get_child(item, item->children.size - 1)
+               : NULL;
+}
+
+static bool volt_lsp_is_identifier(volt_ast_node_t* node) {
+    return node && node->type == VOLT_AST_NODE_TOKEN && node->token &&
+           node->token->type == VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL;
+}
+
+// Its own identifiers, and those of the declarations nested in it (namespace members, attached
+// methods)
+static void volt_lsp_declared_names(volt_ast_node_t* declaration, volt_lsp_hash_vector_t* names) {
+    if (!declaration || declaration->type != VOLT_AST_NODE_EXPRESSION)
+        return;
+
+    for (size_t i = 0; i < declaration->children.size; i++) {
+        volt_ast_node_t* child = volt_ast_get_child(declaration, i);
+        if (volt_lsp_is_identifier(child)) {
+            volt_lsp_hash_vector_push_back(names, volt_lsp_hash(child->token->lexeme));
+        } else if (volt_ast_is(child, "items")) {
+            volt_vector_t items = volt_vector_default();
+            volt_ast_collect_list(child, "item", &items);
+            for (size_t j = 0; j < items.size; j++)
+                volt_lsp_declared_names(volt_lsp_declaration(volt_vector_get(&items, j)), names);
+            volt_vector_deinit(&items);
+        }
+    }
+}
+
+// Function bodies are left out, so editing one leaves the signature as it was
+static void volt_lsp_signature(volt_ast_node_t* node, uint64_t* hash,
+                               volt_lsp_hash_vector_t* interface) {
+    if (!node || volt_ast_is(node, "block"))
+        return;
+
+    if (node->type == VOLT_AST_NODE_TOKEN) {
+        if (!node->token)
+            return;
+        uint64_t lexeme = volt_lsp_hash(node->token->lexeme);
+        *hash           = (*hash ^ lexeme ^ (uint64_t) node->token->type) * 0x100000001B3ull;
+        if (node->token->type == VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL)
+            volt_lsp_hash_vector_push_back(interface, lexeme);
+        return;
+    }
+
+    for (size_t i = 0; i < node->children.size; i++)
+        volt_lsp_signature(volt_ast_get_child(node, i), hash, interface);
+}
+
+static void volt_lsp_summarize(volt_lsp_server_t* server, volt_lsp_document_t* document,
+                               size_t index, volt_lsp_item_t* item) {
+    volt_parser_item_t* parsed = &document->parser.items.data[index];
+    volt_token_vector_t* tokens = &document->lexer.tokens;
+
+    memset(item, 0, sizeof(volt_lsp_item_t));
+    item->node                  = parsed->node;
+    item->dirty                 = true;
+    item->names.allocator       = server->allocator;
+    item->interface.allocator   = server->allocator;
+    item->references.allocator  = server->allocator;
+    item->diagnostics.allocator = server->allocator;
+    volt_lsp_hash_vector_init(&item->names);
+    volt_lsp_hash_vector_init(&item->interface);
+    volt_lsp_hash_vector_init(&item->references);
+    volt_lsp_diagnostic_vector_init(&item->diagnostics);
+
+    volt_ast_node_t* declaration = volt_lsp_declaration(parsed->node);
+    item->signature              = 0xCBF29CE484222325ull;
+    volt_lsp_signature(declaration, &item->signature, &item->interface);
+    volt_lsp_hash_normalize(&item->interface);
+    volt_lsp_declared_names(declaration, &item->names);
+    volt_lsp_hash_normalize(&item->names);
+
+    // Bodies are read from the tokens: a lazily parsed one has no nodes yet
+    size_t first   = parsed->start < tokens->size ? tokens->data[parsed->start].line : 0;
+    item->content  = 0xCBF29CE484222325ull;
+    for (size_t i = parsed->start; i < parsed->end && i < tokens->size; i++) {
+        volt_token_t* token  = &tokens->data[i];
+        uint64_t      lexeme = volt_lsp_hash(token->lexeme);
+        item->content = (item->content ^ lexeme ^ (uint64_t) token->type) * 0x100000001B3ull;
+        item->content = (item->content ^ (token->line - first) ^ ((uint64_t) token->column << 32)) *
+                        0x100000001B3ull;
+        if (token->type == VOLT_TOKEN_TYPE_IDENTIFIER_LITERAL)
+            volt_lsp_hash_vector_push_back(&item->references, lexeme);
+    }
+    volt_lsp_hash_normalize(&item->references);
+}
+
+static void volt_lsp_diagnostics_clear(volt_lsp_server_t*            server,
+                                       volt_lsp_diagnostic_vector_t* diagnostics) {
+    for (size_t i = 0; i < diagnostics->size; i++)
+        server->allocator->free(diagnostics->data[i].message);
+    volt_lsp_diagnostic_vector_clear(diagnostics);
+}
+
+static void volt_lsp_item_deinit(volt_lsp_server_t* server, volt_lsp_item_t* item) {
+    volt_lsp_diagnostics_clear(server, &item->diagnostics);
+    volt_lsp_diagnostic_vector_deinit(&item->diagnostics);
+    volt_lsp_hash_vector_deinit(&item->names);
+    volt_lsp_hash_vector_deinit(&item->interface);
+    volt_lsp_hash_vector_deinit(&item->references);
+}
+
+// Pairs removed items with the inserted ones they became. One laid out exactly as before was
+// only reparsed (a full parse replaces every node), and takes over the diagnostics of its twin
+// without being checked again, unless the twin had a syntax error: bodies are parsed when they
+// are checked, so that is the only way to see it again. One with the same signature only had
+// its body edited. The names declared by the rest changed, and whatever mentions them has to be
+// checked again.
+static void volt_lsp_pair(volt_lsp_server_t* server, volt_lsp_item_t* removed,
+                          size_t removed_count, volt_lsp_item_t* inserted, size_t inserted_count) {
+    bool* paired = server->allocator->malloc(removed_count + inserted_count + 1);
+    if (!paired)
+        return;
+    memset(paired, 0, removed_count + inserted_count + 1);
+    bool* matched = paired + removed_count;
+
+    // Both run in document order, so a twin is looked for from just past the previous one
+    size_t from = 0;
+    for (size_t i = 0; i < inserted_count; i++) {
+        for (size_t k = 0; k < removed_count; k++) {
+            size_t twin = (from + k) % removed_count;
+            if (paired[twin] || removed[twin].broken ||
+                removed[twin].content != inserted[i].content)
+                continue;
+
+            volt_lsp_diagnostic_vector_t diagnostics = inserted[i].diagnostics;
+            inserted[i].diagnostics                  = removed[twin].diagnostics;
+            removed[twin].diagnostics                = diagnostics;
+            inserted[i].dirty                        = false;
+            paired[twin]                             = true;
+            matched[i]                               = true;
+            from                                     = twin + 1;
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < inserted_count; i++) {
+        if (matched[i])
+            continue;
+
+        size_t twin = 0;
+        while (twin < removed_count &&
+               (paired[twin] || removed[twin].signature != inserted[i].signature))
+            twin++;
+        if (twin < removed_count) {
+            paired[twin] = true;
+            continue;
+        }
+        volt_lsp_hash_vector_append_range(&server->changed, inserted[i].names.data,
+                                          inserted[i].names.size);
+    }
+
+    for (size_t i = 0; i < removed_count; i++) {
+        if (!paired[i])
+            volt_lsp_hash_vector_append_range(&server->changed, removed[i].names.data,
+                                              removed[i].names.size);
+    }
+    server->allocator->free(paired);
+}
+
+// Lines the document's items up with its parser's again after an edit. Items the parser kept
+// are the same nodes and keep what is known about them; the ones between them are summarized
+// afresh and marked dirty. A full parse replaces every node, so nothing is kept then.
+static void volt_lsp_refresh(volt_lsp_server_t* server, volt_lsp_document_t* document) {
+    volt_lsp_item_vector_t*    old    = &document->items;
+    volt_parser_item_vector_t* parsed = &document->parser.items;
+
+    size_t prefix = 0;
+    size_t suffix = 0;
+    if (document->generation == document->parser.generation) {
+        while (prefix < old->size && prefix < parsed->size &&
+               old->data[prefix].node == parsed->data[prefix].node)
+            prefix++;
+        while (suffix < old->size - prefix && suffix < parsed->size - prefix &&
+               old->data[old->size - 1 - suffix].node ==
+                   parsed->data[parsed->size - 1 - suffix].node)
+            suffix++;
+    }
+    document->generation = document->parser.generation;
+
+    size_t removed_end  = old->size - suffix;
+    size_t inserted_end = parsed->size - suffix;
+
+    volt_lsp_item_vector_t items = {.allocator = server->allocator};
+    volt_lsp_item_vector_init(&items);
+    volt_lsp_item_vector_reserve(&items, parsed->size);
+    volt_lsp_item_vector_append_range(&items, old->data, prefix);
+    for (size_t i = prefix; i < inserted_end; i++) {
+        volt_lsp_item_t item;
+        volt_lsp_summarize(server, document, i, &item);
+        volt_lsp_item_vector_push_back(&items, item);
+    }
+    volt_lsp_item_vector_append_range(&items, old->data + removed_end, suffix);
+
+    volt_lsp_pair(server, old->data + prefix, removed_end - prefix, items.data + prefix,
+                  inserted_end - prefix);
+
+    for (size_t i = prefix; i < removed_end; i++)
+        volt_lsp_item_deinit(server, &old->data[i]);
+    volt_lsp_item_vector_deinit(old);
+    *old = items;
+
+    volt_lsp_offset_vector_clear(&document->lines);
+    volt_lsp_offset_vector_push_back(&document->lines, 0);
+    for (size_t i = 0; i < document->lexer.input_stream_length; i++) {
+        if (document->lexer.input_stream[i] == '\n')
+            volt_lsp_offset_vector_push_back(&document->lines, i + 1);
+    }
+}
+
+// Line of an item's first token
+static size_t volt_lsp_item_line(volt_lsp_document_t* document, size_t index) {
+    size_t start = document->parser.items.data[index].start;
+    return start < document->lexer.tokens.size ? document->lexer.tokens.data[start].line : 0;
+}
+
+// The last item starting on or before `line`, SIZE_MAX when there is none
+static size_t volt_lsp_item_at(volt_lsp_document_t* document, size_t line) {
+    size_t low  = 0;
+    size_t high = document->items.size;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (volt_lsp_item_line(document, middle) <= line)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low > 0 && line > 0 ? low - 1 : SIZE_MAX;
+}
+
+// DOCUMENTS
+
+static char* volt_lsp_strndup(volt_lsp_server_t* server, const char* text, size_t length) {
+    char* copy = server->allocator->malloc(length + 1);
+    if (!copy)
+        return NULL;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+static char* volt_lsp_read_file(volt_lsp_server_t* server, const char* path) {
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+        return NULL;
+
+    fseek(fp, 0L, SEEK_END);
+    long size = ftell(fp);
+    rewind(fp);
+
+    char* text = size >= 0 ? server->allocator->malloc((size_t) size + 1) : NULL;
+    if (text && fread(text, 1, (size_t) size, fp) != (size_t) size) {
+        server->allocator->free(text);
+        text = NULL;
+    }
+    fclose(fp);
+
+    if (text)
+        text[size] = '\0';
+    return text;
+}
+
+// `/home/a b.volt` -> `file:///home/a%20b.volt`, `C:\x.volt` -> `file:///C:/x.volt`
+static char* volt_lsp_uri_from_path(volt_lsp_server_t* server, const char* path) {
+    static const char hex[] = "0123456789ABCDEF";
+
+    size_t length = strlen(path);
+    char*  uri    = server->allocator->malloc(length * 3 + 9);
+    if (!uri)
+        return NULL;
+
+    size_t size = (size_t) sprintf(uri, path[0] == '/' ? "file://" : "file:///");
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char) path[i];
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            strchr("-._~/:", c)) {
+            uri[size++] = (char) c;
+        } else if (c == '\\') {
+            uri[size++] = '/';
+        } else {
+            uri[size++] = '%';
+            uri[size++] = hex[c >> 4];
+            uri[size++] = hex[c & 0xF];
+        }
+    }
+    uri[size] = '\0';
+    return uri;
+}
+
+// The inverse, for `file:` URIs; other schemes keep the URI as their name
+static char* volt_lsp_path_from_uri(volt_lsp_server_t* server, const char* uri) {
+    if (strncmp(uri, "file://", 7) != 0)
+        return volt_lsp_strndup(server, uri, strlen(uri));
+
+    const char* at = uri + 7;
+#if defined(_WIN32)
+    if (at[0] == '/' && at[1] && (at[2] == ':' || strncmp(at + 2, "%3A", 3) == 0 ||
+                                  strncmp(at + 2, "%3a", 3) == 0))
+        at++;
+#endif
+
+    char* path = volt_lsp_strndup(server, at, strlen(at));
+    if (!path)
+        return NULL;
+
+    size_t size = 0;
+    for (size_t i = 0; path[i]; i++) {
+        unsigned int c;
+        if (path[i] == '%' && path[i + 1] && path[i + 2] && sscanf(path + i + 1, "%2x", &c) == 1) {
+            path[size++] = (char) c;
+            i += 2;
+        } else {
+            path[size++] = path[i];
+        }
+    }
+    path[size] = '\0';
+    return path;
+}
+
+static char* volt_lsp_absolute(volt_lsp_server_t* server, const char* path) {
+#if defined(_WIN32)
+    char* absolute = _fullpath(NULL, path, 0);
+#else
+    char* absolute = realpath(path, NULL);
+#endif
+    if (!absolute)
+        return volt_lsp_strndup(server, path, strlen(path));
+
+    char* copy = volt_lsp_strndup(server, absolute, strlen(absolute));
+    free(absolute);
+    return copy;
+}
+
+static volt_lsp_document_t* volt_lsp_document_create(volt_lsp_server_t* server, char* uri,
+                                                     char* path) {
+    volt_lsp_document_t* document = server->allocator->malloc(sizeof(volt_lsp_document_t));
+    if (!document) {
+        server->allocator->free(uri);
+        server->allocator->free(path);
+        return NULL;
+    }
+
+    memset(document, 0, sizeof(volt_lsp_document_t));
+    document->uri                 = uri;
+    document->path                = path;
+    document->items.allocator     = server->allocator;
+    document->lines.allocator     = server->allocator;
+    document->loose.allocator     = server->allocator;
+    document->published.allocator = server->allocator;
+    volt_error_handler_init(&document->syntax, server->allocator);
+    volt_lsp_item_vector_init(&document->items);
+    volt_lsp_offset_vector_init(&document->lines);
+    volt_lsp_diagnostic_vector_init(&document->loose);
+    volt_json_text_vector_init(&document->published);
+    volt_json_write_raw(&document->published, "[]");
+
+    volt_vector_push_back(&server->documents, document);
+    return document;
+}
+
+static volt_lsp_document_t* volt_lsp_document_find(volt_lsp_server_t* server, const char* uri) {
+    for (size_t i = 0; i < server->documents.size; i++) {
+        volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+        if (strcmp(document->uri, uri) == 0)
+            return document;
+    }
+
+    // Clients spell the same file differently (`c%3A` for `C:`), so the paths are compared too
+    char* path = volt_lsp_path_from_uri(server, uri);
+    for (size_t i = 0; path && i < server->documents.size; i++) {
+        volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+        if (strcmp(document->path, path) == 0) {
+            server->allocator->free(path);
+            return document;
+        }
+    }
+    server->allocator->free(path);
+    return NULL;
+}
+
+// Lexes and parses the current text from scratch
+static void volt_lsp_document_parse(volt_lsp_server_t* server, volt_lsp_document_t* document) {
+    volt_lexer_t* lexer = &document->lexer;
+
+    volt_error_handler_deinit(&document->syntax);
+    volt_error_handler_init(&document->syntax, server->allocator);
+
+    for (size_t i = 0; i < lexer->tokens.size; i++)
+        volt_token_deinit(&lexer->tokens.data[i]);
+    volt_token_vector_deinit(&lexer->tokens);
+    lexer->input_stream_name = document->path;
+    lexer->error_handler     = &document->syntax;
+    volt_lexer_init(lexer, server->allocator);
+    volt_lexer_lex(lexer);
+
+    if (!document->loaded) {
+        volt_parser_init(&document->parser, server->allocator, &lexer->tokens,
+                         &document->syntax, document->path);
+        document->parser.lazy_bodies = true;
+        if (server->compiler->args.interpreted_parser)
+            document->parser.interpreted = true;
+        document->loaded = true;
+    }
+    volt_parser_parse(&document->parser);
+}
+
+// Takes over `text`
+static void volt_lsp_document_set_text(volt_lsp_server_t* server, volt_lsp_document_t* document,
+                                       char* text) {
+    if (!text)
+        return;
+    if (document->lexer.input_stream)
+        server->allocator->free((void*) document->lexer.input_stream);
+    document->lexer.input_stream = text;
+    volt_lsp_document_parse(server, document);
+    volt_lsp_refresh(server, document);
+}
+
+static void volt_lsp_document_destroy(volt_lsp_server_t* server, volt_lsp_document_t* document) {
+    // Whatever mentioned its declarations loses them
+    for (size_t i = 0; i < document->items.size; i++) {
+        volt_lsp_item_t* item = &document->items.data[i];
+        volt_lsp_hash_vector_append_range(&server->changed, item->names.data, item->names.size);
+        volt_lsp_item_deinit(server, item);
+    }
+    volt_lsp_item_vector_deinit(&document->items);
+    volt_lsp_offset_vector_deinit(&document->lines);
+    volt_lsp_diagnostics_clear(server, &document->loose);
+    volt_lsp_diagnostic_vector_deinit(&document->loose);
+    volt_json_text_vector_deinit(&document->published);
+
+    if (document->loaded) {
+        volt_parser_deinit(&document->parser);
+        volt_lexer_deinit(&document->lexer);
+    }
+    volt_error_handler_deinit(&document->syntax);
+    server->allocator->free(document->uri);
+    server->allocator->free(document->path);
+    server->allocator->free(document);
+}
+
+// POSITIONS
+// LSP positions are a zero-based line and a count of UTF-16 code units into it. Tokens and
+// errors carry a one-based line and byte column.
+
+static size_t volt_lsp_utf8_size(unsigned char lead) {
+    return lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+}
+
+// Clamped to the end of the line and of the text
+static size_t volt_lsp_offset(volt_lexer_t* lexer, volt_json_t* position) {
+    const char* text   = lexer->input_stream;
+    size_t      length = lexer->input_stream_length;
+    int64_t     line   = volt_json_int(volt_json_get(position, "line"), 0);
+    int64_t     units  = volt_json_int(volt_json_get(position, "character"), 0);
+
+    size_t offset = 0;
+    while (line > 0 && offset < length) {
+        if (text[offset++] == '\n')
+            line--;
+    }
+    while (units > 0 && offset < length && text[offset] != '\n') {
+        size_t size = volt_lsp_utf8_size((unsigned char) text[offset]);
+        units -= size == 4 ? 2 : 1;
+        offset += size;
+    }
+    return offset < length ? offset : length;
+}
+
+static void volt_lsp_write_position(volt_json_text_vector_t* out, volt_lexer_t* lexer,
+                                    volt_lsp_offset_vector_t* lines, size_t line,
+                                    size_t offset) {
+    size_t units = 0;
+    for (size_t i = lines->data[line]; i < offset;) {
+        size_t size = volt_lsp_utf8_size((unsigned char) lexer->input_stream[i]);
+        units += size == 4 ? 2 : 1;
+        i += size;
+    }
+
+    volt_json_write_raw(out, "{\"line\":");
+    volt_json_write_int(out, (int64_t) line);
+    volt_json_write_raw(out, ",\"character\":");
+    volt_json_write_int(out, (int64_t) units);
+    volt_json_write_raw(out, "}");
+}
+
+// The range runs to the end of the token the error points at, within its line
+static void volt_lsp_write_diagnostic(volt_json_text_vector_t* out, volt_lsp_document_t* document,
+                                      volt_lsp_offset_vector_t* lines, size_t line,
+                                      size_t column, const char* message, bool warning) {
+    volt_lexer_t* lexer = &document->lexer;
+
+    line         = line > 0 ? line - 1 : 0;
+    line         = line < lines->size ? line : lines->size - 1;
+    size_t end   = line + 1 < lines->size ? lines->data[line + 1] - 1
+                                          : lexer->input_stream_length;
+    size_t start = lines->data[line] + (column > 0 ? column - 1 : 0);
+    start        = start < end ? start : end;
+
+    size_t through = start;
+
+    volt_token_vector_t* tokens = &lexer->tokens;
+    size_t               low    = 0;
+    size_t               high   = tokens->size;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (tokens->data[middle].offset < start)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low < tokens->size && tokens->data[low].offset == start)
+        through = start + tokens->data[low].length;
+    through = through < end ? through : end;
+
+    volt_json_write_raw(out, "{\"range\":{\"start\":");
+    volt_lsp_write_position(out, lexer, lines, line, start);
+    volt_json_write_raw(out, ",\"end\":");
+    volt_lsp_write_position(out, lexer, lines, line, through);
+    volt_json_write_raw(out, warning ? "},\"severity\":2" : "},\"severity\":1");
+    volt_json_write_raw(out, ",\"source\":\"voltc\",\"message\":");
+    volt_json_write_string(out, message, strlen(message));
+    volt_json_write_raw(out, "}");
+}
+
+// TRANSPORT
+
+static void volt_lsp_send(volt_lsp_server_t* server) {
+    if (!server->out)
+        return;
+    fprintf(server->out, "Content-Length: %zu\r\n\r\n", server->output.size);
+    fwrite(server->output.data, 1, server->output.size, server->out);
+    fflush(server->out);
+}
+
+// Starts a response to `id`, to be finished with the result or error and a closing brace
+static void volt_lsp_begin_response(volt_lsp_server_t* server, volt_json_t* id) {
+    volt_json_text_vector_clear(&server->output);
+    volt_json_write_raw(&server->output, "{\"jsonrpc\":\"2.0\",\"id\":");
+    volt_json_write_value(&server->output, id);
+}
+
+static void volt_lsp_respond(volt_lsp_server_t* server, volt_json_t* id, const char* result) {
+    volt_lsp_begin_response(server, id);
+    volt_json_write_raw(&server->output, ",\"result\":");
+    volt_json_write_raw(&server->output, result);
+    volt_json_write_raw(&server->output, "}");
+    volt_lsp_send(server);
+}
+
+static void volt_lsp_respond_error(volt_lsp_server_t* server, volt_json_t* id, int64_t code,
+                                   const char* message) {
+    volt_lsp_begin_response(server, id);
+    volt_json_write_raw(&server->output, ",\"error\":{\"code\":");
+    volt_json_write_int(&server->output, code);
+    volt_json_write_raw(&server->output, ",\"message\":");
+    volt_json_write_string(&server->output, message, strlen(message));
+    volt_json_write_raw(&server->output, "}}");
+    volt_lsp_send(server);
+}
+
+// `Content-Length` value: decimal digits only. `too_long` is set when they name a body larger than
+// VOLT_LSP_MAX_CONTENT_LENGTH, so it can be skipped; one that does not fit a size_t is malformed.
+static bool volt_lsp_parse_length(const char* text, size_t* length, bool* too_long) {
+    while (*text == ' ' || *text == '\t')
+        text++;
+    if (*text < '0' || *text > '9')
+        return false;
+
+    size_t value = 0;
+    for (; *text >= '0' && *text <= '9'; text++) {
+        size_t digit = (size_t) (*text - '0');
+        if (value > (SIZE_MAX - digit) / 10)
+            return false;
+        value = value * 10 + digit;
+    }
+    while (*text == ' ' || *text == '\t' || *text == '\r' || *text == '\n')
+        text++;
+    if (*text)
+        return false;
+
+    *length   = value;
+    *too_long = value > VOLT_LSP_MAX_CONTENT_LENGTH;
+    return true;
+}
+
+// One message body, in the arena; NULL once the input ends. A message whose length is missing,
+// malformed or too large comes back empty, which the caller answers with a parse error.
+static char* volt_lsp_read(volt_lsp_server_t* server, size_t* length) {
+    char   header[256];
+    size_t content_length = 0;
+    bool   has_length = false, valid = true, too_long = false;
+    for (;;) {
+        if (!fgets(header, sizeof(header), server->in))
+            return NULL;
+        if (strncmp(header, "Content-Length:", 15) == 0) {
+            valid      = volt_lsp_parse_length(header + 15, &content_length, &too_long);
+            has_length = true;
+        } else if ((strcmp(header, "\r\n") == 0 || strcmp(header, "\n") == 0) && has_length) {
+            break;
+        }
+    }
+
+    if (!valid || too_long) {
+        // An oversized body can still be skipped, which keeps the stream in step; without a
+        // valid length there is nothing to go by. Input ending early shows on the next read.
+        for (size_t left = too_long ? content_length : 0; left > 0;) {
+            size_t chunk = left < sizeof(header) ? left : sizeof(header);
+            if (fread(header, 1, chunk, server->in) != chunk)
+                break;
+            left -= chunk;
+        }
+        content_length = 0;
+    }
+
+    char* body = volt_arena_alloc(&server->arena, content_length + 1);
+    if (!body || fread(body, 1, content_length, server->in) != content_length)
+        return NULL;
+    body[content_length] = '\0';
+    *length              = content_length;
+    return body;
+}
+
+// DIAGNOSTICS
+
+static void volt_lsp_publish(volt_lsp_server_t* server, volt_lsp_document_t* document) {
+    volt_json_text_vector_t* scratch = &server->scratch;
+    volt_json_text_vector_clear(scratch);
+    volt_json_write_raw(scratch, "[");
+
+    volt_lsp_offset_vector_t* lines = &document->lines;
+    for (size_t i = 0; i < document->syntax.errors.size; i++) {
+        volt_error_t* error = &document->syntax.errors.data[i];
+        if (scratch->size > 1)
+            volt_json_write_raw(scratch, ",");
+        volt_lsp_write_diagnostic(scratch, document, lines, error->line, error->column,
+                                  error->message, error->type == VOLT_ERROR_TYPE_WARNING);
+    }
+    for (size_t i = 0; i < document->loose.size; i++) {
+        volt_lsp_diagnostic_t* diagnostic = &document->loose.data[i];
+        if (scratch->size > 1)
+            volt_json_write_raw(scratch, ",");
+        volt_lsp_write_diagnostic(scratch, document, lines, diagnostic->line,
+                                  diagnostic->column, diagnostic->message, false);
+    }
+    for (size_t i = 0; i < document->items.size; i++) {
+        volt_lsp_item_t* item = &document->items.data[i];
+        for (size_t j = 0; j < item->diagnostics.size; j++) {
+            volt_lsp_diagnostic_t* diagnostic = &item->diagnostics.data[j];
+            if (scratch->size > 1)
+                volt_json_write_raw(scratch, ",");
+            volt_lsp_write_diagnostic(scratch, document, lines,
+                                      volt_lsp_item_line(document, i) + diagnostic->line,
+                                      diagnostic->column, diagnostic->message, false);
+        }
+    }
+    volt_json_write_raw(scratch, "]");
+
+    // Unchanged diagnostics are not sent again
+    if (scratch->size == document->published.size &&
+        memcmp(scratch->data, document->published.data, scratch->size) == 0)
+        return;
+    volt_json_text_vector_clear(&document->published);
+    volt_json_text_vector_append_range(&document->published, scratch->data, scratch->size);
+
+    volt_json_text_vector_t* out = &server->output;
+    volt_json_text_vector_clear(out);
+    volt_json_write_raw(out, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\","
+                             "\"params\":{\"uri\":");
+    volt_json_write_string(out, document->uri, strlen(document->uri));
+    volt_json_write_raw(out, ",\"diagnostics\":");
+    volt_json_text_vector_append_range(out, scratch->data, scratch->size);
+    volt_json_write_raw(out, "}}");
+    volt_lsp_send(server);
+}
+
+static volt_lsp_document_t* volt_lsp_document_of(volt_lsp_server_t* server, const char* file) {
+    for (size_t i = 0; file && i < server->documents.size; i++) {
+        volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+        if (document->path == file || strcmp(document->path, file) == 0)
+            return document;
+    }
+    return NULL;
+}
+
+static bool volt_lsp_diagnostic_known(volt_lsp_diagnostic_vector_t* diagnostics,
+                                      volt_lsp_diagnostic_t*        diagnostic) {
+    for (size_t i = 0; i < diagnostics->size; i++) {
+        volt_lsp_diagnostic_t* known = &diagnostics->data[i];
+        if (known->line == diagnostic->line && known->column == diagnostic->column &&
+            strcmp(known->message, diagnostic->message) == 0)
+            return true;
+    }
+    return false;
+}
+
+// Errors of the run go to the items they were reported in. Checked items start over; the others
+// only gain errors they did not have yet, as reporting one of those is a side effect of checking
+// another item (a generic instance, a declaration), which does not happen on every run.
+static void volt_lsp_collect(volt_lsp_server_t* server) {
+    for (size_t i = 0; i < server->documents.size; i++) {
+        volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+        volt_lsp_diagnostics_clear(server, &document->loose);
+        for (size_t j = 0; j < document->items.size; j++) {
+            if (document->items.data[j].dirty)
+                volt_lsp_diagnostics_clear(server, &document->items.data[j].diagnostics);
+        }
+    }
+
+    volt_error_handler_t* handler = &server->compiler->error_handler;
+    for (size_t i = 0; i < handler->errors.size; i++) {
+        volt_error_t*        error    = &handler->errors.data[i];
+        volt_lsp_document_t* document = volt_lsp_document_of(server, error->file);
+        if (!document || !error->message)
+            continue;
+
+        volt_lsp_diagnostic_vector_t* target     = &document->loose;
+        bool                          checked    = true;
+        volt_lsp_diagnostic_t         diagnostic = {error->line, error->column, NULL};
+
+        size_t index = volt_lsp_item_at(document, error->line);
+        if (index != SIZE_MAX) {
+            volt_lsp_item_t* item = &document->items.data[index];
+            target                = &item->diagnostics;
+            checked               = item->dirty;
+            diagnostic.line       = error->line - volt_lsp_item_line(document, index);
+        }
+
+        diagnostic.message = (char*) error->message;
+        if (!checked && volt_lsp_diagnostic_known(target, &diagnostic))
+            continue;
+        diagnostic.message = volt_lsp_strndup(server, error->message, strlen(error->message));
+        if (diagnostic.message)
+            volt_lsp_diagnostic_vector_push_back(target, diagnostic);
+    }
+
+    volt_error_handler_deinit(handler);
+    volt_error_handler_init(handler, server->allocator);
+
+    for (size_t i = 0; i < server->documents.size; i++) {
+        volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+        for (size_t j = 0; j < document->syntax.errors.size; j++) {
+            size_t index = volt_lsp_item_at(document, document->syntax.errors.data[j].line);
+            if (index != SIZE_MAX)
+                document->items.data[index].broken = true;
+        }
+    }
+}
+
+// ANALYSIS
+
+static int volt_lsp_compare_node(const void* a, const void* b) {
+    uintptr_t x = (uintptr_t) *(volt_ast_node_t* const*) a;
+    uintptr_t y = (uintptr_t) *(volt_ast_node_t* const*) b;
+    return x < y ? -1 : x > y;
+}
+
+static bool volt_lsp_checks(void* context, volt_ast_node_t* declaration) {
+    volt_ast_node_vector_t* checked = context;
+    return checked->size > 0 && bsearch(&declaration, checked->data, checked->size,
+                                        sizeof(volt_ast_node_t*), volt_lsp_compare_node);
+}
+
+// The analyzer asks about top-level declarations, and about those nested in namespaces
+static void volt_lsp_check(volt_lsp_server_t* server, volt_ast_node_t* declaration) {
+    if (!declaration)
+        return;
+    volt_ast_node_vector_push_back(&server->checked, declaration);
+    if (!volt_ast_is(declaration, "namespace_decl"))
+        return;
+
+    volt_vector_t items = volt_vector_default();
+    volt_ast_collect_list(volt_ast_find_child(declaration, "items"), "item", &items);
+    for (size_t i = 0; i < items.size; i++)
+        volt_lsp_check(server, volt_lsp_declaration(volt_vector_get(&items, i)));
+    volt_vector_deinit(&items);
+}
+
+// Items mentioning a changed name are checked again. When one's own signature mentions it, what
+// it declares may have changed meaning too, and so on until nothing new is reached.
+static void volt_lsp_propagate(volt_lsp_server_t* server) {
+    volt_lsp_hash_normalize(&server->changed);
+
+    bool grew = server->changed.size > 0;
+    while (grew) {
+        grew = false;
+        for (size_t i = 0; i < server->documents.size; i++) {
+            volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+            for (size_t j = 0; j < document->items.size; j++) {
+                volt_lsp_item_t* item = &document->items.data[j];
+                if (!item->dirty && volt_lsp_hash_intersects(&item->references, &server->changed))
+                    item->dirty = true;
+                if (item->dirty && !item->propagated &&
+                    volt_lsp_hash_intersects(&item->interface, &server->changed)) {
+                    item->propagated = true;
+                    volt_lsp_hash_vector_append_range(&server->changed, item->names.data,
+                                                      item->names.size);
+                    grew = true;
+                }
+            }
+        }
+        if (grew)
+            volt_lsp_hash_normalize(&server->changed);
+    }
+}
+
+// Declarations are collected from every document on each run, which is cheap next to checking
+// bodies; bodies are only checked for dirty items. The analyzer stays alive until the next run.
+static void volt_lsp_analyze(volt_lsp_server_t* server) {
+    volt_compiler_t* compiler = server->compiler;
+
+    volt_lsp_propagate(server);
+
+    size_t dirty = 0;
+    size_t total = 0;
+    volt_ast_node_vector_clear(&server->checked);
+    for (size_t i = 0; i < server->documents.size; i++) {
+        volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+        for (size_t j = 0; j < document->items.size; j++) {
+            volt_lsp_item_t* item = &document->items.data[j];
+            total++;
+            if (!item->dirty)
+                continue;
+            dirty++;
+            volt_lsp_check(server, volt_lsp_declaration(item->node));
+        }
+    }
+    if (server->checked.size > 0)
+        qsort(server->checked.data, server->checked.size, sizeof(volt_ast_node_t*),
+              volt_lsp_compare_node);
+
+    volt_semantic_analyzer_deinit(&compiler->analyzer);
+    server->allocator->free(server->asts);
+    server->allocator->free(server->names);
+    size_t documents = server->documents.size + 1;
+    server->asts     = server->allocator->malloc(sizeof(volt_ast_node_t*) * documents);
+    server->names    = server->allocator->malloc(sizeof(const char*) * documents);
+
+    size_t count = 0;
+    for (size_t i = 0; server->asts && server->names && i < server->documents.size; i++) {
+        volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+        if (!document->parser.root)
+            continue;
+        server->asts[count]  = document->parser.root;
+        server->names[count] = document->path;
+        count++;
+    }
+
+    memset(&compiler->analyzer, 0, sizeof(volt_semantic_analyzer_t));
+    if (count > 0 &&
+        volt_semantic_analyzer_init(&compiler->analyzer, server->allocator, server->asts,
+                                    server->names, count, &compiler->error_handler) ==
+            VOLT_SUCCESS) {
+        if (dirty < total) {
+            compiler->analyzer.checks         = volt_lsp_checks;
+            compiler->analyzer.checks_context = &server->checked;
+        }
+        volt_semantic_analyzer_analyze(&compiler->analyzer);
+    }
+
+    volt_lsp_collect(server);
+
+    for (size_t i = 0; i < server->documents.size; i++) {
+        volt_lsp_document_t* document = volt_vector_get(&server->documents, i);
+        for (size_t j = 0; j < document->items.size; j++) {
+            document->items.data[j].dirty      = false;
+            document->items.data[j].propagated = false;
+        }
+    }
+    volt_lsp_hash_vector_clear(&server->changed);
+
+    for (size_t i = 0; i < server->documents.size; i++)
+        volt_lsp_publish(server, volt_vector_get(&server->documents, i));
+}
+
+// NOTIFICATIONS
+
+static void volt_lsp_did_open(volt_lsp_server_t* server, volt_json_t* params) {
+    volt_json_t* document_json = volt_json_get(params, "textDocument");
+    const char*  uri           = volt_json_string(volt_json_get(document_json, "uri"));
+    volt_json_t* text          = volt_json_get(document_json, "text");
+    if (!uri || !volt_json_string(text))
+        return;
+
+    volt_lsp_document_t* document = volt_lsp_document_find(server, uri);
+    if (document && document->lexer.input_stream &&
+        strcmp(document->lexer.input_stream, text->string) == 0)
+        return;  // The workspace copy is what the editor has
+
+    if (!document) {
+        document = volt_lsp_document_create(server, volt_lsp_strndup(server, uri, strlen(uri)),
+                                            volt_lsp_path_from_uri(server, uri));
+        if (!document)
+            return;
+    }
+    volt_lsp_document_set_text(server, document,
+                               volt_lsp_strndup(server, text->string, text->length));
+    volt_lsp_analyze(server);
+}
+
+// Ranged changes are relexed and reparsed in place. A document with syntax errors is parsed
+// again from scratch once they are applied: the incremental parse only reports errors in the
+// part it looked at, and the others would be lost.
+static void volt_lsp_did_change(volt_lsp_server_t* server, volt_json_t* params) {
+    const char* uri = volt_json_string(volt_json_get(volt_json_get(params, "textDocument"), "uri"));
+    volt_lsp_document_t* document = uri ? volt_lsp_document_find(server, uri) : NULL;
+    if (!document || !document->loaded)
+        return;
+
+    bool         reparse = false;
+    volt_json_t* changes = volt_json_get(params, "contentChanges");
+    for (volt_json_t* change = changes ? changes->first : NULL; change; change = change->next) {
+        volt_json_t* text  = volt_json_get(change, "text");
+        volt_json_t* range = volt_json_get(change, "range");
+        if (!volt_json_string(text))
+            continue;
+
+        if (!range) {
+            volt_lsp_document_set_text(server, document,
+                                       volt_lsp_strndup(server, text->string, text->length));
+            reparse = false;
+            continue;
+        }
+
+        size_t start = volt_lsp_offset(&document->lexer, volt_json_get(range, "start"));
+        size_t end   = volt_lsp_offset(&document->lexer, volt_json_get(range, "end"));
+        end          = end > start ? end : start;
+
+        volt_token_edit_t edit;
+        if (volt_lexer_relex(&document->lexer, start, end - start, text->string, &edit) !=
+            VOLT_SUCCESS) {
+            reparse = true;
+        } else if (reparse || document->syntax.errors.size > 0) {
+            reparse = true;
+        } else {
+            volt_parser_reparse(&document->parser, &edit);
+            volt_lsp_refresh(server, document);
+        }
+    }
+
+    if (reparse) {
+        volt_lsp_document_parse(server, document);
+        volt_lsp_refresh(server, document);
+    }
+    volt_lsp_analyze(server);
+}
+
+// Workspace files go back to what is on disk; other documents are dropped
+static void volt_lsp_did_close(volt_lsp_server_t* server, volt_json_t* params) {
+    const char* uri = volt_json_string(volt_json_get(volt_json_get(params, "textDocument"), "uri"));
+    volt_lsp_document_t* document = uri ? volt_lsp_document_find(server, uri) : NULL;
+    if (!document)
+        return;
+
+    if (document->workspace) {
+        char* text = volt_lsp_read_file(server, document->path);
+        if (text && strcmp(text, document->lexer.input_stream) == 0) {
+            server->allocator->free(text);
+            return;
+        }
+        volt_lsp_document_set_text(server, document, text);
+        volt_lsp_analyze(server);
+        return;
+    }
+
+    for (size_t i = 0; i < server->documents.size; i++) {
+        if (volt_vector_get(&server->documents, i) == document) {
+            volt_vector_remove(&server->documents, i);
+            break;
+        }
+    }
+
+    // Its diagnostics go with it
+    volt_json_text_vector_t* out = &server->output;
+    volt_json_text_vector_clear(out);
+    volt_json_write_raw(out, "{\"jsonrpc\":\"2.0\",\"method\":\"textDocument/publishDiagnostics\","
+                             "\"params\":{\"uri\":");
+    volt_json_write_string(out, document->uri, strlen(document->uri));
+    volt_json_write_raw(out, ",\"diagnostics\":[]}}");
+    volt_lsp_send(server);
+
+    volt_lsp_document_destroy(server, document);
+    volt_lsp_analyze(server);
+}
+
+// DISPATCH
+
+static void volt_lsp_handle(volt_lsp_server_t* server, volt_json_t* message, const char* method) {
+    volt_json_t* id     = volt_json_get(message, "id");
+    volt_json_t* params = volt_json_get(message, "params");
+
+    if (strcmp(method, "initialize") == 0) {
+        volt_lsp_respond(server, id,
+                         "{\"capabilities\":{\"textDocumentSync\":{\"openClose\":true,"
+                         "\"change\":2}},\"serverInfo\":{\"name\":\"voltc\"}}");
+    } else if (strcmp(method, "initialized") == 0) {
+        volt_lsp_analyze(server);
+    } else if (strcmp(method, "shutdown") == 0) {
+        server->shutdown = true;
+        volt_lsp_respond(server, id, "null");
+    } else if (strcmp(method, "exit") == 0) {
+        server->exit = true;
+    } else if (server->shutdown && id) {
+        volt_lsp_respond_error(server, id, VOLT_LSP_INVALID_REQUEST, "Server is shutting down");
+    } else if (strcmp(method, "textDocument/didOpen") == 0) {
+        volt_lsp_did_open(server, params);
+    } else if (strcmp(method, "textDocument/didChange") == 0) {
+        volt_lsp_did_change(server, params);
+    } else if (strcmp(method, "textDocument/didClose") == 0) {
+        volt_lsp_did_close(server, params);
+    } else if (id) {
+        volt_lsp_respond_error(server, id, VOLT_LSP_METHOD_NOT_FOUND, "Method not found");
+    }
+    // Other notifications ($/cancelRequest, didSave, ...) need nothing
+}
+
+static void volt_lsp_record(volt_lsp_server_t* server, const char* method, double milliseconds) {
+    volt_lsp_timing_t* timing = NULL;
+    for (size_t i = 0; i < server->timings.size && !timing; i++) {
+        if (strcmp(server->timings.data[i].method, method) == 0)
+            timing = &server->timings.data[i];
+    }
+    if (!timing) {
+        volt_lsp_timing_t added = {.samples = {.allocator = server->allocator}};
+        snprintf(added.method, sizeof(added.method), "%s", method);
+        volt_lsp_sample_vector_init(&added.samples);
+        volt_lsp_timing_vector_push_back(&server->timings, added);
+        timing = volt_lsp_timing_vector_back(&server->timings);
+    }
+    if (timing)
+        volt_lsp_sample_vector_push_back(&timing->samples, milliseconds);
+}
+
+static int volt_lsp_compare_sample(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return x < y ? -1 : x > y;
+}
+
+static void volt_lsp_print_timings(volt_lsp_server_t* server) {
+    printf("%-32s %8s %10s %10s %10s %10s\n", "method", "count", "mean ms", "p50 ms", "p95 ms",
+           "max ms");
+    for (size_t i = 0; i < server->timings.size; i++) {
+        volt_lsp_timing_t* timing  = &server->timings.data[i];
+        double*            samples = timing->samples.data;
+        size_t             count   = timing->samples.size;
+        qsort(samples, count, sizeof(double), volt_lsp_compare_sample);
+
+        double total = 0;
+        for (size_t j = 0; j < count; j++)
+            total += samples[j];
+        printf("%-32s %8zu %10.3f %10.3f %10.3f %10.3f\n", timing->method, count,
+               total / (double) count, samples[count / 2], samples[count * 95 / 100],
+               samples[count - 1]);
+    }
+}
+
+volt_status_code_t volt_lsp_run(volt_compiler_t* compiler) {
+    volt_lsp_server_t server = {0};
+    server.compiler          = compiler;
+    server.allocator         = compiler->allocator;
+    server.in                = stdin;
+    server.out               = compiler->args.lsp_replay ? NULL : stdout;
+
+#if defined(_WIN32)
+    // Content-Length counts bytes; text mode would turn \r\n into \n under it
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    server.documents           = volt_vector_default();
+    server.documents.allocator = server.allocator;
+    server.changed.allocator   = server.allocator;
+    server.checked.allocator   = server.allocator;
+    server.output.allocator    = server.allocator;
+    server.scratch.allocator   = server.allocator;
+    server.timings.allocator   = server.allocator;
+    volt_lsp_hash_vector_init(&server.changed);
+    volt_ast_node_vector_init(&server.checked);
+    volt_json_text_vector_init(&server.output);
+    volt_json_text_vector_init(&server.scratch);
+    volt_lsp_timing_vector_init(&server.timings);
+    volt_arena_init(&server.arena, server.allocator);
+
+    // The workspace is what the command line names; everything in it is analyzed on `initialized`
+    for (size_t i = 0; i < compiler->args.input_count; i++) {
+        char* path = volt_lsp_absolute(&server, compiler->args.input_files[i]);
+        char* text = path ? volt_lsp_read_file(&server, path) : NULL;
+        if (!text) {
+            volt_fmt_logf(VOLT_FMT_LEVEL_ERROR, "Error reading file: {s}",
+                          compiler->args.input_files[i]);
+            server.allocator->free(path);
+            continue;
+        }
+
+        volt_lsp_document_t* document =
+            volt_lsp_document_create(&server, volt_lsp_uri_from_path(&server, path), path);
+        if (!document) {
+            server.allocator->free(text);
+            continue;
+        }
+        document->workspace = true;
+        volt_lsp_document_set_text(&server, document, text);
+    }
+
+    while (!server.exit) {
+        volt_arena_mark_t mark   = volt_arena_mark(&server.arena);
+        size_t            length = 0;
+        char*             body   = volt_lsp_read(&server, &length);
+        if (!body)
+            break;
+
+        clock_t      start   = clock();
+        volt_json_t* message = volt_json_parse(&server.arena, body, length);
+        const char*  method  = volt_json_string(volt_json_get(message, "method"));
+        if (!message) {
+            volt_lsp_respond_error(&server, NULL, VOLT_LSP_PARSE_ERROR, "Parse error");
+        } else if (method) {
+            volt_lsp_handle(&server, message, method);
+            if (compiler->args.lsp_replay)
+                volt_lsp_record(&server, method,
+                                (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC);
+        }
+        volt_arena_release(&server.arena, mark);
+    }
+
+    if (compiler->args.lsp_replay)
+        volt_lsp_print_timings(&server);
+
+    for (size_t i = 0; i < server.documents.size; i++)
+        volt_lsp_document_destroy(&server, volt_vector_get(&server.documents, i));
+    volt_vector_deinit(&server.documents);
+    for (size_t i = 0; i < server.timings.size; i++)
+        volt_lsp_sample_vector_deinit(&server.timings.data[i].samples);
+    volt_lsp_timing_vector_deinit(&server.timings);
+    volt_lsp_hash_vector_deinit(&server.changed);
+    volt_ast_node_vector_deinit(&server.checked);
+    volt_json_text_vector_deinit(&server.output);
+    volt_json_text_vector_deinit(&server.scratch);
+    volt_arena_deinit(&server.arena);
+
+    // The analyzer holds these until volt_deinit releases it
+    volt_semantic_analyzer_deinit(&compiler->analyzer);
+    server.allocator->free(server.asts);
+    server.allocator->free(server.names);
+
+    return server.shutdown ? VOLT_SUCCESS : VOLT_FAILURE;
+}
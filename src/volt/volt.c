@@ -1,32 +1,103 @@
 #include <lexer/lexer.h>
 #include <pch.h>
+#include <semantic/coroutine.h>
+#include <semantic/dce.h>
+#include <semantic/devirt.h>
+#include <semantic/escape.h>
+#include <semantic/fallible.h>
+#include <semantic/format.h>
+#include <semantic/layout.h>
+#include <semantic/loop.h>
+#include <semantic/match.h>
 #include <util/fmt.h>
 #include <volt/volt.h>
 
 #include "util/types/types.h"
 #include "util/types/vector.h"
 
+#if defined(_WIN32)
+#    include <process.h>
+#else
+#    include <errno.h>
+#    include <spawn.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+extern char** environ;
+#endif
+
+// Consumes `--option` arguments, compacting argv so only inputs and outputs remain
+static inline void _volt_parse_cmd_options(volt_cmd_args_t* args) {
+    uint32_t kept = 1;
+    for (uint32_t i = 1; i < args->argc && args->argv[i]; i++) {
+        const char* arg = args->argv[i];
+        if (strncmp(arg, "--", 2) != 0) {
+            args->argv[kept++] = args->argv[i];
+            continue;
+        }
+
+        if (strcmp(arg, "--print-dce") == 0) {
+            args->print_dce = true;
+        } else if (strcmp(arg, "--print-layouts") == 0) {
+            args->print_layouts = true;
+        } else if (strcmp(arg, "--print-coroutines") == 0) {
+            args->print_coroutines = true;
+        } else if (strcmp(arg, "--print-loops") == 0) {
+            args->print_loops = true;
+        } else if (strcmp(arg, "--print-matches") == 0) {
+            args->print_matches = true;
+        } else if (strcmp(arg, "--print-escapes") == 0) {
+            args->print_escapes = true;
+        } else if (strcmp(arg, "--print-fallible") == 0) {
+            args->print_fallible = true;
+        } else if (strcmp(arg, "--print-formats") == 0) {
+            args->print_formats = true;
+        } else if (strcmp(arg, "--print-devirt") == 0) {
+            args->print_devirt = true;
+        } else if (strcmp(arg, "--interpreted-parser") == 0) {
+            args->interpreted_parser = true;
+        } else if (strcmp(arg, "--lazy-bodies") == 0) {
+            args->lazy_bodies = true;
+        } else if (strncmp(arg, "--runtime=", 10) == 0) {
+            args->runtime_library = arg + 10;
+        } else if (strcmp(arg, "--lsp") == 0 || strcmp(arg, "--lsp-replay") == 0) {
+            // Every edit runs an analysis, whose progress is not worth a line each time
+            args->lsp        = true;
+            args->lsp_replay = strcmp(arg, "--lsp-replay") == 0;
+            volt_fmt_disable_level(VOLT_FMT_LEVEL_INFO);
+        } else {
+            volt_fmt_logf(VOLT_FMT_LEVEL_ERROR, "Unknown option: {s}", arg);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    args->argv[kept] = NULL;
+    args->argc       = kept;
+}
+
 // Expects argv like: prog <in1> <in2> ... -o <out1> <out2> ...
+// Without `outputs_required`, `-o` and the outputs may be left out.
 static inline char*** _volt_fmt_cmd_args(uint32_t argc, char** argv, size_t* o_input_count,
-                                         size_t* o_output_count, volt_allocator_t* allocator) {
+                                         size_t* o_output_count, bool outputs_required,
+                                         volt_allocator_t* allocator) {
     (void) argc;
     size_t i = 1;
     while (argv[i] && argv[i][0] != '-')
         i++;
     size_t inputs = (i > 1) ? (i - 1) : 0;
 
-    if (!argv[i] || strcmp(argv[i], "-o") != 0) {
+    if ((argv[i] || outputs_required) && (!argv[i] || strcmp(argv[i], "-o") != 0)) {
         volt_fmt_logf(VOLT_FMT_LEVEL_ERROR, "Expected -o separating inputs/outputs.");
         exit(EXIT_FAILURE);
     }
-    i++;  // skip -o
+    if (argv[i])
+        i++;  // skip -o
 
     size_t out_start = i;
     while (argv[i])
         i++;
     size_t outputs = (i > out_start) ? (i - out_start) : 0;
 
-    if (inputs != outputs) {
+    if (outputs_required && inputs != outputs) {
         volt_fmt_logf(VOLT_FMT_LEVEL_ERROR, "Incorrect amount of input arguments.");
         exit(EXIT_FAILURE);
     }
@@ -76,14 +147,16 @@ static inline const char* _volt_read_file(const char* path, volt_allocator_t* al
     }
 
     fclose(fp);
+    buffer[fsize] = '\0';
 
     return (const char*) buffer;
 }
 
 volt_status_code_t volt_cmd_args_init(volt_cmd_args_t* args, volt_allocator_t* allocator) {
-    args->allocator   = allocator;
+    args->allocator = allocator;
+    _volt_parse_cmd_options(args);
     args->parsed_args = (const char***) _volt_fmt_cmd_args(
-        args->argc, args->argv, &args->input_count, &args->output_count, allocator);
+        args->argc, args->argv, &args->input_count, &args->output_count, !args->lsp, allocator);
     args->input_files  = args->parsed_args[0];  // this is technically unsafe but idgaf
     args->output_files = args->parsed_args[1];
     return VOLT_SUCCESS;
@@ -108,6 +181,10 @@ volt_status_code_t volt_init(volt_compiler_t* compiler) {
     volt_fmt_logf(VOLT_FMT_LEVEL_INFO, "Initializing voltc...");
     volt_cmd_args_t* args = &compiler->args;
 
+    // The language server keeps its own lexers and parsers, one per open document
+    if (args->lsp)
+        return VOLT_SUCCESS;
+
     compiler->lexers = compiler->allocator->malloc(sizeof(volt_lexer_t) * args->input_count);
     memset(compiler->lexers, 0, sizeof(volt_lexer_t) * args->input_count);
 
@@ -133,18 +210,20 @@ volt_status_code_t volt_deinit(volt_compiler_t* compiler) {
     volt_semantic_analyzer_deinit(&compiler->analyzer);
 
     // Deinit lexers first (they own buffers)
-    for (size_t i = 0; i < compiler->args.input_count; i++) {
+    for (size_t i = 0; compiler->lexers && i < compiler->args.input_count; i++) {
         volt_lexer_t* lexer = &compiler->lexers[i];
         volt_lexer_deinit(lexer);
     }
 
-    for (size_t i = 0; i < compiler->args.input_count; i++) {
+    for (size_t i = 0; compiler->parsers && i < compiler->args.input_count; i++) {
         volt_parser_t* parser = &compiler->parsers[i];
         volt_parser_deinit(parser);
     }
 
     compiler->allocator->free(compiler->lexers);
     compiler->lexers = NULL;
+    compiler->allocator->free(compiler->parsers);
+    compiler->parsers = NULL;
 
     volt_cmd_args_deinit(&compiler->args);
     volt_error_handler_deinit(&compiler->error_handler);
@@ -173,6 +252,10 @@ volt_status_code_t volt_lex(volt_compiler_t* compiler) {
 
         volt_parser_init(parser, compiler->allocator, &lexer->tokens, &compiler->error_handler,
                          lexer->input_stream_name);
+        if (compiler->args.interpreted_parser)
+            parser->interpreted = true;
+        if (compiler->args.lazy_bodies)
+            parser->lazy_bodies = true;
     }
 
     return VOLT_SUCCESS;
@@ -207,6 +290,31 @@ volt_status_code_t volt_analyze(volt_compiler_t* compiler) {
     // Run semantic analysis
     volt_status_code_t result = volt_semantic_analyzer_analyze(&compiler->analyzer);
 
+    if (result == VOLT_SUCCESS && compiler->args.print_layouts)
+        volt_layout_print(&compiler->analyzer);
+    if (result == VOLT_SUCCESS && compiler->args.print_coroutines)
+        volt_coroutine_print(&compiler->analyzer);
+    if (result == VOLT_SUCCESS && compiler->args.print_loops)
+        volt_loop_print(&compiler->analyzer);
+    if (result == VOLT_SUCCESS && compiler->args.print_matches)
+        volt_match_print(&compiler->analyzer);
+    if (result == VOLT_SUCCESS && compiler->args.print_escapes)
+        volt_escape_print(&compiler->analyzer);
+    if (result == VOLT_SUCCESS && compiler->args.print_fallible)
+        volt_fallible_print(&compiler->analyzer);
+    if (result == VOLT_SUCCESS && compiler->args.print_formats)
+        volt_format_print(&compiler->analyzer);
+    if (result == VOLT_SUCCESS && compiler->args.print_devirt)
+        volt_devirt_print(&compiler->analyzer);
+
+    // Drop everything codegen will never need
+    if (result == VOLT_SUCCESS) {
+        volt_dce_stats_t stats = {0};
+        result                 = volt_dce_run(&compiler->analyzer, &stats);
+        if (result == VOLT_SUCCESS && compiler->args.print_dce)
+            volt_dce_print(&compiler->analyzer, &stats);
+    }
+
     // Cleanup temporary arrays
     compiler->allocator->free(asts);
     compiler->allocator->free(filenames);
@@ -219,7 +327,156 @@ volt_status_code_t volt_compile(volt_compiler_t* compiler) {
     return 1;
 }
 
+// LINKING
+
+// Async functions, and `extern "C" fn volt_rt_*` declarations such as those behind std::mem
+static bool volt_uses_runtime(volt_semantic_analyzer_t* analyzer) {
+    if (analyzer->coroutines.size > 0)
+        return true;
+
+    volt_scope_t* global = analyzer->global_scope;
+    for (size_t i = 0; i < global->symbols.size; i++) {
+        volt_symbol_t* symbol = (volt_symbol_t*) volt_small_vector_get(&global->symbols, i);
+        if (volt_ast_is(symbol->declaration, "extern_decl") &&
+            strncmp(symbol->name, "volt_rt_", 8) == 0)
+            return true;
+    }
+    return false;
+}
+
+// `--runtime=<path>`, then $VOLT_RUNTIME_LIBRARY, then the archive the build puts next to the
+// compiler, or in ../lib beside it once installed. NULL when none of them is there.
+static char* volt_runtime_library(volt_compiler_t* compiler) {
+    char        path[4096];
+    const char* chosen = compiler->args.runtime_library;
+    if (!chosen || !*chosen)
+        chosen = getenv("VOLT_RUNTIME_LIBRARY");
+
+    if (chosen && *chosen) {
+        snprintf(path, sizeof(path), "%s", chosen);
+    } else {
+#if defined(VOLT_RUNTIME_LIBRARY) && !defined(_WIN32)
+        char    executable[4096];
+        ssize_t size = readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+        if (size > 0)
+            executable[size] = '\0';
+        else
+            snprintf(executable, sizeof(executable), "%s", compiler->args.argv[0]);
+
+        const char* slash     = strrchr(executable, '/');
+        int         directory = slash ? (int) (slash - executable) : 1;
+        const char* base      = slash ? executable : ".";
+
+        snprintf(path, sizeof(path), "%.*s/%s", directory, base, VOLT_RUNTIME_LIBRARY);
+        if (access(path, R_OK) != 0)
+            snprintf(path, sizeof(path), "%.*s/../lib/%s", directory, base, VOLT_RUNTIME_LIBRARY);
+        if (access(path, R_OK) != 0)
+            return NULL;
+#else
+        return NULL;
+#endif
+    }
+
+    size_t length = strlen(path);
+    char*  copy   = compiler->allocator->malloc(length + 1);
+    if (copy)
+        memcpy(copy, path, length + 1);
+    return copy;
+}
+
+// Runs `argv` without a shell and waits for it; the exit status, or -1 if it could not run
+static int volt_run(char** argv) {
+#if defined(_WIN32)
+    return (int) _spawnvp(_P_WAIT, argv[0], (const char* const*) argv);
+#else
+    pid_t pid;
+    if (posix_spawnp(&pid, argv[0], NULL, NULL, argv, environ) != 0)
+        return -1;
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR)
+            return -1;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+#endif
+}
+
+// Links the object files into an executable named after the first one, together with the
+// runtime library
 volt_status_code_t volt_link(volt_compiler_t* compiler) {
-    (void) compiler;
-    return 1;
+    if (compiler->analyzer.had_error || compiler->args.output_count == 0)
+        return VOLT_FAILURE;
+
+    for (size_t i = 0; i < compiler->args.output_count; i++) {
+        FILE* fp = fopen(compiler->args.output_files[i], "rb");
+        if (!fp) {
+            volt_fmt_logf(VOLT_FMT_LEVEL_INFO, "Skipping link: {s} was not produced",
+                          compiler->args.output_files[i]);
+            return VOLT_SUCCESS;
+        }
+        fclose(fp);
+    }
+
+    // The runtime is a static archive, so the linker only pulls in the parts a program uses:
+    // the scheduler, the per-thread writers or std::mem's allocators
+    char* runtime = volt_runtime_library(compiler);
+    if (!runtime && volt_uses_runtime(&compiler->analyzer)) {
+        volt_fmt_logf(VOLT_FMT_LEVEL_ERROR,
+                      "This program needs the runtime library, which was not found; pass "
+                      "--runtime=<path> or set VOLT_RUNTIME_LIBRARY");
+        return VOLT_FAILURE;
+    }
+
+    // `prog.o` -> `prog`
+    const char* first     = compiler->args.output_files[0];
+    const char* extension = strrchr(first, '.');
+    const char* separator = strrchr(first, '/');
+    size_t      stem      = extension && extension > (separator ? separator : first)
+                                ? (size_t) (extension - first)
+                                : strlen(first);
+
+    // cc <outputs...> [<runtime> -lpthread] -o <stem>
+    size_t argc = compiler->args.output_count + 6;
+    char** argv = compiler->allocator->malloc(argc * sizeof(char*));
+    char*  name = compiler->allocator->malloc(stem + 1);
+    if (!argv || !name) {
+        compiler->allocator->free(argv);
+        compiler->allocator->free(name);
+        compiler->allocator->free(runtime);
+        return VOLT_FAILURE;
+    }
+    memcpy(name, first, stem);
+    name[stem] = '\0';
+
+    size_t count  = 0;
+    argv[count++] = "cc";
+    for (size_t i = 0; i < compiler->args.output_count; i++)
+        argv[count++] = (char*) compiler->args.output_files[i];
+    if (runtime) {
+        argv[count++] = runtime;
+        argv[count++] = "-lpthread";
+    }
+    argv[count++] = "-o";
+    argv[count++] = name;
+    argv[count]   = NULL;
+
+    // Shown as typed, for copying; arguments are passed as they are, never through a shell
+    char   command[1024];
+    size_t length = 0;
+    for (size_t i = 0; i < count && length < sizeof(command); i++)
+        length += (size_t) snprintf(command + length, sizeof(command) - length, "%s%s",
+                                    i ? " " : "", argv[i]);
+    volt_fmt_logf(VOLT_FMT_LEVEL_INFO, "Linking: {s}", command);
+
+    int status = volt_run(argv);
+    if (status < 0)
+        volt_fmt_logf(VOLT_FMT_LEVEL_ERROR, "Linking failed: could not run cc");
+    else if (status != 0)
+        volt_fmt_logf(VOLT_FMT_LEVEL_ERROR, "Linking failed: cc exited with {i32}", status);
+
+    compiler->allocator->free(argv);
+    compiler->allocator->free(name);
+    compiler->allocator->free(runtime);
+    return status == 0 ? VOLT_SUCCESS : VOLT_FAILURE;
 }
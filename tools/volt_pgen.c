@@ -0,0 +1,470 @@
+// volt_pgen: turns the grammar in volt_define_expressions (src/parser/expression.c) into C.
+//
+// Every rule reachable from `unit` becomes one function and every alternative another. Rule
+// functions dispatch on the lookahead token with a switch: alternatives that start with a token
+// other than the lookahead are never entered, only recorded as expected, exactly as the
+// interpreter would have after failing them. Subrules are direct calls. The output is included
+// by src/parser/parser.c and builds on its helpers (checkpoints, pending children, failure
+// tracking), so the generated parser produces the same AST and diagnostics as the interpreter.
+// Function bodies (volt_body) are skipped by volt_parser_skip_body instead when parsing lazily.
+//
+// The grammar itself is written out too, as static const tables with every subrule already
+// resolved to its rule index. The parser points at them (volt_grammar) instead of building the
+// grammar at startup, and --interpreted-parser walks the same tables.
+//
+// Usage: volt_pgen <output file>
+
+#include <parser/expression.h>
+#include <pch.h>
+
+#include "lexer/token.h"
+
+typedef struct volt_pgen_t volt_pgen_t;
+struct volt_pgen_t {
+    FILE*                       out;
+    volt_expression_registry_t* registry;
+    bool*                       reachable;  // Per rule, indexed like registry->expressions
+};
+
+// HELPER FUNCTIONS
+
+static bool volt_pgen_is_identifier(const char* name) {
+    if (!name || !*name || (*name >= '0' && *name <= '9'))
+        return false;
+    for (const char* c = name; *c; c++) {
+        bool alpha = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z');
+        if (!alpha && !(*c >= '0' && *c <= '9') && *c != '_')
+            return false;
+    }
+    return true;
+}
+
+static bool volt_pgen_is_tail_recursive(const volt_expression_t* expr, size_t alt_index) {
+    size_t length = expr->alternative_lengths[alt_index];
+    if (length == 0)
+        return false;
+
+    const volt_subexpression_t* last = &expr->alternatives[alt_index][length - 1];
+    return last->is_subexpression && strcmp(last->subexpression, expr->expression_name) == 0;
+}
+
+// Elements the alternative's function matches: list rules loop instead of matching their tail
+static size_t volt_pgen_alt_length(const volt_expression_t* expr, size_t alt_index) {
+    size_t length = expr->alternative_lengths[alt_index];
+    if (expr->is_list && volt_pgen_is_tail_recursive(expr, alt_index))
+        length--;
+    return length;
+}
+
+// The token an alternative must start with, or VOLT_TOKEN_TYPE_NONE when it can start with
+// anything (a subrule or an optional token first)
+static volt_token_type_t volt_pgen_leading_token(const volt_expression_t* expr, size_t alt_index) {
+    if (volt_pgen_alt_length(expr, alt_index) == 0)
+        return VOLT_TOKEN_TYPE_NONE;
+
+    const volt_subexpression_t* first = &expr->alternatives[alt_index][0];
+    if (first->is_subexpression || first->is_optional)
+        return VOLT_TOKEN_TYPE_NONE;
+    return first->token_type;
+}
+
+static const char* volt_pgen_token_name(volt_token_type_t type) {
+    const char* name = volt_token_type_to_string(type);
+    if (strcmp(name, "UNKNOWN_TOKEN_TYPE") == 0) {
+        fprintf(stderr, "volt_pgen: token type %d has no name\n", (int) type);
+        exit(EXIT_FAILURE);
+    }
+    return name;
+}
+
+static void volt_pgen_mark_reachable(volt_pgen_t* pgen, size_t index) {
+    if (index >= pgen->registry->count || pgen->reachable[index])
+        return;
+    pgen->reachable[index] = true;
+
+    const volt_expression_t* expr = pgen->registry->expressions[index];
+    for (size_t alt = 0; alt < expr->num_alternatives; alt++) {
+        for (size_t i = 0; i < expr->alternative_lengths[alt]; i++) {
+            const volt_subexpression_t* sub = &expr->alternatives[alt][i];
+            if (sub->is_subexpression)
+                volt_pgen_mark_reachable(pgen, sub->rule);
+        }
+    }
+}
+
+// Alternatives after one with no elements can never be reached
+static size_t volt_pgen_live_alternatives(const volt_expression_t* expr) {
+    for (size_t alt = 0; alt < expr->num_alternatives; alt++) {
+        if (expr->alternative_lengths[alt] == 0)
+            return alt + 1;
+    }
+    return expr->num_alternatives;
+}
+
+// EMITTERS
+static void volt_pgen_emit_comment(volt_pgen_t* pgen, const volt_expression_t* expr,
+                                   size_t alt_index, const char* indent) {
+    fprintf(pgen->out, "%s// %s ::=", indent, expr->expression_name);
+    if (expr->alternative_lengths[alt_index] == 0)
+        fprintf(pgen->out, " <empty>");
+    for (size_t i = 0; i < expr->alternative_lengths[alt_index]; i++) {
+        const volt_subexpression_t* sub = &expr->alternatives[alt_index][i];
+        fprintf(pgen->out, " %s%s",
+                sub->is_subexpression ? sub->subexpression : volt_pgen_token_name(sub->token_type),
+                sub->is_optional ? "?" : "");
+    }
+    fprintf(pgen->out, "\n");
+}
+
+static void volt_pgen_emit_alternative(volt_pgen_t* pgen, const volt_expression_t* expr,
+                                       size_t alt_index) {
+    size_t length = volt_pgen_alt_length(expr, alt_index);
+
+    volt_pgen_emit_comment(pgen, expr, alt_index, "");
+    fprintf(pgen->out, "static bool volt_gen_%s_%zu(volt_parser_t* parser) {\n",
+            expr->expression_name, alt_index);
+    fprintf(pgen->out,
+            "    volt_parser_checkpoint_t checkpoint = volt_parser_checkpoint(parser);\n");
+    fprintf(pgen->out, "    volt_ast_node_t*         child;\n\n");
+
+    for (size_t i = 0; i < length; i++) {
+        const volt_subexpression_t* sub = &expr->alternatives[alt_index][i];
+        if (!sub->is_subexpression) {
+            fprintf(pgen->out, "    child = volt_parser_match_token(parser, VOLT_TOKEN_TYPE_%s);\n",
+                    volt_pgen_token_name(sub->token_type));
+        } else if (sub->rule < pgen->registry->count && sub->is_body) {
+            fprintf(pgen->out,
+                    "    child = parser->lazy_bodies\n"
+                    "                ? volt_parser_skip_body(parser, &volt_grammar_%s_%zu[%zu])\n"
+                    "                : volt_gen_%s(parser);\n",
+                    expr->expression_name, alt_index, i, sub->subexpression);
+        } else if (sub->rule < pgen->registry->count) {
+            fprintf(pgen->out, "    child = volt_gen_%s(parser);\n", sub->subexpression);
+        } else {
+            fprintf(stderr, "volt_pgen: warning: '%s' refers to unknown rule '%s'\n",
+                    expr->expression_name, sub->subexpression);
+            fprintf(pgen->out, "    child = volt_parser_unknown_rule(parser);\n");
+        }
+        fprintf(pgen->out,
+                "    if (!volt_parser_push_%s(parser, child))\n        goto backtrack;\n",
+                sub->is_optional ? "optional" : "child");
+    }
+
+    fprintf(pgen->out, "    return true;\n\n");
+    fprintf(pgen->out, "backtrack:\n");
+    fprintf(pgen->out, "    volt_parser_backtrack(parser, checkpoint);\n");
+    fprintf(pgen->out, "    return false;\n");
+    fprintf(pgen->out, "}\n\n");
+}
+
+// The alternatives tried, in grammar order, when the lookahead is `lookahead`
+// (VOLT_TOKEN_TYPE_NONE for any token no alternative starts with)
+static void volt_pgen_emit_case_body(volt_pgen_t* pgen, const volt_expression_t* expr,
+                                     volt_token_type_t lookahead, const char* indent) {
+    size_t live = volt_pgen_live_alternatives(expr);
+    for (size_t alt = 0; alt < live; alt++) {
+        volt_token_type_t leading = volt_pgen_leading_token(expr, alt);
+        bool              tail    = expr->is_list && volt_pgen_is_tail_recursive(expr, alt);
+
+        if (leading != VOLT_TOKEN_TYPE_NONE && leading != lookahead) {
+            // Not entered: the interpreter would only have recorded its first token as expected
+            fprintf(pgen->out, "%svolt_parser_expect(parser, VOLT_TOKEN_TYPE_%s);\n", indent,
+                    volt_pgen_token_name(leading));
+            continue;
+        }
+
+        if (expr->alternative_lengths[alt] == 0) {
+            volt_pgen_emit_comment(pgen, expr, alt, indent);
+            if (expr->is_list)
+                fprintf(pgen->out, "%sbreak;\n", indent);
+            else
+                fprintf(pgen->out, "%sreturn volt_parser_reduce(parser, rule, first_child);\n",
+                        indent);
+            return;
+        }
+
+        fprintf(pgen->out, "%sif (volt_gen_%s_%zu(parser))", indent, expr->expression_name, alt);
+        if (!expr->is_list)
+            fprintf(pgen->out, "\n%s    return volt_parser_reduce(parser, rule, first_child);\n",
+                    indent);
+        else if (tail)
+            fprintf(pgen->out, " {\n%s    more = parser->current > start;\n%s    break;\n%s}\n",
+                    indent, indent, indent);
+        else
+            fprintf(pgen->out, "\n%s    break;\n", indent);
+    }
+    fprintf(pgen->out, "%sbreak;\n", indent);
+}
+
+static void volt_pgen_emit_dispatch(volt_pgen_t* pgen, const volt_expression_t* expr,
+                                    const char* indent) {
+    size_t live = volt_pgen_live_alternatives(expr);
+
+    // Tokens that some alternative starts with get their own case; tokens leading the same
+    // alternatives share one
+    bool handled[VOLT_TOKEN_TYPE_COUNT] = {0};
+    bool any_case                       = false;
+    for (size_t alt = 0; alt < live; alt++) {
+        volt_token_type_t leading = volt_pgen_leading_token(expr, alt);
+        if (leading != VOLT_TOKEN_TYPE_NONE)
+            any_case = true;
+    }
+
+    if (!any_case) {
+        // Nothing to dispatch on; a switch with only a default would just add noise
+        fprintf(pgen->out, "%sdo {\n", indent);
+        char inner[64];
+        snprintf(inner, sizeof(inner), "%s    ", indent);
+        volt_pgen_emit_case_body(pgen, expr, VOLT_TOKEN_TYPE_NONE, inner);
+        fprintf(pgen->out, "%s} while (0);\n", indent);
+        return;
+    }
+
+    char body_indent[64];
+    snprintf(body_indent, sizeof(body_indent), "%s        ", indent);
+
+    fprintf(pgen->out, "%sswitch (volt_parser_lookahead(parser)) {\n", indent);
+    for (size_t alt = 0; alt < live; alt++) {
+        volt_token_type_t leading = volt_pgen_leading_token(expr, alt);
+        if (leading == VOLT_TOKEN_TYPE_NONE || handled[leading])
+            continue;
+
+        // Same body for every token that starts exactly the same set of alternatives
+        for (size_t other = alt; other < live; other++) {
+            volt_token_type_t token = volt_pgen_leading_token(expr, other);
+            if (token == VOLT_TOKEN_TYPE_NONE || handled[token])
+                continue;
+
+            bool same = true;
+            for (size_t k = 0; k < live && same; k++) {
+                volt_token_type_t at = volt_pgen_leading_token(expr, k);
+                same = (at == leading) == (at == token);
+            }
+            if (!same)
+                continue;
+
+            fprintf(pgen->out, "%s    case VOLT_TOKEN_TYPE_%s:\n", indent,
+                    volt_pgen_token_name(token));
+            handled[token] = true;
+        }
+        volt_pgen_emit_case_body(pgen, expr, leading, body_indent);
+    }
+    fprintf(pgen->out, "%s    default:\n", indent);
+    volt_pgen_emit_case_body(pgen, expr, VOLT_TOKEN_TYPE_NONE, body_indent);
+    fprintf(pgen->out, "%s}\n", indent);
+}
+
+static void volt_pgen_emit_rule(volt_pgen_t* pgen, size_t index) {
+    const volt_expression_t* expr = pgen->registry->expressions[index];
+
+    for (size_t alt = 0; alt < expr->num_alternatives; alt++)
+        volt_pgen_emit_comment(pgen, expr, alt, "");
+    fprintf(pgen->out, "static volt_ast_node_t* volt_gen_%s(volt_parser_t* parser) {\n",
+            expr->expression_name);
+    fprintf(pgen->out, "    const volt_expression_t* rule        = &volt_grammar_rules[%zu];\n",
+            index);
+    fprintf(pgen->out, "    size_t                   first_child = parser->pending.size;\n\n");
+
+    if (expr->is_list) {
+        bool has_tail = false;
+        for (size_t alt = 0; alt < volt_pgen_live_alternatives(expr); alt++)
+            has_tail = has_tail || volt_pgen_is_tail_recursive(expr, alt);
+
+        fprintf(pgen->out, "    bool more = true;\n");
+        fprintf(pgen->out, "    while (more) {\n");
+        fprintf(pgen->out, "        size_t start = parser->current;\n");
+        fprintf(pgen->out, "        more         = false;\n");
+        if (!has_tail)
+            fprintf(pgen->out, "        (void) start;\n");
+        fprintf(pgen->out, "\n");
+        volt_pgen_emit_dispatch(pgen, expr, "        ");
+        fprintf(pgen->out, "    }\n\n");
+        fprintf(pgen->out, "    return volt_parser_reduce(parser, rule, first_child);\n");
+    } else {
+        volt_pgen_emit_dispatch(pgen, expr, "    ");
+        fprintf(pgen->out, "\n    volt_parser_fail_rule(parser, rule);\n");
+        fprintf(pgen->out, "    return NULL;\n");
+    }
+    fprintf(pgen->out, "}\n\n");
+}
+
+// One array per alternative, then per rule its alternatives and lengths, then the rules and the
+// registry over them. Empty alternatives and rules point at nothing.
+static void volt_pgen_emit_tables(volt_pgen_t* pgen) {
+    volt_expression_registry_t* registry = pgen->registry;
+
+    fprintf(pgen->out, "// GRAMMAR\n");
+    for (size_t i = 0; i < registry->count; i++) {
+        const volt_expression_t* expr = registry->expressions[i];
+        const char*              name = expr->expression_name;
+
+        for (size_t alt = 0; alt < expr->num_alternatives; alt++) {
+            if (expr->alternative_lengths[alt] == 0)
+                continue;
+
+            volt_pgen_emit_comment(pgen, expr, alt, "");
+            fprintf(pgen->out, "static const volt_subexpression_t volt_grammar_%s_%zu[] = {\n",
+                    name, alt);
+            for (size_t j = 0; j < expr->alternative_lengths[alt]; j++) {
+                const volt_subexpression_t* sub = &expr->alternatives[alt][j];
+                if (sub->is_subexpression)
+                    fprintf(pgen->out,
+                            "    {.subexpression = \"%s\", .is_subexpression = true, "
+                            ".is_optional = %s,%s .rule = %zu},\n",
+                            sub->subexpression, sub->is_optional ? "true" : "false",
+                            sub->is_body ? " .is_body = true," : "", sub->rule);
+                else
+                    fprintf(pgen->out,
+                            "    {.token_type = VOLT_TOKEN_TYPE_%s, .is_subexpression = false, "
+                            ".is_optional = %s},\n",
+                            volt_pgen_token_name(sub->token_type),
+                            sub->is_optional ? "true" : "false");
+            }
+            fprintf(pgen->out, "};\n");
+        }
+
+        if (expr->num_alternatives == 0)
+            continue;
+
+        fprintf(pgen->out, "static const volt_subexpression_t* const volt_grammar_%s_alts[] = {\n",
+                name);
+        for (size_t alt = 0; alt < expr->num_alternatives; alt++) {
+            if (expr->alternative_lengths[alt] == 0)
+                fprintf(pgen->out, "    NULL,\n");
+            else
+                fprintf(pgen->out, "    volt_grammar_%s_%zu,\n", name, alt);
+        }
+        fprintf(pgen->out, "};\n");
+        fprintf(pgen->out, "static const size_t volt_grammar_%s_lengths[] = {", name);
+        for (size_t alt = 0; alt < expr->num_alternatives; alt++)
+            fprintf(pgen->out, "%s%zu", alt ? ", " : "", expr->alternative_lengths[alt]);
+        fprintf(pgen->out, "};\n\n");
+    }
+
+    fprintf(pgen->out,
+            "static const volt_expression_t volt_grammar_rules[VOLT_GENERATED_RULE_COUNT] = {\n");
+    for (size_t i = 0; i < registry->count; i++) {
+        const volt_expression_t* expr = registry->expressions[i];
+        const char*              name = expr->expression_name;
+        bool                     any  = expr->num_alternatives > 0;
+
+        fprintf(pgen->out, "    {.expression_name     = \"%s\",\n", name);
+        fprintf(pgen->out, "     .num_alternatives    = %zu,\n", expr->num_alternatives);
+        fprintf(pgen->out, "     .capacity            = %zu,\n", expr->num_alternatives);
+        if (any) {
+            fprintf(pgen->out, "     .alternatives        = volt_grammar_%s_alts,\n", name);
+            fprintf(pgen->out, "     .alternative_lengths = volt_grammar_%s_lengths,\n", name);
+        } else {
+            fprintf(pgen->out, "     .alternatives        = NULL,\n");
+            fprintf(pgen->out, "     .alternative_lengths = NULL,\n");
+        }
+        fprintf(pgen->out, "     .is_list             = %s},\n", expr->is_list ? "true" : "false");
+    }
+    fprintf(pgen->out, "};\n\n");
+
+    fprintf(pgen->out, "static const volt_expression_t* const "
+                       "volt_grammar_expressions[VOLT_GENERATED_RULE_COUNT] = {\n");
+    for (size_t i = 0; i < registry->count; i++)
+        fprintf(pgen->out, "    &volt_grammar_rules[%zu],\n", i);
+    fprintf(pgen->out, "};\n\n");
+
+    fprintf(pgen->out, "static const volt_expression_registry_t volt_grammar = {\n");
+    fprintf(pgen->out, "    .expressions = volt_grammar_expressions,\n");
+    fprintf(pgen->out, "    .count       = VOLT_GENERATED_RULE_COUNT,\n");
+    fprintf(pgen->out, "    .capacity    = VOLT_GENERATED_RULE_COUNT,\n");
+    fprintf(pgen->out, "    .allocator   = NULL,\n");
+    fprintf(pgen->out, "};\n\n");
+}
+
+static void volt_pgen_emit(volt_pgen_t* pgen) {
+    volt_expression_registry_t* registry = pgen->registry;
+
+    fprintf(pgen->out,
+            "// Generated by volt_pgen from volt_define_expressions (src/parser/expression.c).\n"
+            "// Do not edit; it is rebuilt with the compiler.\n"
+            "// Included by src/parser/parser.c.\n\n");
+
+    fprintf(pgen->out, "#define VOLT_GENERATED_RULE_COUNT %zu\n\n", registry->count);
+    volt_pgen_emit_tables(pgen);
+
+    fprintf(pgen->out, "// RULES\n");
+    for (size_t i = 0; i < registry->count; i++) {
+        if (pgen->reachable[i])
+            fprintf(pgen->out, "static volt_ast_node_t* volt_gen_%s(volt_parser_t* parser);\n",
+                    registry->expressions[i]->expression_name);
+    }
+    fprintf(pgen->out, "\n// ALTERNATIVES\n");
+    for (size_t i = 0; i < registry->count; i++) {
+        const volt_expression_t* expr = registry->expressions[i];
+        if (!pgen->reachable[i])
+            continue;
+        for (size_t alt = 0; alt < volt_pgen_live_alternatives(expr); alt++) {
+            if (expr->alternative_lengths[alt] > 0)
+                volt_pgen_emit_alternative(pgen, expr, alt);
+        }
+    }
+
+    fprintf(pgen->out, "// RULE FUNCTIONS\n");
+    for (size_t i = 0; i < registry->count; i++) {
+        if (pgen->reachable[i])
+            volt_pgen_emit_rule(pgen, i);
+    }
+
+    // Lets the parser start at any rule by index, as it does for skipped function bodies
+    fprintf(pgen->out, "// Rule functions by registry index, NULL when unreachable from `unit`\n");
+    fprintf(pgen->out, "static volt_ast_node_t* (*const "
+                       "volt_gen_rules[VOLT_GENERATED_RULE_COUNT])(volt_parser_t*) = {\n");
+    for (size_t i = 0; i < registry->count; i++) {
+        if (pgen->reachable[i])
+            fprintf(pgen->out, "    volt_gen_%s,\n", registry->expressions[i]->expression_name);
+        else
+            fprintf(pgen->out, "    NULL,\n");
+    }
+    fprintf(pgen->out, "};\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <output file>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    volt_expression_registry_t registry = {0};
+    volt_expression_registry_init(&registry, NULL);
+    volt_define_expressions(&registry);
+    volt_expression_registry_resolve(&registry);
+
+    for (size_t i = 0; i < registry.count; i++) {
+        if (!volt_pgen_is_identifier(registry.expressions[i]->expression_name)) {
+            fprintf(stderr, "volt_pgen: rule name '%s' is not a C identifier\n",
+                    registry.expressions[i]->expression_name);
+            return EXIT_FAILURE;
+        }
+    }
+
+    volt_pgen_t pgen = {0};
+    pgen.registry    = &registry;
+    pgen.reachable   = calloc(registry.count ? registry.count : 1, sizeof(bool));
+    if (!pgen.reachable)
+        return EXIT_FAILURE;
+
+    size_t unit = volt_expression_registry_index(&registry, "unit");
+    if (unit == registry.count) {
+        fprintf(stderr, "volt_pgen: grammar has no 'unit' rule\n");
+        return EXIT_FAILURE;
+    }
+    volt_pgen_mark_reachable(&pgen, unit);
+
+    pgen.out = fopen(argv[1], "w");
+    if (!pgen.out) {
+        fprintf(stderr, "volt_pgen: cannot write %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    volt_pgen_emit(&pgen);
+
+    bool written = fclose(pgen.out) == 0;
+    free(pgen.reachable);
+    volt_expression_registry_deinit(&registry);
+    return written ? EXIT_SUCCESS : EXIT_FAILURE;
+}